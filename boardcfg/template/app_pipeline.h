@@ -31,6 +31,12 @@
 #define PIPELINE_TRANSPORT_TX(token, command, rc, iov, iov_count) \
   USBTransport_SendResponse(token, command, rc, iov, iov_count);
 
+#define PIPELINE_TRANSPORT_TX_PINNED(token, command, rc, iov, iov_count) \
+  USBTransport_SendPinnedResponse(token, command, rc, iov, iov_count);
+
+#define PIPELINE_TRANSPORT_TX_IS_PINNED(data) \
+  USBTransport_IsPinned(data)
+
 #define PIPELINE_TRANSPORT_RX(data, size) \
   StreamDecoder_Process(data, size);
 
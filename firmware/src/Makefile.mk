@@ -1,8 +1,12 @@
 noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
+                      firmware/src/libdimmercurve.la \
                       firmware/src/libdimmermodel.la \
+                      firmware/src/libdmxmerge.la \
+                      firmware/src/libfadeengine.la \
                       firmware/src/libflags.la \
                       firmware/src/libledmodel.la \
                       firmware/src/libmessagehandler.la \
+                      firmware/src/libmovinglight.la \
                       firmware/src/libnetworkmodel.la \
                       firmware/src/libproxymodel.la \
                       firmware/src/librandom.la \
@@ -12,6 +16,7 @@ noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
                       firmware/src/librdmutil.la \
                       firmware/src/libreceivercounters.la \
                       firmware/src/libresponder.la \
+                      firmware/src/libsensormodel.la \
                       firmware/src/libspirgb.la \
                       firmware/src/libstreamdecoder.la \
                       firmware/src/libtransceiver.la \
@@ -20,9 +25,18 @@ noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
 firmware_src_libcoarsetimer_la_SOURCES = firmware/src/coarse_timer.c
 firmware_src_libcoarsetimer_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libdimmercurve_la_SOURCES = firmware/src/dimmer_curve.c
+firmware_src_libdimmercurve_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libdimmermodel_la_SOURCES = firmware/src/dimmer_model.c
 firmware_src_libdimmermodel_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libdmxmerge_la_SOURCES = firmware/src/dmx_merge.c
+firmware_src_libdmxmerge_la_CFLAGS = $(BUILD_FLAGS)
+
+firmware_src_libfadeengine_la_SOURCES = firmware/src/fade_engine.c
+firmware_src_libfadeengine_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libflags_la_SOURCES = firmware/src/flags.c
 firmware_src_libflags_la_CFLAGS = $(BUILD_FLAGS)
 
@@ -32,6 +46,9 @@ firmware_src_libledmodel_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libmessagehandler_la_SOURCES = firmware/src/message_handler.c
 firmware_src_libmessagehandler_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libmovinglight_la_SOURCES = firmware/src/moving_light.c
+firmware_src_libmovinglight_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libnetworkmodel_la_SOURCES = firmware/src/network_model.c
 firmware_src_libnetworkmodel_la_CFLAGS = $(BUILD_FLAGS)
 
@@ -59,8 +76,12 @@ firmware_src_libreceivercounters_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libresponder_la_SOURCES = firmware/src/responder.c
 firmware_src_libresponder_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libsensormodel_la_SOURCES = firmware/src/sensor_model.c
+firmware_src_libsensormodel_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libspirgb_la_SOURCES = firmware/src/spi_rgb.c
 firmware_src_libspirgb_la_CFLAGS = $(BUILD_FLAGS)
+firmware_src_libspirgb_la_LIBADD = firmware/src/libdimmercurve.la
 
 firmware_src_libstreamdecoder_la_SOURCES = firmware/src/stream_decoder.c
 firmware_src_libstreamdecoder_la_CFLAGS = $(BUILD_FLAGS)
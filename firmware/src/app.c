@@ -46,10 +46,49 @@
 
 #include "app_settings.h"
 
+/*
+ * @brief Build the TransceiverHardwareSettings for a port.
+ */
+#define TRANSCEIVER_SETTINGS(uart, timer, ic, io_port, break_pin, \
+                             tx_enable_pin, rx_enable_pin, tx_dma, tx_channel, \
+                             rx_dma, rx_channel) \
+  { \
+    .usart = AS_USART_ID(uart), \
+    .usart_vector = AS_USART_INTERRUPT_VECTOR(uart), \
+    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(uart), \
+    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(uart), \
+    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(uart), \
+    .port = io_port, \
+    .break_bit = break_pin, \
+    .tx_enable_bit = tx_enable_pin, \
+    .rx_enable_bit = rx_enable_pin, \
+    .input_capture_module = AS_IC_ID(ic), \
+    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(ic), \
+    .input_capture_source = AS_IC_INTERRUPT_SOURCE(ic), \
+    .timer_module_id = AS_TIMER_ID(timer), \
+    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(timer), \
+    .timer_source = AS_TIMER_INTERRUPT_SOURCE(timer), \
+    .input_capture_timer = AS_IC_TMR_ID(timer), \
+    .use_tx_dma = tx_dma, \
+    .tx_dma_channel = AS_DMA_CHANNEL(tx_channel), \
+    .tx_dma_trigger = AS_USART_DMA_TX_TRIGGER(uart), \
+    .tx_dma_vector = AS_DMA_INTERRUPT_VECTOR(tx_channel), \
+    .tx_dma_source = AS_DMA_INTERRUPT_SOURCE(tx_channel), \
+    .use_rx_dma = rx_dma, \
+    .rx_dma_channel = AS_DMA_CHANNEL(rx_channel), \
+    .rx_dma_trigger = AS_USART_DMA_RX_TRIGGER(uart), \
+    .rx_dma_vector = AS_DMA_INTERRUPT_VECTOR(rx_channel), \
+    .rx_dma_source = AS_DMA_INTERRUPT_SOURCE(rx_channel), \
+  }
+
 void __ISR(AS_TIMER_ISR_VECTOR(COARSE_TIMER_ID), ipl6) TimerEvent() {
   CoarseTimer_TimerEvent();
 }
 
+void __ISR(AS_DMA_ISR_VECTOR(SPI_DMA_CHANNEL), ipl5) SPIDMAEvent() {
+  SPIRGB_DMAEvent();
+}
+
 void APP_Initialize(void) {
 #ifdef PRE_APP_INIT_HOOK
   PRE_APP_INIT_HOOK();
@@ -73,25 +112,42 @@ void APP_Initialize(void) {
   SysLog_Initialize(NULL);
 
   // Initialize the DMX / RDM Transceiver
-  TransceiverHardwareSettings transceiver_settings = {
-    .usart = AS_USART_ID(TRANSCEIVER_UART),
-    .usart_vector = AS_USART_INTERRUPT_VECTOR(TRANSCEIVER_UART),
-    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(TRANSCEIVER_UART),
-    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(TRANSCEIVER_UART),
-    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(TRANSCEIVER_UART),
-    .port = TRANSCEIVER_PORT,
-    .break_bit = TRANSCEIVER_PORT_BIT,
-    .tx_enable_bit = TRANSCEIVER_TX_ENABLE_PORT_BIT,
-    .rx_enable_bit = TRANSCEIVER_RX_ENABLE_PORT_BIT,
-    .input_capture_module = AS_IC_ID(TRANSCEIVER_IC),
-    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(TRANSCEIVER_IC),
-    .input_capture_source = AS_IC_INTERRUPT_SOURCE(TRANSCEIVER_IC),
-    .timer_module_id = AS_TIMER_ID(TRANSCEIVER_TIMER),
-    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(TRANSCEIVER_TIMER),
-    .timer_source = AS_TIMER_INTERRUPT_SOURCE(TRANSCEIVER_TIMER),
-    .input_capture_timer = AS_IC_TMR_ID(TRANSCEIVER_TIMER),
+  const TransceiverHardwareSettings transceiver_settings[] = {
+    TRANSCEIVER_SETTINGS(TRANSCEIVER_UART, TRANSCEIVER_TIMER, TRANSCEIVER_IC,
+                         TRANSCEIVER_PORT, TRANSCEIVER_PORT_BIT,
+                         TRANSCEIVER_TX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_RX_ENABLE_PORT_BIT, TRANSCEIVER_TX_DMA,
+                         TRANSCEIVER_TX_DMA_CHANNEL, TRANSCEIVER_RX_DMA,
+                         TRANSCEIVER_RX_DMA_CHANNEL),
+#if TRANSCEIVER_PORT_COUNT > 1
+    TRANSCEIVER_SETTINGS(TRANSCEIVER_1_UART, TRANSCEIVER_1_TIMER,
+                         TRANSCEIVER_1_IC, TRANSCEIVER_1_PORT,
+                         TRANSCEIVER_1_PORT_BIT,
+                         TRANSCEIVER_1_TX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_1_RX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_1_TX_DMA, TRANSCEIVER_1_TX_DMA_CHANNEL,
+                         TRANSCEIVER_1_RX_DMA, TRANSCEIVER_1_RX_DMA_CHANNEL),
+#endif
+#if TRANSCEIVER_PORT_COUNT > 2
+    TRANSCEIVER_SETTINGS(TRANSCEIVER_2_UART, TRANSCEIVER_2_TIMER,
+                         TRANSCEIVER_2_IC, TRANSCEIVER_2_PORT,
+                         TRANSCEIVER_2_PORT_BIT,
+                         TRANSCEIVER_2_TX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_2_RX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_2_TX_DMA, TRANSCEIVER_2_TX_DMA_CHANNEL,
+                         TRANSCEIVER_2_RX_DMA, TRANSCEIVER_2_RX_DMA_CHANNEL),
+#endif
+#if TRANSCEIVER_PORT_COUNT > 3
+    TRANSCEIVER_SETTINGS(TRANSCEIVER_3_UART, TRANSCEIVER_3_TIMER,
+                         TRANSCEIVER_3_IC, TRANSCEIVER_3_PORT,
+                         TRANSCEIVER_3_PORT_BIT,
+                         TRANSCEIVER_3_TX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_3_RX_ENABLE_PORT_BIT,
+                         TRANSCEIVER_3_TX_DMA, TRANSCEIVER_3_TX_DMA_CHANNEL,
+                         TRANSCEIVER_3_RX_DMA, TRANSCEIVER_3_RX_DMA_CHANNEL),
+#endif
   };
-  Transceiver_Initialize(&transceiver_settings, NULL, NULL);
+  Transceiver_Initialize(transceiver_settings, NULL, NULL);
 
   // Base RDM Responder
   RDMResponderSettings responder_settings = {
@@ -104,6 +160,23 @@ void APP_Initialize(void) {
   RDMResponder_Initialize(&responder_settings);
   ReceiverCounters_ResetCounters();
 
+  // SPI DMX Output. This comes before the RDM Handler, since activating the
+  // LED model configures the pixels.
+  SPIRGBConfiguration spi_config;
+  spi_config.module_id = SPI_MODULE_ID;
+  spi_config.baud_rate = SPI_BAUD_RATE;
+  spi_config.use_enhanced_buffering = SPI_USE_ENHANCED_BUFFERING;
+  spi_config.use_dma = SPI_USE_DMA;
+  spi_config.dma_channel = AS_DMA_CHANNEL(SPI_DMA_CHANNEL);
+  spi_config.dma_trigger = SPI_DMA_TRIGGER;
+  spi_config.dma_vector = AS_DMA_INTERRUPT_VECTOR(SPI_DMA_CHANNEL);
+  spi_config.dma_source = AS_DMA_INTERRUPT_SOURCE(SPI_DMA_CHANNEL);
+  SPIRGB_Init(&spi_config);
+
+  // Send a frame with all pixels set to 0.
+  SPIRGB_BeginUpdate();
+  SPIRGB_CompleteUpdate();
+
   // RDM Handler
   RDMHandlerSettings rdm_handler_settings = {
     .default_model = LED_MODEL_ID,
@@ -136,16 +209,6 @@ void APP_Initialize(void) {
 
   Flags_Initialize();
 
-  // SPI DMX Output
-  SPIRGBConfiguration spi_config;
-  spi_config.module_id = SPI_MODULE_ID;
-  spi_config.baud_rate = SPI_BAUD_RATE;
-  spi_config.use_enhanced_buffering = SPI_USE_ENHANCED_BUFFERING;
-  SPIRGB_Init(&spi_config);
-
-  // Send a frame with all pixels set to 0.
-  SPIRGB_BeginUpdate();
-  SPIRGB_CompleteUpdate();
 }
 
 void APP_Tasks(void) {
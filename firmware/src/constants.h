@@ -181,9 +181,39 @@ typedef enum {
    */
   COMMAND_GET_RDM_RESPONDER_JITTER = 0x29,
 
+  /**
+   * @brief Set the DMX stream refresh interval.
+   * See @ref message-commands-setrefreshinterval.
+   */
+  COMMAND_SET_DMX_REFRESH_INTERVAL = 0x2a,
+
+  /**
+   * @brief Get the DMX stream refresh interval.
+   * See @ref message-commands-getrefreshinterval.
+   */
+  COMMAND_GET_DMX_REFRESH_INTERVAL = 0x2b,
+
   // DMX
   TX_DMX = 0x30,  //!< Transmit a DMX frame. See @ref message-commands-txdmx.
 
+  /**
+   * @brief Load the DMX stream and start transmitting it continuously.
+   * See @ref message-commands-startdmxstream.
+   */
+  COMMAND_START_DMX_STREAM = 0x31,
+
+  /**
+   * @brief Stop transmitting the DMX stream.
+   * See @ref message-commands-stopdmxstream.
+   */
+  COMMAND_STOP_DMX_STREAM = 0x32,
+
+  /**
+   * @brief Update runs of slots in the DMX stream.
+   * See @ref message-commands-updatedmxstream.
+   */
+  COMMAND_UPDATE_DMX_STREAM = 0x33,
+
   // RDM
   /**
    * @brief Send an RDM Discovery Unique Branch and wait for a response.
@@ -208,6 +238,18 @@ typedef enum {
   GET_FLAGS = 0xf2,  //!< Get the flags state
 } Command;
 
+/**
+ * @brief The bits of the Command field that select the transceiver port.
+ *
+ * See @ref message-ports.
+ */
+#define COMMAND_PORT_MASK 0xf000u
+
+/**
+ * @brief The offset of the port in the Command field.
+ */
+#define COMMAND_PORT_SHIFT 12u
+
 /**
  * @brief JaRule command return codes.
  */
@@ -290,6 +332,14 @@ typedef enum {
  */
 #define DEFAULT_RDM_RESPONDER_DELAY 1760u
 
+/**
+ * @brief The default break to break interval for the DMX stream.
+ * @sa Transceiver_SetDMXRefreshInterval.
+ *
+ * Measured in 10ths of a millisecond. This gives a refresh rate of 44Hz.
+ */
+#define DEFAULT_DMX_REFRESH_INTERVAL 227u
+
 #endif  // FIRMWARE_SRC_CONSTANTS_H_
 
 /**
@@ -0,0 +1,179 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dimmer_curve.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "dimmer_curve.h"
+
+#include <stdlib.h>
+
+/*
+ * The tables were generated with:
+ *   Linear: i
+ *   Modified Linear: i ? round(26 + 229 * (i - 1) / 254) : 0
+ *   Square: round(i * i / 255)
+ *   Modified Square: i ? round(26 + 229 * ((i - 1) / 254) ^ 2) : 0
+ *
+ * 26 (~10%) is the pre-heat level of the modified curves.
+ */
+static const uint8_t LINEAR[DIMMER_CURVE_TABLE_SIZE] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+  12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+  24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
+  36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+  48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+  60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+  72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83,
+  84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95,
+  96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107,
+  108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+  120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131,
+  132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+  144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155,
+  156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167,
+  168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+  180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+  192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203,
+  204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215,
+  216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
+  228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+  240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251,
+  252, 253, 254, 255
+};
+
+static const uint8_t MODIFIED_LINEAR[DIMMER_CURVE_TABLE_SIZE] = {
+  0, 26, 27, 28, 29, 30, 31, 31, 32, 33, 34, 35,
+  36, 37, 38, 39, 40, 40, 41, 42, 43, 44, 45, 46,
+  47, 48, 49, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+  58, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 67,
+  68, 69, 70, 71, 72, 73, 74, 75, 76, 76, 77, 78,
+  79, 80, 81, 82, 83, 84, 85, 86, 86, 87, 88, 89,
+  90, 91, 92, 93, 94, 95, 95, 96, 97, 98, 99, 100,
+  101, 102, 103, 104, 104, 105, 106, 107, 108, 109, 110, 111,
+  112, 113, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122,
+  122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 131, 132,
+  133, 134, 135, 136, 137, 138, 139, 140, 140, 141, 142, 143,
+  144, 145, 146, 147, 148, 149, 150, 150, 151, 152, 153, 154,
+  155, 156, 157, 158, 159, 159, 160, 161, 162, 163, 164, 165,
+  166, 167, 168, 168, 169, 170, 171, 172, 173, 174, 175, 176,
+  177, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 186,
+  187, 188, 189, 190, 191, 192, 193, 194, 195, 195, 196, 197,
+  198, 199, 200, 201, 202, 203, 204, 205, 205, 206, 207, 208,
+  209, 210, 211, 212, 213, 214, 214, 215, 216, 217, 218, 219,
+  220, 221, 222, 223, 223, 224, 225, 226, 227, 228, 229, 230,
+  231, 232, 232, 233, 234, 235, 236, 237, 238, 239, 240, 241,
+  241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 250, 251,
+  252, 253, 254, 255
+};
+
+static const uint8_t SQUARE[DIMMER_CURVE_TABLE_SIZE] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2,
+  2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5,
+  5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9,
+  9, 9, 10, 10, 11, 11, 11, 12, 12, 13, 13, 14,
+  14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19, 20,
+  20, 21, 21, 22, 23, 23, 24, 24, 25, 26, 26, 27,
+  28, 28, 29, 30, 30, 31, 32, 32, 33, 34, 35, 35,
+  36, 37, 38, 38, 39, 40, 41, 42, 42, 43, 44, 45,
+  46, 47, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56,
+  56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67,
+  68, 69, 70, 71, 73, 74, 75, 76, 77, 78, 79, 80,
+  81, 82, 84, 85, 86, 87, 88, 89, 91, 92, 93, 94,
+  95, 97, 98, 99, 100, 102, 103, 104, 105, 107, 108, 109,
+  111, 112, 113, 115, 116, 117, 119, 120, 121, 123, 124, 126,
+  127, 128, 130, 131, 133, 134, 136, 137, 139, 140, 142, 143,
+  145, 146, 148, 149, 151, 152, 154, 155, 157, 158, 160, 162,
+  163, 165, 166, 168, 170, 171, 173, 175, 176, 178, 180, 181,
+  183, 185, 186, 188, 190, 192, 193, 195, 197, 199, 200, 202,
+  204, 206, 207, 209, 211, 213, 215, 217, 218, 220, 222, 224,
+  226, 228, 230, 232, 233, 235, 237, 239, 241, 243, 245, 247,
+  249, 251, 253, 255
+};
+
+static const uint8_t MODIFIED_SQUARE[DIMMER_CURVE_TABLE_SIZE] = {
+  0, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+  26, 27, 27, 27, 27, 27, 27, 27, 27, 27, 28, 28,
+  28, 28, 28, 28, 29, 29, 29, 29, 29, 30, 30, 30,
+  30, 31, 31, 31, 31, 32, 32, 32, 33, 33, 33, 34,
+  34, 34, 35, 35, 35, 36, 36, 36, 37, 37, 38, 38,
+  38, 39, 39, 40, 40, 41, 41, 41, 42, 42, 43, 43,
+  44, 44, 45, 45, 46, 47, 47, 48, 48, 49, 49, 50,
+  50, 51, 52, 52, 53, 53, 54, 55, 55, 56, 57, 57,
+  58, 59, 59, 60, 61, 61, 62, 63, 64, 64, 65, 66,
+  67, 67, 68, 69, 70, 71, 71, 72, 73, 74, 75, 75,
+  76, 77, 78, 79, 80, 81, 81, 82, 83, 84, 85, 86,
+  87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98,
+  99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
+  111, 112, 113, 115, 116, 117, 118, 119, 120, 121, 123, 124,
+  125, 126, 127, 129, 130, 131, 132, 133, 135, 136, 137, 138,
+  140, 141, 142, 144, 145, 146, 147, 149, 150, 151, 153, 154,
+  155, 157, 158, 160, 161, 162, 164, 165, 167, 168, 169, 171,
+  172, 174, 175, 177, 178, 180, 181, 183, 184, 186, 187, 189,
+  190, 192, 193, 195, 196, 198, 199, 201, 203, 204, 206, 207,
+  209, 211, 212, 214, 215, 217, 219, 220, 222, 224, 225, 227,
+  229, 230, 232, 234, 236, 237, 239, 241, 243, 244, 246, 248,
+  250, 251, 253, 255
+};
+
+static const uint8_t* const CURVES[DIMMER_CURVE_COUNT] = {
+  LINEAR,
+  MODIFIED_LINEAR,
+  SQUARE,
+  MODIFIED_SQUARE
+};
+
+/*
+ * @brief Round a 16-bit level to 8 bits.
+ */
+static uint8_t ToOutputLevel(uint16_t level) {
+  return level >= 0xff80 ? 0xff : (level + 0x80) >> 8;
+}
+
+const uint8_t *DimmerCurve_GetTable(DimmerCurveType type) {
+  if (type < DIMMER_CURVE_LINEAR || type > DIMMER_CURVE_COUNT) {
+    return NULL;
+  }
+  return CURVES[type - 1];
+}
+
+void DimmerCurve_Init(DimmerCurve *curve, DimmerCurveType type,
+                      uint16_t min_level, uint16_t max_level,
+                      bool on_below_min) {
+  curve->table = DimmerCurve_GetTable(type);
+  if (curve->table == NULL) {
+    curve->table = LINEAR;
+  }
+  curve->min_level = ToOutputLevel(min_level);
+  curve->max_level = ToOutputLevel(max_level);
+  curve->on_below_min = on_below_min;
+}
+
+uint8_t DimmerCurve_Apply(const DimmerCurve *curve, uint8_t level) {
+  if (curve == NULL) {
+    return level;
+  }
+
+  uint8_t output = curve->table[level];
+  if (output > curve->max_level) {
+    output = curve->max_level;
+  }
+  if (output < curve->min_level) {
+    output = curve->on_below_min ? curve->min_level : 0u;
+  }
+  return output;
+}
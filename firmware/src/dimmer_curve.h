@@ -0,0 +1,126 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dimmer_curve.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup dimmer_curve Dimmer Curves
+ * @brief Map DMX levels to output levels.
+ *
+ * The curves are precomputed 256 entry tables, stored in flash. A DimmerCurve
+ * combines a curve with the minimum & maximum level clamps of an output. It
+ * can be applied per level with DimmerCurve_Apply(), or folded into an
+ * output's own lookup table.
+ *
+ * @addtogroup dimmer_curve
+ * @{
+ * @file dimmer_curve.h
+ * @brief Map DMX levels to output levels.
+ */
+
+#ifndef FIRMWARE_SRC_DIMMER_CURVE_H_
+#define FIRMWARE_SRC_DIMMER_CURVE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of entries in a curve table.
+ */
+#define DIMMER_CURVE_TABLE_SIZE 256u
+
+/**
+ * @brief The dimmer curves.
+ *
+ * These match the values used by PID_CURVE.
+ */
+typedef enum {
+  DIMMER_CURVE_LINEAR = 1,  //!< Output = Input.
+  /**
+   * @brief Linear, with level 1 starting at the pre-heat level.
+   */
+  DIMMER_CURVE_MODIFIED_LINEAR = 2,
+  DIMMER_CURVE_SQUARE = 3,  //!< Square law.
+  /**
+   * @brief Square law, with level 1 starting at the pre-heat level.
+   */
+  DIMMER_CURVE_MODIFIED_SQUARE = 4,
+} DimmerCurveType;
+
+/**
+ * @brief The number of curves.
+ */
+#define DIMMER_CURVE_COUNT 4u
+
+/**
+ * @brief A curve & the level limits for an output.
+ */
+typedef struct {
+  const uint8_t *table;  //!< The curve table, from DimmerCurve_GetTable().
+  uint8_t min_level;  //!< The minimum output level.
+  uint8_t max_level;  //!< The maximum output level.
+  /**
+   * @brief If true, levels below the minimum output min_level, otherwise they
+   * output 0.
+   */
+  bool on_below_min;
+} DimmerCurve;
+
+/**
+ * @brief Get the table for a curve.
+ * @param type The curve.
+ * @returns The curve table, or NULL if the curve type is invalid.
+ */
+const uint8_t *DimmerCurve_GetTable(DimmerCurveType type);
+
+/**
+ * @brief Initialize a DimmerCurve.
+ * @param curve The DimmerCurve to initialize.
+ * @param type The curve type, invalid types are treated as linear.
+ * @param min_level The 16-bit minimum level.
+ * @param max_level The 16-bit maximum level.
+ * @param on_below_min The behavior for levels below the minimum.
+ *
+ * The levels use the 16-bit range of PID_MINIMUM_LEVEL & PID_MAXIMUM_LEVEL,
+ * they're rounded to 8 bits.
+ */
+void DimmerCurve_Init(DimmerCurve *curve, DimmerCurveType type,
+                      uint16_t min_level, uint16_t max_level,
+                      bool on_below_min);
+
+/**
+ * @brief Apply a curve and the level limits to a DMX level.
+ * @param curve The DimmerCurve to apply, or NULL for a linear curve with no
+ *   limits.
+ * @param level The DMX level.
+ * @returns The output level.
+ */
+uint8_t DimmerCurve_Apply(const DimmerCurve *curve, uint8_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_DIMMER_CURVE_H_
@@ -19,14 +19,22 @@
 #include "dimmer_model.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "coarse_timer.h"
 #include "constants.h"
+#include "dimmer_curve.h"
+#include "dmx_merge.h"
+#include "fade_engine.h"
 #include "macros.h"
 #include "rdm_frame.h"
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "receiver_counters.h"
+#include "responder.h"
+#include "spi_rgb.h"
+#include "transceiver.h"
 #include "utils.h"
 
 #include <syslog.h>
@@ -34,10 +42,12 @@
 #include <system_config.h>
 
 // Various constants
-enum { NUMBER_OF_SUB_DEVICES = 4 };
+enum { NUMBER_OF_SUB_DEVICES = 128 };
+// Sub-device 2 is skipped, so the last index is one more than the count.
+enum { MAX_SUB_DEVICE_INDEX = NUMBER_OF_SUB_DEVICES + 1 };
 enum { NUMBER_OF_SCENES = 3 };
 enum { NUMBER_OF_LOCK_STATES = 3 };
-enum { NUMBER_OF_CURVES = 4 };
+enum { NUMBER_OF_CURVES = DIMMER_CURVE_COUNT };
 enum { NUMBER_OF_OUTPUT_RESPONSE_TIMES = 2 };
 enum { NUMBER_OF_MODULATION_FREQUENCIES = 4 };
 enum { NUMBER_OF_SELF_TESTS = 2 };
@@ -51,6 +61,9 @@ static const char PERSONALITY_DESCRIPTION[] = "Dimmer";
 static const uint8_t STATUS_TYPE_MASK = 0xf;
 static const uint16_t INITIAL_START_ADDRESSS = 1u;
 static const uint32_t STATUS_MESSAGE_TRIGGER_INTERVAL = 300000;  // 30s
+// Fade, delay & hold times are in 10ths of a second.
+static const uint16_t INFINITE_TIME = 0xffff;
+static const uint32_t TIME_UNIT_INTERVAL = 1000u;  // 100ms
 
 static const char LOCK_STATE_DESCRIPTION_UNLOCKED[] = "Unlocked";
 static const char LOCK_STATE_DESCRIPTION_SUBDEVICES_LOCKED[] =
@@ -76,6 +89,17 @@ static const char MODULATION_FREQUENCY_DESCRIPTION4[] = "2kHz";
 
 static const char STS_OLP_TESTING_DESCRIPTION[] = "Counter cycle %d.%d";
 
+/*
+ * @brief The source of the scene being played back.
+ */
+typedef enum {
+  SCENE_SOURCE_NONE,  //!< No scene is playing
+  SCENE_SOURCE_PLAYBACK,  //!< Set with PRESET_PLAYBACK
+  SCENE_SOURCE_STARTUP,  //!< DMX_STARTUP_MODE, no DMX since activation
+  SCENE_SOURCE_FAIL,  //!< DMX_FAIL_MODE, DMX was lost
+  SCENE_SOURCE_RELEASED,  //!< The startup or fail hold time expired.
+} SceneSource;
+
 enum {
   LOCK_STATE_UNLOCKED = 0x0000,
   LOCK_STATE_SUBDEVICES_LOCKED = 0x0001,
@@ -92,6 +116,7 @@ typedef struct {
   uint16_t down_fade_time;
   uint16_t wait_time;
   uint8_t programmed_state;
+  uint8_t levels[NUMBER_OF_SUB_DEVICES];  //!< Indexed by g_subdevices
 } Scene;
 
 typedef struct {
@@ -119,6 +144,19 @@ typedef struct {
   CoarseTimer_Value self_test_timer;
   StatusMessage status_message;
 
+  /*
+   * @brief The time the last DMX frame was seen, or the time we were
+   *   activated if there hasn't been DMX.
+   */
+  CoarseTimer_Value dmx_timer;
+  CoarseTimer_Value scene_timer;  //!< The time the current scene started.
+  CoarseTimer_Value merge_timer;  //!< The time of the last merge.
+  uint32_t dmx_frames;  //!< The DMX frame count at the last check.
+  SceneSource scene_source;
+  bool seen_dmx;  //!< True if DMX has been received since activation.
+  bool dmx_lost;  //!< True if the fail scene has been triggered.
+  bool merge_pending;  //!< True if the merge should run on the next Tasks.
+
   uint16_t playback_mode;
   uint16_t startup_scene;
   uint16_t startup_delay;
@@ -153,6 +191,7 @@ typedef struct {
   uint8_t output_response_time;
   uint8_t modulation_frequency;
   RDMStatusType sd_report_threshold;
+  DimmerCurve output_curve;  //!< Built from the curve & level limits.
 } DimmerSubDevice;
 
 typedef struct {
@@ -162,6 +201,12 @@ typedef struct {
 
 static DimmerSubDevice g_subdevices[NUMBER_OF_SUB_DEVICES];
 
+/*
+ * @brief Maps a sub-device index to the sub-device, or NULL if the index isn't
+ *   in use.
+ */
+static DimmerSubDevice *g_subdevice_map[MAX_SUB_DEVICE_INDEX + 1];
+
 static const char* LOCK_STATES[NUMBER_OF_LOCK_STATES] = {
   LOCK_STATE_DESCRIPTION_UNLOCKED,
   LOCK_STATE_DESCRIPTION_SUBDEVICES_LOCKED,
@@ -180,6 +225,16 @@ static const char* OUTPUT_RESPONSE_TIMES[NUMBER_OF_OUTPUT_RESPONSE_TIMES] = {
   OUTPUT_RESPONSE_DESCRIPTION2,
 };
 
+/*
+ * @brief The minimum fade time for each output response time, in 10ths of a
+ *   second.
+ */
+static const uint16_t OUTPUT_RESPONSE_FADE_TIMES[
+    NUMBER_OF_OUTPUT_RESPONSE_TIMES] = {
+  0u,  // Fast
+  10u,  // Slow
+};
+
 static const ModulationFrequency
 MODULATION_FREQUENCY[NUMBER_OF_MODULATION_FREQUENCIES] = {
   {
@@ -220,9 +275,239 @@ static StatusMessages g_status_messages;
 static RootDevice g_root_device;
 static DimmerSubDevice *g_active_device = NULL;
 
+// The fade engine storage, one channel per sub-device.
+static int32_t g_fade_levels[NUMBER_OF_SUB_DEVICES];
+static int32_t g_fade_steps[NUMBER_OF_SUB_DEVICES];
+static uint8_t g_fade_targets[NUMBER_OF_SUB_DEVICES];
+
+// The merge inputs & buffers, one level per sub-device.
+static uint8_t g_dmx_levels[NUMBER_OF_SUB_DEVICES];
+static uint8_t g_preset_levels[NUMBER_OF_SUB_DEVICES];
+static uint8_t g_output_levels[NUMBER_OF_SUB_DEVICES];
+static uint8_t g_last_dmx_levels[NUMBER_OF_SUB_DEVICES];
+static uint8_t g_last_preset_levels[NUMBER_OF_SUB_DEVICES];
+
+static const DMXMergeBuffers MERGE_BUFFERS = {
+  .output = g_output_levels,
+  .last_dmx = g_last_dmx_levels,
+  .last_preset = g_last_preset_levels,
+  .length = NUMBER_OF_SUB_DEVICES
+};
+
 // Helper functions
 // ----------------------------------------------------------------------------
 
+/*
+ * @brief Rebuild a sub-device's output curve from its curve & level limits.
+ */
+static void UpdateOutputCurve(DimmerSubDevice *subdevice) {
+  // The minimum depends on the direction of the level change, which we don't
+  // know here, so use the lower one.
+  const uint16_t min_level = subdevice->min_level_increasing <
+      subdevice->min_level_decreasing ? subdevice->min_level_increasing :
+      subdevice->min_level_decreasing;
+  DimmerCurve_Init(&subdevice->output_curve, subdevice->curve, min_level,
+                   subdevice->max_level, subdevice->on_below_min);
+}
+
+/*
+ * @brief Called after a SET changes the curve or levels of the active device.
+ */
+static void ActiveDeviceOutputChanged() {
+  UpdateOutputCurve(g_active_device);
+  g_root_device.merge_pending = true;
+}
+
+/*
+ * @brief Check if a time in 10ths of a second has elapsed.
+ * @param start_time The start of the period.
+ * @param time The period, in 10ths of a second. INFINITE_TIME never elapses.
+ */
+static bool HasTimeElapsed(CoarseTimer_Value start_time, uint16_t time) {
+  return time != INFINITE_TIME &&
+         CoarseTimer_HasElapsed(start_time, time * TIME_UNIT_INTERVAL);
+}
+
+/*
+ * @brief Fade the sub-devices to a scene.
+ * @param source The reason for playing the scene.
+ * @param scene_index The scene to play, or PRESET_PLAYBACK_ALL to set all
+ *   sub-devices to level.
+ * @param level The level to play the scene at.
+ *
+ * The up & down fade times of the scene are used, limited by the output
+ * response time of each sub-device.
+ */
+static void PlayScene(SceneSource source, uint16_t scene_index,
+                      uint8_t level) {
+  const Scene *scene = scene_index == PRESET_PLAYBACK_ALL ? NULL :
+      &g_root_device.scenes[scene_index - 1u];
+
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    uint8_t target = level;
+    uint16_t fade_time = 0u;
+    if (scene) {
+      target = (scene->levels[i] * level) / UINT8_MAX;
+      fade_time = target >= FadeEngine_GetLevel(i) ? scene->up_fade_time :
+          scene->down_fade_time;
+    }
+    const uint16_t min_fade_time =
+        OUTPUT_RESPONSE_FADE_TIMES[g_subdevices[i].output_response_time - 1u];
+    FadeEngine_FadeTo(i, target,
+                      fade_time < min_fade_time ? min_fade_time : fade_time);
+  }
+  g_root_device.scene_source = source;
+  g_root_device.scene_timer = CoarseTimer_GetTime();
+  g_root_device.merge_pending = true;
+}
+
+/*
+ * @brief Fade out at the end of a startup or fail scene's hold time.
+ */
+static void ReleaseScene(uint16_t scene_index) {
+  const uint16_t fade_time = scene_index == PRESET_PLAYBACK_ALL ? 0u :
+      g_root_device.scenes[scene_index - 1u].down_fade_time;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    FadeEngine_FadeTo(i, 0u, fade_time);
+  }
+  g_root_device.scene_source = SCENE_SOURCE_RELEASED;
+}
+
+/*
+ * @brief Run the startup & fail scenes.
+ *
+ * The startup scene plays if no DMX has been received startup_delay after
+ * activation. The fail scene plays if DMX stops for fail_loss_of_signal_delay.
+ * Both are released when DMX arrives or the hold time expires. Preset playback
+ * takes priority over both.
+ */
+static void SceneTasks() {
+  const uint32_t dmx_frames = ReceiverCounters_DMXFrames();
+  if (dmx_frames != g_root_device.dmx_frames) {
+    g_root_device.dmx_frames = dmx_frames;
+    g_root_device.dmx_timer = CoarseTimer_GetTime();
+    g_root_device.seen_dmx = true;
+    g_root_device.dmx_lost = false;
+    if (g_root_device.scene_source == SCENE_SOURCE_STARTUP ||
+        g_root_device.scene_source == SCENE_SOURCE_FAIL ||
+        g_root_device.scene_source == SCENE_SOURCE_RELEASED) {
+      g_root_device.scene_source = SCENE_SOURCE_NONE;
+      g_root_device.merge_pending = true;
+    }
+    return;
+  }
+
+  switch (g_root_device.scene_source) {
+    case SCENE_SOURCE_NONE:
+      if (!g_root_device.seen_dmx) {
+        if (g_root_device.startup_scene != PRESET_PLAYBACK_OFF &&
+            HasTimeElapsed(g_root_device.dmx_timer,
+                           g_root_device.startup_delay)) {
+          // Only play the startup scene once.
+          g_root_device.seen_dmx = true;
+          PlayScene(SCENE_SOURCE_STARTUP, g_root_device.startup_scene,
+                    g_root_device.startup_level);
+        }
+      } else if (!g_root_device.dmx_lost &&
+                 g_root_device.fail_scene != PRESET_PLAYBACK_OFF &&
+                 HasTimeElapsed(g_root_device.dmx_timer,
+                                g_root_device.fail_loss_of_signal_delay)) {
+        g_root_device.dmx_lost = true;
+        PlayScene(SCENE_SOURCE_FAIL, g_root_device.fail_scene,
+                  g_root_device.fail_level);
+      }
+      break;
+    case SCENE_SOURCE_STARTUP:
+      if (HasTimeElapsed(g_root_device.scene_timer,
+                         g_root_device.startup_hold)) {
+        ReleaseScene(g_root_device.startup_scene);
+      }
+      break;
+    case SCENE_SOURCE_FAIL:
+      if (HasTimeElapsed(g_root_device.scene_timer,
+                         g_root_device.fail_hold_time)) {
+        ReleaseScene(g_root_device.fail_scene);
+      }
+      break;
+    case SCENE_SOURCE_PLAYBACK:
+    case SCENE_SOURCE_RELEASED:
+      break;
+  }
+}
+
+/*
+ * @brief Get the merge rule for the current scene & PRESET_MERGEMODE.
+ */
+static DMXMergeMode CurrentMergeMode() {
+  switch (g_root_device.scene_source) {
+    case SCENE_SOURCE_NONE:
+      return DMX_MERGE_DMX_ONLY;
+    case SCENE_SOURCE_PLAYBACK:
+      break;
+    default:
+      // Startup & fail scenes only play without DMX.
+      return DMX_MERGE_PRESET_ONLY;
+  }
+
+  switch (g_root_device.merge_mode) {
+    case MERGE_MODE_HTP:
+      return DMX_MERGE_HTP;
+    case MERGE_MODE_LTP:
+      return DMX_MERGE_LTP;
+    case MERGE_MODE_DMX_ONLY:
+      return DMX_MERGE_DMX_ONLY;
+    default:
+      // The default is for the preset to override DMX.
+      return DMX_MERGE_PRESET_ONLY;
+  }
+}
+
+/*
+ * @brief Merge the DMX & preset levels of the sub-devices and send the result
+ *   to the SPI output.
+ *
+ * This runs once per fade tick, or sooner if the scene or merge mode changed.
+ * The DMX levels come from the latest complete frame, so a merge never sees a
+ * frame that is only partly received.
+ */
+static void MergeTasks() {
+  if (!(g_root_device.merge_pending ||
+        CoarseTimer_HasElapsed(g_root_device.merge_timer,
+                               FADE_ENGINE_TICK_INTERVAL))) {
+    return;
+  }
+  g_root_device.merge_timer = CoarseTimer_GetTime();
+  g_root_device.merge_pending = false;
+
+  TransceiverDMXFrame frame;
+  if (!Transceiver_GetLatestDMXFrame(&frame)) {
+    frame.data = NULL;
+    frame.size = 0u;
+  }
+
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    const uint16_t slot = g_subdevices[i].responder.dmx_start_address - 1u;
+    g_dmx_levels[i] = slot < frame.size ? frame.data[slot] : 0u;
+    g_preset_levels[i] = FadeEngine_GetLevel(i);
+  }
+  DMXMerge_Merge(CurrentMergeMode(), g_dmx_levels, g_preset_levels,
+                 &MERGE_BUFFERS);
+
+  // Sub-device n drives SPI slot n, through its own curve.
+  SPIRGB_BeginUpdate();
+  for (i = 0u; i < NUMBER_OF_SUB_DEVICES; i++) {
+    const uint8_t level = DimmerCurve_Apply(&g_subdevices[i].output_curve,
+                                            g_output_levels[i]);
+    if (SPIRGB_SetSlot(i, level)) {
+      break;
+    }
+  }
+  SPIRGB_CompleteUpdate();
+}
+
 /*
  * @brief Set a block address for all the sub devices.
  * @param start_address the new start address
@@ -440,6 +725,10 @@ int DimmerModel_CapturePreset(const RDMHeader *header,
   scene->down_fade_time = down_fade_time;
   scene->wait_time = wait_time;
   scene->programmed_state = PRESET_PROGRAMMED;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    scene->levels[i] = g_output_levels[i];
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -466,6 +755,12 @@ int DimmerModel_SetPresetPlayback(const RDMHeader *header,
   g_root_device.playback_mode = playback_mode;
   g_root_device.playback_level = param_data[2];
 
+  if (playback_mode != PRESET_PLAYBACK_OFF) {
+    PlayScene(SCENE_SOURCE_PLAYBACK, playback_mode, param_data[2]);
+  } else if (g_root_device.scene_source == SCENE_SOURCE_PLAYBACK) {
+    // The levels are held until DMX or another scene replaces them.
+    g_root_device.scene_source = SCENE_SOURCE_NONE;
+  }
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -733,6 +1028,7 @@ int DimmerModel_SetPresetStatus(const RDMHeader *header,
     scene->down_fade_time = 0u;
     scene->wait_time = 0u;
     scene->programmed_state = PRESET_NOT_PROGRAMMED;
+    memset(scene->levels, 0, NUMBER_OF_SUB_DEVICES);
   } else {
     // don't change the state here, if we haven't been programmed, just update
     // the timing params
@@ -760,6 +1056,7 @@ int DimmerModel_SetPresetMergeMode(const RDMHeader *header,
   }
 
   g_root_device.merge_mode = merge_mode;
+  g_root_device.merge_pending = true;
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -865,6 +1162,7 @@ int DimmerModel_SetMinimumLevel(const RDMHeader *header,
   g_active_device->min_level_increasing = min_level_increasing;
   g_active_device->min_level_decreasing = min_level_decreasing;
   g_active_device->on_below_min = on_below_min;
+  ActiveDeviceOutputChanged();
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -875,8 +1173,10 @@ int DimmerModel_GetMaximumLevel(const RDMHeader *header,
 
 int DimmerModel_SetMaximumLevel(const RDMHeader *header,
                                 const uint8_t *param_data) {
-  return RDMResponder_GenericSetUInt16(header, param_data,
-                                       &g_active_device->max_level);
+  int response = RDMResponder_GenericSetUInt16(header, param_data,
+                                               &g_active_device->max_level);
+  ActiveDeviceOutputChanged();
+  return response;
 }
 
 int DimmerModel_GetCurve(const RDMHeader *header,
@@ -904,6 +1204,7 @@ int DimmerModel_SetCurve(const RDMHeader *header,
   }
 
   g_active_device->curve = curve;
+  ActiveDeviceOutputChanged();
   return RDMResponder_BuildSetAck(header);
 }
 
@@ -1012,6 +1313,9 @@ void DimmerModel_Initialize() {
     g_root_device.scenes[i].wait_time = 0u;
     g_root_device.scenes[i].programmed_state = i == 0u ?
         PRESET_PROGRAMMED_READ_ONLY : PRESET_NOT_PROGRAMMED;
+    // The read only scene is full on.
+    memset(g_root_device.scenes[i].levels, i == 0u ? UINT8_MAX : 0u,
+           NUMBER_OF_SUB_DEVICES);
   }
 
   g_root_device.playback_mode = PRESET_PLAYBACK_OFF;
@@ -1029,11 +1333,23 @@ void DimmerModel_Initialize() {
   g_root_device.merge_mode = MERGE_MODE_DEFAULT;
   g_root_device.power_on_self_test = false;
   g_root_device.running_self_test = SELF_TEST_OFF;
+  g_root_device.scene_source = SCENE_SOURCE_NONE;
+
+  FadeEngineSettings fade_settings = {
+    .levels = g_fade_levels,
+    .steps = g_fade_steps,
+    .targets = g_fade_targets,
+    .channel_count = NUMBER_OF_SUB_DEVICES
+  };
+  FadeEngine_Initialize(&fade_settings);
+  DMXMerge_Reset(&MERGE_BUFFERS);
 
   // Initialize the subdevices.
   uint8_t parent_uid[UID_LENGTH];
   RDMResponder_GetUID(parent_uid);
 
+  memset(g_subdevice_map, 0, sizeof(g_subdevice_map));
+
   uint16_t sub_device_index = 1u;
   for (i = 0u; i < NUMBER_OF_SUB_DEVICES; i++) {
     if (i == 1) {
@@ -1046,20 +1362,22 @@ void DimmerModel_Initialize() {
     subdevice->responder.def = &SUBDEVICE_RESPONDER_DEFINITION;
 
     subdevice->index = sub_device_index++;
+    g_subdevice_map[subdevice->index] = subdevice;
     subdevice->min_level_increasing = 0u;
     subdevice->min_level_decreasing = 0u;
-    subdevice->max_level = 0u;
+    subdevice->max_level = 0xfffe;
     subdevice->on_below_min = 0u;
     subdevice->identify_mode = IDENTIFY_MODE_QUIET;
     subdevice->burn_in = 0u;
-    subdevice->curve = 1u;
+    subdevice->curve = DIMMER_CURVE_LINEAR;
     subdevice->output_response_time = 1u;
     subdevice->modulation_frequency = 1u;
     subdevice->sd_report_threshold = STATUS_ADVISORY;
     subdevice->status_message.is_active = false;
+    UpdateOutputCurve(subdevice);
 
     RDMResponder_SwitchResponder(&subdevice->responder);
-    memcpy(g_responder->uid, parent_uid, UID_LENGTH);
+    RDMResponder_SetUID(parent_uid);
     RDMResponder_ResetToFactoryDefaults();
     g_responder->is_subdevice = true;
     g_responder->sub_device_count = NUMBER_OF_SUB_DEVICES;
@@ -1084,9 +1402,29 @@ static void DimmerModel_Activate() {
   RDMResponder_ResetToFactoryDefaults();
   g_responder->sub_device_count = NUMBER_OF_SUB_DEVICES;
   g_root_device.status_message_timer = CoarseTimer_GetTime();
+  g_root_device.dmx_timer = CoarseTimer_GetTime();
+  g_root_device.dmx_frames = ReceiverCounters_DMXFrames();
+  g_root_device.seen_dmx = false;
+  g_root_device.dmx_lost = false;
+  g_root_device.merge_pending = true;
+  if (g_root_device.scene_source != SCENE_SOURCE_PLAYBACK) {
+    g_root_device.scene_source = SCENE_SOURCE_NONE;
+  }
+  // The merged levels drive the SPI output, rather than the raw slots.
+  Responder_SetSPIOutput(false);
 }
 
-static void DimmerModel_Deactivate() {}
+static void DimmerModel_Deactivate() {
+  Responder_SetSPIOutput(true);
+}
+
+/*
+ * @brief Make a sub-device the active one, for RDMResponder_DispatchSetToAll().
+ */
+static void SelectSubDevice(unsigned int index) {
+  g_active_device = &g_subdevices[index];
+  RDMResponder_SwitchResponder(&g_subdevices[index].responder);
+}
 
 static int DimmerModel_HandleRequest(const RDMHeader *header,
                                      const uint8_t *param_data) {
@@ -1126,23 +1464,23 @@ static int DimmerModel_HandleRequest(const RDMHeader *header,
     }
   }
 
-  unsigned int i = 0u;
-  bool handled = false;
-  int response_size = RDM_RESPONDER_NO_RESPONSE;
-  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
-    if (sub_device == g_subdevices[i].index || sub_device == SUBDEVICE_ALL) {
-      if (!locked) {
-        g_active_device = &g_subdevices[i];
-        RDMResponder_SwitchResponder(&g_subdevices[i].responder);
-        response_size = RDMResponder_DispatchPID(header, param_data);
-      }
-      handled = true;
+  if (sub_device == SUBDEVICE_ALL) {
+    if (locked) {
+      return RDMResponder_BuildNack(header, NR_WRITE_PROTECT);
     }
-  }
 
-  RDMResponder_RestoreResponder();
+    // It's not really clear how to handle the response to an all-subdevices
+    // call, in this case we return the last one.
+    int response_size = RDMResponder_DispatchSetToAll(
+        header, param_data, &SUBDEVICE_RESPONDER_DEFINITION, SelectSubDevice,
+        NUMBER_OF_SUB_DEVICES);
+    RDMResponder_RestoreResponder();
+    return response_size;
+  }
 
-  if (!handled) {
+  DimmerSubDevice *subdevice = sub_device <= MAX_SUB_DEVICE_INDEX ?
+      g_subdevice_map[sub_device] : NULL;
+  if (!subdevice) {
     return RDMResponder_BuildNack(header, NR_SUB_DEVICE_OUT_OF_RANGE);
   }
 
@@ -1150,8 +1488,10 @@ static int DimmerModel_HandleRequest(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_WRITE_PROTECT);
   }
 
-  // If it was an all-subdevices call, it's not really clear how to handle the
-  // response, in this case we return the last one.
+  g_active_device = subdevice;
+  RDMResponder_SwitchResponder(&subdevice->responder);
+  int response_size = RDMResponder_DispatchPID(header, param_data);
+  RDMResponder_RestoreResponder();
   return response_size;
 }
 
@@ -1164,6 +1504,10 @@ static void DimmerModel_Tasks() {
   static uint8_t cycle = 0u;
   static uint16_t complete_cycles = 0u;
 
+  SceneTasks();
+  FadeEngine_Tasks();
+  MergeTasks();
+
   if (g_root_device.running_self_test &&
       CoarseTimer_HasElapsed(
           g_root_device.self_test_timer,
@@ -1225,6 +1569,12 @@ static void DimmerModel_Tasks() {
   }
 }
 
+const ResponderDefinition *const DIMMER_MODEL_DEFINITIONS[] = {
+  &ROOT_RESPONDER_DEFINITION,
+  &SUBDEVICE_RESPONDER_DEFINITION,
+  NULL
+};
+
 const ModelEntry DIMMER_MODEL_ENTRY = {
   .model_id = DIMMER_MODEL_ID,
   .activate_fn = DimmerModel_Activate,
@@ -1255,16 +1605,6 @@ static const PIDDescriptor ROOT_PID_DESCRIPTORS[] = {
     RDMResponder_SetDeviceLabel},
   {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
-    RDMResponder_SetIdentifyDevice},
-  {PID_PERFORM_SELFTEST, DimmerModel_GetSelfTest, 0u,
-    DimmerModel_PerformSelfTest},
-  {PID_SELF_TEST_DESCRIPTION, DimmerModel_GetSelfTestDescription, 1u,
-    (PIDCommandHandler) NULL},
-  {PID_CAPTURE_PRESET, (PIDCommandHandler) NULL, 0,
-    DimmerModel_CapturePreset},
-  {PID_PRESET_PLAYBACK, DimmerModel_GetPresetPlayback, 0,
-    DimmerModel_SetPresetPlayback},
   {PID_DMX_BLOCK_ADDRESS, DimmerModel_GetDMXBlockAddress, 0u,
     DimmerModel_SetDMXBlockAddress},
   {PID_DMX_FAIL_MODE, DimmerModel_GetDMXFailMode, 0u,
@@ -1275,6 +1615,16 @@ static const PIDDescriptor ROOT_PID_DESCRIPTORS[] = {
   {PID_LOCK_STATE, DimmerModel_GetLockState, 0u, DimmerModel_SetLockState},
   {PID_LOCK_STATE_DESCRIPTION, DimmerModel_GetLockStateDescription, 1u,
     (PIDCommandHandler) NULL},
+  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
+    RDMResponder_SetIdentifyDevice},
+  {PID_PERFORM_SELFTEST, DimmerModel_GetSelfTest, 0u,
+    DimmerModel_PerformSelfTest},
+  {PID_SELF_TEST_DESCRIPTION, DimmerModel_GetSelfTestDescription, 1u,
+    (PIDCommandHandler) NULL},
+  {PID_CAPTURE_PRESET, (PIDCommandHandler) NULL, 0,
+    DimmerModel_CapturePreset},
+  {PID_PRESET_PLAYBACK, DimmerModel_GetPresetPlayback, 0,
+    DimmerModel_SetPresetPlayback},
   {PID_PRESET_INFO, DimmerModel_GetPresetInfo, 0u,
     (PIDCommandHandler) NULL},
   {PID_PRESET_STATUS, DimmerModel_GetPresetStatus, 2u,
@@ -1326,15 +1676,10 @@ static const PIDDescriptor SUBDEVICE_PID_DESCRIPTORS[] = {
     (PIDCommandHandler) NULL},
   {PID_MANUFACTURER_LABEL, RDMResponder_GetManufacturerLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_DMX_START_ADDRESS, RDMResponder_GetDMXStartAddress, 0u,
-    RDMResponder_SetDMXStartAddress},
   {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
-    RDMResponder_SetIdentifyDevice},
-  {PID_BURN_IN, DimmerModel_GetBurnIn, 0u, DimmerModel_SetBurnIn},
-  {PID_IDENTIFY_MODE, DimmerModel_GetIdentifyMode, 0u,
-    DimmerModel_SetIdentifyMode},
+  {PID_DMX_START_ADDRESS, RDMResponder_GetDMXStartAddress, 0u,
+    RDMResponder_SetDMXStartAddress},
   {PID_DIMMER_INFO, DimmerModel_GetDimmerInfo, 0u,
     (PIDCommandHandler) NULL},
   {PID_MINIMUM_LEVEL, DimmerModel_GetMinimumLevel, 0u,
@@ -1353,6 +1698,11 @@ static const PIDDescriptor SUBDEVICE_PID_DESCRIPTORS[] = {
   {PID_MODULATION_FREQUENCY_DESCRIPTION,
     DimmerModel_GetModulationFrequencyDescription, 1u,
     (PIDCommandHandler) NULL},
+  {PID_BURN_IN, DimmerModel_GetBurnIn, 0u, DimmerModel_SetBurnIn},
+  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
+    RDMResponder_SetIdentifyDevice},
+  {PID_IDENTIFY_MODE, DimmerModel_GetIdentifyMode, 0u,
+    DimmerModel_SetIdentifyMode}
 };
 
 static const ProductDetailIds SUBDEVICE_PRODUCT_DETAIL_ID_LIST = {
@@ -0,0 +1,134 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dmx_merge.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "dmx_merge.h"
+
+#include <string.h>
+
+typedef uint32_t Word;
+
+enum { WORD_SIZE = sizeof(Word) };
+
+static const Word HIGH_BITS = 0x80808080u;
+static const Word LOW_BITS = 0x7f7f7f7fu;
+
+/*
+ * @brief Load a word, the buffers don't need to be aligned.
+ */
+static inline Word LoadWord(const uint8_t *ptr) {
+  Word word;
+  memcpy(&word, ptr, WORD_SIZE);
+  return word;
+}
+
+static inline void StoreWord(uint8_t *ptr, Word word) {
+  memcpy(ptr, &word, WORD_SIZE);
+}
+
+/*
+ * @brief Expand the high bit of each byte to the whole byte.
+ */
+static inline Word ByteMask(Word high_bits) {
+  return (high_bits - (high_bits >> 7)) | high_bits;
+}
+
+/*
+ * @brief The per-byte maximum of two words.
+ */
+static inline Word WordMax(Word a, Word b) {
+  // The high bit of each byte is set if the low 7 bits of a are >= those of b.
+  // Setting the high bit of a first means there is no borrow between bytes.
+  const Word low_ge = ((a & LOW_BITS) | HIGH_BITS) - (b & LOW_BITS);
+  const Word ge = ((a & ~b) | (~(a ^ b) & low_ge)) & HIGH_BITS;
+  const Word mask = ByteMask(ge);
+  return (a & mask) | (b & ~mask);
+}
+
+/*
+ * @brief A mask with all bits set in each non-zero byte.
+ */
+static inline Word NonZeroMask(Word word) {
+  return ByteMask((((word & LOW_BITS) + LOW_BITS) | word) & HIGH_BITS);
+}
+
+static void MergeHTP(const uint8_t *dmx, const uint8_t *preset,
+                     uint8_t *output, uint16_t length) {
+  uint16_t i = 0u;
+  for (; i + WORD_SIZE <= length; i += WORD_SIZE) {
+    StoreWord(output + i, WordMax(LoadWord(dmx + i), LoadWord(preset + i)));
+  }
+  for (; i < length; i++) {
+    output[i] = dmx[i] > preset[i] ? dmx[i] : preset[i];
+  }
+}
+
+static void MergeLTP(const uint8_t *dmx, const uint8_t *preset,
+                     const DMXMergeBuffers *buffers) {
+  uint8_t *output = buffers->output;
+  const uint8_t *last_dmx = buffers->last_dmx;
+  const uint8_t *last_preset = buffers->last_preset;
+  const uint16_t length = buffers->length;
+
+  uint16_t i = 0u;
+  for (; i + WORD_SIZE <= length; i += WORD_SIZE) {
+    const Word dmx_word = LoadWord(dmx + i);
+    const Word preset_word = LoadWord(preset + i);
+    const Word dmx_changed = NonZeroMask(dmx_word ^ LoadWord(last_dmx + i));
+    const Word preset_changed =
+        NonZeroMask(preset_word ^ LoadWord(last_preset + i)) & ~dmx_changed;
+    StoreWord(output + i,
+              (dmx_word & dmx_changed) | (preset_word & preset_changed) |
+              (LoadWord(output + i) & ~(dmx_changed | preset_changed)));
+  }
+  for (; i < length; i++) {
+    if (dmx[i] != last_dmx[i]) {
+      output[i] = dmx[i];
+    } else if (preset[i] != last_preset[i]) {
+      output[i] = preset[i];
+    }
+  }
+}
+
+void DMXMerge_Reset(const DMXMergeBuffers *buffers) {
+  memset(buffers->output, 0, buffers->length);
+  memset(buffers->last_dmx, 0, buffers->length);
+  memset(buffers->last_preset, 0, buffers->length);
+}
+
+void DMXMerge_Merge(DMXMergeMode mode, const uint8_t *dmx,
+                    const uint8_t *preset, const DMXMergeBuffers *buffers) {
+  switch (mode) {
+    case DMX_MERGE_DMX_ONLY:
+      memcpy(buffers->output, dmx, buffers->length);
+      break;
+    case DMX_MERGE_PRESET_ONLY:
+      memcpy(buffers->output, preset, buffers->length);
+      break;
+    case DMX_MERGE_HTP:
+      MergeHTP(dmx, preset, buffers->output, buffers->length);
+      break;
+    case DMX_MERGE_LTP:
+      MergeLTP(dmx, preset, buffers);
+      break;
+  }
+  // Track the inputs in all modes, so switching to LTP doesn't see stale
+  // changes.
+  memcpy(buffers->last_dmx, dmx, buffers->length);
+  memcpy(buffers->last_preset, preset, buffers->length);
+}
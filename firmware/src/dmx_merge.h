@@ -0,0 +1,92 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * dmx_merge.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup dmx_merge DMX Merge
+ * @brief Merge live DMX with preset levels.
+ *
+ * The merge works on a word at a time, so a 512 slot frame takes 128
+ * iterations. HTP uses a per-byte max computed with 32-bit operations, LTP
+ * uses per-byte change masks.
+ *
+ * @addtogroup dmx_merge
+ * @{
+ * @file dmx_merge.h
+ * @brief Merge live DMX with preset levels.
+ */
+
+#ifndef FIRMWARE_SRC_DMX_MERGE_H_
+#define FIRMWARE_SRC_DMX_MERGE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The rules used to combine DMX & preset levels.
+ */
+typedef enum {
+  DMX_MERGE_DMX_ONLY,  //!< Use the DMX levels.
+  DMX_MERGE_PRESET_ONLY,  //!< Use the preset levels.
+  DMX_MERGE_HTP,  //!< Highest takes precedence.
+  DMX_MERGE_LTP,  //!< Latest takes precedence, DMX wins a tie.
+} DMXMergeMode;
+
+/**
+ * @brief The buffers used by the merge.
+ *
+ * Each buffer must have length bytes.
+ */
+typedef struct {
+  uint8_t *output;  //!< The merged levels.
+  uint8_t *last_dmx;  //!< The DMX levels from the previous merge.
+  uint8_t *last_preset;  //!< The preset levels from the previous merge.
+  uint16_t length;  //!< The number of levels.
+} DMXMergeBuffers;
+
+/**
+ * @brief Reset the merge buffers to 0.
+ * @param buffers The buffers to reset.
+ */
+void DMXMerge_Reset(const DMXMergeBuffers *buffers);
+
+/**
+ * @brief Merge the DMX and preset levels.
+ * @param mode The merge rule to use.
+ * @param dmx The DMX levels.
+ * @param preset The preset levels.
+ * @param buffers The buffers, the result is written to buffers->output.
+ *
+ * For LTP, a level that changed since the previous merge replaces the output.
+ * Levels that haven't changed keep the previous output.
+ */
+void DMXMerge_Merge(DMXMergeMode mode, const uint8_t *dmx,
+                    const uint8_t *preset, const DMXMergeBuffers *buffers);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_DMX_MERGE_H_
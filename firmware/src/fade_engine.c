@@ -0,0 +1,127 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * fade_engine.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "fade_engine.h"
+
+#include <string.h>
+
+#include "coarse_timer.h"
+
+enum { LEVEL_SHIFT = 16 };
+
+typedef struct {
+  FadeEngineSettings settings;
+  CoarseTimer_Value tick_timer;
+  bool is_fading;
+} FadeEngine;
+
+static FadeEngine g_engine;
+
+static void Tick() {
+  int32_t *levels = g_engine.settings.levels;
+  int32_t *steps = g_engine.settings.steps;
+  const uint8_t *targets = g_engine.settings.targets;
+  const uint16_t channel_count = g_engine.settings.channel_count;
+  bool is_fading = false;
+
+  uint16_t i = 0u;
+  for (; i < channel_count; i++) {
+    const int32_t step = steps[i];
+    if (step == 0) {
+      continue;
+    }
+    const int32_t target = (int32_t) targets[i] << LEVEL_SHIFT;
+    int32_t level = levels[i] + step;
+    if ((step > 0 && level >= target) || (step < 0 && level <= target)) {
+      level = target;
+      steps[i] = 0;
+    } else {
+      is_fading = true;
+    }
+    levels[i] = level;
+  }
+  g_engine.is_fading = is_fading;
+}
+
+void FadeEngine_Initialize(const FadeEngineSettings *settings) {
+  g_engine.settings = *settings;
+  g_engine.is_fading = false;
+  g_engine.tick_timer = CoarseTimer_GetTime();
+
+  const uint16_t channel_count = settings->channel_count;
+  memset(settings->levels, 0, channel_count * sizeof(int32_t));
+  memset(settings->steps, 0, channel_count * sizeof(int32_t));
+  memset(settings->targets, 0, channel_count * sizeof(uint8_t));
+}
+
+void FadeEngine_SetLevel(uint16_t channel, uint8_t level) {
+  g_engine.settings.levels[channel] = (int32_t) level << LEVEL_SHIFT;
+  g_engine.settings.steps[channel] = 0;
+  g_engine.settings.targets[channel] = level;
+}
+
+void FadeEngine_FadeTo(uint16_t channel, uint8_t level, uint16_t fade_time) {
+  if (fade_time == 0u) {
+    FadeEngine_SetLevel(channel, level);
+    return;
+  }
+
+  const int32_t delta = ((int32_t) level << LEVEL_SHIFT) -
+                        g_engine.settings.levels[channel];
+  if (delta == 0) {
+    g_engine.settings.steps[channel] = 0;
+    g_engine.settings.targets[channel] = level;
+    return;
+  }
+
+  const int32_t ticks = (int32_t) fade_time * FADE_ENGINE_TICKS_PER_FADE_UNIT;
+  int32_t step = delta / ticks;
+  if (step == 0) {
+    // Very small changes over very long times.
+    step = delta > 0 ? 1 : -1;
+  }
+  g_engine.settings.steps[channel] = step;
+  g_engine.settings.targets[channel] = level;
+
+  if (!g_engine.is_fading) {
+    g_engine.is_fading = true;
+    g_engine.tick_timer = CoarseTimer_GetTime();
+  }
+}
+
+uint8_t FadeEngine_GetLevel(uint16_t channel) {
+  return (g_engine.settings.levels[channel] + (1 << (LEVEL_SHIFT - 1))) >>
+         LEVEL_SHIFT;
+}
+
+bool FadeEngine_IsFading() {
+  return g_engine.is_fading;
+}
+
+void FadeEngine_Tasks() {
+  // Ticks are scheduled back to back, so this uses ElapsedTime rather than
+  // HasElapsed, which would add a unit to each tick.
+  if (!g_engine.is_fading ||
+      CoarseTimer_ElapsedTime(g_engine.tick_timer) <
+          FADE_ENGINE_TICK_INTERVAL) {
+    return;
+  }
+  g_engine.tick_timer += FADE_ENGINE_TICK_INTERVAL;
+  Tick();
+}
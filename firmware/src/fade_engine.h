@@ -0,0 +1,126 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * fade_engine.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup fade_engine Fade Engine
+ * @brief Fade a set of channels between levels.
+ *
+ * Each channel has a Q8.16 fixed point level, a per-tick step and a target.
+ * The levels are advanced once per FADE_ENGINE_TICK_INTERVAL by a single pass
+ * over the packed arrays, so the work per tick is bounded by the channel
+ * count, and idle channels cost a single compare. At most one tick is run per
+ * call to FadeEngine_Tasks(); if the main loop falls behind, the following
+ * calls catch up a tick at a time rather than all at once.
+ *
+ * The storage is provided by the caller, see FadeEngineSettings.
+ *
+ * @addtogroup fade_engine
+ * @{
+ * @file fade_engine.h
+ * @brief Fade a set of channels between levels.
+ */
+
+#ifndef FIRMWARE_SRC_FADE_ENGINE_H_
+#define FIRMWARE_SRC_FADE_ENGINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The interval between fade ticks, in CoarseTimer units.
+ *
+ * This is 20ms, which is a little faster than the DMX frame rate.
+ */
+#define FADE_ENGINE_TICK_INTERVAL 200u
+
+/**
+ * @brief The number of ticks per fade time unit (a 10th of a second).
+ */
+#define FADE_ENGINE_TICKS_PER_FADE_UNIT 5u
+
+/**
+ * @brief The storage for the fade engine.
+ *
+ * Each array must have channel_count entries.
+ */
+typedef struct {
+  int32_t *levels;  //!< The current levels, in Q8.16 fixed point.
+  int32_t *steps;  //!< The change per tick, 0 if the channel isn't fading.
+  uint8_t *targets;  //!< The levels being faded to.
+  uint16_t channel_count;  //!< The number of channels.
+} FadeEngineSettings;
+
+/**
+ * @brief Initialize the fade engine.
+ * @param settings The storage to use, all channels are set to 0.
+ */
+void FadeEngine_Initialize(const FadeEngineSettings *settings);
+
+/**
+ * @brief Set the level of a channel, cancelling any fade.
+ * @param channel The channel, must be less than the channel count.
+ * @param level The new level.
+ */
+void FadeEngine_SetLevel(uint16_t channel, uint8_t level);
+
+/**
+ * @brief Fade a channel to a new level.
+ * @param channel The channel, must be less than the channel count.
+ * @param level The level to fade to.
+ * @param fade_time The time to take, in 10ths of a second. 0 sets the level
+ *   immediately.
+ *
+ * This replaces any fade in progress, the new fade starts from the current
+ * level.
+ */
+void FadeEngine_FadeTo(uint16_t channel, uint8_t level, uint16_t fade_time);
+
+/**
+ * @brief Get the level of a channel.
+ * @param channel The channel, must be less than the channel count.
+ * @returns The current level, rounded to 8 bits.
+ */
+uint8_t FadeEngine_GetLevel(uint16_t channel);
+
+/**
+ * @brief Check if any channels are fading.
+ * @returns true if at least one channel hasn't reached its target.
+ */
+bool FadeEngine_IsFading();
+
+/**
+ * @brief Perform the periodic fade tasks.
+ *
+ * This should be called in the main event loop.
+ */
+void FadeEngine_Tasks();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_FADE_ENGINE_H_
@@ -80,8 +80,8 @@ static inline void Flags_SetLogOverflow() {
 /**
  * @brief Set the TX Drop flag.
  *
- * This indicates we tried to send a message to the host before the previous
- * message completed sending.
+ * This indicates we tried to send a message to the host while the transport's
+ * TX queue was full.
  */
 static inline void Flags_SetTXDrop() {
   g_flags.flags.tx_drop = true;
@@ -25,6 +25,7 @@
 #include "rdm_frame.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "spi_rgb.h"
 #include "utils.h"
 
 // Various constants
@@ -33,20 +34,11 @@ enum {SOFTWARE_VERSION = 0x00000000 };
 static const char DEVICE_MODEL_DESCRIPTION[] = "Ja Rule LED Driver";
 static const char SOFTWARE_LABEL[] = "Alpha";
 static const char DEFAULT_DEVICE_LABEL[] = "Ja Rule";
-enum { MAX_PIXEL_COUNT = 170u };
-enum { DEFAULT_PIXEL_COUNT = 2u };
+enum { MAX_PIXEL_COUNT = SPIRGB_MAX_PIXEL_COUNT };
+enum { DEFAULT_PIXEL_COUNT = SPIRGB_DEFAULT_PIXEL_COUNT };
 
 static const ResponderDefinition RESPONDER_DEFINITION;
 
-typedef enum {
-  PIXEL_TYPE_LPD8806 = 0x0001,
-  /*
-  PIXEL_TYPE_WS2801 = 0x0002,
-  PIXEL_TYPE_P9813 = 0x0003,
-  PIXEL_TYPE_APA102 = 0x0004,
-  */
-} PixelType;
-
 typedef struct {
   PixelType pixel_type;
 
@@ -70,7 +62,7 @@ static const ParameterDescription PIXEL_TYPE_DESCRIPTION = {
   .unit = UNITS_NONE,
   .prefix = PREFIX_NONE,
   .min_valid_value = PIXEL_TYPE_LPD8806,
-  .max_valid_value = PIXEL_TYPE_LPD8806,
+  .max_valid_value = PIXEL_TYPE_APA102,
   .default_value = PIXEL_TYPE_LPD8806,
   .description = PIXEL_TYPE_STRING,
 };
@@ -123,7 +115,7 @@ int LEDModel_SetPixelType(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
   }
   const uint16_t type = ExtractUInt16(param_data);
-  if (type != PIXEL_TYPE_LPD8806) {
+  if (!SPIRGB_Configure(type, g_model.pixel_count)) {
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
   g_model.pixel_type = type;
@@ -142,7 +134,7 @@ int LEDModel_SetPixelCount(const RDMHeader *header,
   }
 
   const uint16_t count = ExtractUInt16(param_data);
-  if (count > MAX_PIXEL_COUNT) {
+  if (!SPIRGB_Configure(g_model.pixel_type, count)) {
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
   g_model.pixel_count = count;
@@ -159,6 +151,7 @@ static void LEDModel_Activate() {
 
   g_model.pixel_type = PIXEL_TYPE_LPD8806;
   g_model.pixel_count = DEFAULT_PIXEL_COUNT;
+  SPIRGB_Configure(g_model.pixel_type, g_model.pixel_count);
 }
 
 static void LEDModel_Deactivate() {}
@@ -190,6 +183,11 @@ static int LEDModel_HandleRequest(const RDMHeader *header,
 
 static void LEDModel_Tasks() {}
 
+const ResponderDefinition *const LED_MODEL_DEFINITIONS[] = {
+  &RESPONDER_DEFINITION,
+  NULL
+};
+
 const ModelEntry LED_MODEL_ENTRY = {
   .model_id = LED_MODEL_ID,
   .activate_fn = LEDModel_Activate,
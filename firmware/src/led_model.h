@@ -32,6 +32,7 @@
 
 #include "rdm.h"
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,14 @@ extern "C" {
  */
 extern const ModelEntry LED_MODEL_ENTRY;
 
+/**
+ * @brief The ResponderDefinitions used by the model, terminated by NULL.
+ *
+ * RDMResponder_DispatchPID() requires each descriptor table to be sorted by
+ * PID, this allows the tests to check all of them.
+ */
+extern const ResponderDefinition *const LED_MODEL_DEFINITIONS[];
+
 /**
  * @brief Initialize the led model.
  */
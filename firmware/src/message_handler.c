@@ -35,12 +35,19 @@
 static TransportTXFunction g_message_tx_cb;
 #endif
 
+// The size of the offset & length fields before each run of slots in an
+// UPDATE_DMX_STREAM message.
+enum { DMX_STREAM_RUN_HEADER_SIZE = 4u };
+
 static inline uint16_t JoinUInt16(uint8_t upper, uint8_t lower) {
   return (upper << 8) + lower;
 }
 
-static inline void SendMessage(uint8_t token, Command command, uint8_t rc,
-                               const IOVec* iov, unsigned int iov_size) {
+/*
+ * @brief Hand a message to the transport.
+ */
+static inline void TransmitMessage(uint8_t token, Command command, uint8_t rc,
+                                   const IOVec* iov, unsigned int iov_size) {
 #ifdef PIPELINE_TRANSPORT_TX
   PIPELINE_TRANSPORT_TX(token, command, rc, iov, iov_size);
 #else
@@ -48,6 +55,34 @@ static inline void SendMessage(uint8_t token, Command command, uint8_t rc,
 #endif
 }
 
+/*
+ * @brief Send a message.
+ *
+ * The command is tagged with the selected transceiver port.
+ */
+static inline void SendMessage(uint8_t token, Command command, uint8_t rc,
+                               const IOVec* iov, unsigned int iov_size) {
+  command = (Command) (command | (Transceiver_GetPort() << COMMAND_PORT_SHIFT));
+  TransmitMessage(token, command, rc, iov, iov_size);
+}
+
+/*
+ * @brief Send a message where the last IOVec may be referenced rather than
+ *   copied.
+ *
+ * The command is tagged with the given transceiver port.
+ */
+static inline void SendPinnedMessage(uint8_t port, uint8_t token,
+                                     Command command, uint8_t rc,
+                                     const IOVec* iov, unsigned int iov_size) {
+  command = (Command) (command | (port << COMMAND_PORT_SHIFT));
+#ifdef PIPELINE_TRANSPORT_TX_PINNED
+  PIPELINE_TRANSPORT_TX_PINNED(token, command, rc, iov, iov_size);
+#else
+  TransmitMessage(token, command, rc, iov, iov_size);
+#endif
+}
+
 static void Echo(const Message *message) {
   IOVec iovec;
   iovec.base = message->payload;
@@ -64,6 +99,11 @@ static void SetMode(uint8_t token,
     return;
   }
   mode = payload[0];
+  // There is a single RDM responder, which is bound to port 0.
+  if (mode && Transceiver_GetPort() != 0u) {
+    SendMessage(token, COMMAND_SET_MODE, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
   Transceiver_SetMode(mode ? T_MODE_RESPONDER : T_MODE_CONTROLLER);
   SendMessage(token, COMMAND_SET_MODE, RC_OK, NULL, 0u);
 }
@@ -284,6 +324,75 @@ static void ReturnRDMResponderJitter(uint8_t token, unsigned int length) {
   SendMessage(token, COMMAND_GET_RDM_RESPONDER_JITTER, RC_OK, &iovec, 1u);
 }
 
+static void SetDMXRefreshInterval(uint8_t token,
+                                  const uint8_t* payload,
+                                  unsigned int length) {
+  uint16_t interval;
+  if (length != sizeof(interval)) {
+    SendMessage(token, COMMAND_SET_DMX_REFRESH_INTERVAL, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+
+  interval = JoinUInt16(payload[1], payload[0]);
+  bool ok = Transceiver_SetDMXRefreshInterval(interval);
+  SendMessage(token, COMMAND_SET_DMX_REFRESH_INTERVAL,
+              ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
+}
+
+static void ReturnDMXRefreshInterval(uint8_t token, unsigned int length) {
+  if (length) {
+    SendMessage(token, COMMAND_GET_DMX_REFRESH_INTERVAL, RC_BAD_PARAM,
+                NULL, 0u);
+    return;
+  }
+  uint16_t interval = Transceiver_GetDMXRefreshInterval();
+  IOVec iovec;
+  iovec.base = (uint8_t*) &interval;
+  iovec.length = sizeof(interval);
+  SendMessage(token, COMMAND_GET_DMX_REFRESH_INTERVAL, RC_OK, &iovec, 1u);
+}
+
+/*
+ * @brief Apply a series of (offset, length, slots) runs to the DMX stream.
+ */
+static void UpdateDMXStream(uint8_t token, const uint8_t* payload,
+                            unsigned int length) {
+  // Check the runs are well formed, and within the stream, before applying
+  // any of them.
+  const unsigned int slot_count = Transceiver_GetDMXStreamSize();
+  unsigned int offset = 0u;
+  while (offset != length) {
+    if (length - offset < DMX_STREAM_RUN_HEADER_SIZE) {
+      SendMessage(token, COMMAND_UPDATE_DMX_STREAM, RC_BAD_PARAM, NULL, 0u);
+      return;
+    }
+    uint16_t start_slot = JoinUInt16(payload[offset + 1u], payload[offset]);
+    uint16_t run_length = JoinUInt16(payload[offset + 3u],
+                                     payload[offset + 2u]);
+    offset += DMX_STREAM_RUN_HEADER_SIZE;
+    if (length - offset < run_length ||
+        (unsigned int) start_slot + run_length > slot_count) {
+      SendMessage(token, COMMAND_UPDATE_DMX_STREAM, RC_BAD_PARAM, NULL, 0u);
+      return;
+    }
+    offset += run_length;
+  }
+
+  bool ok = true;
+  offset = 0u;
+  while (ok && offset != length) {
+    uint16_t start_slot = JoinUInt16(payload[offset + 1u], payload[offset]);
+    uint16_t run_length = JoinUInt16(payload[offset + 3u],
+                                     payload[offset + 2u]);
+    offset += DMX_STREAM_RUN_HEADER_SIZE;
+    ok = Transceiver_UpdateDMXStream(start_slot, payload + offset, run_length);
+    offset += run_length;
+  }
+  SendMessage(token, COMMAND_UPDATE_DMX_STREAM, ok ? RC_OK : RC_BAD_PARAM,
+              NULL, 0u);
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void MessageHandler_Initialize(TransportTXFunction tx_cb) {
@@ -293,7 +402,12 @@ void MessageHandler_Initialize(TransportTXFunction tx_cb) {
 }
 
 void MessageHandler_HandleMessage(const Message *message) {
-  switch (message->command) {
+  if (!Transceiver_SelectPort(message->command >> COMMAND_PORT_SHIFT)) {
+    SendMessage(message->token, message->command, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  switch (message->command & ~COMMAND_PORT_MASK) {
     case COMMAND_ECHO:
       Echo(message);
       break;
@@ -303,6 +417,20 @@ void MessageHandler_HandleMessage(const Message *message) {
         SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
       }
       break;
+    case COMMAND_START_DMX_STREAM:
+      SendMessage(message->token, message->command,
+                  Transceiver_StartDMXStream(message->payload,
+                                             message->length) ?
+                  RC_OK : RC_BAD_PARAM,
+                  NULL, 0u);
+      break;
+    case COMMAND_UPDATE_DMX_STREAM:
+      UpdateDMXStream(message->token, message->payload, message->length);
+      break;
+    case COMMAND_STOP_DMX_STREAM:
+      Transceiver_StopDMXStream();
+      SendMessage(message->token, message->command, RC_OK, NULL, 0u);
+      break;
     case GET_FLAGS:
       Flags_SendResponse(message->token);
       break;
@@ -370,6 +498,12 @@ void MessageHandler_HandleMessage(const Message *message) {
     case COMMAND_GET_RDM_RESPONDER_JITTER:
       ReturnRDMResponderJitter(message->token, message->length);
       break;
+    case COMMAND_SET_DMX_REFRESH_INTERVAL:
+      SetDMXRefreshInterval(message->token, message->payload, message->length);
+      break;
+    case COMMAND_GET_DMX_REFRESH_INTERVAL:
+      ReturnDMXRefreshInterval(message->token, message->length);
+      break;
 
     case COMMAND_RDM_BROADCAST_REQUEST:
       if (!Transceiver_QueueRDMRequest(message->token, message->payload,
@@ -382,6 +516,7 @@ void MessageHandler_HandleMessage(const Message *message) {
       // Just echo the command code back if we don't understand it.
       SendMessage(message->token, message->command, RC_UNKNOWN, NULL, 0u);
   }
+  Transceiver_SelectPort(0u);
 }
 
 void MessageHandler_TransceiverEvent(const TransceiverEvent *event) {
@@ -440,7 +575,9 @@ void MessageHandler_TransceiverEvent(const TransceiverEvent *event) {
     vector_size++;
   }
 
-  SendMessage(event->token, command, rc, (IOVec*) &iovec, vector_size);
+  // The transceiver holds on to the data until the transport releases it.
+  SendPinnedMessage(event->port, event->token, command, rc, (IOVec*) &iovec,
+                    vector_size);
   SysLog_Print(SYSLOG_INFO, "Token %d, op %d, result: %d",
                event->token, event->op, event->result);
 }
@@ -51,6 +51,9 @@ void MessageHandler_Initialize(TransportTXFunction tx_cb);
  * @brief Handle messages from the Host System
  * @param message The message to handle, ownership is not transferred.
  *   Invalidated once the call completes.
+ *
+ * The transceiver port in the upper bits of the command is selected while the
+ * message is handled, see @ref message-ports.
  */
 void MessageHandler_HandleMessage(const Message* message);
 
@@ -23,6 +23,7 @@
 #include "coarse_timer.h"
 #include "constants.h"
 #include "macros.h"
+#include "moving_light_pids.h"
 #include "rdm_buffer.h"
 #include "rdm_frame.h"
 #include "rdm_responder.h"
@@ -47,43 +48,11 @@ static const char LANGUAGE_FRENCH[] = "fr";
 
 static const ResponderDefinition RESPONDER_DEFINITION;
 
-/*
- * @brief The simple model state.
- */
-typedef struct {
-  uint32_t device_hours;
-  uint32_t lamp_hours;
-  uint32_t lamp_strikes;
-  uint32_t device_power_cycles;
-  CoarseTimer_Value lamp_strike_time;
-  CoarseTimer_Value clock_timer;
-  uint8_t lamp_state;
-  uint8_t lamp_on_mode;
-  uint8_t display_level;
-  uint8_t display_invert;
-  uint8_t power_state;
-  uint8_t language_index;
-  bool pan_invert;
-  bool tilt_invert;
-  bool pan_tilt_swap;
-  bool using_factory_defaults;
-
-  // The Clock
-  uint16_t year;
-  uint8_t month;
-  uint8_t day;
-  uint8_t hour;
-  uint8_t minute;
-  uint8_t second;
-} MovingLightModel;
-
 static const char *LANGUAGES[NUMBER_OF_LANGUAGES] = {
   LANGUAGE_ENGLISH,
   LANGUAGE_FRENCH,
 };
 
-static MovingLightModel g_moving_light;
-
 // Helper functions
 // ----------------------------------------------------------------------------
 static void MovingLightModel_ResetToFactoryDefaults() {
@@ -177,115 +146,6 @@ int MovingLightModel_SetLanguage(const RDMHeader *header,
   return RDMResponder_BuildSetAck(header);
 }
 
-int MovingLightModel_GetBool(const RDMHeader *header,
-                             UNUSED const uint8_t *param_data) {
-  switch (ntohs(header->param_id)) {
-    case PID_PAN_INVERT:
-      return RDMResponder_GenericGetBool(header, g_moving_light.pan_invert);
-    case PID_TILT_INVERT:
-      return RDMResponder_GenericGetBool(header, g_moving_light.tilt_invert);
-    case PID_PAN_TILT_SWAP:
-      return RDMResponder_GenericGetBool(header, g_moving_light.pan_tilt_swap);
-    default:
-      return RDM_RESPONDER_NO_RESPONSE;
-  }
-}
-
-int MovingLightModel_SetBool(const RDMHeader *header,
-                             const uint8_t *param_data) {
-  bool *value = NULL;
-  switch (ntohs(header->param_id)) {
-    case PID_PAN_INVERT:
-      value = &g_moving_light.pan_invert;
-      break;
-    case PID_TILT_INVERT:
-      value = &g_moving_light.tilt_invert;
-      break;
-    case PID_PAN_TILT_SWAP:
-      value = &g_moving_light.pan_tilt_swap;
-      break;
-    default:
-      return RDM_RESPONDER_NO_RESPONSE;
-  }
-
-  bool old_value = *value;
-  int response_size = RDMResponder_GenericSetBool(header, param_data, value);
-  if (*value != old_value) {
-    g_moving_light.using_factory_defaults = false;
-  }
-  return response_size;
-}
-
-int MovingLightModel_GetUInt8(const RDMHeader *header,
-                              UNUSED const uint8_t *param_data) {
-  switch (ntohs(header->param_id)) {
-    case PID_LAMP_STATE:
-      return RDMResponder_GenericGetUInt8(header, g_moving_light.lamp_state);
-    case PID_LAMP_ON_MODE:
-      return RDMResponder_GenericGetUInt8(header, g_moving_light.lamp_on_mode);
-    case PID_DISPLAY_INVERT:
-      return RDMResponder_GenericGetUInt8(header,
-                                          g_moving_light.display_invert);
-    case PID_DISPLAY_LEVEL:
-      return RDMResponder_GenericGetUInt8(header, g_moving_light.display_level);
-    case PID_POWER_STATE:
-      return RDMResponder_GenericGetUInt8(header, g_moving_light.power_state);
-    default:
-      return RDM_RESPONDER_NO_RESPONSE;
-  }
-}
-
-int MovingLightModel_SetUInt8(const RDMHeader *header,
-                              const uint8_t *param_data) {
-  if (ntohs(header->param_id) != PID_DISPLAY_LEVEL) {
-    return RDM_RESPONDER_NO_RESPONSE;
-  }
-  uint8_t old_value = g_moving_light.display_level;
-  int response_size = RDMResponder_GenericSetUInt8(
-      header, param_data, &g_moving_light.display_level);
-  if (g_moving_light.display_level != old_value) {
-    g_moving_light.using_factory_defaults = false;
-  }
-  return response_size;
-}
-
-int MovingLightModel_GetUInt32(const RDMHeader *header,
-                               UNUSED const uint8_t *param_data) {
-  switch (ntohs(header->param_id)) {
-    case PID_DEVICE_HOURS:
-      return RDMResponder_GenericGetUInt32(header, g_moving_light.device_hours);
-    case PID_LAMP_HOURS:
-      return RDMResponder_GenericGetUInt32(header, g_moving_light.lamp_hours);
-    case PID_LAMP_STRIKES:
-      return RDMResponder_GenericGetUInt32(header, g_moving_light.lamp_strikes);
-    case PID_DEVICE_POWER_CYCLES:
-      return RDMResponder_GenericGetUInt32(
-          header, g_moving_light.device_power_cycles);
-    default:
-      return RDM_RESPONDER_NO_RESPONSE;
-  }
-}
-
-int MovingLightModel_SetUInt32(const RDMHeader *header,
-                               const uint8_t *param_data) {
-  switch (ntohs(header->param_id)) {
-    case PID_DEVICE_HOURS:
-      return RDMResponder_GenericSetUInt32(header, param_data,
-                                           &g_moving_light.device_hours);
-    case PID_LAMP_HOURS:
-      return RDMResponder_GenericSetUInt32(header, param_data,
-                                           &g_moving_light.lamp_hours);
-    case PID_LAMP_STRIKES:
-      return RDMResponder_GenericSetUInt32(header, param_data,
-                                           &g_moving_light.lamp_strikes);
-    case PID_DEVICE_POWER_CYCLES:
-      return RDMResponder_GenericSetUInt32(header, param_data,
-                                           &g_moving_light.device_power_cycles);
-    default:
-      return RDM_RESPONDER_NO_RESPONSE;
-  }
-}
-
 int MovingLightModel_GetFactoryDefaults(const RDMHeader *header,
                                         const uint8_t *param_data) {
   bool using_defaults = (g_moving_light.using_factory_defaults &&
@@ -326,45 +186,14 @@ int MovingLightModel_SetLampState(const RDMHeader *header,
   return RDMResponder_BuildSetAck(header);
 }
 
-int MovingLightModel_SetLampOnMode(const RDMHeader *header,
-                                   const uint8_t *param_data) {
-  if (header->param_data_length != sizeof(uint8_t)) {
-    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
-  }
-
-  if (param_data[0] > LAMP_ON_MODE_ON_AFTER_CAL) {
-    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
-  }
-  if (g_moving_light.lamp_on_mode != param_data[0]) {
-    g_moving_light.using_factory_defaults = false;
-  }
-  g_moving_light.lamp_on_mode = param_data[0];
-  return RDMResponder_BuildSetAck(header);
-}
-
-int MovingLightModel_SetDisplayInvert(const RDMHeader *header,
-                                      const uint8_t *param_data) {
-  if (header->param_data_length != sizeof(uint8_t)) {
-    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
-  }
-
-  if (param_data[0] > DISPLAY_INVERT_AUTO) {
-    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
-  }
-  if (g_moving_light.display_invert != param_data[0]) {
-    g_moving_light.using_factory_defaults = false;
-  }
-  g_moving_light.display_invert = param_data[0];
-  return RDMResponder_BuildSetAck(header);
-}
-
 int MovingLightModel_SetPowerState(const RDMHeader *header,
                                    const uint8_t *param_data) {
   if (header->param_data_length != sizeof(uint8_t)) {
     return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
   }
 
-  if (param_data[0] > POWER_STATE_NORMAL) {
+  if (param_data[0] > POWER_STATE_STANDBY &&
+      param_data[0] != POWER_STATE_NORMAL) {
     return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
   }
   if (g_moving_light.power_state != param_data[0]) {
@@ -524,6 +353,11 @@ static void MovingLightModel_Tasks() {
   }
 }
 
+const ResponderDefinition *const MOVING_LIGHT_MODEL_DEFINITIONS[] = {
+  &RESPONDER_DEFINITION,
+  NULL
+};
+
 const ModelEntry MOVING_LIGHT_MODEL_ENTRY = {
   .model_id = MOVING_LIGHT_MODEL_ID,
   .activate_fn = MovingLightModel_Activate,
@@ -533,72 +367,6 @@ const ModelEntry MOVING_LIGHT_MODEL_ENTRY = {
   .tasks_fn = MovingLightModel_Tasks
 };
 
-static const PIDDescriptor PID_DESCRIPTORS[] = {
-  {PID_COMMS_STATUS, RDMResponder_GetCommsStatus, 0u,
-    RDMResponder_SetCommsStatus},
-  {PID_SUPPORTED_PARAMETERS, RDMResponder_GetSupportedParameters, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_DEVICE_INFO, RDMResponder_GetDeviceInfo, 0u, (PIDCommandHandler) NULL},
-  {PID_PRODUCT_DETAIL_ID_LIST, RDMResponder_GetProductDetailIds, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_DEVICE_MODEL_DESCRIPTION, RDMResponder_GetDeviceModelDescription, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_MANUFACTURER_LABEL, RDMResponder_GetManufacturerLabel, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_DEVICE_LABEL, RDMResponder_GetDeviceLabel, 0u,
-    RDMResponder_SetDeviceLabel},
-  {PID_FACTORY_DEFAULTS, MovingLightModel_GetFactoryDefaults, 0u,
-    MovingLightModel_SetFactoryDefaults},
-  {PID_LANGUAGE_CAPABILITIES, MovingLightModel_GetLanguageCapabilities, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_LANGUAGE, MovingLightModel_GetLanguage, 0u,
-    MovingLightModel_SetLanguage},
-  {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_BOOT_SOFTWARE_VERSION_ID, RDMResponder_GetBootSoftwareVersion, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_BOOT_SOFTWARE_VERSION_LABEL, RDMResponder_GetBootSoftwareVersionLabel,
-    0u, (PIDCommandHandler) NULL},
-  {PID_DMX_PERSONALITY, RDMResponder_GetDMXPersonality, 0u,
-    RDMResponder_SetDMXPersonality},
-  {PID_DMX_PERSONALITY_DESCRIPTION, RDMResponder_GetDMXPersonalityDescription,
-    1u, (PIDCommandHandler) NULL},
-  {PID_DMX_START_ADDRESS, RDMResponder_GetDMXStartAddress, 0u,
-    RDMResponder_SetDMXStartAddress},
-  {PID_SLOT_INFO, RDMResponder_GetSlotInfo, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_SLOT_DESCRIPTION, RDMResponder_GetSlotDescription, 2,
-    (PIDCommandHandler) NULL},
-  {PID_DEFAULT_SLOT_VALUE, RDMResponder_GetDefaultSlotValue, 0u,
-    (PIDCommandHandler) NULL},
-  {PID_DEVICE_HOURS, MovingLightModel_GetUInt32, 0u,
-    MovingLightModel_SetUInt32},
-  {PID_LAMP_HOURS, MovingLightModel_GetUInt32, 0u,
-    MovingLightModel_SetUInt32},
-  {PID_LAMP_STRIKES, MovingLightModel_GetUInt32, 0u,
-    MovingLightModel_SetUInt32},
-  {PID_LAMP_STATE, MovingLightModel_GetUInt8, 0u,
-    MovingLightModel_SetLampState},
-  {PID_LAMP_ON_MODE, MovingLightModel_GetUInt8, 0u,
-    MovingLightModel_SetLampOnMode},
-  {PID_DEVICE_POWER_CYCLES, MovingLightModel_GetUInt32, 0u,
-    MovingLightModel_SetUInt32},
-  {PID_DISPLAY_INVERT, MovingLightModel_GetUInt8, 0u,
-    MovingLightModel_SetDisplayInvert},
-  {PID_DISPLAY_LEVEL, MovingLightModel_GetUInt8, 0u, MovingLightModel_SetUInt8},
-  {PID_PAN_INVERT, MovingLightModel_GetBool, 0u, MovingLightModel_SetBool},
-  {PID_TILT_INVERT, MovingLightModel_GetBool, 0u, MovingLightModel_SetBool},
-  {PID_PAN_TILT_SWAP, MovingLightModel_GetBool, 0u, MovingLightModel_SetBool},
-  {PID_REAL_TIME_CLOCK, MovingLightModel_GetClock, 0u,
-    MovingLightModel_SetClock},
-  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
-    RDMResponder_SetIdentifyDevice},
-  {PID_RESET_DEVICE, (PIDCommandHandler) NULL, 0u,
-    MovingLightModel_ResetDevice},
-  {PID_POWER_STATE, MovingLightModel_GetUInt8, 0u,
-    MovingLightModel_SetPowerState}
-};
-
 static const ProductDetailIds PRODUCT_DETAIL_ID_LIST = {
   .ids = {PRODUCT_DETAIL_TEST, PRODUCT_DETAIL_CHANGEOVER_MANUAL,
           PRODUCT_DETAIL_LED},
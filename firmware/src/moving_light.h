@@ -30,6 +30,7 @@
 #include "system_config.h"
 
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +41,14 @@ extern "C" {
  */
 extern const ModelEntry MOVING_LIGHT_MODEL_ENTRY;
 
+/**
+ * @brief The ResponderDefinitions used by the model, terminated by NULL.
+ *
+ * RDMResponder_DispatchPID() requires each descriptor table to be sorted by
+ * PID, this allows the tests to check all of them.
+ */
+extern const ResponderDefinition *const MOVING_LIGHT_MODEL_DEFINITIONS[];
+
 /**
  * @brief Initialize the Moving Light Model.
  */
@@ -0,0 +1,289 @@
+/*
+ * Generated by tools/pidgen from moving_light.pids, do not edit.
+ *
+ * This is included once, by the model's .c file.
+ */
+
+#ifndef FIRMWARE_SRC_MOVING_LIGHT_PIDS_H_
+#define FIRMWARE_SRC_MOVING_LIGHT_PIDS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "macros.h"
+#include "rdm.h"
+#include "rdm_buffer.h"
+#include "rdm_responder.h"
+#include "utils.h"
+#include "coarse_timer.h"
+
+/*
+ * @brief The model state.
+ */
+typedef struct {
+  uint32_t device_hours;
+  uint32_t lamp_hours;
+  uint32_t lamp_strikes;
+  uint32_t device_power_cycles;
+  CoarseTimer_Value lamp_strike_time;
+  CoarseTimer_Value clock_timer;
+  uint16_t year;
+  uint8_t lamp_state;
+  uint8_t lamp_on_mode;
+  uint8_t display_level;
+  uint8_t display_invert;
+  uint8_t power_state;
+  uint8_t language_index;
+  bool pan_invert;
+  bool tilt_invert;
+  bool pan_tilt_swap;
+  bool using_factory_defaults;
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+} MovingLightModel;
+
+static MovingLightModel g_moving_light;
+
+// Model PID handlers
+int MovingLightModel_GetFactoryDefaults(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_SetFactoryDefaults(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_GetLanguageCapabilities(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_GetLanguage(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_SetLanguage(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_SetLampState(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_GetClock(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_SetClock(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_ResetDevice(const RDMHeader *header,
+    const uint8_t *param_data);
+int MovingLightModel_SetPowerState(const RDMHeader *header,
+    const uint8_t *param_data);
+
+enum {
+  FIELD_SIZE_MASK = 0x07,  //!< The size of the field in bytes.
+  FIELD_TRACKED = 0x80,  //!< Clears using_factory_defaults when changed.
+};
+
+/*
+ * @brief A field served by the generic GET / SET handlers.
+ */
+typedef struct {
+  uint16_t pid;
+  uint8_t offset;  //!< The offset of the field in the state.
+  uint8_t flags;  //!< The field size, and FIELD_TRACKED.
+  uint32_t min;
+  uint32_t max;
+} GeneratedField;
+
+static const GeneratedField GENERATED_FIELDS[] = {
+  {PID_DEVICE_HOURS,
+    offsetof(MovingLightModel, device_hours),
+    sizeof(uint32_t), 0u, UINT32_MAX},
+  {PID_LAMP_HOURS,
+    offsetof(MovingLightModel, lamp_hours),
+    sizeof(uint32_t), 0u, UINT32_MAX},
+  {PID_LAMP_STRIKES,
+    offsetof(MovingLightModel, lamp_strikes),
+    sizeof(uint32_t), 0u, UINT32_MAX},
+  {PID_LAMP_STATE,
+    offsetof(MovingLightModel, lamp_state),
+    sizeof(uint8_t), 0u, UINT8_MAX},
+  {PID_LAMP_ON_MODE,
+    offsetof(MovingLightModel, lamp_on_mode),
+    sizeof(uint8_t) | FIELD_TRACKED, 0u, LAMP_ON_MODE_ON_AFTER_CAL},
+  {PID_DEVICE_POWER_CYCLES,
+    offsetof(MovingLightModel, device_power_cycles),
+    sizeof(uint32_t), 0u, UINT32_MAX},
+  {PID_DISPLAY_INVERT,
+    offsetof(MovingLightModel, display_invert),
+    sizeof(uint8_t) | FIELD_TRACKED, 0u, DISPLAY_INVERT_AUTO},
+  {PID_DISPLAY_LEVEL,
+    offsetof(MovingLightModel, display_level),
+    sizeof(uint8_t) | FIELD_TRACKED, 0u, UINT8_MAX},
+  {PID_PAN_INVERT,
+    offsetof(MovingLightModel, pan_invert),
+    sizeof(bool) | FIELD_TRACKED, 0u, 1u},
+  {PID_TILT_INVERT,
+    offsetof(MovingLightModel, tilt_invert),
+    sizeof(bool) | FIELD_TRACKED, 0u, 1u},
+  {PID_PAN_TILT_SWAP,
+    offsetof(MovingLightModel, pan_tilt_swap),
+    sizeof(bool) | FIELD_TRACKED, 0u, 1u},
+  {PID_POWER_STATE,
+    offsetof(MovingLightModel, power_state),
+    sizeof(uint8_t), 0u, UINT8_MAX}
+};
+
+/*
+ * @brief Find the field for a PID.
+ *
+ * Only PIDs in GENERATED_FIELDS are dispatched to the generic
+ * handlers, so this always finds a field.
+ */
+static const GeneratedField *MovingLightModel_FindField(uint16_t pid) {
+  const unsigned int last = (sizeof(GENERATED_FIELDS) /
+                             sizeof(GeneratedField)) - 1u;
+  unsigned int i = 0u;
+  for (; i < last; i++) {
+    if (GENERATED_FIELDS[i].pid == pid) {
+      break;
+    }
+  }
+  return &GENERATED_FIELDS[i];
+}
+
+static uint32_t MovingLightModel_ReadField(const GeneratedField *field) {
+  const uint8_t *ptr = (const uint8_t*) &g_moving_light + field->offset;
+  switch (field->flags & FIELD_SIZE_MASK) {
+    case sizeof(uint32_t):
+      return *(const uint32_t*) ptr;
+    case sizeof(uint16_t):
+      return *(const uint16_t*) ptr;
+    default:
+      return *ptr;
+  }
+}
+
+static int MovingLightModel_GetField(const RDMHeader *header,
+    UNUSED const uint8_t *param_data) {
+  const GeneratedField *field = MovingLightModel_FindField(
+      ntohs(header->param_id));
+  const uint32_t value = MovingLightModel_ReadField(field);
+  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
+  switch (field->flags & FIELD_SIZE_MASK) {
+    case sizeof(uint32_t):
+      ptr = PushUInt32(ptr, value);
+      break;
+    case sizeof(uint16_t):
+      ptr = PushUInt16(ptr, value);
+      break;
+    default:
+      *ptr++ = value;
+  }
+  return RDMResponder_AddHeaderAndChecksum(header, ACK,
+                                           ptr - g_rdm_buffer);
+}
+
+static int MovingLightModel_SetField(const RDMHeader *header,
+    const uint8_t *param_data) {
+  const GeneratedField *field = MovingLightModel_FindField(
+      ntohs(header->param_id));
+  const unsigned int size = field->flags & FIELD_SIZE_MASK;
+  if (header->param_data_length != size) {
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  uint32_t value = param_data[0];
+  if (size == sizeof(uint32_t)) {
+    value = ExtractUInt32(param_data);
+  } else if (size == sizeof(uint16_t)) {
+    value = ExtractUInt16(param_data);
+  }
+  if (value < field->min || value > field->max) {
+    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
+  }
+
+  if ((field->flags & FIELD_TRACKED) &&
+      MovingLightModel_ReadField(field) != value) {
+    g_moving_light.using_factory_defaults = false;
+  }
+
+  uint8_t *ptr = (uint8_t*) &g_moving_light + field->offset;
+  switch (size) {
+    case sizeof(uint32_t):
+      *(uint32_t*) ptr = value;
+      break;
+    case sizeof(uint16_t):
+      *(uint16_t*) ptr = value;
+      break;
+    default:
+      *ptr = value;
+  }
+  return RDMResponder_BuildSetAck(header);
+}
+
+static const PIDDescriptor PID_DESCRIPTORS[] = {
+  {PID_COMMS_STATUS, RDMResponder_GetCommsStatus, 0u,
+    RDMResponder_SetCommsStatus},
+  {PID_SUPPORTED_PARAMETERS, RDMResponder_GetSupportedParameters, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_DEVICE_INFO, RDMResponder_GetDeviceInfo, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_PRODUCT_DETAIL_ID_LIST, RDMResponder_GetProductDetailIds, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_DEVICE_MODEL_DESCRIPTION, RDMResponder_GetDeviceModelDescription, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_MANUFACTURER_LABEL, RDMResponder_GetManufacturerLabel, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_DEVICE_LABEL, RDMResponder_GetDeviceLabel, 0u,
+    RDMResponder_SetDeviceLabel},
+  {PID_FACTORY_DEFAULTS, MovingLightModel_GetFactoryDefaults, 0u,
+    MovingLightModel_SetFactoryDefaults},
+  {PID_LANGUAGE_CAPABILITIES, MovingLightModel_GetLanguageCapabilities, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_LANGUAGE, MovingLightModel_GetLanguage, 0u,
+    MovingLightModel_SetLanguage},
+  {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_BOOT_SOFTWARE_VERSION_ID, RDMResponder_GetBootSoftwareVersion, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_BOOT_SOFTWARE_VERSION_LABEL,
+    RDMResponder_GetBootSoftwareVersionLabel, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_DMX_PERSONALITY, RDMResponder_GetDMXPersonality, 0u,
+    RDMResponder_SetDMXPersonality},
+  {PID_DMX_PERSONALITY_DESCRIPTION,
+    RDMResponder_GetDMXPersonalityDescription, 1u,
+    (PIDCommandHandler) NULL},
+  {PID_DMX_START_ADDRESS, RDMResponder_GetDMXStartAddress, 0u,
+    RDMResponder_SetDMXStartAddress},
+  {PID_SLOT_INFO, RDMResponder_GetSlotInfo, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_SLOT_DESCRIPTION, RDMResponder_GetSlotDescription, 2u,
+    (PIDCommandHandler) NULL},
+  {PID_DEFAULT_SLOT_VALUE, RDMResponder_GetDefaultSlotValue, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_DEVICE_HOURS, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_LAMP_HOURS, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_LAMP_STRIKES, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_LAMP_STATE, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetLampState},
+  {PID_LAMP_ON_MODE, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_DEVICE_POWER_CYCLES, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_DISPLAY_INVERT, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_DISPLAY_LEVEL, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_PAN_INVERT, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_TILT_INVERT, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_PAN_TILT_SWAP, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetField},
+  {PID_REAL_TIME_CLOCK, MovingLightModel_GetClock, 0u,
+    MovingLightModel_SetClock},
+  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
+    RDMResponder_SetIdentifyDevice},
+  {PID_RESET_DEVICE, (PIDCommandHandler) NULL, 0u,
+    MovingLightModel_ResetDevice},
+  {PID_POWER_STATE, MovingLightModel_GetField, 0u,
+    MovingLightModel_SetPowerState}
+};
+
+#endif  // FIRMWARE_SRC_MOVING_LIGHT_PIDS_H_
@@ -633,6 +633,11 @@ static int NetworkModel_HandleRequest(const RDMHeader *header,
 
 static void NetworkModel_Tasks() {}
 
+const ResponderDefinition *const NETWORK_MODEL_DEFINITIONS[] = {
+  &RESPONDER_DEFINITION,
+  NULL
+};
+
 const ModelEntry NETWORK_MODEL_ENTRY = {
   .model_id = NETWORK_MODEL_ID,
   .activate_fn = NetworkModel_Activate,
@@ -656,8 +661,6 @@ static const PIDDescriptor PID_DESCRIPTORS[] = {
     RDMResponder_SetDeviceLabel},
   {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
-    RDMResponder_SetIdentifyDevice},
   {PID_LIST_INTERFACES, NetworkModel_GetListInterfaces, 0u,
     (PIDCommandHandler) NULL},
   {PID_INTERFACE_LABEL, NetworkModel_GetInterfaceLabel, 4u,
@@ -684,6 +687,8 @@ static const PIDDescriptor PID_DESCRIPTORS[] = {
   {PID_DNS_HOSTNAME, NetworkModel_GetHostname, 0u, NetworkModel_SetHostname},
   {PID_DNS_DOMAIN_NAME, NetworkModel_GetDomainName, 0u,
     NetworkModel_SetDomainName},
+  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
+    RDMResponder_SetIdentifyDevice}
 };
 
 static const ProductDetailIds PRODUCT_DETAIL_ID_LIST = {
@@ -28,6 +28,7 @@
 #define FIRMWARE_SRC_NETWORK_MODEL_H_
 
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,14 @@ extern "C" {
  */
 extern const ModelEntry NETWORK_MODEL_ENTRY;
 
+/**
+ * @brief The ResponderDefinitions used by the model, terminated by NULL.
+ *
+ * RDMResponder_DispatchPID() requires each descriptor table to be sorted by
+ * PID, this allows the tests to check all of them.
+ */
+extern const ResponderDefinition *const NETWORK_MODEL_DEFINITIONS[];
+
 /**
  * @brief Initialize the network model.
  */
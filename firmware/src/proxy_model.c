@@ -258,9 +258,12 @@ void ProxyModel_Initialize() {
   for (; i < NUMBER_OF_CHILDREN; i++) {
     ChildDevice *device = &g_children[i];
 
+    uint8_t uid[UID_LENGTH];
+    memcpy(uid, parent_uid, UID_LENGTH);
+    uid[UID_LENGTH - 1] += (i + 1u);
+
     RDMResponder_SwitchResponder(&device->responder);
-    memcpy(g_responder->uid, parent_uid, UID_LENGTH);
-    g_responder->uid[UID_LENGTH - 1] += (i + 1u);
+    RDMResponder_SetUID(uid);
     g_responder->def = &CHILD_DEVICE_RESPONDER_DEFINITION;
     RDMResponder_ResetToFactoryDefaults();
     g_responder->is_proxied_device = true;
@@ -305,11 +308,33 @@ static int ProxyModel_HandleRequest(const RDMHeader *header,
 
 static void ProxyModel_Tasks() {}
 
+static int ProxyModel_Ioctl(ModelIoctl command, uint8_t *data,
+                            unsigned int length) {
+  switch (command) {
+    case IOCTL_GET_UID_MASK:
+      if (length != UID_LENGTH) {
+        return 0;
+      }
+      // The children only differ from the root device in the last byte.
+      memset(data, 0xff, UID_LENGTH);
+      data[UID_LENGTH - 1] = 0u;
+      return 1;
+    default:
+      return RDMResponder_Ioctl(command, data, length);
+  }
+}
+
+const ResponderDefinition *const PROXY_MODEL_DEFINITIONS[] = {
+  &ROOT_RESPONDER_DEFINITION,
+  &CHILD_DEVICE_RESPONDER_DEFINITION,
+  NULL
+};
+
 const ModelEntry PROXY_MODEL_ENTRY = {
   .model_id = PROXY_MODEL_ID,
   .activate_fn = ProxyModel_Activate,
   .deactivate_fn = ProxyModel_Deactivate,
-  .ioctl_fn = RDMResponder_Ioctl,
+  .ioctl_fn = ProxyModel_Ioctl,
   .request_fn = ProxyModel_HandleRequest,
   .tasks_fn = ProxyModel_Tasks
 };
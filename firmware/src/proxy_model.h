@@ -42,6 +42,7 @@
 #define FIRMWARE_SRC_PROXY_MODEL_H_
 
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +53,14 @@ extern "C" {
  */
 extern const ModelEntry PROXY_MODEL_ENTRY;
 
+/**
+ * @brief The ResponderDefinitions used by the model, terminated by NULL.
+ *
+ * RDMResponder_DispatchPID() requires each descriptor table to be sorted by
+ * PID, this allows the tests to check all of them.
+ */
+extern const ResponderDefinition *const PROXY_MODEL_DEFINITIONS[];
+
 /**
  * @brief Initialize the proxy model.
  */
@@ -74,6 +74,11 @@ static const uint8_t RDM_CHECKSUM_LENGTH = 2u;
  */
 static const uint8_t MESSAGE_LENGTH_OFFSET = 2u;
 
+/**
+ * @brief The location of the destination UID in a frame.
+ */
+static const uint8_t DESTINATION_UID_OFFSET = 3u;
+
 /**
  * @brief The location of the parameter data length in a frame.
  */
@@ -171,16 +176,6 @@ static const uint16_t SENSOR_VALUE_UNSUPPORTED = 0u;
  */
 static const unsigned int MAX_STATUS_MESSAGES_PER_FRAME = 21u;
 
-/*
- * @brief The maximum number of slot info entries in a RDM frame.
- */
-static const unsigned int MAX_SLOT_INFO_PER_FRAME = 46u;
-
-/**
- * @brief The maximum number of default slot value entries in a RDM frame.
- */
-static const unsigned int MAX_DEFAULT_SLOT_VALUE_PER_FRAME = 77u;
-
 /**
  * @brief The maximum pin code from E1.37-1.
  */
@@ -40,6 +40,15 @@ extern "C" {
  */
 extern uint8_t *g_rdm_buffer;
 
+/**
+ * @brief The start of the RDM response to send.
+ *
+ * This is reset to g_rdm_buffer before each request is handled. Responders
+ * that have a pre-built response, like the DUB response, can point it
+ * elsewhere to avoid copying the response into g_rdm_buffer.
+ */
+extern const uint8_t *g_rdm_response;
+
 #ifdef __cplusplus
 }
 #endif
@@ -209,6 +209,7 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
   // We need to intercept calls to the SET_MODEL_ID pid, and use them to change
   // the active model.
   int response_size = RDM_RESPONDER_NO_RESPONSE;
+  g_rdm_response = g_rdm_buffer;
 
   if (ntohs(header->param_id) == PID_DEVICE_MODEL) {
     response_size = GetSetModelId(header, param_data);
@@ -224,7 +225,7 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
 
   if (response_size) {
     IOVec iov;
-    iov.base = g_rdm_buffer;
+    iov.base = g_rdm_response;
     iov.length = abs(response_size);
 
 #ifdef PIPELINE_RDMRESPONDER_SEND
@@ -243,6 +244,14 @@ void RDMHandler_GetUID(uint8_t *uid) {
   }
 }
 
+void RDMHandler_GetUIDMask(uint8_t *mask) {
+  if (!(g_rdm_handler.active_model &&
+        g_rdm_handler.active_model->ioctl_fn(IOCTL_GET_UID_MASK, mask,
+                                             UID_LENGTH))) {
+    memset(mask, 0xff, UID_LENGTH);
+  }
+}
+
 void RDMHandler_Tasks() {
   if (g_rdm_handler.active_model) {
     g_rdm_handler.active_model->tasks_fn();
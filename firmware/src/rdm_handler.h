@@ -122,6 +122,17 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
  */
 void RDMHandler_GetUID(uint8_t *uid);
 
+/**
+ * @brief Get the mask of UID bits the active model responds to.
+ * @param mask A pointer to copy the mask into, must be at least UID_LENGTH
+ *   bytes.
+ *
+ * Bits that are clear in the mask are ignored when matching the destination
+ * UID of a request. If the model doesn't provide a mask, or no model is active,
+ * the mask will be ffff:ffffffff.
+ */
+void RDMHandler_GetUIDMask(uint8_t *mask);
+
 /**
  * @brief Perform the periodic RDM Handler tasks.
  *
@@ -101,6 +101,19 @@ typedef enum {
    * @returns Returns 1 on success or 0 if length didn't match UID_LENGTH.
    */
   IOCTL_GET_UID,
+
+  /**
+   * @brief Copies the mask of UID bits the model answers to.
+   * @param data, a memory location to copy the mask to.
+   * @param length should be set to UID_LENGTH.
+   * @returns Returns 1 on success or 0 if the model only responds to the UID
+   *   returned by IOCTL_GET_UID.
+   *
+   * A destination UID is for this model if it matches the model's UID in all
+   * the bits set in the mask. Models that respond to more than one UID, such
+   * as the proxy, use this to widen the match.
+   */
+  IOCTL_GET_UID_MASK,
 } ModelIoctl;
 
 /**
@@ -37,6 +37,8 @@ static const uint8_t FIVE5_CONSTANT = 0x55u;
 static const uint8_t AA_CONSTANT = 0xaau;
 static const uint8_t FE_CONSTANT = 0xfeu;
 static const uint8_t SENSOR_VALUE_PARAM_DATA_LENGTH = 9u;
+static const unsigned int SLOT_INFO_SIZE = 5u;
+static const unsigned int DEFAULT_SLOT_VALUE_SIZE = 3u;
 static const uint16_t FLASH_FAST = 1000u;
 static const uint16_t FLASH_SLOW = 10000u;
 
@@ -77,6 +79,19 @@ typedef struct {
 
 static InternalResponderState g_internal_state;
 
+/*
+ * @brief The state of a list response that is being sent with ACK_OVERFLOW.
+ */
+typedef struct {
+  const RDMResponder *responder;  //!< NULL if there is no overflow pending.
+  uint8_t controller_uid[UID_LENGTH];
+  uint16_t sub_device;  //!< In network byte order.
+  uint16_t param_id;  //!< In network byte order.
+  unsigned int next_item;
+} OverflowState;
+
+static OverflowState g_overflow;
+
 // Helper functions
 // ----------------------------------------------------------------------------
 
@@ -92,6 +107,31 @@ static inline const PersonalityDefinition* CurrentPersonality() {
   return NULL;
 }
 
+/*
+ * @brief Find the descriptor for a PID.
+ * @param definition The ResponderDefinition to search, the descriptors must be
+ *   sorted by PID.
+ * @param pid The PID to look for.
+ * @returns The PIDDescriptor, or NULL if the PID isn't supported.
+ */
+static const PIDDescriptor* FindDescriptor(
+    const ResponderDefinition *definition, uint16_t pid) {
+  unsigned int lower = 0u;
+  unsigned int upper = definition->descriptor_count;
+  while (lower < upper) {
+    unsigned int middle = lower + (upper - lower) / 2u;
+    uint16_t middle_pid = definition->descriptors[middle].pid;
+    if (pid == middle_pid) {
+      return &definition->descriptors[middle];
+    } else if (pid < middle_pid) {
+      upper = middle;
+    } else {
+      lower = middle + 1u;
+    }
+  }
+  return NULL;
+}
+
 /*
  * @brief Record the sensor at the specified index.
  */
@@ -140,6 +180,52 @@ static uint8_t *BuildSensorValueResponse(uint8_t *ptr, uint8_t index,
   return ptr;
 }
 
+/*
+ * @brief Check if a request continues the pending ACK_OVERFLOW response.
+ */
+static bool IsOverflowContinuation(const RDMHeader *header) {
+  return g_overflow.responder == g_responder &&
+         header->command_class == GET_COMMAND &&
+         header->param_id == g_overflow.param_id &&
+         header->sub_device == g_overflow.sub_device &&
+         memcmp(header->src_uid, g_overflow.controller_uid, UID_LENGTH) == 0;
+}
+
+static uint8_t *WriteSupportedParameter(unsigned int index, uint8_t *ptr) {
+  uint16_t pid = g_responder->def->descriptors[index].pid;
+  switch (pid) {
+    case PID_DISC_UNIQUE_BRANCH:
+    case PID_DISC_MUTE:
+    case PID_DISC_UN_MUTE:
+    case PID_SUPPORTED_PARAMETERS:
+    case PID_PARAMETER_DESCRIPTION:
+    case PID_DEVICE_INFO:
+    case PID_SOFTWARE_VERSION_LABEL:
+    case PID_DMX_START_ADDRESS:
+    case PID_IDENTIFY_DEVICE:
+      if (!g_responder->is_subdevice) {
+        return ptr;
+      }
+      break;
+    default:
+      {}
+  }
+  return PushUInt16(ptr, pid);
+}
+
+static uint8_t *WriteSlotInfo(unsigned int index, uint8_t *ptr) {
+  const SlotDefinition *slot = &CurrentPersonality()->slots[index];
+  ptr = PushUInt16(ptr, index);
+  *ptr++ = slot->slot_type;
+  return PushUInt16(ptr, slot->slot_label_id);
+}
+
+static uint8_t *WriteDefaultSlotValue(unsigned int index, uint8_t *ptr) {
+  ptr = PushUInt16(ptr, index);
+  *ptr++ = CurrentPersonality()->slots[index].default_value;
+  return ptr;
+}
+
 static inline uint16_t GetControlField() {
   return (g_responder->sub_device_count ? MUTE_SUBDEVICE_FLAG : 0) |
          (g_responder->is_managed_proxy ? MUTE_MANAGED_PROXY_FLAG : 0) |
@@ -168,7 +254,9 @@ void RDMResponder_Initialize(const RDMResponderSettings *settings) {
   PLIB_PORTS_PinSet(PORTS_ID_0, g_internal_state.mute_port,
                     g_internal_state.mute_bit);
 
-  memcpy(g_responder->uid, settings->uid, UID_LENGTH);
+  g_overflow.responder = NULL;
+
+  RDMResponder_SetUID(settings->uid);
   g_responder->def = NULL;
   g_responder->is_subdevice = false;
   g_responder->is_managed_proxy = false;
@@ -228,44 +316,39 @@ void RDMResponder_GetUID(uint8_t *uid) {
   memcpy(uid, g_responder->uid, UID_LENGTH);
 }
 
-int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
-                                  unsigned int param_data_length) {
-  if (g_responder->is_muted || param_data_length != 2 * UID_LENGTH) {
-    return RDM_RESPONDER_NO_RESPONSE;
-  }
-
-  if (!(RDMUtil_UIDCompare(param_data, g_responder->uid) <= 0 &&
-        RDMUtil_UIDCompare(g_responder->uid, param_data + UID_LENGTH) <= 0)) {
-    return RDM_RESPONDER_NO_RESPONSE;
-  }
+void RDMResponder_SetUID(const uint8_t *uid) {
+  memcpy(g_responder->uid, uid, UID_LENGTH);
 
-  uint8_t *response = (uint8_t*) g_rdm_buffer;
+  uint8_t *response = g_responder->dub_response;
   memset(response, FE_CONSTANT, 7);
   response[7] = AA_CONSTANT;
-  response[8] = g_responder->uid[0] | AA_CONSTANT;
-  response[9] = g_responder->uid[0] | FIVE5_CONSTANT;
-  response[10] = g_responder->uid[1] | AA_CONSTANT;
-  response[11] = g_responder->uid[1] | FIVE5_CONSTANT;
-
-  response[12] = g_responder->uid[2] | AA_CONSTANT;
-  response[13] = g_responder->uid[2] | FIVE5_CONSTANT;
-  response[14] = g_responder->uid[3] | AA_CONSTANT;
-  response[15] = g_responder->uid[3] | FIVE5_CONSTANT;
-  response[16] = g_responder->uid[4] | AA_CONSTANT;
-  response[17] = g_responder->uid[4] | FIVE5_CONSTANT;
-  response[18] = g_responder->uid[5] | AA_CONSTANT;
-  response[19] = g_responder->uid[5] | FIVE5_CONSTANT;
 
   uint16_t checksum = 0u;
   unsigned int i;
-  for (i = 8u; i < 20u; i++) {
-    checksum += response[i];
+  for (i = 0u; i < UID_LENGTH; i++) {
+    response[8u + 2u * i] = uid[i] | AA_CONSTANT;
+    response[9u + 2u * i] = uid[i] | FIVE5_CONSTANT;
+    checksum += response[8u + 2u * i] + response[9u + 2u * i];
   }
 
   response[20] = ShortMSB(checksum) | AA_CONSTANT;
   response[21] = ShortMSB(checksum) | FIVE5_CONSTANT;
   response[22] = ShortLSB(checksum) | AA_CONSTANT;
   response[23] = ShortLSB(checksum) | FIVE5_CONSTANT;
+}
+
+int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
+                                  unsigned int param_data_length) {
+  if (g_responder->is_muted || param_data_length != 2 * UID_LENGTH) {
+    return RDM_RESPONDER_NO_RESPONSE;
+  }
+
+  if (!(RDMUtil_UIDCompare(param_data, g_responder->uid) <= 0 &&
+        RDMUtil_UIDCompare(g_responder->uid, param_data + UID_LENGTH) <= 0)) {
+    return RDM_RESPONDER_NO_RESPONSE;
+  }
+
+  g_rdm_response = g_responder->dub_response;
   return -DUB_RESPONSE_LENGTH;
 }
 
@@ -366,40 +449,95 @@ int RDMResponder_BuildParamDescription(
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
 
+int RDMResponder_BuildListResponse(const RDMHeader *header,
+                                   unsigned int item_count,
+                                   unsigned int max_item_size,
+                                   RDMListItemWriter writer) {
+  unsigned int i = 0u;
+  if (IsOverflowContinuation(header)) {
+    i = g_overflow.next_item;
+  }
+  g_overflow.responder = NULL;
+
+  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
+  const uint8_t *end = ptr + MAX_PARAM_DATA_SIZE;
+  for (; i < item_count && ptr + max_item_size <= end; i++) {
+    ptr = writer(i, ptr);
+  }
+
+  RDMResponseType response_type = ACK;
+  if (i < item_count) {
+    g_overflow.responder = g_responder;
+    memcpy(g_overflow.controller_uid, header->src_uid, UID_LENGTH);
+    g_overflow.sub_device = header->sub_device;
+    g_overflow.param_id = header->param_id;
+    g_overflow.next_item = i;
+    response_type = ACK_OVERFLOW;
+  }
+  return RDMResponder_AddHeaderAndChecksum(header, response_type,
+                                           ptr - g_rdm_buffer);
+}
+
 int RDMResponder_DispatchPID(const RDMHeader *header,
                              const uint8_t *param_data) {
-  const ResponderDefinition *definition = g_responder->def;
-  uint16_t pid = ntohs(header->param_id);
-  unsigned int i = 0u;
-  // TODO(simon): convert to binary search if the list gets long.
-  // We'll need to add a check to ensure it's sorted though.
-  for (; i < definition->descriptor_count; i++) {
-    if (pid == definition->descriptors[i].pid) {
-      if (header->command_class == GET_COMMAND) {
-        if (RDMUtil_IsUnicast(header->dest_uid)) {\
-          if (definition->descriptors[i].get_handler) {
-            if (header->param_data_length ==
-                definition->descriptors[i].get_param_size) {
-              return definition->descriptors[i].get_handler(header, param_data);
-            } else {
-              return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
-            }
-          } else {
-            return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
-          }
-        } else {
-          return RDM_RESPONDER_NO_RESPONSE;
-        }
-      } else {
-        if (definition->descriptors[i].set_handler) {
-          return definition->descriptors[i].set_handler(header, param_data);
-        } else {
-          return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
-        }
-      }
+  if (!IsOverflowContinuation(header)) {
+    g_overflow.responder = NULL;
+  }
+
+  const PIDDescriptor *descriptor = FindDescriptor(g_responder->def,
+                                                   ntohs(header->param_id));
+  if (!descriptor) {
+    return RDMResponder_BuildNack(header, NR_UNKNOWN_PID);
+  }
+
+  if (header->command_class == GET_COMMAND) {
+    if (!RDMUtil_IsUnicast(header->dest_uid)) {
+      return RDM_RESPONDER_NO_RESPONSE;
+    }
+    if (!descriptor->get_handler) {
+      return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
+    }
+    if (header->param_data_length != descriptor->get_param_size) {
+      return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+    }
+    return descriptor->get_handler(header, param_data);
+  } else {
+    if (!descriptor->set_handler) {
+      return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
     }
+    return descriptor->set_handler(header, param_data);
   }
-  return RDMResponder_BuildNack(header, NR_UNKNOWN_PID);
+}
+
+int RDMResponder_DispatchSetToAll(const RDMHeader *header,
+                                  const uint8_t *param_data,
+                                  const ResponderDefinition *definition,
+                                  RDMResponderSelector select_fn,
+                                  unsigned int count) {
+  g_overflow.responder = NULL;
+
+  const PIDDescriptor *descriptor = FindDescriptor(definition,
+                                                   ntohs(header->param_id));
+  if (!descriptor) {
+    return RDMResponder_BuildNack(header, NR_UNKNOWN_PID);
+  }
+  if (!descriptor->set_handler) {
+    return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
+  }
+
+  // SET handlers don't build a response to a broadcast, so all but the last
+  // responder are passed a broadcast copy of the header.
+  RDMHeader broadcast_header = *header;
+  memset(broadcast_header.dest_uid, 0xff, UID_LENGTH);
+
+  int response_size = RDM_RESPONDER_NO_RESPONSE;
+  unsigned int i = 0u;
+  for (; i < count; i++) {
+    select_fn(i);
+    response_size = descriptor->set_handler(
+        i + 1u == count ? header : &broadcast_header, param_data);
+  }
+  return response_size;
 }
 
 int RDMResponder_Ioctl(ModelIoctl command, uint8_t *data, unsigned int length) {
@@ -533,32 +671,9 @@ int RDMResponder_SetUnMute(const RDMHeader *header) {
 
 int RDMResponder_GetSupportedParameters(const RDMHeader *header,
                                         UNUSED const uint8_t *param_data) {
-  const ResponderDefinition *definition = g_responder->def;
-
-  // TODO(simon): handle ack-overflow here
-  unsigned int i = 0u;
-  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  for (; i < definition->descriptor_count; i++) {
-    switch (definition->descriptors[i].pid) {
-      case PID_DISC_UNIQUE_BRANCH:
-      case PID_DISC_MUTE:
-      case PID_DISC_UN_MUTE:
-      case PID_SUPPORTED_PARAMETERS:
-      case PID_PARAMETER_DESCRIPTION:
-      case PID_DEVICE_INFO:
-      case PID_SOFTWARE_VERSION_LABEL:
-      case PID_DMX_START_ADDRESS:
-      case PID_IDENTIFY_DEVICE:
-        if (g_responder->is_subdevice) {
-          ptr = PushUInt16(ptr, definition->descriptors[i].pid);
-        }
-        break;
-      default:
-        ptr = PushUInt16(ptr, definition->descriptors[i].pid);
-    }
-  }
-
-  return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
+  return RDMResponder_BuildListResponse(
+      header, g_responder->def->descriptor_count, sizeof(uint16_t),
+      WriteSupportedParameter);
 }
 
 int RDMResponder_GetCommsStatus(const RDMHeader *header,
@@ -754,18 +869,8 @@ int RDMResponder_GetSlotInfo(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_HARDWARE_FAULT);
   }
 
-  // TODO(simon): If we have more than 46 slots we'll need to ACK_OVERFLOW
-  unsigned int slot_count = min(MAX_SLOT_INFO_PER_FRAME,
-                                personality->slot_count);
-  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  unsigned int i = 0u;
-  for (; i < slot_count; i++) {
-    ptr = PushUInt16(ptr, i);
-    *ptr++ = personality->slots[i].slot_type;
-    ptr = PushUInt16(ptr, personality->slots[i].slot_label_id);
-  }
-
-  return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
+  return RDMResponder_BuildListResponse(header, personality->slot_count,
+                                        SLOT_INFO_SIZE, WriteSlotInfo);
 }
 
 int RDMResponder_GetSlotDescription(const RDMHeader *header,
@@ -796,16 +901,9 @@ int RDMResponder_GetDefaultSlotValue(const RDMHeader *header,
     return RDMResponder_BuildNack(header, NR_HARDWARE_FAULT);
   }
 
-  // TODO(simon): If we have more than 77 slots we'll need to ACK_OVERFLOW
-  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
-  unsigned int slot_count = min(MAX_DEFAULT_SLOT_VALUE_PER_FRAME,
-                                personality->slot_count);
-  unsigned int i = 0u;
-  for (; i < slot_count; i++) {
-    ptr = PushUInt16(ptr, i);
-    *ptr++ = personality->slots[i].default_value;
-  }
-  return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
+  return RDMResponder_BuildListResponse(header, personality->slot_count,
+                                        DEFAULT_SLOT_VALUE_SIZE,
+                                        WriteDefaultSlotValue);
 }
 
 int RDMResponder_GetSensorDefinition(const RDMHeader *header,
@@ -67,6 +67,18 @@ extern "C" {
  */
 extern const char MANUFACTURER_LABEL[];
 
+/**
+ * @brief Write one item of a list response.
+ * @param index The index of the item to write.
+ * @param ptr The location to write the item to.
+ * @returns A pointer to the end of the item. An item can be skipped by
+ *   returning ptr.
+ *
+ * The item must not be larger than the max_item_size passed to
+ * RDMResponder_BuildListResponse().
+ */
+typedef uint8_t* (*RDMListItemWriter)(unsigned int index, uint8_t *ptr);
+
 /**
  * @brief A PID handler.
  * @param incoming_header The header for the request.
@@ -77,6 +89,12 @@ extern const char MANUFACTURER_LABEL[];
 typedef int (*PIDCommandHandler)(const RDMHeader *incoming_header,
                                  const uint8_t *param_data);
 
+/**
+ * @brief Make a responder the current one, see RDMResponder_DispatchSetToAll().
+ * @param index The index of the responder.
+ */
+typedef void (*RDMResponderSelector)(unsigned int index);
+
 /**
  * @brief A parameter description.
  *
@@ -232,6 +250,9 @@ typedef struct {
 typedef struct {
   /**
    * @brief The descriptor table.
+   *
+   * This must be sorted by PID, since RDMResponder_DispatchPID() uses a binary
+   * search to find the descriptor.
    */
   const PIDDescriptor *descriptors;
 
@@ -288,6 +309,13 @@ typedef struct {
   char device_label[RDM_DEFAULT_STRING_SIZE];  //!< Device label
   uint8_t uid[UID_LENGTH];  //!< Responder's UID
 
+  /**
+   * @brief The encoded DUB response for the UID.
+   *
+   * This is updated by RDMResponder_SetUID().
+   */
+  uint8_t dub_response[DUB_RESPONSE_LENGTH];
+
   /**
    * @brief The ResponderDefinition
    */
@@ -369,12 +397,23 @@ void RDMResponder_ResetToFactoryDefaults();
  */
 void RDMResponder_GetUID(uint8_t *uid);
 
+/**
+ * @brief Set the UID of the responder.
+ * @param uid The new UID, must be UID_LENGTH bytes.
+ *
+ * This also rebuilds the responder's DUB response.
+ */
+void RDMResponder_SetUID(const uint8_t *uid);
+
 /**
  * @brief Handle a Discovery-unique-branch request.
  * @param param_data The DUB request param_data.
  * @param param_data_length The size of the param_data.
  * @returns The size of the RDM response frame, this will be negative to
  *   indicate no break should be sent.
+ *
+ * The response isn't built in g_rdm_buffer, instead g_rdm_response is pointed
+ * at the responder's pre-built DUB response.
  */
 int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
                                   unsigned int param_data_length);
@@ -443,6 +482,24 @@ int RDMResponder_BuildParamDescription(const RDMHeader *incoming_header,
                                        uint16_t param_id,
                                        const ParameterDescription *description);
 
+/**
+ * @brief Build a GET response for a list that may not fit in a single frame.
+ * @param incoming_header The header of the incoming frame.
+ * @param item_count The number of items in the list.
+ * @param max_item_size The largest size of a single item.
+ * @param writer The function used to write each item.
+ * @returns The size of the RDM response frame.
+ *
+ * As many whole items as fit are written to the frame. If items remain, the
+ * response is an ACK_OVERFLOW and the position is saved, so the next identical
+ * GET from the same controller continues from the following item. The last
+ * frame is sent as an ACK. Any other GET or SET abandons the saved position.
+ */
+int RDMResponder_BuildListResponse(const RDMHeader *incoming_header,
+                                   unsigned int item_count,
+                                   unsigned int max_item_size,
+                                   RDMListItemWriter writer);
+
 /**
  * @brief Invoke a PID handler from the ResponderDefinition.
  * @param incoming_header The header of the incoming frame.
@@ -456,6 +513,25 @@ int RDMResponder_BuildParamDescription(const RDMHeader *incoming_header,
 int RDMResponder_DispatchPID(const RDMHeader *incoming_header,
                              const uint8_t *param_data);
 
+/**
+ * @brief Apply a SET request to a number of responders.
+ * @param incoming_header The header of the incoming frame.
+ * @param param_data The received parameter data.
+ * @param definition The ResponderDefinition the responders share.
+ * @param select_fn Called before the SET handler runs for each responder.
+ * @param count The number of responders.
+ * @returns The size of the RDM response frame.
+ *
+ * The PID handler is looked up once. It runs for each responder in turn, but
+ * only the last one builds a response, which is the one that is returned.
+ * The caller should call RDMResponder_RestoreResponder() afterwards.
+ */
+int RDMResponder_DispatchSetToAll(const RDMHeader *incoming_header,
+                                  const uint8_t *param_data,
+                                  const ResponderDefinition *definition,
+                                  RDMResponderSelector select_fn,
+                                  unsigned int count);
+
 /**
  * @brief A base Ioctl handler.
  * @param command The ioctl command to run.
@@ -68,6 +68,48 @@ static ResponderState g_state = STATE_START_CODE;
  */
 static unsigned int g_offset = 0u;
 
+/*
+ * @brief The running checksum of the RDM frame, updated as each slot is
+ *   processed so the checksum can be verified as soon as the last slot
+ *   arrives.
+ */
+static uint16_t g_checksum = 0u;
+
+/*
+ * @brief True if DMX512 slots are passed to the SPI output.
+ */
+static bool g_spi_output = true;
+
+/*
+ * @brief The UID & UID mask of the active model, cached at the start of each
+ *   RDM frame.
+ */
+static uint8_t g_uid[UID_LENGTH];
+static uint8_t g_uid_mask[UID_LENGTH];
+
+/*
+ * @brief Check if the destination UID of a frame is one we respond to.
+ * @param dest_uid The destination UID.
+ * @returns true if the destination is the all-devices broadcast, a
+ *   manufacturer broadcast for our ESTA ID or matches our UID in all the bits
+ *   set in the mask.
+ */
+static bool IsAddressedToUs(const uint8_t *dest_uid) {
+  if (dest_uid[2] == 0xff && dest_uid[3] == 0xff && dest_uid[4] == 0xff &&
+      dest_uid[5] == 0xff) {
+    return (dest_uid[0] == 0xff && dest_uid[1] == 0xff) ||
+           (dest_uid[0] == g_uid[0] && dest_uid[1] == g_uid[1]);
+  }
+
+  unsigned int i = 0u;
+  for (; i < UID_LENGTH; i++) {
+    if ((dest_uid[i] ^ g_uid[i]) & g_uid_mask[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*
  * @brief Call the RDM handler when we have a complete and valid frame.
  */
@@ -91,10 +133,8 @@ static inline void DispatchRDMRequest(const uint8_t *frame) {
  * @brief Increment the bad-checksum counter if the frame was for us.
  */
 static inline void PossiblyIncrementChecksumCounter(const uint8_t *frame) {
-  uint8_t uid[UID_LENGTH];
-  RDMHandler_GetUID(uid);
   RDMHeader *header = (RDMHeader*) frame;
-  if (RDMUtil_RequiresAction(uid, header->dest_uid)) {
+  if (RDMUtil_RequiresAction(g_uid, header->dest_uid)) {
     SysLog_Message(SYSLOG_ERROR, "Checksum mismatch");
     g_responder_counters.rdm_checksum_invalid++;
   }
@@ -105,17 +145,21 @@ static inline void PossiblyIncrementChecksumCounter(const uint8_t *frame) {
  */
 static inline void PossiblyIncrementLengthMismatchCounter(
     const uint8_t *frame) {
-  uint8_t uid[UID_LENGTH];
-  RDMHandler_GetUID(uid);
   RDMHeader *header = (RDMHeader*) frame;
-  if (RDMUtil_RequiresAction(uid, header->dest_uid)) {
+  if (RDMUtil_RequiresAction(g_uid, header->dest_uid)) {
     g_responder_counters.rdm_length_mismatch++;
   }
 }
 
 // Public Functions
 // ----------------------------------------------------------------------------
-void Responder_Initialize() {}
+void Responder_Initialize() {
+  g_spi_output = true;
+}
+
+void Responder_SetSPIOutput(bool enabled) {
+  g_spi_output = enabled;
+}
 
 void Responder_Receive(const TransceiverEvent *event) {
   // While this function is running, UART interrupts are disabled.
@@ -150,7 +194,9 @@ void Responder_Receive(const TransceiverEvent *event) {
   }
 
   if (event->result == T_RESULT_RX_FRAME_TIMEOUT) {
-    SPIRGB_CompleteUpdate();
+    if (g_spi_output) {
+      SPIRGB_CompleteUpdate();
+    }
     return;
   }
 
@@ -164,8 +210,13 @@ void Responder_Receive(const TransceiverEvent *event) {
           SysLog_Message(SYSLOG_DEBUG, "DMX frame");
           g_responder_counters.dmx_frames++;
           g_state = STATE_DMX_DATA;
-          SPIRGB_BeginUpdate();
+          if (g_spi_output) {
+            SPIRGB_BeginUpdate();
+          }
         } else if (b == RDM_START_CODE) {
+          g_checksum = b;
+          RDMHandler_GetUID(g_uid);
+          RDMHandler_GetUIDMask(g_uid_mask);
           g_responder_counters.rdm_frames++;
           g_state = STATE_RDM_SUB_START_CODE;
         } else {
@@ -181,6 +232,7 @@ void Responder_Receive(const TransceiverEvent *event) {
           g_responder_counters.rdm_sub_start_code_invalid++;
           g_state = STATE_DISCARD;
         } else {
+          g_checksum += b;
           g_state = STATE_RDM_MESSAGE_LENGTH;
         }
         break;
@@ -190,11 +242,18 @@ void Responder_Receive(const TransceiverEvent *event) {
           g_responder_counters.rdm_msg_len_invalid++;
           g_state = STATE_DISCARD;
         } else {
+          g_checksum += b;
           g_state = STATE_RDM_BODY;
         }
         break;
       // data[2] is at least 24
       case STATE_RDM_BODY:
+        if (g_offset == DESTINATION_UID_OFFSET + UID_LENGTH - 1u &&
+            !IsAddressedToUs(event->data + DESTINATION_UID_OFFSET)) {
+          // Not for us, skip the rest of the frame without checksumming it.
+          g_state = STATE_DISCARD;
+          continue;
+        }
         if (g_offset == RDM_PARAM_DATA_LENGTH_OFFSET) {
           if (b != event->data[MESSAGE_LENGTH_OFFSET] - sizeof(RDMHeader)) {
             SysLog_Print(SYSLOG_INFO, "Invalid RDM PDL: %d, msg len: %d",
@@ -204,6 +263,7 @@ void Responder_Receive(const TransceiverEvent *event) {
             continue;
           }
         }
+        g_checksum += b;
         if (g_offset + 1u == event->data[MESSAGE_LENGTH_OFFSET]) {
           g_state = STATE_RDM_CHECKSUM_LO;
         }
@@ -212,7 +272,9 @@ void Responder_Receive(const TransceiverEvent *event) {
         g_state = STATE_RDM_CHECKSUM_HI;
         break;
       case STATE_RDM_CHECKSUM_HI:
-        if (RDMUtil_VerifyChecksum(event->data, event->length)) {
+        // Any slots after the checksum mean the length is wrong.
+        if (g_offset + 1u == event->length &&
+            g_checksum == JoinShort(event->data[g_offset - 1u], b)) {
           DispatchRDMRequest(event->data);
         } else {
           PossiblyIncrementChecksumCounter(event->data);
@@ -225,10 +287,10 @@ void Responder_Receive(const TransceiverEvent *event) {
         break;
       case STATE_DMX_DATA:
         // TODO(simon): configure this with DMX_START_ADDRESS and footprints.
-        if (g_offset - 1u < 6u) {
-          SPIRGB_SetPixel((g_offset - 1u) / 3u, (g_offset - 1u) % 3u, b);
-        } else if (g_offset - 1u == 6u) {
-          SPIRGB_CompleteUpdate();
+        if (g_offset - 1u < DMX_FRAME_SIZE) {
+          if (g_spi_output && SPIRGB_SetSlot(g_offset - 1u, b)) {
+            SPIRGB_CompleteUpdate();
+          }
         }
 
         g_responder_counters.dmx_last_checksum += b;
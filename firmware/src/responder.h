@@ -33,6 +33,8 @@
 #ifndef FIRMWARE_SRC_RESPONDER_H_
 #define FIRMWARE_SRC_RESPONDER_H_
 
+#include <stdbool.h>
+
 #include "transceiver.h"
 
 #ifdef __cplusplus
@@ -44,6 +46,13 @@ extern "C" {
  */
 void Responder_Initialize();
 
+/**
+ * @brief Control if DMX512 slots are passed to the SPI output.
+ * @param enabled true if the responder should drive the SPI output, false if
+ *   the active model drives it instead.
+ */
+void Responder_SetSPIOutput(bool enabled);
+
 /**
  * @brief Called when data is received.
  * @param event The transceiver event.
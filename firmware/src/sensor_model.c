@@ -22,6 +22,7 @@
 
 #include "coarse_timer.h"
 #include "constants.h"
+#include "random.h"
 #include "rdm_frame.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
@@ -141,6 +142,11 @@ static void SensorModel_Tasks() {
   }
 }
 
+const ResponderDefinition *const SENSOR_MODEL_DEFINITIONS[] = {
+  &RESPONDER_DEFINITION,
+  NULL
+};
+
 const ModelEntry SENSOR_MODEL_ENTRY = {
   .model_id = SENSOR_MODEL_ID,
   .activate_fn = SensorModel_Activate,
@@ -33,6 +33,7 @@
 #define FIRMWARE_SRC_SENSOR_MODEL_H_
 
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +44,14 @@ extern "C" {
  */
 extern const ModelEntry SENSOR_MODEL_ENTRY;
 
+/**
+ * @brief The ResponderDefinitions used by the model, terminated by NULL.
+ *
+ * RDMResponder_DispatchPID() requires each descriptor table to be sorted by
+ * PID, this allows the tests to check all of them.
+ */
+extern const ResponderDefinition *const SENSOR_MODEL_DEFINITIONS[];
+
 /**
  * @brief Initialize the sensor model.
  */
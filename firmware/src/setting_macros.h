@@ -115,6 +115,22 @@
  */
 #define AS_USART_INTERRUPT_ERROR_SOURCE(id) _CAT3(INT_SOURCE_USART_, id, _ERROR)
 
+/**
+ * @def AS_USART_DMA_TX_TRIGGER
+ * @brief Expands to a DMA_TRIGGER_SOURCE.
+ * @param id The USART module id.
+ * @returns The DMA trigger for the USART TX interrupt.
+ */
+#define AS_USART_DMA_TX_TRIGGER(id) _CAT3(DMA_TRIGGER_USART_, id, _TRANSMIT)
+
+/**
+ * @def AS_USART_DMA_RX_TRIGGER
+ * @brief Expands to a DMA_TRIGGER_SOURCE.
+ * @param id The USART module id.
+ * @returns The DMA trigger for the USART RX interrupt.
+ */
+#define AS_USART_DMA_RX_TRIGGER(id) _CAT3(DMA_TRIGGER_USART_, id, _RECEIVE)
+
 /**
  * @def AS_IC_ID
  * @brief Expands to a IC_MODULE_ID.
@@ -155,6 +171,38 @@
  */
 #define AS_IC_TMR_ID(id) _CAT2(IC_TIMER_TMR, id)
 
+/**
+ * @def AS_DMA_CHANNEL
+ * @brief Expands to a DMA_CHANNEL.
+ * @param id The DMA channel number.
+ * @returns The corresponding DMA_CHANNEL.
+ */
+#define AS_DMA_CHANNEL(id) _CAT2(DMA_CHANNEL_, id)
+
+/**
+ * @def AS_DMA_ISR_VECTOR
+ * @brief Expands to an ISR vector number.
+ * @param id The DMA channel number.
+ * @returns The corresponding ISR vector
+ */
+#define AS_DMA_ISR_VECTOR(id) _CAT3(_DMA_, id, _VECTOR)
+
+/**
+ * @def AS_DMA_INTERRUPT_SOURCE
+ * @brief Expands to a INT_SOURCE.
+ * @param id The DMA channel number.
+ * @returns The corresponding INT_SOURCE.
+ */
+#define AS_DMA_INTERRUPT_SOURCE(id) _CAT2(INT_SOURCE_DMA_, id)
+
+/**
+ * @def AS_DMA_INTERRUPT_VECTOR
+ * @brief Expands to an INT_VECTOR.
+ * @param id The DMA channel number.
+ * @returns The corresponding vector
+ */
+#define AS_DMA_INTERRUPT_VECTOR(id) _CAT2(INT_VECTOR_DMA, id)
+
 /**
  * @}
  */
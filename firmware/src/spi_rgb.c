@@ -21,47 +21,363 @@
 
 #include <string.h>
 
+#include "coarse_timer.h"
+#include "dimmer_curve.h"
+#include "dmx_spec.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/spi/plib_spi.h"
+#include "sys/kmem.h"
 #include "syslog.h"
+#include "system/int/sys_int.h"
 
-// TODO(simon): move these into the config (and set with RDM?)
-static const uint8_t LPD8806_PIXEL_BYTE = 0x80u;
-
-enum { LATCH_BYTES = 1u };
-enum { PIXEL_COUNT = 2u };
 enum { SLOTS_PER_PIXEL = 3u };
 
+// The DMA size registers on the PIC32MX are 8 bits wide, so a block is at most
+// 256 bytes. Larger frames are sent as a chain of blocks.
+enum { DMA_MAX_BLOCK_SIZE = 256u };
+
+/*
+ * @brief The largest frame any encoder produces.
+ *
+ * This is APA102 at the maximum pixel count: a 4 byte start frame, 4 bytes
+ * per pixel and an end frame of one byte per 16 pixels.
+ */
+enum {
+  MAX_FRAME_SIZE = 4u + 4u * SPIRGB_MAX_PIXEL_COUNT +
+                   (SPIRGB_MAX_PIXEL_COUNT + 15u) / 16u
+};
+
+/*
+ * @brief Describes how a pixel protocol lays out a frame.
+ */
+typedef struct {
+  PixelType type;
+  uint8_t start_size;  //!< The number of 0 bytes before the first pixel.
+  uint8_t pixel_size;  //!< The number of bytes per pixel.
+  uint8_t pixel_prefix;  //!< The value of the first byte in a 4 byte pixel.
+  uint8_t offsets[SLOTS_PER_PIXEL];  //!< The R, G & B offsets in a pixel.
+  uint8_t value_mask;  //!< OR'ed into each encoded value.
+  uint8_t value_shift;  //!< Each value is right shifted by this amount.
+  /**
+   * @brief The number of pixels per trailing 0 byte, or 0 if there isn't a
+   * latch / end frame.
+   */
+  uint8_t pixels_per_latch_byte;
+  /**
+   * @brief The time the clock must idle between frames, in 10ths of a
+   * millisecond, or 0 if frames can be sent back to back.
+   */
+  uint8_t latch_time;
+  SPI_CLOCK_POLARITY clock_polarity;
+  SPI_OUTPUT_DATA_PHASE data_phase;
+} PixelEncoder;
+
+/*
+ * All the pixels sample data on the rising edge of the clock.
+ */
+static const PixelEncoder ENCODERS[] = {
+  // LPD8806: GRB, 7 bit values with the MSB set, and a latch of one 0 byte
+  // per 32 pixels.
+  {PIXEL_TYPE_LPD8806, 0u, 3u, 0u, {1u, 0u, 2u}, 0x80u, 1u, 32u, 0u,
+   SPI_CLOCK_POLARITY_IDLE_HIGH,
+   SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK},
+  // WS2801: RGB, latched by holding the clock low for 500uS.
+  {PIXEL_TYPE_WS2801, 0u, 3u, 0u, {0u, 1u, 2u}, 0u, 0u, 0u, 5u,
+   SPI_CLOCK_POLARITY_IDLE_LOW,
+   SPI_OUTPUT_DATA_PHASE_ON_ACTIVE_TO_IDLE_CLOCK},
+  // APA102: 4 byte start frame, then 0xff (full global brightness) followed
+  // by BGR. The end frame clocks the data through the strip; we use 0s rather
+  // than 1s so that any pixels beyond pixel_count stay dark.
+  {PIXEL_TYPE_APA102, 4u, 4u, 0xffu, {3u, 2u, 1u}, 0u, 0u, 16u, 0u,
+   SPI_CLOCK_POLARITY_IDLE_HIGH,
+   SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK},
+};
+
 typedef struct {
   SPI_MODULE_ID module_id;
   bool use_enhanced_buffering;
+  bool use_dma;
+  DMA_CHANNEL dma_channel;
+  INT_SOURCE dma_source;
   bool in_update;
-  uint32_t tx_index;
-  uint8_t pixels[SLOTS_PER_PIXEL * PIXEL_COUNT + LATCH_BYTES];
+  bool frame_ready;  //!< The back buffer holds a frame waiting to be sent.
+  bool tx_active;  //!< The front buffer is being sent.
+  CoarseTimer_Value tx_end;  //!< When the clock went idle.
+  /**
+   * @brief The next byte to send, or the end of the DMA block.
+   *
+   * With DMA, this is advanced by SPIRGB_DMAEvent().
+   */
+  uint16_t tx_index;
+  uint16_t frame_size;
+  uint16_t slot_count;
+  const PixelEncoder *encoder;
+  bool use_curve;
+  DimmerCurve curve;
+
+  /**
+   * @brief Maps a DMX value to the byte sent on the wire.
+   *
+   * This includes the curve, so it costs nothing per slot.
+   */
+  uint8_t encode[DIMMER_CURVE_TABLE_SIZE];
+
+  /**
+   * @brief Maps a slot to an offset in a frame.
+   *
+   * Slots without a pixel map to the sink byte at MAX_FRAME_SIZE.
+   */
+  uint16_t slot_offsets[DMX_FRAME_SIZE];
+
+  uint8_t *front;  //!< The frame being sent.
+  uint8_t *back;  //!< The frame being updated.
+  uint8_t frames[2u][MAX_FRAME_SIZE + 1u];
 } SPIState;
 
 static SPIState g_spi;
 
+static const PixelEncoder *LookupEncoder(PixelType type) {
+  unsigned int i = 0u;
+  for (; i < sizeof(ENCODERS) / sizeof(PixelEncoder); i++) {
+    if (ENCODERS[i].type == type) {
+      return &ENCODERS[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * @brief Build the encode table from the encoder and the curve.
+ */
+static void BuildEncodeTable() {
+  const PixelEncoder *encoder = g_spi.encoder;
+  const DimmerCurve *curve = g_spi.use_curve ? &g_spi.curve : NULL;
+  unsigned int i = 0u;
+  for (; i < DIMMER_CURVE_TABLE_SIZE; i++) {
+    g_spi.encode[i] = encoder->value_mask |
+                      (DimmerCurve_Apply(curve, i) >> encoder->value_shift);
+  }
+}
+
+/*
+ * @brief Write as much of the front buffer to the SPI module as it will take.
+ */
+static void WriteBytes() {
+  while (g_spi.tx_index < g_spi.frame_size) {
+    if (g_spi.use_enhanced_buffering) {
+      if (PLIB_SPI_TransmitBufferIsFull(g_spi.module_id)) {
+        return;
+      }
+    } else if (PLIB_SPI_IsBusy(g_spi.module_id)) {
+      return;
+    }
+    PLIB_SPI_BufferWrite(g_spi.module_id, g_spi.front[g_spi.tx_index]);
+    g_spi.tx_index++;
+  }
+}
+
+/*
+ * @brief Hand the next block of the front buffer to the DMA channel.
+ */
+static void StartDMABlock() {
+  uint16_t block_size = g_spi.frame_size - g_spi.tx_index;
+  if (block_size > DMA_MAX_BLOCK_SIZE) {
+    block_size = DMA_MAX_BLOCK_SIZE;
+  }
+  PLIB_DMA_ChannelXSourceStartAddressSet(
+      DMA_ID_0, g_spi.dma_channel, KVA_TO_PA(g_spi.front + g_spi.tx_index));
+  PLIB_DMA_ChannelXSourceSizeSet(DMA_ID_0, g_spi.dma_channel, block_size);
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, g_spi.dma_channel,
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  PLIB_DMA_ChannelXEnable(DMA_ID_0, g_spi.dma_channel);
+  g_spi.tx_index += block_size;
+}
+
+/*
+ * @brief Check if the front buffer has been sent.
+ */
+static bool IsTXComplete() {
+  if (g_spi.use_dma) {
+    // SPIRGB_DMAEvent() starts each block after the first, so the frame has
+    // been sent once the last block has been started and has completed.
+    return g_spi.tx_index == g_spi.frame_size &&
+           (g_spi.frame_size == 0u ||
+            PLIB_DMA_ChannelXINTSourceFlagGet(
+                DMA_ID_0, g_spi.dma_channel, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  }
+  WriteBytes();
+  return g_spi.tx_index == g_spi.frame_size;
+}
+
+/*
+ * @brief Check if the SPI module is ready for the next frame.
+ *
+ * This waits for the front buffer to be sent and, for pixels latched by an
+ * idle clock, for the latch time to pass.
+ */
+static bool IsReady() {
+  const uint8_t latch_time = g_spi.encoder->latch_time;
+  if (g_spi.tx_active) {
+    if (!IsTXComplete() ||
+        (latch_time && PLIB_SPI_IsBusy(g_spi.module_id))) {
+      return false;
+    }
+    g_spi.tx_active = false;
+    g_spi.tx_end = CoarseTimer_GetTime();
+  }
+  // HasElapsed() is strict, so the clock idles for at least latch_time.
+  return latch_time == 0u || CoarseTimer_HasElapsed(g_spi.tx_end, latch_time);
+}
+
+/*
+ * @brief Swap the buffers and start sending the new front buffer.
+ */
+static void StartTX() {
+  uint8_t *frame = g_spi.front;
+  g_spi.front = g_spi.back;
+  g_spi.back = frame;
+  // The next update may not touch every slot, so start from the current frame.
+  memcpy(g_spi.back, g_spi.front, g_spi.frame_size);
+
+  g_spi.frame_ready = false;
+  g_spi.tx_active = true;
+  g_spi.tx_index = 0u;
+
+  if (g_spi.use_dma) {
+    if (g_spi.frame_size) {
+      StartDMABlock();
+      SYS_INT_SourceStatusClear(g_spi.dma_source);
+      SYS_INT_SourceEnable(g_spi.dma_source);
+    }
+  } else {
+    WriteBytes();
+  }
+}
+
 void SPIRGB_Init(const SPIRGBConfiguration *config) {
   g_spi.module_id = config->module_id;
   g_spi.use_enhanced_buffering = config->use_enhanced_buffering;
+  g_spi.use_dma = config->use_dma;
+  g_spi.dma_channel = config->dma_channel;
+  g_spi.dma_source = config->dma_source;
   g_spi.in_update = false;
-  g_spi.tx_index = 0u;
-
-  memset(g_spi.pixels, LPD8806_PIXEL_BYTE, SLOTS_PER_PIXEL * PIXEL_COUNT);
-  memset(&g_spi.pixels[SLOTS_PER_PIXEL * PIXEL_COUNT], 0, LATCH_BYTES);
+  g_spi.tx_active = false;
+  g_spi.front = g_spi.frames[0];
+  g_spi.back = g_spi.frames[1];
 
-  // Init the SPI hardware.
+  // Init the SPI hardware. The clock mode depends on the pixel type, so
+  // SPIRGB_Configure() sets it and enables the module.
   PLIB_SPI_BaudRateSet(g_spi.module_id, SYS_CLK_FREQ, config->baud_rate);
   PLIB_SPI_CommunicationWidthSelect(g_spi.module_id,
                                     SPI_COMMUNICATION_WIDTH_8BITS);
-  PLIB_SPI_ClockPolaritySelect(g_spi.module_id, SPI_CLOCK_POLARITY_IDLE_HIGH);
   if (g_spi.use_enhanced_buffering) {
     PLIB_SPI_FIFOEnable(g_spi.module_id);
+    if (g_spi.use_dma) {
+      PLIB_SPI_FIFOInterruptModeSelect(
+          g_spi.module_id, SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL);
+    }
   }
   PLIB_SPI_SlaveSelectDisable(g_spi.module_id);
   PLIB_SPI_PinDisable(g_spi.module_id, SPI_PIN_SLAVE_SELECT);
   PLIB_SPI_MasterEnable(g_spi.module_id);
+
+  // Setup the DMA channel, one byte is moved into the SPI TX buffer each time
+  // the TX interrupt is raised. The priorities are below the transceiver's,
+  // since the DMX timing is stricter than the pixel timing.
+  if (g_spi.use_dma) {
+    PLIB_DMA_Enable(DMA_ID_0);
+    PLIB_DMA_ChannelXDisable(DMA_ID_0, g_spi.dma_channel);
+    PLIB_DMA_ChannelXPrioritySelect(DMA_ID_0, g_spi.dma_channel,
+                                    DMA_CHANNEL_PRIORITY_1);
+    PLIB_DMA_ChannelXStartIRQSet(DMA_ID_0, g_spi.dma_channel,
+                                 config->dma_trigger);
+    PLIB_DMA_ChannelXTriggerEnable(DMA_ID_0, g_spi.dma_channel,
+                                   DMA_CHANNEL_TRIGGER_TRANSFER_START);
+    PLIB_DMA_ChannelXDestinationStartAddressSet(
+        DMA_ID_0, g_spi.dma_channel,
+        KVA_TO_PA(PLIB_SPI_BufferAddressGet(g_spi.module_id)));
+    PLIB_DMA_ChannelXDestinationSizeSet(DMA_ID_0, g_spi.dma_channel, 1u);
+    PLIB_DMA_ChannelXCellSizeSet(DMA_ID_0, g_spi.dma_channel, 1u);
+    PLIB_DMA_ChannelXINTSourceEnable(DMA_ID_0, g_spi.dma_channel,
+                                     DMA_INT_BLOCK_TRANSFER_COMPLETE);
+
+    SYS_INT_VectorPrioritySet(config->dma_vector, INT_PRIORITY_LEVEL5);
+    SYS_INT_VectorSubprioritySet(config->dma_vector, INT_SUBPRIORITY_LEVEL0);
+  }
+
+  SPIRGB_Configure(PIXEL_TYPE_LPD8806, SPIRGB_DEFAULT_PIXEL_COUNT);
+}
+
+bool SPIRGB_Configure(PixelType type, uint16_t pixel_count) {
+  const PixelEncoder *encoder = LookupEncoder(type);
+  if (encoder == NULL || pixel_count > SPIRGB_MAX_PIXEL_COUNT) {
+    return false;
+  }
+
+  g_spi.encoder = encoder;
+  BuildEncodeTable();
+
+  uint16_t latch_size = 0u;
+  if (encoder->pixels_per_latch_byte) {
+    latch_size = (pixel_count + encoder->pixels_per_latch_byte - 1u) /
+                 encoder->pixels_per_latch_byte;
+  }
+  g_spi.frame_size = encoder->start_size + pixel_count * encoder->pixel_size +
+                     latch_size;
+  g_spi.slot_count = pixel_count * SLOTS_PER_PIXEL;
+
+  if (g_spi.tx_active && g_spi.use_dma) {
+    SYS_INT_SourceDisable(g_spi.dma_source);
+    SYS_INT_SourceStatusClear(g_spi.dma_source);
+    PLIB_DMA_ChannelXDisable(DMA_ID_0, g_spi.dma_channel);
+  }
+  g_spi.tx_active = false;
+
+  // The clock mode can only be changed while the module is off. Any frame in
+  // progress was cut short, so the clock idles from now.
+  PLIB_SPI_Disable(g_spi.module_id);
+  PLIB_SPI_ClockPolaritySelect(g_spi.module_id, encoder->clock_polarity);
+  PLIB_SPI_OutputDataPhaseSelect(g_spi.module_id, encoder->data_phase);
   PLIB_SPI_Enable(g_spi.module_id);
+  g_spi.tx_end = CoarseTimer_GetTime();
+
+  // Start and end frames are 0, the pixels are off.
+  memset(g_spi.frames, 0, sizeof(g_spi.frames));
+
+  uint16_t pixel = 0u;
+  for (; pixel < pixel_count; pixel++) {
+    const uint16_t offset = encoder->start_size + pixel * encoder->pixel_size;
+    if (encoder->pixel_size > SLOTS_PER_PIXEL) {
+      g_spi.back[offset] = encoder->pixel_prefix;
+    }
+    uint8_t color = 0u;
+    for (; color < SLOTS_PER_PIXEL; color++) {
+      g_spi.slot_offsets[pixel * SLOTS_PER_PIXEL + color] =
+          offset + encoder->offsets[color];
+      g_spi.back[offset + encoder->offsets[color]] = g_spi.encode[0];
+    }
+  }
+
+  unsigned int i = g_spi.slot_count;
+  for (; i < DMX_FRAME_SIZE; i++) {
+    g_spi.slot_offsets[i] = MAX_FRAME_SIZE;
+  }
+
+  // Send the cleared frame.
+  g_spi.in_update = false;
+  g_spi.frame_ready = true;
+  return true;
+}
+
+void SPIRGB_SetCurve(const DimmerCurve *curve) {
+  g_spi.use_curve = curve != NULL;
+  if (curve) {
+    g_spi.curve = *curve;
+  }
+  // Otherwise SPIRGB_Configure() will build the table.
+  if (g_spi.encoder) {
+    BuildEncodeTable();
+  }
 }
 
 void SPIRGB_BeginUpdate() {
@@ -69,45 +385,43 @@ void SPIRGB_BeginUpdate() {
 }
 
 void SPIRGB_SetPixel(uint16_t index, RGB_Color color, uint8_t value) {
-  if (index >= PIXEL_COUNT || !g_spi.in_update) {
+  if (index >= g_spi.slot_count / SLOTS_PER_PIXEL || !g_spi.in_update) {
     return;
   }
-  // Map RGB to GRB
-  uint8_t color_offset = 0u;
-  switch (color) {
-    case RED:
-      color_offset = 1u;
-      break;
-    case GREEN:
-      color_offset = 0u;
-      break;
-    case BLUE:
-      color_offset = 2u;
-      break;
-    }
-  g_spi.pixels[index * SLOTS_PER_PIXEL + color_offset] =
-      LPD8806_PIXEL_BYTE | value >> 1;
+  g_spi.back[g_spi.slot_offsets[index * SLOTS_PER_PIXEL + color]] =
+      g_spi.encode[value];
+}
+
+bool SPIRGB_SetSlot(uint16_t slot, uint8_t value) {
+  g_spi.back[g_spi.slot_offsets[slot]] = g_spi.encode[value];
+  return slot + 1u == g_spi.slot_count;
 }
 
 void SPIRGB_CompleteUpdate() {
+  if (!g_spi.in_update) {
+    return;
+  }
   g_spi.in_update = false;
-  g_spi.tx_index = 0u;
+  g_spi.frame_ready = true;
+
+  if (IsReady()) {
+    StartTX();
+  }
 }
 
-void SPIRGB_Tasks() {
-  if (g_spi.in_update) {
-    return;
+void SPIRGB_DMAEvent() {
+  if (g_spi.tx_index == g_spi.frame_size) {
+    // The frame has been sent. Leave the flag set so IsTXComplete() sees the
+    // final block.
+    SYS_INT_SourceDisable(g_spi.dma_source);
+  } else {
+    StartDMABlock();
   }
+  SYS_INT_SourceStatusClear(g_spi.dma_source);
+}
 
-  while (g_spi.tx_index < PIXEL_COUNT * SLOTS_PER_PIXEL + LATCH_BYTES) {
-    if (g_spi.use_enhanced_buffering) {
-      if (PLIB_SPI_TransmitBufferIsFull(g_spi.module_id)) {
-        return;
-      }
-    } else if (PLIB_SPI_IsBusy(g_spi.module_id)) {
-      return;
-    }
-    PLIB_SPI_BufferWrite(g_spi.module_id, g_spi.pixels[g_spi.tx_index]);
-    g_spi.tx_index++;
+void SPIRGB_Tasks() {
+  if (IsReady() && g_spi.frame_ready && !g_spi.in_update) {
+    StartTX();
   }
 }
@@ -21,8 +21,34 @@
  * @defgroup spi_dmx SPI Pixel Controller
  * @brief Control RGB Pixels using SPI
  *
- * This only supports the LPD8806 chip for now. We're happy to accept pull
- * requests adding support for different pixel types.
+ * Supports LPD8806, WS2801 and APA102 pixels, up to a full universe of RGB
+ * pixels. We're happy to accept pull requests adding support for different
+ * pixel types.
+ *
+ * @par Encoding
+ *
+ * SPIRGB_Configure() builds two tables: one that maps a DMX value to the byte
+ * sent on the wire for the pixel type, and one that maps each DMX slot to an
+ * offset in the SPI frame. Applying a slot with SPIRGB_SetSlot() is then a
+ * lookup and a store, which keeps the per-slot work in the receive path
+ * constant regardless of the pixel type. The dimmer curve set with
+ * SPIRGB_SetCurve() is folded into the first table, so it's free at runtime.
+ *
+ * @par Output
+ *
+ * There are two frame buffers. Updates are written to the back buffer while
+ * the front buffer is sent, so decoding the next DMX frame never waits on the
+ * SPI output. SPIRGB_CompleteUpdate() swaps the buffers if the output is idle,
+ * otherwise the swap happens in SPIRGB_Tasks() once the current frame has been
+ * sent. WS2801 pixels latch when the clock idles low for 500uS, so for those
+ * the next frame also waits for the latch time to pass.
+ *
+ * With use_dma, the front buffer is moved into the SPI TX buffer by a DMA
+ * channel triggered by the SPI TX interrupt, so sending a frame costs no CPU
+ * time. A block is at most 256 bytes, so SPIRGB_DMAEvent() starts the next
+ * block from the block complete interrupt. The SPI TX buffer covers the
+ * interrupt latency, so the clock doesn't idle mid-frame. Otherwise
+ * SPIRGB_Tasks() writes the bytes, which requires it to be called frequently.
  *
  * @addtogroup spi_dmx
  * @{
@@ -39,7 +65,32 @@ extern "C" {
 #endif
 
 #include "system_config.h"
+#include "dimmer_curve.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/spi/plib_spi.h"
+#include "system/int/sys_int.h"
+
+/**
+ * @brief The maximum number of RGB pixels, one full universe.
+ */
+#define SPIRGB_MAX_PIXEL_COUNT 170u
+
+/**
+ * @brief The number of RGB pixels after SPIRGB_Init().
+ */
+#define SPIRGB_DEFAULT_PIXEL_COUNT 2u
+
+/**
+ * @brief The pixel types.
+ *
+ * The values match those used by PID_PIXEL_TYPE.
+ */
+typedef enum {
+  PIXEL_TYPE_LPD8806 = 0x0001,  //!< LPD8806, GRB order.
+  PIXEL_TYPE_WS2801 = 0x0002,  //!< WS2801, RGB order.
+  // PIXEL_TYPE_P9813 = 0x0003,
+  PIXEL_TYPE_APA102 = 0x0004,  //!< APA102, BGR order.
+} PixelType;
 
 /**
  * @brief RGB color values.
@@ -64,6 +115,12 @@ typedef struct {
    * normal mode there may be delays between bytes.
    */
   bool use_enhanced_buffering;
+
+  bool use_dma;  //!< Send frames using DMA.
+  DMA_CHANNEL dma_channel;  //!< The DMA channel to use.
+  DMA_TRIGGER_SOURCE dma_trigger;  //!< The SPI TX trigger for the DMA channel.
+  INT_VECTOR dma_vector;  //!< The vector to use for the DMA channel.
+  INT_SOURCE dma_source;  //!< The source of DMA channel interrupts.
 } SPIRGBConfiguration;
 
 /**
@@ -72,10 +129,33 @@ typedef struct {
  */
 void SPIRGB_Init(const SPIRGBConfiguration *config);
 
+/**
+ * @brief Change the pixel type and count.
+ * @param type The type of pixels.
+ * @param pixel_count The number of RGB pixels, up to SPIRGB_MAX_PIXEL_COUNT.
+ * @returns true if the configuration was applied, false if the type or count
+ *   was invalid.
+ *
+ * This rebuilds the encoding tables, sets the SPI clock mode for the pixel
+ * type and resets all pixels to off. It aborts any update that is in
+ * progress.
+ */
+bool SPIRGB_Configure(PixelType type, uint16_t pixel_count);
+
+/**
+ * @brief Set the curve & level limits applied to all slots.
+ * @param curve The curve to apply, or NULL for a linear curve with no limits.
+ *   The curve is copied.
+ *
+ * This takes effect from the next update.
+ */
+void SPIRGB_SetCurve(const DimmerCurve *curve);
+
 /**
  * @brief Begin a frame update.
  *
- * This pauses the SPI sending task.
+ * Until SPIRGB_CompleteUpdate() is called, changes are made to the back
+ * buffer and won't be sent.
  */
 void SPIRGB_BeginUpdate();
 
@@ -87,11 +167,24 @@ void SPIRGB_BeginUpdate();
  */
 void SPIRGB_SetPixel(uint16_t index, RGB_Color color, uint8_t value);
 
+/**
+ * @brief Set the value of a slot.
+ * @param slot The zero-indexed slot, must be less than DMX_FRAME_SIZE.
+ * @param value The new value for the slot.
+ * @returns true if this was the last slot used by the pixels, at which point
+ *   SPIRGB_CompleteUpdate() can be called.
+ *
+ * This is called for each slot of a DMX frame, so the slot isn't range
+ * checked. Slots beyond the pixels are discarded. Slots 0, 1 & 2 are the R, G
+ * & B values of the first pixel and so on.
+ */
+bool SPIRGB_SetSlot(uint16_t slot, uint8_t value);
+
 /**
  * @brief Complete a frame update.
  *
- * This unpauses the SPI sending task. The frame will be sent on the next call
- * to SPIRGB_Tasks().
+ * The frame is sent as soon as the previous frame has been sent. If another
+ * update completes before then, the frame is replaced by the newer one.
  */
 void SPIRGB_CompleteUpdate();
 
@@ -102,6 +195,13 @@ void SPIRGB_CompleteUpdate();
  */
 void SPIRGB_Tasks();
 
+/**
+ * @brief Handle the DMA block complete interrupt.
+ *
+ * This should be called from the ISR for the DMA channel.
+ */
+void SPIRGB_DMAEvent();
+
 #ifdef __cplusplus
 }
 #endif
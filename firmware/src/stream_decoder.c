@@ -31,6 +31,9 @@
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
+// The size of the message header, including the SOM.
+enum { HEADER_SIZE = 6u };
+
 // The state indicates the next byte we expect
 
 typedef enum {
@@ -57,6 +60,46 @@ typedef struct {
 
 StreamDecoderData g_stream_data;
 
+static inline void DispatchMessage() {
+#ifdef PIPELINE_HANDLE_MESSAGE
+  PIPELINE_HANDLE_MESSAGE(&g_stream_data.message);
+#else
+  g_stream_data.handler(&g_stream_data.message);
+#endif
+}
+
+/*
+ * @brief Decode a message that is entirely contained within the buffer.
+ * @param data A pointer to the SOM.
+ * @param size The number of bytes available, starting at the SOM.
+ * @returns The size of the message, including the SOM & EOM, or 0 if the
+ *   buffer doesn't contain the complete message.
+ *
+ * This avoids running the state machine a byte at a time, and always points
+ * the payload into the caller's buffer.
+ */
+static inline unsigned int DecodeCompleteMessage(const uint8_t* data,
+                                                 unsigned int size) {
+  if (size < HEADER_SIZE + 1u) {
+    return 0u;
+  }
+
+  uint16_t length = data[4] | (data[5] << 8);
+  unsigned int message_size = HEADER_SIZE + length + 1u;
+  if (size < message_size) {
+    return 0u;
+  }
+
+  if (data[message_size - 1u] == END_OF_MESSAGE_ID) {
+    g_stream_data.message.token = data[1];
+    g_stream_data.message.command = data[2] | (data[3] << 8);
+    g_stream_data.message.length = length;
+    g_stream_data.message.payload = length ? data + HEADER_SIZE : NULL;
+    DispatchMessage();
+  }
+  return message_size;
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void StreamDecoder_Initialize(MessageHandler handler) {
@@ -89,13 +132,21 @@ void StreamDecoder_Process(const uint8_t* data, unsigned int size) {
 
   const uint8_t *end = data + size;
   uint32_t payload_size;
+  unsigned int message_size;
 
   while (data < end) {
     switch (g_stream_data.state) {
       case START_OF_MESSAGE:
         for (; data < end; data++) {
           if (*data == START_OF_MESSAGE_ID) {
-            g_stream_data.state = TOKEN;
+            // If the entire message is in the buffer, decode it in one go.
+            // Otherwise fall back to the state machine.
+            message_size = DecodeCompleteMessage(data, end - data);
+            if (message_size) {
+              data += message_size - 1u;
+            } else {
+              g_stream_data.state = TOKEN;
+            }
             break;
           }
         }
@@ -154,11 +205,7 @@ void StreamDecoder_Process(const uint8_t* data, unsigned int size) {
         break;
       case END_OF_MESSAGE:
         if (*data == END_OF_MESSAGE_ID) {
-#ifdef PIPELINE_HANDLE_MESSAGE
-          PIPELINE_HANDLE_MESSAGE(&g_stream_data.message);
-#else
-          g_stream_data.handler(&g_stream_data.message);
-#endif
+          DispatchMessage();
         }
         g_stream_data.fragment_offset = 0u;
         g_stream_data.state = START_OF_MESSAGE;
@@ -183,7 +183,7 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #define USB_DEVICE_CDC_QUEUE_DEPTH_COMBINED 3
 
 /* Endpoint Transfer Queue Size combined for Read and write */
-#define USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED    2
+#define USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED    4
 
 
 
@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "sys/attribs.h"
+#include "sys/kmem.h"
 #include "system/int/sys_int.h"
 #include "system/clk/sys_clk.h"
 
@@ -30,6 +31,7 @@
 #include "coarse_timer.h"
 #include "constants.h"
 #include "dmx_spec.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/ic/plib_ic.h"
 #include "peripheral/tmr/plib_tmr.h"
 #include "peripheral/usart/plib_usart.h"
@@ -43,13 +45,22 @@
 
 enum { BUFFER_SIZE = DMX_FRAME_SIZE + 1u };
 
-// The number of buffers we maintain for overlapping I/O
-enum { NUMBER_OF_BUFFERS = 2};
+// The DMA size registers on the PIC32MX are 8 bits wide, so a block is at most
+// 256 bytes. Frames are sent and received as a chain of blocks.
+enum { DMA_MAX_BLOCK_SIZE = 256u };
+
+// The number of buffers we maintain for overlapping I/O. As well as the
+// queued frames, there is the active buffer and one pinned by the transport.
+enum { NUMBER_OF_BUFFERS = TRANSCEIVER_QUEUE_DEPTH + 2u };
 
 static const uint16_t BREAK_FUDGE_FACTOR = 74u;
 static const uint16_t MARK_FUDGE_FACTOR = 217u;
 static const uint16_t RESPONSE_FUDGE_FACTOR = 24u;
 
+// The time from the falling edge of a break until the USART flags the framing
+// error, in 10ths of a microsecond. This is 9.5 bit times at 250kbps.
+static const uint16_t FRAMING_ERROR_DELAY = 380u;
+
 typedef enum {
   // Controller states
   STATE_C_INITIALIZE = 0,  //!< Initialize controller state.
@@ -106,6 +117,68 @@ typedef struct {
   uint8_t data[BUFFER_SIZE];
 } TransceiverBuffer;
 
+typedef struct {
+  // Timing params
+  uint16_t break_time;
+  uint16_t break_ticks;
+  uint16_t mark_time;
+  uint16_t mark_ticks;
+  uint16_t rdm_broadcast_timeout;
+  uint16_t rdm_response_timeout;
+  uint16_t rdm_dub_response_limit;
+  uint16_t rdm_responder_delay;
+  uint16_t rdm_responder_jitter;
+  uint16_t dmx_refresh_interval;
+} TimingSettings;
+
+/**
+ * @brief The state for continuous DMX transmission.
+ *
+ * The ISRs transmit from front, while updates are written to back. The buffers
+ * are swapped at the start of a frame, so an update is never partially sent.
+ */
+typedef struct {
+  TransceiverBuffer buffers[2];
+  TransceiverBuffer* front;  //!< The buffer used for the next frame.
+  TransceiverBuffer* back;  //!< The buffer updates are written to.
+  bool enabled;  //!< True if the stream is being transmitted.
+  bool updated;  //!< True if back contains changes not yet in front.
+} DMXStream;
+
+/*
+ * @brief A DMX frame in the latest-frame triple buffer.
+ */
+typedef struct {
+  uint32_t sequence;  //!< 0 if the buffer has never been written.
+  uint16_t size;  //!< The number of slots, excluding the start code.
+  uint8_t data[DMX_FRAME_SIZE];
+} DMXFrameBuffer;
+
+/*
+ * @brief The buffers used by Transceiver_GetLatestDMXFrame().
+ *
+ * The receive path writes into one buffer, one holds the latest complete
+ * frame and the reader holds the third. The writer and reader each swap their
+ * buffer with the latest one, so neither waits for the other.
+ */
+typedef struct {
+  DMXFrameBuffer buffers[3];
+  uint8_t write_index;  //!< Only used by the writer.
+  uint8_t read_index;  //!< Only used by the reader.
+
+  /**
+   * @brief The index of the latest frame, ORed with LATEST_DMX_FRAME_NEW if
+   *   the reader hasn't taken it yet.
+   */
+  volatile uint8_t latest;
+  uint32_t sequence;
+} LatestDMXFrame;
+
+static const uint8_t LATEST_DMX_FRAME_NEW = 0x80u;
+
+/*
+ * @brief The state for a single DMX512 / RDM port.
+ */
 typedef struct {
   TransceiverState state;  //!< The current state of the transceiver.
   TransceiverMode mode;  //!< The operating mode of the transceiver.
@@ -124,8 +197,8 @@ typedef struct {
   /**
    * @brief The time to wait for the RDM response.
    *
-   * This is set to either g_timing_settings.rdm_response_timeout or
-   * g_timing_settings.rdm_broadcast_timeout depending on the type of request.
+   * This is set to either timing_settings.rdm_response_timeout or
+   * timing_settings.rdm_broadcast_timeout depending on the type of request.
    */
   uint16_t rdm_response_timeout;
 
@@ -135,6 +208,16 @@ typedef struct {
    */
   uint16_t data_index;
 
+  /**
+   * @brief The end of the block the TX DMA channel is sending.
+   */
+  uint16_t tx_dma_end;
+
+  /**
+   * @brief The start of the block the RX DMA channel is receiving into.
+   */
+  uint16_t rx_dma_offset;
+
   /**
    * @brief The index of the last byte delivered to the responder callback.
    */
@@ -171,44 +254,68 @@ typedef struct {
    * @brief The buffer current used for transmit / receive.
    */
   TransceiverBuffer* active;
-  TransceiverBuffer* next;  //!< The next buffer ready to be transmitted
+
+  /**
+   * @brief The buffers ready to be transmitted, in the order they were queued.
+   */
+  TransceiverBuffer* queue[TRANSCEIVER_QUEUE_DEPTH];
+  uint8_t queue_head;  //!< The index of the next buffer in the queue.
+  uint8_t queue_size;  //!< The number of buffers in the queue.
+
+  /**
+   * @brief A completed buffer the transport is still sending from.
+   *
+   * This is returned to the free list once the transport releases it.
+   */
+  TransceiverBuffer* pinned;
 
   TransceiverBuffer* free_list[NUMBER_OF_BUFFERS];
   uint8_t free_size;  //!< The number of buffers in the free list, may be 0.
-} TransceiverData;
 
-typedef struct {
-  // Timing params
-  uint16_t break_time;
-  uint16_t break_ticks;
-  uint16_t mark_time;
-  uint16_t mark_ticks;
-  uint16_t rdm_broadcast_timeout;
-  uint16_t rdm_response_timeout;
-  uint16_t rdm_dub_response_limit;
-  uint16_t rdm_responder_delay;
-  uint16_t rdm_responder_jitter;
-} TimingSettings;
+  /**
+   * @brief A frame received with DMA, waiting for the RX callback.
+   *
+   * The next frame is received into the active buffer while this one is
+   * processed.
+   */
+  TransceiverBuffer* rx_ready;
+
+  /**
+   * @brief The buffer the next frame is received into, once the active one
+   *   is complete. Only used when receiving with DMA.
+   */
+  TransceiverBuffer* rx_spare;
+  bool rx_dma_active;  //!< True if the RX DMA channel is receiving.
 
-// The TX / RX buffers
-static TransceiverBuffer buffers[NUMBER_OF_BUFFERS];
+  TransceiverHardwareSettings hw_settings;  //!< The hardware settings.
+  TimingSettings timing_settings;  //!< The timing settings.
 
-// The transceiver state
-TransceiverData g_transceiver;
+  /**
+   * @brief The timing information for the current operation.
+   */
+  TransceiverTiming timing;
 
-// The hardware settings
-static TransceiverHardwareSettings g_hw_settings;
+  /**
+   * @brief The timing information for the frame in rx_ready.
+   */
+  TransceiverTiming rx_ready_timing;
 
-// The timing information for the current operation.
-static TransceiverTiming g_timing;
+  DMXStream stream;  //!< The continuous DMX stream.
+  LatestDMXFrame latest_dmx;  //!< The latest received DMX frame.
+  TransceiverBuffer buffers[NUMBER_OF_BUFFERS];  //!< The TX / RX buffers.
+} TransceiverPort;
+
+// The ports
+static TransceiverPort g_ports[TRANSCEIVER_PORT_COUNT];
+
+// The selected port, the ISRs and Transceiver_Tasks() switch this while they
+// run.
+static TransceiverPort *g_port = &g_ports[0];
 
 // The event callback, or NULL if there isn't one.
 static TransceiverEventCallback g_tx_callback = NULL;
 static TransceiverEventCallback g_rx_callback = NULL;
 
-// The timing settings
-static TimingSettings g_timing_settings;
-
 // Timer Functions
 // ----------------------------------------------------------------------------
 /*
@@ -227,8 +334,9 @@ static inline uint16_t MicroSecondsToTicks(uint16_t micro_seconds) {
  */
 static inline void RebaseTimer(uint16_t last_event) {
   PLIB_TMR_Counter16BitSet(
-      g_hw_settings.timer_module_id,
-      PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) - last_event);
+      g_port->hw_settings.timer_module_id,
+      PLIB_TMR_Counter16BitGet(g_port->hw_settings.timer_module_id) -
+      last_event);
 }
 
 // I/O Functions
@@ -239,11 +347,11 @@ static inline void RebaseTimer(uint16_t last_event) {
  */
 static inline void EnableTX() {
   PLIB_PORTS_PinSet(PORTS_ID_0,
-                    g_hw_settings.port,
-                    g_hw_settings.tx_enable_bit);
+                    g_port->hw_settings.port,
+                    g_port->hw_settings.tx_enable_bit);
   PLIB_PORTS_PinSet(PORTS_ID_0,
-                    g_hw_settings.port,
-                    g_hw_settings.rx_enable_bit);
+                    g_port->hw_settings.port,
+                    g_port->hw_settings.rx_enable_bit);
 }
 
 /*
@@ -251,11 +359,11 @@ static inline void EnableTX() {
  */
 static inline void EnableRX() {
   PLIB_PORTS_PinClear(PORTS_ID_0,
-                      g_hw_settings.port,
-                      g_hw_settings.rx_enable_bit);
+                      g_port->hw_settings.port,
+                      g_port->hw_settings.rx_enable_bit);
   PLIB_PORTS_PinClear(PORTS_ID_0,
-                      g_hw_settings.port,
-                      g_hw_settings.tx_enable_bit);
+                      g_port->hw_settings.port,
+                      g_port->hw_settings.tx_enable_bit);
 }
 
 /*
@@ -263,8 +371,8 @@ static inline void EnableRX() {
  */
 static inline void SetBreak() {
   PLIB_PORTS_PinClear(PORTS_ID_0,
-                      g_hw_settings.port,
-                      g_hw_settings.break_bit);
+                      g_port->hw_settings.port,
+                      g_port->hw_settings.break_bit);
 }
 
 /*
@@ -272,8 +380,8 @@ static inline void SetBreak() {
  */
 static inline void SetMark() {
   PLIB_PORTS_PinSet(PORTS_ID_0,
-                    g_hw_settings.port,
-                    g_hw_settings.break_bit);
+                    g_port->hw_settings.port,
+                    g_port->hw_settings.break_bit);
 }
 
 /*
@@ -290,18 +398,133 @@ static inline void ResetToMark() {
  * @brief Push data into the UART TX queue.
  */
 static void UART_TXBytes() {
-  while (!PLIB_USART_TransmitterBufferIsFull(g_hw_settings.usart) &&
-         g_transceiver.data_index != g_transceiver.active->size) {
+  while (!PLIB_USART_TransmitterBufferIsFull(g_port->hw_settings.usart) &&
+         g_port->data_index != g_port->active->size) {
     PLIB_USART_TransmitterByteSend(
-        g_hw_settings.usart,
-        g_transceiver.active->data[g_transceiver.data_index]);
-    g_transceiver.data_index++;
+        g_port->hw_settings.usart,
+        g_port->active->data[g_port->data_index]);
+    g_port->data_index++;
+  }
+}
+
+/*
+ * @brief Hand the next block of the active buffer to the TX DMA channel.
+ *
+ * The channel is triggered by the USART TX interrupt, so it keeps the TX FIFO
+ * topped up without involving the CPU. Transceiver_DMAEvent() runs once the
+ * last byte of the block has been moved into the FIFO, and either starts the
+ * next block or waits for the FIFO to drain.
+ */
+static void StartTXDMA() {
+  uint16_t block_size = g_port->active->size - g_port->data_index;
+  if (block_size > DMA_MAX_BLOCK_SIZE) {
+    block_size = DMA_MAX_BLOCK_SIZE;
+  }
+  g_port->tx_dma_end = g_port->data_index + block_size;
+
+  PLIB_USART_TransmitterInterruptModeSelect(g_port->hw_settings.usart,
+                                            USART_TRANSMIT_FIFO_NOT_FULL);
+  PLIB_DMA_ChannelXSourceStartAddressSet(
+      DMA_ID_0, g_port->hw_settings.tx_dma_channel,
+      KVA_TO_PA(g_port->active->data + g_port->data_index));
+  PLIB_DMA_ChannelXSourceSizeSet(
+      DMA_ID_0, g_port->hw_settings.tx_dma_channel, block_size);
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0,
+                                      g_port->hw_settings.tx_dma_channel,
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.tx_dma_source);
+  SYS_INT_SourceEnable(g_port->hw_settings.tx_dma_source);
+  PLIB_DMA_ChannelXEnable(DMA_ID_0, g_port->hw_settings.tx_dma_channel);
+}
+
+/*
+ * @brief Abort any DMA transfer in progress.
+ */
+static void StopTXDMA() {
+  if (!g_port->hw_settings.use_tx_dma) {
+    return;
+  }
+  SYS_INT_SourceDisable(g_port->hw_settings.tx_dma_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.tx_dma_source);
+  PLIB_DMA_ChannelXDisable(DMA_ID_0, g_port->hw_settings.tx_dma_channel);
+}
+
+/*
+ * @brief The size of the block the RX DMA channel is receiving into.
+ */
+static inline uint16_t RXDMABlockSize() {
+  uint16_t block_size = BUFFER_SIZE - g_port->rx_dma_offset;
+  return block_size > DMA_MAX_BLOCK_SIZE ? DMA_MAX_BLOCK_SIZE : block_size;
+}
+
+/*
+ * @brief Point the RX DMA channel at the next block of the active buffer.
+ */
+static void ArmRXDMABlock() {
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0,
+                                      g_port->hw_settings.rx_dma_channel,
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  PLIB_DMA_ChannelXDestinationStartAddressSet(
+      DMA_ID_0, g_port->hw_settings.rx_dma_channel,
+      KVA_TO_PA(g_port->active->data + g_port->rx_dma_offset));
+  PLIB_DMA_ChannelXDestinationSizeSet(DMA_ID_0,
+                                      g_port->hw_settings.rx_dma_channel,
+                                      RXDMABlockSize());
+  PLIB_DMA_ChannelXEnable(DMA_ID_0, g_port->hw_settings.rx_dma_channel);
+}
+
+/*
+ * @brief Receive into the active buffer using the RX DMA channel.
+ *
+ * The frame is complete when the USART flags the break of the following
+ * frame as a framing error. Transceiver_RXDMAEvent() runs as each block fills
+ * and re-arms the channel for the next one.
+ */
+static void StartRXDMA() {
+  g_port->rx_dma_offset = 0u;
+  ArmRXDMABlock();
+  g_port->rx_dma_active = true;
+
+  SYS_INT_SourceStatusClear(g_port->hw_settings.rx_dma_source);
+  SYS_INT_SourceEnable(g_port->hw_settings.rx_dma_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.usart_error_source);
+  SYS_INT_SourceEnable(g_port->hw_settings.usart_error_source);
+}
+
+/*
+ * @brief The number of bytes the RX DMA channel has moved into the active
+ *   buffer.
+ */
+static uint16_t RXDMACount() {
+  // Once a block is full the channel stops and the pointer wraps to 0.
+  if (PLIB_DMA_ChannelXINTSourceFlagGet(DMA_ID_0,
+                                        g_port->hw_settings.rx_dma_channel,
+                                        DMA_INT_BLOCK_TRANSFER_COMPLETE)) {
+    return g_port->rx_dma_offset + RXDMABlockSize();
+  }
+  return g_port->rx_dma_offset + PLIB_DMA_ChannelXDestinationPointerGet(
+      DMA_ID_0, g_port->hw_settings.rx_dma_channel);
+}
+
+/*
+ * @brief Stop the RX DMA channel.
+ * @returns The number of bytes the channel moved into the active buffer.
+ */
+static uint16_t StopRXDMA() {
+  if (!g_port->hw_settings.use_rx_dma) {
+    return 0u;
   }
+  SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+  SYS_INT_SourceDisable(g_port->hw_settings.rx_dma_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.rx_dma_source);
+  PLIB_DMA_ChannelXDisable(DMA_ID_0, g_port->hw_settings.rx_dma_channel);
+  g_port->rx_dma_active = false;
+  return RXDMACount();
 }
 
 void UART_FlushRX() {
-  while (PLIB_USART_ReceiverDataIsAvailable(g_hw_settings.usart)) {
-    PLIB_USART_ReceiverByteReceive(g_hw_settings.usart);
+  while (PLIB_USART_ReceiverDataIsAvailable(g_port->hw_settings.usart)) {
+    PLIB_USART_ReceiverByteReceive(g_port->hw_settings.usart);
   }
 }
 
@@ -310,36 +533,36 @@ void UART_FlushRX() {
  * @returns true if the RX buffer is now full.
  */
 bool UART_RXBytes() {
-  while (PLIB_USART_ReceiverDataIsAvailable(g_hw_settings.usart) &&
-         g_transceiver.data_index != BUFFER_SIZE) {
-    g_transceiver.active->data[g_transceiver.data_index] =
-        PLIB_USART_ReceiverByteReceive(g_hw_settings.usart);
-    g_transceiver.data_index++;
-  }
-  if (g_transceiver.active->op == OP_RDM_WITH_RESPONSE ||
-      g_transceiver.active->op == OP_RDM_BROADCAST) {
-    if (g_transceiver.found_expected_length) {
-      if (g_transceiver.data_index == g_transceiver.expected_length) {
+  while (PLIB_USART_ReceiverDataIsAvailable(g_port->hw_settings.usart) &&
+         g_port->data_index != BUFFER_SIZE) {
+    g_port->active->data[g_port->data_index] =
+        PLIB_USART_ReceiverByteReceive(g_port->hw_settings.usart);
+    g_port->data_index++;
+  }
+  if (g_port->active->op == OP_RDM_WITH_RESPONSE ||
+      g_port->active->op == OP_RDM_BROADCAST) {
+    if (g_port->found_expected_length) {
+      if (g_port->data_index == g_port->expected_length) {
         // We've got enough data to move on
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
         ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        g_port->state = STATE_C_COMPLETE;
       }
     } else {
-      if (g_transceiver.data_index >= 3u) {
-        if (g_transceiver.active->data[0] == RDM_START_CODE &&
-            g_transceiver.active->data[1] == RDM_SUB_START_CODE) {
-          g_transceiver.found_expected_length = true;
+      if (g_port->data_index >= 3u) {
+        if (g_port->active->data[0] == RDM_START_CODE &&
+            g_port->active->data[1] == RDM_SUB_START_CODE) {
+          g_port->found_expected_length = true;
           // Add two bytes for the checksum
-          g_transceiver.expected_length = g_transceiver.active->data[2] + 2;
+          g_port->expected_length = g_port->active->data[2] + 2;
         }
       }
     }
   }
-  g_transceiver.last_byte = PLIB_TMR_Counter16BitGet(
-      g_hw_settings.timer_module_id);
-  g_transceiver.last_byte_coarse = CoarseTimer_GetTime();
-  return g_transceiver.data_index >= BUFFER_SIZE;
+  g_port->last_byte = PLIB_TMR_Counter16BitGet(
+      g_port->hw_settings.timer_module_id);
+  g_port->last_byte_coarse = CoarseTimer_GetTime();
+  return g_port->data_index >= BUFFER_SIZE;
 }
 
 // Memory Buffer Management
@@ -349,85 +572,254 @@ bool UART_RXBytes() {
  * @brief Setup the transceiver buffers.
  */
 static void InitializeBuffers() {
-  g_transceiver.active = NULL;
-  g_transceiver.next = NULL;
+  g_port->active = NULL;
+  g_port->queue_head = 0u;
+  g_port->queue_size = 0u;
+  g_port->pinned = NULL;
+  g_port->rx_ready = NULL;
+  g_port->rx_spare = NULL;
+  g_port->rx_dma_active = false;
 
   unsigned int i = 0u;
   for (; i < NUMBER_OF_BUFFERS; i++) {
-    g_transceiver.free_list[i] = &buffers[i];
+    g_port->free_list[i] = &g_port->buffers[i];
   }
-  g_transceiver.free_size = NUMBER_OF_BUFFERS;
+  g_port->free_size = NUMBER_OF_BUFFERS;
+}
+
+/*
+ * @brief Check if a buffer belongs to the DMX stream, rather than the pool.
+ */
+static inline bool IsStreamBuffer(const TransceiverBuffer *buffer) {
+  return buffer == &g_port->stream.buffers[0] ||
+         buffer == &g_port->stream.buffers[1];
 }
 
 /*
  * @brief Return the active buffer to the free list.
  */
 static void FreeActiveBuffer() {
-  if (g_transceiver.active) {
-    g_transceiver.free_list[g_transceiver.free_size] = g_transceiver.active;
-    g_transceiver.free_size++;
-    g_transceiver.active = NULL;
+  if (g_port->active && !IsStreamBuffer(g_port->active)) {
+    g_port->free_list[g_port->free_size] = g_port->active;
+    g_port->free_size++;
+  }
+  g_port->active = NULL;
+}
+
+/*
+ * @brief Check if the transport is still referencing a buffer's data.
+ */
+static inline bool IsPinned(const TransceiverBuffer *buffer) {
+#ifdef PIPELINE_TRANSPORT_TX_IS_PINNED
+  return PIPELINE_TRANSPORT_TX_IS_PINNED(buffer->data);
+#else
+  (void) buffer;
+  return false;
+#endif
+}
+
+/*
+ * @brief Return the pinned buffer to the free list, if the transport is done
+ *   with it.
+ */
+static void ReleasePinnedBuffer() {
+  if (g_port->pinned && !IsPinned(g_port->pinned)) {
+    g_port->free_list[g_port->free_size] = g_port->pinned;
+    g_port->free_size++;
+    g_port->pinned = NULL;
+  }
+}
+
+/*
+ * @brief Take a buffer from the free list and add it to the tail of the queue.
+ * @returns The buffer, or NULL if the queue is full.
+ */
+static TransceiverBuffer* QueueBuffer() {
+  if (g_port->free_size == 0u ||
+      g_port->queue_size == TRANSCEIVER_QUEUE_DEPTH) {
+    return NULL;
+  }
+
+  g_port->free_size--;
+  TransceiverBuffer* buffer = g_port->free_list[g_port->free_size];
+  g_port->queue[
+      (g_port->queue_head + g_port->queue_size) %
+      TRANSCEIVER_QUEUE_DEPTH] = buffer;
+  g_port->queue_size++;
+  return buffer;
+}
+
+/*
+ * @brief Reset the latest-frame triple buffer.
+ */
+static void InitializeLatestDMXFrame() {
+  unsigned int i = 0u;
+  for (; i < 3u; i++) {
+    g_port->latest_dmx.buffers[i].sequence = 0u;
+    g_port->latest_dmx.buffers[i].size = 0u;
+  }
+  g_port->latest_dmx.write_index = 0u;
+  g_port->latest_dmx.latest = 1u;
+  g_port->latest_dmx.read_index = 2u;
+  g_port->latest_dmx.sequence = 0u;
+}
+
+/*
+ * @brief Publish a received frame, if it's a DMX frame.
+ * @param data The frame, including the start code.
+ * @param size The size of the frame, including the start code.
+ *
+ * This is called from either Transceiver_Tasks() or the USART ISR, but never
+ * both at the same time.
+ */
+static void PublishDMXFrame(const uint8_t* data, unsigned int size) {
+  if (size == 0u || data[0] != NULL_START_CODE) {
+    return;
+  }
+
+  DMXFrameBuffer* buffer =
+      &g_port->latest_dmx.buffers[g_port->latest_dmx.write_index];
+  buffer->size = size - 1u > DMX_FRAME_SIZE ? DMX_FRAME_SIZE : size - 1u;
+  memcpy(buffer->data, data + 1, buffer->size);
+  g_port->latest_dmx.sequence++;
+  buffer->sequence = g_port->latest_dmx.sequence;
+
+  g_port->latest_dmx.write_index = __sync_lock_test_and_set(
+      &g_port->latest_dmx.latest,
+      g_port->latest_dmx.write_index | LATEST_DMX_FRAME_NEW) &
+      ~LATEST_DMX_FRAME_NEW;
+}
+
+/*
+ * @brief Return the buffers used for DMA receive to the free list.
+ */
+static void FreeRXDMABuffers() {
+  if (g_port->rx_ready) {
+    g_port->free_list[g_port->free_size] = g_port->rx_ready;
+    g_port->free_size++;
+    g_port->rx_ready = NULL;
+  }
+  if (g_port->rx_spare) {
+    g_port->free_list[g_port->free_size] = g_port->rx_spare;
+    g_port->free_size++;
+    g_port->rx_spare = NULL;
   }
 }
 
 /*
- * @brief Move the next buffer to the active buffer.
+ * @brief Move the buffer at the head of the queue to the active buffer.
  */
 static void TakeNextBuffer() {
-  if (g_transceiver.active) {
-    g_transceiver.free_list[g_transceiver.free_size] = g_transceiver.active;
-    g_transceiver.free_size++;
+  FreeActiveBuffer();
+  if (g_port->queue_size) {
+    g_port->active = g_port->queue[g_port->queue_head];
+    g_port->queue_head = (g_port->queue_head + 1u) %
+                               TRANSCEIVER_QUEUE_DEPTH;
+    g_port->queue_size--;
   }
-  g_transceiver.active = g_transceiver.next;
-  g_transceiver.next = NULL;
-  g_transceiver.data_index = 0u;
+  g_port->data_index = 0u;
+}
+
+/*
+ * @brief Setup the DMX stream buffers.
+ */
+static void InitializeStream() {
+  g_port->stream.front = &g_port->stream.buffers[0];
+  g_port->stream.back = &g_port->stream.buffers[1];
+  g_port->stream.enabled = false;
+  g_port->stream.updated = false;
+
+  unsigned int i = 0u;
+  for (; i < 2u; i++) {
+    g_port->stream.buffers[i].size = 1u;
+    g_port->stream.buffers[i].op = OP_TX_ONLY;
+    g_port->stream.buffers[i].token = 0u;
+    g_port->stream.buffers[i].data[0] = NULL_START_CODE;
+  }
+}
+
+/*
+ * @brief Check if the next DMX stream frame is due.
+ */
+static inline bool StreamFrameDue() {
+  return g_port->stream.enabled &&
+         CoarseTimer_HasElapsed(g_port->tx_frame_start,
+                                g_port->timing_settings.dmx_refresh_interval);
+}
+
+/*
+ * @brief Make the next DMX stream frame the active buffer.
+ *
+ * If there were updates, the buffers are swapped and the new front is copied
+ * to the back so that later updates are applied to the latest data.
+ */
+static void TakeStreamBuffer() {
+  if (g_port->stream.updated) {
+    TransceiverBuffer* buffer = g_port->stream.front;
+    g_port->stream.front = g_port->stream.back;
+    g_port->stream.back = buffer;
+    g_port->stream.back->size = g_port->stream.front->size;
+    memcpy(g_port->stream.back->data, g_port->stream.front->data,
+           g_port->stream.front->size);
+    g_port->stream.updated = false;
+  }
+  g_port->active = g_port->stream.front;
+  g_port->data_index = 0u;
 }
 
 // ----------------------------------------------------------------------------
 static inline void PrepareRDMResponse() {
   // Rebase the timer to when the last byte was received
-  RebaseTimer(g_transceiver.last_byte);
+  RebaseTimer(g_port->last_byte);
 
-  g_transceiver.state = STATE_R_TX_WAITING;
-  PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-  PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
+  g_port->state = STATE_R_TX_WAITING;
+  PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+  PLIB_USART_TransmitterInterruptModeSelect(g_port->hw_settings.usart,
                                             USART_TRANSMIT_FIFO_EMPTY);
 
   TakeNextBuffer();
 
   // Enable the timer to trigger when we send the RDM response.
   unsigned int jitter = 0u;
-  if (g_timing_settings.rdm_responder_jitter) {
-    jitter = Random_PseudoGet() % g_timing_settings.rdm_responder_jitter;
+  if (g_port->timing_settings.rdm_responder_jitter) {
+    jitter = Random_PseudoGet() % g_port->timing_settings.rdm_responder_jitter;
   }
   PLIB_TMR_Period16BitSet(
-      g_hw_settings.timer_module_id,
-      g_timing_settings.rdm_responder_delay - RESPONSE_FUDGE_FACTOR + jitter);
-  SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
-  SYS_INT_SourceEnable(g_hw_settings.timer_source);
+      g_port->hw_settings.timer_module_id,
+      g_port->timing_settings.rdm_responder_delay - RESPONSE_FUDGE_FACTOR +
+      jitter);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.timer_source);
+  SYS_INT_SourceEnable(g_port->hw_settings.timer_source);
 }
 
 static inline void StartSendingRDMResponse() {
-  PLIB_USART_TransmitterEnable(g_hw_settings.usart);
-  if (!PLIB_USART_TransmitterBufferIsFull(g_hw_settings.usart) &&
-       g_transceiver.data_index != g_transceiver.active->size) {
+  if (g_port->hw_settings.use_tx_dma) {
+    StartTXDMA();
+    PLIB_USART_TransmitterEnable(g_port->hw_settings.usart);
+    g_port->state = STATE_R_TX_DATA;
+    return;
+  }
+
+  PLIB_USART_TransmitterEnable(g_port->hw_settings.usart);
+  if (!PLIB_USART_TransmitterBufferIsFull(g_port->hw_settings.usart) &&
+       g_port->data_index != g_port->active->size) {
     PLIB_USART_TransmitterByteSend(
-        g_hw_settings.usart,
-        g_transceiver.active->data[g_transceiver.data_index]);
-    g_transceiver.data_index++;
+        g_port->hw_settings.usart,
+        g_port->active->data[g_port->data_index]);
+    g_port->data_index++;
   }
-  g_transceiver.state = STATE_R_TX_DATA;
+  g_port->state = STATE_R_TX_DATA;
 
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-  SYS_INT_SourceEnable(g_hw_settings.usart_tx_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.usart_tx_source);
+  SYS_INT_SourceEnable(g_port->hw_settings.usart_tx_source);
 }
 
 static inline void LogStateChange() {
   static TransceiverState last_state = STATE_RESET;
 
-  if (g_transceiver.state != last_state) {
-    SysLog_Print(SYSLOG_DEBUG, "Changed to %d", g_transceiver.state);
-    last_state = g_transceiver.state;
+  if (g_port->state != last_state) {
+    SysLog_Print(SYSLOG_DEBUG, "Changed to %d", g_port->state);
+    last_state = g_port->state;
   }
 }
 
@@ -435,23 +827,29 @@ static inline void LogStateChange() {
  * @brief Run the completion callback.
  */
 static inline void FrameComplete() {
+  if (IsStreamBuffer(g_port->active)) {
+    // Stream frames don't generate events.
+    return;
+  }
+
   const uint8_t* data = NULL;
   unsigned int length = 0u;
-  if (g_transceiver.active->op != OP_TX_ONLY &&
-      g_transceiver.data_index != 0u) {
+  if (g_port->active->op != OP_TX_ONLY &&
+      g_port->data_index != 0u) {
     // We actually got some data.
-    data = g_transceiver.active->data;
-    length = g_transceiver.data_index;
-    g_transceiver.result = T_RESULT_RX_DATA;
+    data = g_port->active->data;
+    length = g_port->data_index;
+    g_port->result = T_RESULT_RX_DATA;
   }
 
   TransceiverEvent event = {
-    g_transceiver.active->token,
-    (TransceiverOperation) g_transceiver.active->op,
-    g_transceiver.result,
+    g_port->active->token,
+    (TransceiverOperation) g_port->active->op,
+    g_port->result,
     data,
     length,
-    &g_timing
+    &g_port->timing,
+    Transceiver_GetPort()
   };
 
 #ifdef PIPELINE_TRANSCEIVER_TX_EVENT
@@ -470,11 +868,12 @@ static inline void RXFrameEvent() {
   TransceiverEvent event = {
     0u,
     T_OP_RX,
-    g_transceiver.event_index == 0u ? T_RESULT_RX_START_FRAME :
+    g_port->event_index == 0u ? T_RESULT_RX_START_FRAME :
         T_RESULT_RX_CONTINUE_FRAME,
-    g_transceiver.active->data,
-    g_transceiver.data_index,
-    &g_timing
+    g_port->active->data,
+    g_port->data_index,
+    &g_port->timing,
+    Transceiver_GetPort()
   };
 
 #ifdef PIPELINE_TRANSCEIVER_RX_EVENT
@@ -496,7 +895,8 @@ static inline void RXEndFrameEvent() {
     T_RESULT_RX_FRAME_TIMEOUT,
     NULL,
     0u,
-    &g_timing
+    &g_port->timing,
+    Transceiver_GetPort()
   };
 
 #ifdef PIPELINE_TRANSCEIVER_RX_EVENT
@@ -508,6 +908,136 @@ static inline void RXEndFrameEvent() {
 #endif
 }
 
+/*
+ * @brief Run the RX callback for a frame received with DMA.
+ *
+ * The whole frame is delivered at once, followed by an end-of-frame event.
+ */
+static void DeliverRXDMAFrame() {
+  TransceiverBuffer* frame = g_port->rx_ready;
+  if (!frame) {
+    return;
+  }
+
+  TransceiverEvent event = {
+    0u,
+    T_OP_RX,
+    T_RESULT_RX_START_FRAME,
+    frame->data,
+    frame->size,
+    &g_port->rx_ready_timing,
+    Transceiver_GetPort()
+  };
+
+#ifdef PIPELINE_TRANSCEIVER_RX_EVENT
+  PIPELINE_TRANSCEIVER_RX_EVENT(&event);
+#else
+  if (g_rx_callback) {
+    g_rx_callback(&event);
+  }
+#endif
+  RXEndFrameEvent();
+  PublishDMXFrame(frame->data, frame->size);
+
+  // Receive the frame after next into this buffer. The ISR doesn't touch
+  // rx_spare while rx_ready is set.
+  if (g_port->rx_spare) {
+    g_port->free_list[g_port->free_size] = frame;
+    g_port->free_size++;
+  } else {
+    g_port->rx_spare = frame;
+  }
+  g_port->rx_ready = NULL;
+}
+
+/*
+ * @brief Complete a frame received with DMA.
+ *
+ * This is called from the USART ISR when the break of the following frame
+ * causes a framing error. The received frame is handed to Transceiver_Tasks()
+ * and the next frame is received into the spare buffer.
+ */
+static void RXDMAFrameComplete() {
+  uint16_t length = StopRXDMA();
+  if (length &&
+      !(PLIB_USART_ErrorsGet(g_port->hw_settings.usart) &
+        USART_ERROR_FRAMING)) {
+    // The channel already moved the break into the buffer.
+    length--;
+  }
+  UART_FlushRX();
+  PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+
+  if (length && !g_port->rx_ready && g_port->rx_spare) {
+    g_port->active->size = length;
+    g_port->rx_ready_timing = g_port->timing;
+    g_port->rx_ready = g_port->active;
+    g_port->active = g_port->rx_spare;
+    g_port->rx_spare = NULL;
+  }
+  // Otherwise the previous frame is still being processed, drop this one.
+
+  // Time the break from the falling edge.
+  PLIB_TMR_Counter16BitSet(g_port->hw_settings.timer_module_id,
+                           FRAMING_ERROR_DELAY);
+  g_port->timing.request.break_time = 0u;
+  g_port->timing.request.mark_time = 0u;
+  g_port->data_index = 0u;
+  g_port->event_index = 0u;
+  g_port->active->op = OP_RX;
+  g_port->state = STATE_R_RX_BREAK;
+
+  // Catch the end of the break.
+  PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+  PLIB_IC_FirstCaptureEdgeSelect(g_port->hw_settings.input_capture_module,
+                                 IC_EDGE_RISING);
+  PLIB_IC_Enable(g_port->hw_settings.input_capture_module);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
+  SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
+}
+
+/*
+ * @brief Check on a frame being received with DMA.
+ * @returns true if the frame is still being received with DMA, false if the
+ *   rest of the frame is to be received a slot at a time.
+ */
+static bool PollRXDMA() {
+  uint16_t received = RXDMACount();
+  if (received != g_port->data_index) {
+    g_port->data_index = received;
+    g_port->last_byte_coarse = CoarseTimer_GetTime();
+  }
+
+  if (received && g_port->active->data[0] == RDM_START_CODE) {
+    // The response is timed from the last slot of the request, so receive
+    // the rest of the request a slot at a time.
+    g_port->data_index = StopRXDMA();
+    g_port->last_byte = PLIB_TMR_Counter16BitGet(
+        g_port->hw_settings.timer_module_id);
+    g_port->last_byte_coarse = CoarseTimer_GetTime();
+
+    PLIB_IC_FirstCaptureEdgeSelect(g_port->hw_settings.input_capture_module,
+                                   IC_EDGE_FALLING);
+    PLIB_IC_Enable(g_port->hw_settings.input_capture_module);
+    SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
+    SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
+    SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+    return false;
+  }
+
+  if (received && CoarseTimer_HasElapsed(g_port->last_byte_coarse,
+                                         RESPONDER_DMX_INTERSLOT_TIMEOUT)) {
+    // No break followed the frame.
+    g_port->data_index = StopRXDMA();
+    RXFrameEvent();
+    RXEndFrameEvent();
+    PublishDMXFrame(g_port->active->data, g_port->data_index);
+    PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+    g_port->state = STATE_R_RX_PREPARE;
+  }
+  return true;
+}
+
 /*
  * @brief Reset the settings to their default values.
  */
@@ -519,6 +1049,138 @@ static void ResetTimingSettings() {
   Transceiver_SetRDMDUBResponseLimit(DEFAULT_RDM_DUB_RESPONSE_LIMIT);
   Transceiver_SetRDMResponderDelay(DEFAULT_RDM_RESPONDER_DELAY);
   Transceiver_SetRDMResponderJitter(0u);
+  Transceiver_SetDMXRefreshInterval(DEFAULT_DMX_REFRESH_INTERVAL);
+}
+
+/*
+ * @brief Initialize the selected port.
+ */
+static void InitializePort(const TransceiverHardwareSettings* settings) {
+  g_port->hw_settings = *settings;
+
+  // There is a single RDM responder, the other ports start as controllers.
+  if (g_port == &g_ports[0]) {
+    g_port->state = STATE_R_INITIALIZE;
+    g_port->mode = T_MODE_RESPONDER;
+  } else {
+    g_port->state = STATE_C_INITIALIZE;
+    g_port->mode = T_MODE_CONTROLLER;
+  }
+  g_port->desired_mode = g_port->mode;
+  g_port->data_index = 0u;
+
+  InitializeBuffers();
+  InitializeStream();
+  InitializeLatestDMXFrame();
+  ResetTimingSettings();
+
+  // Setup the Break, TX Enable & RX Enable I/O Pins
+  PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
+                                   settings->port,
+                                   settings->break_bit);
+  PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
+                                   settings->port,
+                                   settings->tx_enable_bit);
+  PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
+                                   settings->port,
+                                   settings->rx_enable_bit);
+
+  // Setup the timer
+  PLIB_TMR_ClockSourceSelect(settings->timer_module_id,
+                             TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK);
+  PLIB_TMR_PrescaleSelect(settings->timer_module_id, TMR_PRESCALE_VALUE_1);
+  PLIB_TMR_Mode16BitEnable(settings->timer_module_id);
+  SYS_INT_VectorPrioritySet(settings->timer_vector, INT_PRIORITY_LEVEL1);
+  SYS_INT_VectorSubprioritySet(settings->timer_vector,
+                               INT_SUBPRIORITY_LEVEL0);
+
+  // Setup the UART
+  PLIB_USART_BaudRateSet(settings->usart,
+                         SYS_CLK_PeripheralFrequencyGet(CLK_BUS_PERIPHERAL_1),
+                         DMX_BAUD);
+  PLIB_USART_HandshakeModeSelect(settings->usart,
+                                 USART_HANDSHAKE_MODE_SIMPLEX);
+  PLIB_USART_OperationModeSelect(settings->usart,
+                                 USART_ENABLE_TX_RX_USED);
+  PLIB_USART_LineControlModeSelect(settings->usart, USART_8N2);
+  PLIB_USART_SyncModeSelect(settings->usart, USART_ASYNC_MODE);
+  PLIB_USART_TransmitterInterruptModeSelect(settings->usart,
+                                            USART_TRANSMIT_FIFO_EMPTY);
+
+  SYS_INT_VectorPrioritySet(settings->usart_vector,
+                            INT_PRIORITY_LEVEL6);
+  SYS_INT_VectorSubprioritySet(settings->usart_vector,
+                               INT_SUBPRIORITY_LEVEL0);
+  SYS_INT_SourceStatusClear(settings->usart_tx_source);
+
+  // Setup input capture
+  PLIB_IC_Disable(settings->input_capture_module);
+  PLIB_IC_ModeSelect(settings->input_capture_module,
+                     IC_INPUT_CAPTURE_EVERY_EDGE_MODE);
+  PLIB_IC_FirstCaptureEdgeSelect(settings->input_capture_module,
+                                 IC_EDGE_RISING);
+  PLIB_IC_TimerSelect(settings->input_capture_module,
+                      settings->input_capture_timer);
+  PLIB_IC_BufferSizeSelect(settings->input_capture_module,
+                           IC_BUFFER_SIZE_16BIT);
+  PLIB_IC_EventsPerInterruptSelect(settings->input_capture_module,
+                                   IC_INTERRUPT_ON_EVERY_CAPTURE_EVENT);
+
+  SYS_INT_VectorPrioritySet(settings->input_capture_vector,
+                            INT_PRIORITY_LEVEL6);
+  SYS_INT_VectorSubprioritySet(settings->input_capture_vector,
+                               INT_SUBPRIORITY_LEVEL0);
+
+  // Setup the TX DMA channel, one byte is moved into the USART TX FIFO each
+  // time the TX interrupt is raised.
+  if (settings->use_tx_dma) {
+    PLIB_DMA_Enable(DMA_ID_0);
+    PLIB_DMA_ChannelXDisable(DMA_ID_0, settings->tx_dma_channel);
+    PLIB_DMA_ChannelXPrioritySelect(DMA_ID_0, settings->tx_dma_channel,
+                                    DMA_CHANNEL_PRIORITY_3);
+    PLIB_DMA_ChannelXStartIRQSet(DMA_ID_0, settings->tx_dma_channel,
+                                 settings->tx_dma_trigger);
+    PLIB_DMA_ChannelXTriggerEnable(DMA_ID_0, settings->tx_dma_channel,
+                                   DMA_CHANNEL_TRIGGER_TRANSFER_START);
+    PLIB_DMA_ChannelXDestinationStartAddressSet(
+        DMA_ID_0, settings->tx_dma_channel,
+        KVA_TO_PA(PLIB_USART_TransmitterAddressGet(settings->usart)));
+    PLIB_DMA_ChannelXDestinationSizeSet(DMA_ID_0, settings->tx_dma_channel,
+                                        1u);
+    PLIB_DMA_ChannelXCellSizeSet(DMA_ID_0, settings->tx_dma_channel, 1u);
+    PLIB_DMA_ChannelXINTSourceEnable(DMA_ID_0, settings->tx_dma_channel,
+                                     DMA_INT_BLOCK_TRANSFER_COMPLETE);
+
+    SYS_INT_VectorPrioritySet(settings->tx_dma_vector,
+                              INT_PRIORITY_LEVEL6);
+    SYS_INT_VectorSubprioritySet(settings->tx_dma_vector,
+                                 INT_SUBPRIORITY_LEVEL0);
+  }
+
+  // Setup the RX DMA channel, one byte is moved out of the USART RX FIFO each
+  // time the RX interrupt is raised. The destination is set for each frame.
+  if (settings->use_rx_dma) {
+    PLIB_DMA_Enable(DMA_ID_0);
+    PLIB_DMA_ChannelXDisable(DMA_ID_0, settings->rx_dma_channel);
+    PLIB_DMA_ChannelXPrioritySelect(DMA_ID_0, settings->rx_dma_channel,
+                                    DMA_CHANNEL_PRIORITY_3);
+    PLIB_DMA_ChannelXStartIRQSet(DMA_ID_0, settings->rx_dma_channel,
+                                 settings->rx_dma_trigger);
+    PLIB_DMA_ChannelXTriggerEnable(DMA_ID_0, settings->rx_dma_channel,
+                                   DMA_CHANNEL_TRIGGER_TRANSFER_START);
+    PLIB_DMA_ChannelXSourceStartAddressSet(
+        DMA_ID_0, settings->rx_dma_channel,
+        KVA_TO_PA(PLIB_USART_ReceiverAddressGet(settings->usart)));
+    PLIB_DMA_ChannelXSourceSizeSet(DMA_ID_0, settings->rx_dma_channel, 1u);
+    PLIB_DMA_ChannelXCellSizeSet(DMA_ID_0, settings->rx_dma_channel, 1u);
+    PLIB_DMA_ChannelXINTSourceEnable(DMA_ID_0, settings->rx_dma_channel,
+                                     DMA_INT_BLOCK_TRANSFER_COMPLETE);
+
+    SYS_INT_VectorPrioritySet(settings->rx_dma_vector,
+                              INT_PRIORITY_LEVEL6);
+    SYS_INT_VectorSubprioritySet(settings->rx_dma_vector,
+                                 INT_SUBPRIORITY_LEVEL0);
+  }
 }
 
 // Interrupt Handlers
@@ -526,85 +1188,97 @@ static void ResetTimingSettings() {
 /*
  * @brief Called when an input capture event occurs.
  */
-void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_IC), ipl6)
-    InputCaptureEvent(void) {
-  while (!PLIB_IC_BufferIsEmpty(g_hw_settings.input_capture_module)) {
-    uint16_t value = PLIB_IC_Buffer16BitGet(g_hw_settings.input_capture_module);
-    switch (g_transceiver.state) {
+static void InputCaptureHandler() {
+  while (!PLIB_IC_BufferIsEmpty(g_port->hw_settings.input_capture_module)) {
+    uint16_t value = PLIB_IC_Buffer16BitGet(
+        g_port->hw_settings.input_capture_module);
+    switch (g_port->state) {
       case STATE_C_RX_WAIT_FOR_DUB:
-        g_timing.dub_response.start = value;
-        g_transceiver.state = STATE_C_RX_IN_DUB;
+        g_port->timing.dub_response.start = value;
+        g_port->state = STATE_C_RX_IN_DUB;
         break;
       case STATE_C_RX_IN_DUB:
-        g_timing.dub_response.end = value;
+        g_port->timing.dub_response.end = value;
         break;
       case STATE_C_RX_WAIT_FOR_BREAK:
-        g_timing.get_set_response.break_start = value;
-        g_transceiver.state = STATE_C_RX_WAIT_FOR_MARK;
+        g_port->timing.get_set_response.break_start = value;
+        g_port->state = STATE_C_RX_WAIT_FOR_MARK;
         break;
       case STATE_C_RX_WAIT_FOR_MARK:
-        if ((uint16_t) (value - g_timing.get_set_response.break_start) <
+        if ((uint16_t) (value - g_port->timing.get_set_response.break_start) <
             CONTROLLER_RX_BREAK_TIME_MIN) {
           // The break was too short, keep looking for a break
-          g_timing.get_set_response.break_start = value;
-          g_transceiver.state = STATE_C_RX_WAIT_FOR_BREAK;
+          g_port->timing.get_set_response.break_start = value;
+          g_port->state = STATE_C_RX_WAIT_FOR_BREAK;
         } else {
-          g_timing.get_set_response.mark_start = value;
+          g_port->timing.get_set_response.mark_start = value;
           // Break was good, enable UART
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_error_source);
-          PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-          g_transceiver.state = STATE_C_RX_DATA;
+          SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+          SYS_INT_SourceEnable(g_port->hw_settings.usart_rx_source);
+          SYS_INT_SourceStatusClear(g_port->hw_settings.usart_error_source);
+          SYS_INT_SourceEnable(g_port->hw_settings.usart_error_source);
+          PLIB_USART_ReceiverEnable(g_port->hw_settings.usart);
+          g_port->state = STATE_C_RX_DATA;
         }
         break;
       case STATE_C_RX_DATA:
-        g_timing.get_set_response.mark_end = value;
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
+        g_port->timing.get_set_response.mark_end = value;
+        SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+        PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
         break;
 
       case STATE_R_RX_MBB:
         // Rebase the timer to when the falling edge occured.
         RebaseTimer(value);
-        g_transceiver.state = STATE_R_RX_BREAK;
+        g_port->state = STATE_R_RX_BREAK;
         break;
       case STATE_R_RX_BREAK:
         if (value >= RESPONDER_RX_BREAK_TIME_MIN &&
             value <= RESPONDER_RX_BREAK_TIME_MAX) {
           // Break was good, enable UART
-          g_timing.request.break_time = value;
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-          PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-          g_transceiver.state = STATE_R_RX_MARK;
+          g_port->timing.request.break_time = value;
+          if (g_port->hw_settings.use_rx_dma) {
+            StartRXDMA();
+          } else {
+            SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+            SYS_INT_SourceEnable(g_port->hw_settings.usart_rx_source);
+          }
+          PLIB_USART_ReceiverEnable(g_port->hw_settings.usart);
+          g_port->state = STATE_R_RX_MARK;
         } else {
           // Break was out of range.
-          g_transceiver.state = STATE_R_RX_MBB;
+          g_port->state = STATE_R_RX_MBB;
         }
         break;
       case STATE_R_RX_MARK:
-        if ((uint16_t) (value - g_timing.request.break_time) <
+        if ((uint16_t) (value - g_port->timing.request.break_time) <
               RESPONDER_RX_MARK_TIME_MIN ||
-            (uint16_t) (value - g_timing.request.break_time) >
+            (uint16_t) (value - g_port->timing.request.break_time) >
               RESPONDER_RX_MARK_TIME_MAX) {
           // Mark was out of range, rebase timer & switch back to BREAK
           RebaseTimer(value);
 
           // Disable UART
-          PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-          SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          g_transceiver.state = STATE_R_RX_BREAK;
+          StopRXDMA();
+          PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+          SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+          SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+          g_port->state = STATE_R_RX_BREAK;
         } else {
-          g_timing.request.mark_time = value - g_timing.request.break_time;
-          g_transceiver.state = STATE_R_RX_DATA;
+          g_port->timing.request.mark_time =
+              value - g_port->timing.request.break_time;
+          g_port->state = STATE_R_RX_DATA;
+          if (g_port->rx_dma_active) {
+            // The USART flags the next break, so there's no need to capture
+            // each edge.
+            SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+            PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+          }
         }
         break;
 
       case STATE_R_RX_DATA:
-        g_transceiver.last_change = value;
+        g_port->last_change = value;
         break;
 
       case STATE_C_INITIALIZE:
@@ -630,65 +1304,72 @@ void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_IC), ipl6)
         {};
     }
   }
-  SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
 }
 
 /*
  * @brief Called when the timer expires.
  */
-void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6)
-    Transceiver_TimerEvent() {
-  switch (g_transceiver.state) {
+static void TimerHandler() {
+  switch (g_port->state) {
     case STATE_C_IN_BREAK:
     case STATE_R_TX_BREAK:
       // Transition to MAB.
       SetMark();
-      g_transceiver.state = g_transceiver.state == STATE_C_IN_BREAK ?
+      g_port->state = g_port->state == STATE_C_IN_BREAK ?
           STATE_C_IN_MARK : STATE_R_TX_MARK;
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id,
-                              g_timing_settings.mark_ticks);
+      PLIB_TMR_Counter16BitClear(g_port->hw_settings.timer_module_id);
+      PLIB_TMR_Period16BitSet(g_port->hw_settings.timer_module_id,
+                              g_port->timing_settings.mark_ticks);
       break;
     case STATE_C_IN_MARK:
       // Stop the timer.
-      SYS_INT_SourceDisable(g_hw_settings.timer_source);
-      PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+      SYS_INT_SourceDisable(g_port->hw_settings.timer_source);
+      PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
 
       // Transition to sending the data.
+      if (g_port->hw_settings.use_tx_dma) {
+        StartTXDMA();
+        PLIB_USART_Enable(g_port->hw_settings.usart);
+        PLIB_USART_TransmitterEnable(g_port->hw_settings.usart);
+        g_port->state = STATE_C_TX_DATA;
+        break;
+      }
+
       // Only push a single byte into the TX queue at the begining, otherwise
       // we blow our timing budget.
-      if (!PLIB_USART_TransmitterBufferIsFull(g_hw_settings.usart) &&
-          g_transceiver.data_index != g_transceiver.active->size) {
+      if (!PLIB_USART_TransmitterBufferIsFull(g_port->hw_settings.usart) &&
+          g_port->data_index != g_port->active->size) {
         PLIB_USART_TransmitterByteSend(
-            g_hw_settings.usart,
-            g_transceiver.active->data[g_transceiver.data_index]);
-        g_transceiver.data_index++;
+            g_port->hw_settings.usart,
+            g_port->active->data[g_port->data_index]);
+        g_port->data_index++;
       }
-      PLIB_USART_Enable(g_hw_settings.usart);
-      PLIB_USART_TransmitterEnable(g_hw_settings.usart);
-      g_transceiver.state = STATE_C_TX_DATA;
-      SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-      SYS_INT_SourceEnable(g_hw_settings.usart_tx_source);
+      PLIB_USART_Enable(g_port->hw_settings.usart);
+      PLIB_USART_TransmitterEnable(g_port->hw_settings.usart);
+      g_port->state = STATE_C_TX_DATA;
+      SYS_INT_SourceStatusClear(g_port->hw_settings.usart_tx_source);
+      SYS_INT_SourceEnable(g_port->hw_settings.usart_tx_source);
       break;
     case STATE_R_TX_WAITING:
       EnableTX();
 
-      if (g_transceiver.active->op == OP_RDM_WITH_RESPONSE) {
+      if (g_port->active->op == OP_RDM_WITH_RESPONSE) {
         SetBreak();
-        PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+        PLIB_TMR_PrescaleSelect(g_port->hw_settings.timer_module_id,
                                 TMR_PRESCALE_VALUE_1);
-        PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
-        PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id,
-                                g_timing_settings.break_ticks);
-        g_transceiver.state = STATE_R_TX_BREAK;
+        PLIB_TMR_Counter16BitClear(g_port->hw_settings.timer_module_id);
+        PLIB_TMR_Period16BitSet(g_port->hw_settings.timer_module_id,
+                                g_port->timing_settings.break_ticks);
+        g_port->state = STATE_R_TX_BREAK;
       } else {
-        SYS_INT_SourceDisable(g_hw_settings.timer_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.timer_source);
         StartSendingRDMResponse();
       }
       break;
     case STATE_R_TX_MARK:
-      SYS_INT_SourceDisable(g_hw_settings.timer_source);
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      SYS_INT_SourceDisable(g_port->hw_settings.timer_source);
+      PLIB_TMR_PrescaleSelect(g_port->hw_settings.timer_module_id,
                               TMR_PRESCALE_VALUE_8);
 
       StartSendingRDMResponse();
@@ -719,7 +1400,7 @@ void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6)
       // Should never happen
       {}
   }
-  SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.timer_source);
 }
 
 /*
@@ -730,147 +1411,155 @@ void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6)
  *  - The USART RX buffer has data.
  *  - A USART RX error has occurred.
  */
-void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6)
-    Transceiver_UARTEvent() {
-  if (SYS_INT_SourceStatusGet(g_hw_settings.usart_tx_source)) {
-    if (g_transceiver.state == STATE_C_TX_DATA) {
+static void UARTHandler() {
+  if (SYS_INT_SourceStatusGet(g_port->hw_settings.usart_tx_source)) {
+    if (g_port->state == STATE_C_TX_DATA) {
       UART_TXBytes();
-      if (g_transceiver.data_index == g_transceiver.active->size) {
+      if (g_port->data_index == g_port->active->size) {
         PLIB_USART_TransmitterInterruptModeSelect(
-            g_hw_settings.usart, USART_TRANSMIT_FIFO_IDLE);
-        g_transceiver.state = STATE_C_TX_DRAIN;
+            g_port->hw_settings.usart, USART_TRANSMIT_FIFO_IDLE);
+        g_port->state = STATE_C_TX_DRAIN;
       }
-    } else if (g_transceiver.state == STATE_C_TX_DRAIN) {
+    } else if (g_port->state == STATE_C_TX_DRAIN) {
       // The last byte has been transmitted
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
+      PLIB_TMR_Counter16BitClear(g_port->hw_settings.timer_module_id);
       // 6.5 ms until overflow.
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id, 65535u);
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      PLIB_TMR_Period16BitSet(g_port->hw_settings.timer_module_id, 65535u);
+      PLIB_TMR_PrescaleSelect(g_port->hw_settings.timer_module_id,
                               TMR_PRESCALE_VALUE_8);
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      PLIB_TMR_Start(g_port->hw_settings.timer_module_id);
 
-      g_transceiver.tx_frame_end = CoarseTimer_GetTime();
-      SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
+      g_port->tx_frame_end = CoarseTimer_GetTime();
+      SYS_INT_SourceDisable(g_port->hw_settings.usart_tx_source);
+      PLIB_USART_TransmitterDisable(g_port->hw_settings.usart);
 
-      if (g_transceiver.active->op == OP_TX_ONLY) {
-        PLIB_USART_Disable(g_hw_settings.usart);
+      if (g_port->active->op == OP_TX_ONLY) {
+        PLIB_USART_Disable(g_port->hw_settings.usart);
         SetMark();
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        g_transceiver.state = STATE_C_COMPLETE;
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
+        g_port->state = STATE_C_COMPLETE;
       } else {
         // Switch to RX Mode.
-        if (g_transceiver.active->op == OP_RDM_DUB) {
-          g_transceiver.state = STATE_C_RX_WAIT_FOR_DUB;
-          g_transceiver.data_index = 0u;
+        if (g_port->active->op == OP_RDM_DUB) {
+          g_port->state = STATE_C_RX_WAIT_FOR_DUB;
+          g_port->data_index = 0u;
 
           // Turn around the line
           EnableRX();
           UART_FlushRX();
 
-          PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
-                                         IC_EDGE_FALLING);
-          PLIB_IC_Enable(g_hw_settings.input_capture_module);
-          SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-          SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+          PLIB_IC_FirstCaptureEdgeSelect(
+              g_port->hw_settings.input_capture_module, IC_EDGE_FALLING);
+          PLIB_IC_Enable(g_port->hw_settings.input_capture_module);
+          SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
+          SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
 
           // TODO(simon) I think we can remove this because its done in the IC
           // ISR
-          PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_error_source);
-
-        } else if (g_transceiver.active->op == OP_RDM_BROADCAST &&
-                   g_timing_settings.rdm_broadcast_timeout == 0u) {
+          PLIB_USART_ReceiverEnable(g_port->hw_settings.usart);
+          SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+          SYS_INT_SourceEnable(g_port->hw_settings.usart_rx_source);
+          SYS_INT_SourceStatusClear(g_port->hw_settings.usart_error_source);
+          SYS_INT_SourceEnable(g_port->hw_settings.usart_error_source);
+
+        } else if (g_port->active->op == OP_RDM_BROADCAST &&
+                   g_port->timing_settings.rdm_broadcast_timeout == 0u) {
           // Go directly to the complete state.
-          PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-          g_transceiver.state = STATE_C_COMPLETE;
+          PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
+          g_port->state = STATE_C_COMPLETE;
         } else {
           // Either T_OP_RDM_WITH_RESPONSE or a non-0 broadcast listen time.
-          g_transceiver.rdm_response_timeout = (
-              g_transceiver.active->op == OP_RDM_BROADCAST ?
-              g_timing_settings.rdm_broadcast_timeout :
-              g_timing_settings.rdm_response_timeout);
-          g_transceiver.state = STATE_C_RX_WAIT_FOR_BREAK;
-          g_transceiver.data_index = 0u;
+          g_port->rdm_response_timeout = (
+              g_port->active->op == OP_RDM_BROADCAST ?
+              g_port->timing_settings.rdm_broadcast_timeout :
+              g_port->timing_settings.rdm_response_timeout);
+          g_port->state = STATE_C_RX_WAIT_FOR_BREAK;
+          g_port->data_index = 0u;
 
           EnableRX();
           UART_FlushRX();
 
-          PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
-                                         IC_EDGE_FALLING);
-          PLIB_IC_Enable(g_hw_settings.input_capture_module);
-          SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-          SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+          PLIB_IC_FirstCaptureEdgeSelect(
+              g_port->hw_settings.input_capture_module, IC_EDGE_FALLING);
+          PLIB_IC_Enable(g_port->hw_settings.input_capture_module);
+          SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
+          SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
         }
       }
-    } else if (g_transceiver.state == STATE_R_TX_DATA) {
+    } else if (g_port->state == STATE_R_TX_DATA) {
       UART_TXBytes();
-      if (g_transceiver.data_index == g_transceiver.active->size) {
+      if (g_port->data_index == g_port->active->size) {
         PLIB_USART_TransmitterInterruptModeSelect(
-            g_hw_settings.usart, USART_TRANSMIT_FIFO_IDLE);
-        g_transceiver.state = STATE_R_TX_DRAIN;
+            g_port->hw_settings.usart, USART_TRANSMIT_FIFO_IDLE);
+        g_port->state = STATE_R_TX_DRAIN;
       }
-    } else if (g_transceiver.state == STATE_R_TX_DRAIN) {
+    } else if (g_port->state == STATE_R_TX_DRAIN) {
       EnableRX();
-      SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      g_transceiver.state = STATE_R_TX_COMPLETE;
+      SYS_INT_SourceDisable(g_port->hw_settings.usart_tx_source);
+      PLIB_USART_TransmitterDisable(g_port->hw_settings.usart);
+      g_port->state = STATE_R_TX_COMPLETE;
     }
-    SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-  } else if (SYS_INT_SourceStatusGet(g_hw_settings.usart_rx_source)) {
-    if (g_transceiver.state == STATE_C_RX_IN_DUB ||
-        g_transceiver.state == STATE_C_RX_DATA) {
+    SYS_INT_SourceStatusClear(g_port->hw_settings.usart_tx_source);
+  } else if (SYS_INT_SourceStatusGet(g_port->hw_settings.usart_rx_source) &&
+             !g_port->rx_dma_active) {
+    if (g_port->state == STATE_C_RX_IN_DUB ||
+        g_port->state == STATE_C_RX_DATA) {
       if (UART_RXBytes()) {
         // RX buffer is full.
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
         ResetToMark();
-        g_transceiver.result = T_RESULT_RX_INVALID;
-        g_transceiver.state = STATE_C_COMPLETE;
+        g_port->result = T_RESULT_RX_INVALID;
+        g_port->state = STATE_C_COMPLETE;
       }
-    } else if (g_transceiver.state == STATE_R_RX_DATA) {
-      if (PLIB_USART_ErrorsGet(g_hw_settings.usart) & USART_ERROR_FRAMING) {
+    } else if (g_port->state == STATE_R_RX_DATA) {
+      if (PLIB_USART_ErrorsGet(g_port->hw_settings.usart) &
+          USART_ERROR_FRAMING) {
         // A framing error indicates a possible break.
         // Switch out of RX mode and back into the break state.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
         UART_FlushRX();
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
 
         // TODO(simon): how to handle this?
         // We need to make sure the last byte was delivered.
-        RebaseTimer(g_transceiver.last_change);
-        g_transceiver.data_index = 0u;
-        g_transceiver.event_index = 0u;
-        g_transceiver.state = STATE_R_RX_BREAK;
+        PublishDMXFrame(g_port->active->data, g_port->data_index);
+        RebaseTimer(g_port->last_change);
+        g_port->data_index = 0u;
+        g_port->event_index = 0u;
+        g_port->state = STATE_R_RX_BREAK;
       } else if (UART_RXBytes()) {
-        // RX buffer is full.
+        // RX buffer is full, which is a complete DMX frame.
         // TODO(simon): What should we do here?
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
+        PublishDMXFrame(g_port->active->data, g_port->data_index);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
 
-        g_transceiver.state = STATE_R_TX_COMPLETE;
+        g_port->state = STATE_R_TX_COMPLETE;
       }
     }
-    SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-  } else if (SYS_INT_SourceStatusGet(g_hw_settings.usart_error_source)) {
-    switch (g_transceiver.state) {
+    SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+  } else if (SYS_INT_SourceStatusGet(g_port->hw_settings.usart_error_source)) {
+    switch (g_port->state) {
       case STATE_C_RX_IN_DUB:
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
+        SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+        PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
         // Fall through
       case STATE_C_RX_DATA:
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
         ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        g_port->state = STATE_C_COMPLETE;
+        break;
+      case STATE_R_RX_DATA:
+        if (g_port->rx_dma_active) {
+          RXDMAFrameComplete();
+        }
         break;
       case STATE_C_INITIALIZE:
       case STATE_C_TX_READY:
@@ -888,7 +1577,6 @@ void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6)
       case STATE_R_RX_PREPARE:
       case STATE_R_RX_BREAK:
       case STATE_R_RX_MARK:
-      case STATE_R_RX_DATA:
       case STATE_R_RX_MBB:
       case STATE_R_TX_WAITING:
       case STATE_R_TX_BREAK:
@@ -901,83 +1589,177 @@ void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6)
         // Should never happen.
         {}
     }
-    SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
+    SYS_INT_SourceStatusClear(g_port->hw_settings.usart_error_source);
+  }
+}
+
+/*
+ * @brief TX DMA Interrupt handler.
+ *
+ * This is called once the DMA channel has moved the last byte of a block into
+ * the USART TX FIFO.
+ */
+static void TXDMAHandler() {
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0,
+                                      g_port->hw_settings.tx_dma_channel,
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  SYS_INT_SourceDisable(g_port->hw_settings.tx_dma_source);
+
+  if (g_port->state == STATE_C_TX_DATA ||
+      g_port->state == STATE_R_TX_DATA) {
+    g_port->data_index = g_port->tx_dma_end;
+    if (g_port->data_index != g_port->active->size) {
+      StartTXDMA();
+      return;
+    }
+    // Let the UART ISR know once the FIFO has drained.
+    PLIB_USART_TransmitterInterruptModeSelect(g_port->hw_settings.usart,
+                                              USART_TRANSMIT_FIFO_IDLE);
+    g_port->state = g_port->state == STATE_C_TX_DATA ?
+        STATE_C_TX_DRAIN : STATE_R_TX_DRAIN;
+    SYS_INT_SourceStatusClear(g_port->hw_settings.usart_tx_source);
+    SYS_INT_SourceEnable(g_port->hw_settings.usart_tx_source);
   }
+  SYS_INT_SourceStatusClear(g_port->hw_settings.tx_dma_source);
+}
+
+/*
+ * @brief RX DMA Interrupt handler.
+ *
+ * This is called once the DMA channel has filled a block of the active buffer.
+ * The channel is re-armed for the next block, until the buffer is full.
+ */
+static void RXDMAHandler() {
+  if (g_port->rx_dma_active) {
+    uint16_t block_end = g_port->rx_dma_offset + RXDMABlockSize();
+    if (block_end == BUFFER_SIZE) {
+      // The buffer is full. Leave the flag set so RXDMACount() includes the
+      // final block.
+      SYS_INT_SourceDisable(g_port->hw_settings.rx_dma_source);
+    } else {
+      g_port->rx_dma_offset = block_end;
+      ArmRXDMABlock();
+    }
+  }
+  SYS_INT_SourceStatusClear(g_port->hw_settings.rx_dma_source);
+}
+
+// ISRs
+// ----------------------------------------------------------------------------
+/*
+ * @brief Run an interrupt handler with a port selected.
+ */
+static inline void RunHandler(unsigned int index, void (*handler)()) {
+  TransceiverPort *previous = g_port;
+  g_port = &g_ports[index];
+  handler();
+  g_port = previous;
 }
 
+/*
+ * @brief Run a function with each port selected in turn.
+ */
+static void ForEachPort(void (*function)()) {
+  unsigned int i = 0u;
+  for (; i < TRANSCEIVER_PORT_COUNT; i++) {
+    RunHandler(i, function);
+  }
+}
+
+void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_IC), ipl6)
+    InputCaptureEvent(void) {
+  RunHandler(0u, InputCaptureHandler);
+}
+
+void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6)
+    Transceiver_TimerEvent() {
+  RunHandler(0u, TimerHandler);
+}
+
+void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6)
+    Transceiver_UARTEvent() {
+  RunHandler(0u, UARTHandler);
+}
+
+void __ISR(AS_DMA_ISR_VECTOR(TRANSCEIVER_TX_DMA_CHANNEL), ipl6)
+    Transceiver_DMAEvent() {
+  RunHandler(0u, TXDMAHandler);
+}
+
+void __ISR(AS_DMA_ISR_VECTOR(TRANSCEIVER_RX_DMA_CHANNEL), ipl6)
+    Transceiver_RXDMAEvent() {
+  RunHandler(0u, RXDMAHandler);
+}
+
+/*
+ * @brief Define the ISRs for one of the additional ports.
+ *
+ * The vector numbers are required at compile time, so each port has its own
+ * ISRs, which select the port and then run the common handler.
+ */
+#define DEFINE_PORT_ISRS(index, uart, timer, ic, tx_dma_channel, \
+                         rx_dma_channel) \
+  void __ISR(AS_IC_ISR_VECTOR(ic), ipl6) InputCaptureEvent ## index(void) { \
+    RunHandler(index, InputCaptureHandler); \
+  } \
+  void __ISR(AS_TIMER_ISR_VECTOR(timer), ipl6) \
+      Transceiver_TimerEvent ## index() { \
+    RunHandler(index, TimerHandler); \
+  } \
+  void __ISR(AS_USART_ISR_VECTOR(uart), ipl6) \
+      Transceiver_UARTEvent ## index() { \
+    RunHandler(index, UARTHandler); \
+  } \
+  void __ISR(AS_DMA_ISR_VECTOR(tx_dma_channel), ipl6) \
+      Transceiver_DMAEvent ## index() { \
+    RunHandler(index, TXDMAHandler); \
+  } \
+  void __ISR(AS_DMA_ISR_VECTOR(rx_dma_channel), ipl6) \
+      Transceiver_RXDMAEvent ## index() { \
+    RunHandler(index, RXDMAHandler); \
+  }
+
+#if TRANSCEIVER_PORT_COUNT > 1
+DEFINE_PORT_ISRS(1, TRANSCEIVER_1_UART, TRANSCEIVER_1_TIMER, TRANSCEIVER_1_IC,
+                 TRANSCEIVER_1_TX_DMA_CHANNEL, TRANSCEIVER_1_RX_DMA_CHANNEL)
+#endif
+
+#if TRANSCEIVER_PORT_COUNT > 2
+DEFINE_PORT_ISRS(2, TRANSCEIVER_2_UART, TRANSCEIVER_2_TIMER, TRANSCEIVER_2_IC,
+                 TRANSCEIVER_2_TX_DMA_CHANNEL, TRANSCEIVER_2_RX_DMA_CHANNEL)
+#endif
+
+#if TRANSCEIVER_PORT_COUNT > 3
+DEFINE_PORT_ISRS(3, TRANSCEIVER_3_UART, TRANSCEIVER_3_TIMER, TRANSCEIVER_3_IC,
+                 TRANSCEIVER_3_TX_DMA_CHANNEL, TRANSCEIVER_3_RX_DMA_CHANNEL)
+#endif
+
 // Public API Functions
 // ----------------------------------------------------------------------------
 void Transceiver_Initialize(const TransceiverHardwareSettings* settings,
                             TransceiverEventCallback tx_callback,
                             TransceiverEventCallback rx_callback) {
-  g_hw_settings = *settings;
   g_tx_callback = tx_callback;
   g_rx_callback = rx_callback;
 
-  g_transceiver.state = STATE_R_INITIALIZE;
-  g_transceiver.mode = T_MODE_RESPONDER;
-  g_transceiver.desired_mode = T_MODE_RESPONDER;
-  g_transceiver.data_index = 0u;
-
-  InitializeBuffers();
-  ResetTimingSettings();
-
-  // Setup the Break, TX Enable & RX Enable I/O Pins
-  PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
-                                   g_hw_settings.port,
-                                   g_hw_settings.break_bit);
-  PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
-                                   g_hw_settings.port,
-                                   g_hw_settings.tx_enable_bit);
-  PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
-                                   g_hw_settings.port,
-                                   g_hw_settings.rx_enable_bit);
-
-  // Setup the timer
-  PLIB_TMR_ClockSourceSelect(g_hw_settings.timer_module_id,
-                             TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK);
-  PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id, TMR_PRESCALE_VALUE_1);
-  PLIB_TMR_Mode16BitEnable(g_hw_settings.timer_module_id);
-  SYS_INT_VectorPrioritySet(g_hw_settings.timer_vector, INT_PRIORITY_LEVEL1);
-  SYS_INT_VectorSubprioritySet(g_hw_settings.timer_vector,
-                               INT_SUBPRIORITY_LEVEL0);
-
-  // Setup the UART
-  PLIB_USART_BaudRateSet(g_hw_settings.usart,
-                         SYS_CLK_PeripheralFrequencyGet(CLK_BUS_PERIPHERAL_1),
-                         DMX_BAUD);
-  PLIB_USART_HandshakeModeSelect(g_hw_settings.usart,
-                                 USART_HANDSHAKE_MODE_SIMPLEX);
-  PLIB_USART_OperationModeSelect(g_hw_settings.usart,
-                                 USART_ENABLE_TX_RX_USED);
-  PLIB_USART_LineControlModeSelect(g_hw_settings.usart, USART_8N2);
-  PLIB_USART_SyncModeSelect(g_hw_settings.usart, USART_ASYNC_MODE);
-  PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
-                                            USART_TRANSMIT_FIFO_EMPTY);
-
-  SYS_INT_VectorPrioritySet(g_hw_settings.usart_vector,
-                            INT_PRIORITY_LEVEL6);
-  SYS_INT_VectorSubprioritySet(g_hw_settings.usart_vector,
-                               INT_SUBPRIORITY_LEVEL0);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
+  unsigned int i = 0u;
+  for (; i < TRANSCEIVER_PORT_COUNT; i++) {
+    g_port = &g_ports[i];
+    InitializePort(&settings[i]);
+  }
+  g_port = &g_ports[0];
+}
 
-  // Setup input capture
-  PLIB_IC_Disable(g_hw_settings.input_capture_module);
-  PLIB_IC_ModeSelect(g_hw_settings.input_capture_module,
-                     IC_INPUT_CAPTURE_EVERY_EDGE_MODE);
-  PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
-                                 IC_EDGE_RISING);
-  PLIB_IC_TimerSelect(g_hw_settings.input_capture_module,
-                      g_hw_settings.input_capture_timer);
-  PLIB_IC_BufferSizeSelect(g_hw_settings.input_capture_module,
-                           IC_BUFFER_SIZE_16BIT);
-  PLIB_IC_EventsPerInterruptSelect(g_hw_settings.input_capture_module,
-                                   IC_INTERRUPT_ON_EVERY_CAPTURE_EVENT);
+bool Transceiver_SelectPort(uint8_t port) {
+  if (port >= TRANSCEIVER_PORT_COUNT) {
+    return false;
+  }
+  g_port = &g_ports[port];
+  return true;
+}
 
-  SYS_INT_VectorPrioritySet(g_hw_settings.input_capture_vector,
-                            INT_PRIORITY_LEVEL6);
-  SYS_INT_VectorSubprioritySet(g_hw_settings.input_capture_vector,
-                               INT_SUBPRIORITY_LEVEL0);
+uint8_t Transceiver_GetPort() {
+  return g_port - g_ports;
 }
 
 void Transceiver_SetMode(TransceiverMode mode) {
@@ -987,38 +1769,52 @@ void Transceiver_SetMode(TransceiverMode mode) {
     SysLog_Print(SYSLOG_INFO, "Switching to Responder mode");
   }
 
-  g_transceiver.desired_mode = mode;
+  g_port->desired_mode = mode;
 }
 
 TransceiverMode Transceiver_GetMode() {
-  return g_transceiver.mode;
+  return g_port->mode;
 }
 
-void Transceiver_Tasks() {
+/*
+ * @brief Perform the periodic tasks for the selected port.
+ */
+static void PortTasks() {
   bool ok;
   LogStateChange();
+  ReleasePinnedBuffer();
+  DeliverRXDMAFrame();
 
-  switch (g_transceiver.state) {
+  switch (g_port->state) {
     case STATE_C_INITIALIZE:
-      PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-      PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      PLIB_USART_Disable(g_hw_settings.usart);
-      PLIB_IC_Disable(g_hw_settings.input_capture_module);
+      PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
+      StopTXDMA();
+      PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+      PLIB_USART_TransmitterDisable(g_port->hw_settings.usart);
+      PLIB_USART_Disable(g_port->hw_settings.usart);
+      PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
       ResetToMark();
-      g_transceiver.state = STATE_C_TX_READY;
+      g_port->state = STATE_C_TX_READY;
       // Fall through
     case STATE_C_TX_READY:
-      if (g_transceiver.desired_mode != T_MODE_CONTROLLER) {
-        TakeNextBuffer();
+      if (g_port->desired_mode != T_MODE_CONTROLLER) {
+        // Discard any queued frames.
+        while (g_port->queue_size) {
+          TakeNextBuffer();
+        }
         FreeActiveBuffer();
         SysLog_Print(SYSLOG_INFO, "Switched to responder mode");
-        g_transceiver.mode = g_transceiver.desired_mode;
-        g_transceiver.state = STATE_R_INITIALIZE;
+        g_port->mode = g_port->desired_mode;
+        g_port->state = STATE_R_INITIALIZE;
         break;
       }
 
-      if (!g_transceiver.next) {
+      // Queued operations take priority over the DMX stream.
+      if (g_port->queue_size) {
+        TakeNextBuffer();
+      } else if (StreamFrameDue()) {
+        TakeStreamBuffer();
+      } else {
         return;
       }
       // @pre Timer is not running.
@@ -1028,31 +1824,29 @@ void Transceiver_Tasks() {
       // @pre RX InputCapture is disabled.
       // @pre line in marking state
 
-      TakeNextBuffer();
-
       // Reset state
-      g_transceiver.found_expected_length = false;
-      g_transceiver.expected_length = 0u;
-      g_transceiver.result = T_RESULT_TX_OK;
-      memset(&g_timing, 0, sizeof(g_timing));
+      g_port->found_expected_length = false;
+      g_port->expected_length = 0u;
+      g_port->result = T_RESULT_TX_OK;
+      memset(&g_port->timing, 0, sizeof(g_port->timing));
 
       // Prepare the UART
       // Set UART Interrupts when the buffer is empty.
-      PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
+      PLIB_USART_TransmitterInterruptModeSelect(g_port->hw_settings.usart,
                                                 USART_TRANSMIT_FIFO_EMPTY);
 
       // Set break and start timer.
-      g_transceiver.state = STATE_C_IN_BREAK;
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      g_port->state = STATE_C_IN_BREAK;
+      PLIB_TMR_PrescaleSelect(g_port->hw_settings.timer_module_id,
                               TMR_PRESCALE_VALUE_1);
-      g_transceiver.tx_frame_start = CoarseTimer_GetTime();
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id,
-                              g_timing_settings.break_ticks);
-      SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
-      SYS_INT_SourceEnable(g_hw_settings.timer_source);
+      g_port->tx_frame_start = CoarseTimer_GetTime();
+      PLIB_TMR_Counter16BitClear(g_port->hw_settings.timer_module_id);
+      PLIB_TMR_Period16BitSet(g_port->hw_settings.timer_module_id,
+                              g_port->timing_settings.break_ticks);
+      SYS_INT_SourceStatusClear(g_port->hw_settings.timer_source);
+      SYS_INT_SourceEnable(g_port->hw_settings.timer_source);
       SetBreak();
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      PLIB_TMR_Start(g_port->hw_settings.timer_module_id);
 
     case STATE_C_IN_BREAK:
     case STATE_C_IN_MARK:
@@ -1064,102 +1858,107 @@ void Transceiver_Tasks() {
       break;
 
     case STATE_C_RX_WAIT_FOR_BREAK:
-      if (CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
-                                 g_transceiver.rdm_response_timeout)) {
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
+      if (CoarseTimer_HasElapsed(g_port->tx_frame_end,
+                                 g_port->rdm_response_timeout)) {
+        SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
         // Note: the IC ISR may have run between the case check and the
         // SourceDisable and switched us to STATE_C_RX_WAIT_FOR_MARK.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+        PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
         ResetToMark();
-        g_transceiver.state = STATE_C_RX_TIMEOUT;
+        g_port->state = STATE_C_RX_TIMEOUT;
       }
       break;
 
     case STATE_C_RX_WAIT_FOR_MARK:
       // Disable interupts so we don't race
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      if (g_transceiver.state == STATE_C_RX_WAIT_FOR_MARK &&
-          ((uint16_t) (PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) -
-            g_timing.get_set_response.break_start) >
+      SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+      if (g_port->state == STATE_C_RX_WAIT_FOR_MARK &&
+          ((uint16_t) (
+              PLIB_TMR_Counter16BitGet(g_port->hw_settings.timer_module_id) -
+              g_port->timing.get_set_response.break_start) >
             CONTROLLER_RX_BREAK_TIME_MAX)) {
         // Break was too long
-        g_transceiver.result = T_RESULT_RX_INVALID;
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+        g_port->result = T_RESULT_RX_INVALID;
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
         ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        g_port->state = STATE_C_COMPLETE;
       } else {
-        SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+        SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
       }
       break;
 
     case STATE_C_RX_DATA:
       // TODO(simon): handle the timeout case here.
       // It's not a static timeout, rather it varies with the slot count.
-      // PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+      // PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
       break;
 
     case STATE_C_RX_WAIT_FOR_DUB:
-      if (CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
-                                 g_timing_settings.rdm_response_timeout)) {
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
+      if (CoarseTimer_HasElapsed(
+              g_port->tx_frame_end,
+              g_port->timing_settings.rdm_response_timeout)) {
+        SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
         // Note: the IC ISR may have run between the case check and the
         // SourceDisable and switched us to STATE_C_RX_IN_DUB.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+        PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
         ResetToMark();
-        g_transceiver.state = STATE_C_RX_TIMEOUT;
+        g_port->state = STATE_C_RX_TIMEOUT;
       }
       break;
     case STATE_C_RX_IN_DUB:
-      if ((uint16_t) (PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) -
-                      g_timing.dub_response.start) >
-           g_timing_settings.rdm_dub_response_limit) {
+      if ((uint16_t) (
+              PLIB_TMR_Counter16BitGet(g_port->hw_settings.timer_module_id) -
+              g_port->timing.dub_response.start) >
+           g_port->timing_settings.rdm_dub_response_limit) {
         // The UART Error interupt may have fired, putting us into
         // STATE_C_COMPLETE, already.
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+        SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+        SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+        PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+        PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
         ResetToMark();
         // We got at least a falling edge, so this should probably be
         // considered a collision, rather than a timeout.
-        g_transceiver.state = STATE_C_COMPLETE;
+        g_port->state = STATE_C_COMPLETE;
       }
       break;
 
     case STATE_C_RX_TIMEOUT:
       SysLog_Message(SYSLOG_INFO, "RX timeout");
-      g_transceiver.state = STATE_C_COMPLETE;
-      g_transceiver.result = T_RESULT_RX_TIMEOUT;
+      g_port->state = STATE_C_COMPLETE;
+      g_port->result = T_RESULT_RX_TIMEOUT;
       break;
     case STATE_C_COMPLETE:
-      if (g_transceiver.active->op == OP_RDM_DUB) {
-        SysLog_Print(SYSLOG_INFO, "First DUB: %d", g_timing.dub_response.start);
-        SysLog_Print(SYSLOG_INFO, "Last DUB: %d", g_timing.dub_response.end);
+      if (g_port->active->op == OP_RDM_DUB) {
+        SysLog_Print(SYSLOG_INFO, "First DUB: %d",
+                     g_port->timing.dub_response.start);
+        SysLog_Print(SYSLOG_INFO, "Last DUB: %d",
+                     g_port->timing.dub_response.end);
       }
-      if (g_transceiver.active->op == OP_RDM_WITH_RESPONSE) {
+      if (g_port->active->op == OP_RDM_WITH_RESPONSE) {
         SysLog_Print(SYSLOG_INFO, "break: %d",
-                     g_timing.get_set_response.break_start);
+                     g_port->timing.get_set_response.break_start);
         SysLog_Print(SYSLOG_INFO, "mark start: %d, end: %d",
-                     g_timing.get_set_response.mark_start,
-                     g_timing.get_set_response.mark_end);
+                     g_port->timing.get_set_response.mark_start,
+                     g_port->timing.get_set_response.mark_end);
         SysLog_Print(SYSLOG_INFO, "Break: %d, Mark: %d",
-                     (uint16_t) (g_timing.get_set_response.mark_start -
-                      g_timing.get_set_response.break_start),
-                     (uint16_t) (g_timing.get_set_response.mark_end -
-                      g_timing.get_set_response.mark_start));
+                     (uint16_t) (g_port->timing.get_set_response.mark_start -
+                      g_port->timing.get_set_response.break_start),
+                     (uint16_t) (g_port->timing.get_set_response.mark_end -
+                      g_port->timing.get_set_response.mark_start));
       }
       FrameComplete();
-      g_transceiver.state = STATE_C_BACKOFF;
+      g_port->state = STATE_C_BACKOFF;
       // Fall through
     case STATE_C_BACKOFF:
       // From E1.11, the min break-to-break time is 1.204ms.
@@ -1169,23 +1968,23 @@ void Transceiver_Tasks() {
       //  - If bcast, the min EOF to break is 0.176ms
       //  - If lost response, the min EOF to break is 3.0ms
       //  - Any other packet, min EOF to break is 176uS.
-      ok = CoarseTimer_HasElapsed(g_transceiver.tx_frame_start,
+      ok = CoarseTimer_HasElapsed(g_port->tx_frame_start,
                                   CONTROLLER_MIN_BREAK_TO_BREAK);
 
-      switch (g_transceiver.active->op) {
+      switch (g_port->active->op) {
         case OP_TX_ONLY:
           // 176uS min, rounds to 0.2ms.
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(g_port->tx_frame_end,
                                        CONTROLLER_NON_RDM_BACKOFF);
           break;
         case OP_RDM_DUB:
           // It would be nice to be able to reduce this if we didn't get a
           // response, but the standard doesn't allow this.
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(g_port->tx_frame_end,
                                        CONTROLLER_DUB_BACKOFF);
           break;
         case OP_RDM_BROADCAST:
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(g_port->tx_frame_end,
                                        CONTROLLER_BROADCAST_BACKOFF);
           break;
         case OP_RDM_WITH_RESPONSE:
@@ -1193,7 +1992,7 @@ void Transceiver_Tasks() {
           // We can probably make this faster, since the 3ms only
           // applies for no responses. If we do get a response, then it's only
           // a 0.176ms delay, from the end of the response frame.
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(g_port->tx_frame_end,
                                        CONTROLLER_MISSING_RESPONSE_BACKOFF);
           break;
         case OP_RDM_DUB_RESPONSE:
@@ -1204,76 +2003,97 @@ void Transceiver_Tasks() {
       }
 
       if (ok) {
-        FreeActiveBuffer();
-        g_transceiver.state = STATE_C_TX_READY;
+        if (IsPinned(g_port->active)) {
+          // The response is still being sent from this buffer. Park it so we
+          // can move on to the next frame.
+          if (g_port->pinned) {
+            break;
+          }
+          g_port->pinned = g_port->active;
+          g_port->active = NULL;
+        } else {
+          FreeActiveBuffer();
+        }
+        g_port->state = STATE_C_TX_READY;
       }
       break;
     case STATE_R_INITIALIZE:
       // This is done once when we switch to Responder mode
       // Reset the UART
-      PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      PLIB_USART_Enable(g_hw_settings.usart);
+      StopTXDMA();
+      StopRXDMA();
+      PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+      PLIB_USART_TransmitterDisable(g_port->hw_settings.usart);
+      PLIB_USART_Enable(g_port->hw_settings.usart);
       UART_FlushRX();
 
       // Put us into RX mode
       EnableRX();
 
       // Setup the timer
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
+      PLIB_TMR_Counter16BitClear(g_port->hw_settings.timer_module_id);
       // 6.5 ms until overflow.
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id, 65535);
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      PLIB_TMR_Period16BitSet(g_port->hw_settings.timer_module_id, 65535);
+      PLIB_TMR_PrescaleSelect(g_port->hw_settings.timer_module_id,
                               TMR_PRESCALE_VALUE_8);
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      PLIB_TMR_Start(g_port->hw_settings.timer_module_id);
 
       // Fall through
     case STATE_R_RX_PREPARE:
       // Setup RX buffer
-      if (!g_transceiver.active) {
-        if (g_transceiver.free_size == 0u) {
+      if (!g_port->active) {
+        if (g_port->free_size == 0u) {
           SysLog_Message(SYSLOG_INFO, "Lost buffers!");
-          g_transceiver.state = STATE_ERROR;
+          g_port->state = STATE_ERROR;
           return;
         }
 
-        g_transceiver.free_size--;
-        g_transceiver.active = g_transceiver.free_list[g_transceiver.free_size];
+        g_port->free_size--;
+        g_port->active = g_port->free_list[g_port->free_size];
+      }
+      if (g_port->hw_settings.use_rx_dma && !g_port->rx_spare &&
+          g_port->free_size) {
+        // The next frame is received into the spare while this one is
+        // processed.
+        g_port->free_size--;
+        g_port->rx_spare =
+            g_port->free_list[g_port->free_size];
       }
 
       // Reset state variables.
-      g_timing.request.break_time = 0u;
-      g_timing.request.mark_time = 0u;
-      g_transceiver.data_index = 0u;
-      g_transceiver.event_index = 0u;
-      g_transceiver.active->op = OP_RX;
+      g_port->timing.request.break_time = 0u;
+      g_port->timing.request.mark_time = 0u;
+      g_port->data_index = 0u;
+      g_port->event_index = 0u;
+      g_port->active->op = OP_RX;
 
-      g_transceiver.state = STATE_R_RX_MBB;
+      g_port->state = STATE_R_RX_MBB;
 
       // Catch the next falling edge.
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-      PLIB_IC_Disable(g_hw_settings.input_capture_module);
-      PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
+      SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+      SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
+      PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+      PLIB_IC_FirstCaptureEdgeSelect(g_port->hw_settings.input_capture_module,
                                      IC_EDGE_FALLING);
-      PLIB_IC_Enable(g_hw_settings.input_capture_module);
-      SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+      PLIB_IC_Enable(g_port->hw_settings.input_capture_module);
+      SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
 
       // Fall through
     case STATE_R_RX_MBB:
       // noop, waiting for IC event
 
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      if (g_transceiver.desired_mode != T_MODE_RESPONDER) {
-        g_transceiver.mode = g_transceiver.desired_mode;
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+      SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+      if (g_port->desired_mode != T_MODE_RESPONDER) {
+        g_port->mode = g_port->desired_mode;
+        PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
+        PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
         FreeActiveBuffer();
+        FreeRXDMABuffers();
         SysLog_Print(SYSLOG_INFO, "Switched to controller mode");
-        g_transceiver.state = STATE_C_INITIALIZE;
+        g_port->state = STATE_C_INITIALIZE;
         break;
       }
-      SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+      SYS_INT_SourceEnable(g_port->hw_settings.input_capture_source);
       break;
 
     case STATE_R_RX_BREAK:
@@ -1284,37 +2104,42 @@ void Transceiver_Tasks() {
       break;
 
     case STATE_R_RX_DATA:
-      SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
+      if (g_port->rx_dma_active && PollRXDMA()) {
+        break;
+      }
+      SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
 
-      if (g_transceiver.data_index != 0u) {
+      if (g_port->data_index != 0u) {
         // Got at least one byte, so we have the start code.
         // Check the time since the last byte.
-        if ((g_transceiver.active->data[0] == RDM_START_CODE &&
-             CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
+        if ((g_port->active->data[0] == RDM_START_CODE &&
+             CoarseTimer_HasElapsed(g_port->last_byte_coarse,
                                     RESPONDER_RDM_INTERSLOT_TIMEOUT)) ||
-            CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
+            CoarseTimer_HasElapsed(g_port->last_byte_coarse,
                                    RESPONDER_DMX_INTERSLOT_TIMEOUT)) {
           // RDM inter-slot timeout
           RXEndFrameEvent();
-          PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-          g_transceiver.state = STATE_R_RX_PREPARE;
+          PublishDMXFrame(g_port->active->data,
+                          g_port->data_index);
+          PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+          g_port->state = STATE_R_RX_PREPARE;
           break;
         }
       }
 
-      if (g_transceiver.event_index != g_transceiver.data_index) {
+      if (g_port->event_index != g_port->data_index) {
         RXFrameEvent();
-        g_transceiver.event_index = g_transceiver.data_index;
+        g_port->event_index = g_port->data_index;
       }
 
-      if (g_transceiver.next) {
+      if (g_port->queue_size) {
         // Update the seed with the value from the coarse timer. This is a
         // useful source of entropy.
         Random_SetSeed(CoarseTimer_GetTime());
         PrepareRDMResponse();
       } else {
         // Continue receiving
-        SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
+        SYS_INT_SourceEnable(g_port->hw_settings.usart_rx_source);
       }
       break;
     case STATE_R_TX_WAITING:
@@ -1329,13 +2154,13 @@ void Transceiver_Tasks() {
       FreeActiveBuffer();
       break;
     case STATE_R_TX_COMPLETE:
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id, 65535u);
-      g_transceiver.data_index = 0u;
-      g_transceiver.state = STATE_R_RX_PREPARE;
+      PLIB_TMR_Period16BitSet(g_port->hw_settings.timer_module_id, 65535u);
+      g_port->data_index = 0u;
+      g_port->state = STATE_R_RX_PREPARE;
       break;
     case STATE_RESET:
-      g_transceiver.mode = g_transceiver.desired_mode;
-      g_transceiver.state = (g_transceiver.mode == T_MODE_RESPONDER ?
+      g_port->mode = g_port->desired_mode;
+      g_port->state = (g_port->mode == T_MODE_RESPONDER ?
           STATE_R_INITIALIZE : STATE_C_INITIALIZE);
       break;
     case STATE_ERROR:
@@ -1343,6 +2168,10 @@ void Transceiver_Tasks() {
   }
 }
 
+void Transceiver_Tasks() {
+  ForEachPort(PortTasks);
+}
+
 /*
  * Queue an operation.
  * @param token The token for this operation.
@@ -1350,27 +2179,29 @@ void Transceiver_Tasks() {
  * @param op The type of operation.
  * @param data The frame's slot data.
  * @param size The number of slots.
- * @returns true if the operation was queued, false if the buffer was full.
+ * @returns true if the operation was queued, false if the queue was full.
  */
 bool Transceiver_QueueFrame(uint8_t token, uint8_t start_code,
                             InternalOperation op, const uint8_t* data,
                             unsigned int size) {
-  if (g_transceiver.mode == T_MODE_RESPONDER || g_transceiver.free_size == 0u) {
+  if (g_port->mode == T_MODE_RESPONDER) {
     return false;
   }
 
-  g_transceiver.free_size--;
-  g_transceiver.next = g_transceiver.free_list[g_transceiver.free_size];
+  TransceiverBuffer* buffer = QueueBuffer();
+  if (!buffer) {
+    return false;
+  }
 
   if (size > DMX_FRAME_SIZE) {
     size = DMX_FRAME_SIZE;
   }
-  g_transceiver.next->size = size + 1u;  // include start code.
-  g_transceiver.next->op = op;
-  g_transceiver.next->token = token;
-  g_transceiver.next->data[0] = start_code;
+  buffer->size = size + 1u;  // include start code.
+  buffer->op = op;
+  buffer->token = token;
+  buffer->data[0] = start_code;
   SysLog_Print(SYSLOG_INFO, "Start code %d", start_code);
-  memcpy(&g_transceiver.next->data[1], data, size);
+  memcpy(&buffer->data[1], data, size);
   return true;
 }
 
@@ -1404,65 +2235,85 @@ bool Transceiver_QueueRDMRequest(uint8_t token, const uint8_t* data,
 bool Transceiver_QueueRDMResponse(bool include_break,
                                   const IOVec* data,
                                   unsigned int iov_count) {
-  if (g_transceiver.free_size == 0u) {
+  TransceiverBuffer* buffer = QueueBuffer();
+  if (!buffer) {
     return false;
   }
 
-  g_transceiver.free_size--;
-  g_transceiver.next = g_transceiver.free_list[g_transceiver.free_size];
-
   unsigned int i = 0u;
   uint16_t offset = 0u;
   for (; i != iov_count; i++) {
     if (offset + data[i].length > BUFFER_SIZE) {
-      memcpy(g_transceiver.next->data + offset, data[i].base,
-             BUFFER_SIZE - offset);
+      memcpy(buffer->data + offset, data[i].base, BUFFER_SIZE - offset);
       offset = BUFFER_SIZE;
       SysLog_Message(SYSLOG_ERROR, "Truncated RDM response");
       break;
     } else {
-      memcpy(g_transceiver.next->data + offset, data[i].base, data[i].length);
+      memcpy(buffer->data + offset, data[i].base, data[i].length);
       offset += data[i].length;
     }
   }
-  g_transceiver.next->size = offset;
-  g_transceiver.next->op = include_break ? OP_RDM_WITH_RESPONSE :
-                           OP_RDM_DUB_RESPONSE;
+  buffer->size = offset;
+  buffer->op = include_break ? OP_RDM_WITH_RESPONSE : OP_RDM_DUB_RESPONSE;
   return true;
 }
 
 /*
- *  This is called by the MessageHandler, so we know we're not in _Tasks or an
- *  ISR.
+ *  This is called by the dimmer model's tasks, so we know we're not in _Tasks
+ *  or an ISR.
  */
-void Transceiver_Reset() {
+bool Transceiver_GetLatestDMXFrame(TransceiverDMXFrame* frame) {
+  if (g_port->latest_dmx.latest & LATEST_DMX_FRAME_NEW) {
+    g_port->latest_dmx.read_index = __sync_lock_test_and_set(
+        &g_port->latest_dmx.latest, g_port->latest_dmx.read_index) &
+        ~LATEST_DMX_FRAME_NEW;
+  }
+
+  const DMXFrameBuffer* buffer =
+      &g_port->latest_dmx.buffers[g_port->latest_dmx.read_index];
+  if (buffer->sequence == 0u) {
+    return false;
+  }
+  frame->data = buffer->data;
+  frame->size = buffer->size;
+  frame->sequence = buffer->sequence;
+  return true;
+}
+
+/*
+ * @brief Reset the selected port.
+ */
+static void ResetPort() {
   // Disable & clear all interrupts.
-  SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-  SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-  SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
+  SYS_INT_SourceDisable(g_port->hw_settings.usart_tx_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.usart_tx_source);
+  SYS_INT_SourceDisable(g_port->hw_settings.usart_rx_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.usart_rx_source);
+  SYS_INT_SourceDisable(g_port->hw_settings.usart_error_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.usart_error_source);
 
   InitializeBuffers();
 
   // Reset Timer
-  SYS_INT_SourceDisable(g_hw_settings.timer_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
-  PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+  SYS_INT_SourceDisable(g_port->hw_settings.timer_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.timer_source);
+  PLIB_TMR_Stop(g_port->hw_settings.timer_module_id);
 
   // Reset IC
-  SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-  PLIB_IC_Disable(g_hw_settings.input_capture_module);
+  SYS_INT_SourceDisable(g_port->hw_settings.input_capture_source);
+  SYS_INT_SourceStatusClear(g_port->hw_settings.input_capture_source);
+  PLIB_IC_Disable(g_port->hw_settings.input_capture_module);
 
   // Reset UART
-  PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-  PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-  PLIB_USART_Disable(g_hw_settings.usart);
+  StopTXDMA();
+  StopRXDMA();
+  PLIB_USART_ReceiverDisable(g_port->hw_settings.usart);
+  PLIB_USART_TransmitterDisable(g_port->hw_settings.usart);
+  PLIB_USART_Disable(g_port->hw_settings.usart);
 
   // Reset buffers in case we got into a weird state.
   InitializeBuffers();
+  InitializeStream();
 
   // Reset all timing configuration.
   ResetTimingSettings();
@@ -1470,7 +2321,11 @@ void Transceiver_Reset() {
   // Set us back into the TX Mark state.
   ResetToMark();
 
-  g_transceiver.state = STATE_RESET;
+  g_port->state = STATE_RESET;
+}
+
+void Transceiver_Reset() {
+  ForEachPort(ResetPort);
 }
 
 bool Transceiver_SetBreakTime(uint16_t break_time_us) {
@@ -1478,15 +2333,15 @@ bool Transceiver_SetBreakTime(uint16_t break_time_us) {
       break_time_us > MAXIMUM_TX_BREAK_TIME) {
     return false;
   }
-  g_timing_settings.break_time = break_time_us;
+  g_port->timing_settings.break_time = break_time_us;
   uint16_t ticks = MicroSecondsToTicks(break_time_us);
-  g_timing_settings.break_ticks = ticks - BREAK_FUDGE_FACTOR;
+  g_port->timing_settings.break_ticks = ticks - BREAK_FUDGE_FACTOR;
   SysLog_Print(SYSLOG_INFO, "Break ticks is %d", ticks);
   return true;
 }
 
 uint16_t Transceiver_GetBreakTime() {
-  return g_timing_settings.break_time;
+  return g_port->timing_settings.break_time;
 }
 
 bool Transceiver_SetMarkTime(uint16_t mark_time_us) {
@@ -1494,80 +2349,129 @@ bool Transceiver_SetMarkTime(uint16_t mark_time_us) {
       mark_time_us > MAXIMUM_TX_MARK_TIME) {
     return false;
   }
-  g_timing_settings.mark_time = mark_time_us;
+  g_port->timing_settings.mark_time = mark_time_us;
   uint16_t ticks = MicroSecondsToTicks(mark_time_us);
-  g_timing_settings.mark_ticks = ticks - MARK_FUDGE_FACTOR;
+  g_port->timing_settings.mark_ticks = ticks - MARK_FUDGE_FACTOR;
   SysLog_Print(SYSLOG_INFO, "MAB ticks is %d", ticks);
   return true;
 }
 
 uint16_t Transceiver_GetMarkTime() {
-  return g_timing_settings.mark_time;
+  return g_port->timing_settings.mark_time;
 }
 
 bool Transceiver_SetRDMBroadcastTimeout(uint16_t delay) {
   if (delay > 50u) {
     return false;
   }
-  g_timing_settings.rdm_broadcast_timeout = delay;
+  g_port->timing_settings.rdm_broadcast_timeout = delay;
   SysLog_Print(SYSLOG_INFO, "Bcast timeout: %d",
-               g_timing_settings.rdm_broadcast_timeout);
+               g_port->timing_settings.rdm_broadcast_timeout);
   return true;
 }
 
 uint16_t Transceiver_GetRDMBroadcastTimeout() {
-  return g_timing_settings.rdm_broadcast_timeout;
+  return g_port->timing_settings.rdm_broadcast_timeout;
 }
 
 bool Transceiver_SetRDMResponseTimeout(uint16_t delay) {
   if (delay < 10u || delay > 50u) {
     return false;
   }
-  g_timing_settings.rdm_response_timeout = delay;
+  g_port->timing_settings.rdm_response_timeout = delay;
   return true;
 }
 
 uint16_t Transceiver_GetRDMResponseTimeout() {
-  return g_timing_settings.rdm_response_timeout;
+  return g_port->timing_settings.rdm_response_timeout;
 }
 
 bool Transceiver_SetRDMDUBResponseLimit(uint16_t limit) {
   if (limit < 10000u || limit > 35000u) {
     return false;
   }
-  g_timing_settings.rdm_dub_response_limit = limit;
+  g_port->timing_settings.rdm_dub_response_limit = limit;
   return true;
 }
 
 uint16_t Transceiver_GetRDMDUBResponseLimit() {
-  return g_timing_settings.rdm_dub_response_limit;
+  return g_port->timing_settings.rdm_dub_response_limit;
 }
 
 bool Transceiver_SetRDMResponderDelay(uint16_t delay) {
   if (delay < MINIMUM_RESPONDER_DELAY || delay > MAXIMUM_RESPONDER_DELAY) {
     return false;
   }
-  g_timing_settings.rdm_responder_delay = delay;
+  g_port->timing_settings.rdm_responder_delay = delay;
   uint16_t max_jitter = MAXIMUM_RESPONDER_DELAY - delay;
-  g_timing_settings.rdm_responder_jitter = (
-    g_timing_settings.rdm_responder_jitter < max_jitter ?
-    g_timing_settings.rdm_responder_jitter : max_jitter);
+  g_port->timing_settings.rdm_responder_jitter = (
+    g_port->timing_settings.rdm_responder_jitter < max_jitter ?
+    g_port->timing_settings.rdm_responder_jitter : max_jitter);
   return true;
 }
 
 uint16_t Transceiver_GetRDMResponderDelay() {
-  return g_timing_settings.rdm_responder_delay;
+  return g_port->timing_settings.rdm_responder_delay;
 }
 
 bool Transceiver_SetRDMResponderJitter(uint16_t max_jitter) {
-  if ((uint32_t) max_jitter + g_timing_settings.rdm_responder_delay >
+  if ((uint32_t) max_jitter + g_port->timing_settings.rdm_responder_delay >
       MAXIMUM_RESPONDER_DELAY) {
     return false;
   }
-  g_timing_settings.rdm_responder_jitter = max_jitter;
+  g_port->timing_settings.rdm_responder_jitter = max_jitter;
   return true;
 }
 
 uint16_t Transceiver_GetRDMResponderJitter() {
-  return g_timing_settings.rdm_responder_jitter;
+  return g_port->timing_settings.rdm_responder_jitter;
+}
+
+bool Transceiver_StartDMXStream(const uint8_t* data, unsigned int size) {
+  if (size > DMX_FRAME_SIZE) {
+    return false;
+  }
+
+  g_port->stream.back->size = size + 1u;  // include start code.
+  memcpy(&g_port->stream.back->data[1], data, size);
+  g_port->stream.updated = true;
+  g_port->stream.enabled = true;
+  return true;
+}
+
+bool Transceiver_UpdateDMXStream(uint16_t offset, const uint8_t* data,
+                                 unsigned int size) {
+  // The size of the back buffer includes the start code.
+  if ((uint32_t) offset + size > g_port->stream.back->size - 1u) {
+    return false;
+  }
+
+  memcpy(&g_port->stream.back->data[1u + offset], data, size);
+  g_port->stream.updated = true;
+  return true;
+}
+
+unsigned int Transceiver_GetDMXStreamSize() {
+  // The size of the back buffer includes the start code.
+  return g_port->stream.back->size - 1u;
+}
+
+void Transceiver_StopDMXStream() {
+  g_port->stream.enabled = false;
+}
+
+bool Transceiver_IsDMXStreamEnabled() {
+  return g_port->stream.enabled;
+}
+
+bool Transceiver_SetDMXRefreshInterval(uint16_t interval) {
+  if (interval > MAXIMUM_DMX_REFRESH_INTERVAL) {
+    return false;
+  }
+  g_port->timing_settings.dmx_refresh_interval = interval;
+  return true;
+}
+
+uint16_t Transceiver_GetDMXRefreshInterval() {
+  return g_port->timing_settings.dmx_refresh_interval;
 }
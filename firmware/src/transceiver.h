@@ -34,8 +34,9 @@
  *  - Transceiver_QueueRDMDUB();
  *  - Transceiver_QueueRDMRequest();
  *
- * When the operation completes, the TransceiverEventCallback will be run, with
- * the result of the operation. See @ref controller-overview
+ * Up to TRANSCEIVER_QUEUE_DEPTH operations can be queued. They are performed in
+ * order, and as each completes the TransceiverEventCallback will be run, with
+ * the token and result of the operation. See @ref controller-overview
  * "Controller State Machine".
  *
  * @par Responder Mode
@@ -44,6 +45,14 @@
  *   received. The handler should call Transceiver_QueueRDMResponse() to send a
  *   response frame. See @ref responder-overview "Responder State Machine".
  *
+ * @par Ports
+ *
+ * Boards with more than one UART can run TRANSCEIVER_PORT_COUNT independent
+ * ports, each with its own mode, queue and timing settings. The functions in
+ * this module act on the port chosen with Transceiver_SelectPort(), port 0 is
+ * selected by default. Transceiver_Tasks() and the ISRs select each port while
+ * they run it, so the event callbacks run with the event's port selected.
+ *
  * @addtogroup transceiver
  * @{
  * @file transceiver.h
@@ -58,6 +67,7 @@
 
 #include "iovec.h"
 #include "system_config.h"
+#include "peripheral/dma/plib_dma.h"
 #include "peripheral/ic/plib_ic.h"
 #include "peripheral/ports/plib_ports.h"
 #include "peripheral/tmr/plib_tmr.h"
@@ -201,6 +211,11 @@ typedef struct {
    * This may be NULL, if no timing information was available.
    */
   TransceiverTiming *timing;
+
+  /**
+   * @brief The port the event occurred on.
+   */
+  uint8_t port;
 } TransceiverEvent;
 
 /**
@@ -211,11 +226,34 @@ typedef struct {
 typedef bool (*TransceiverEventCallback)(const TransceiverEvent *event);
 
 /**
- * @brief The hardware settings to use for the Transceiver.
+ * @brief A complete DMX frame, received in responder mode.
+ */
+typedef struct {
+  /**
+   * @brief The slot data, excluding the start code.
+   */
+  const uint8_t *data;
+
+  /**
+   * @brief The number of slots, excluding the start code. May be 0.
+   */
+  unsigned int size;
+
+  /**
+   * @brief Incremented each time a new frame is received.
+   *
+   * This can be used to check if the frame has changed since the last call to
+   * Transceiver_GetLatestDMXFrame().
+   */
+  uint32_t sequence;
+} TransceiverDMXFrame;
+
+/**
+ * @brief The hardware settings to use for a Transceiver port.
  *
  * Alas, this doesn't contain all of the settings. The vector numbers used in
- * the ISRs are required at compile time, so we can't control that. We'll need
- * to come up with a better way to make this modular.
+ * the ISRs are required at compile time, so they come from the
+ * TRANSCEIVER_UART, TRANSCEIVER_1_UART etc. settings in app_settings.h.
  */
 typedef struct {
   USART_MODULE_ID usart;  //!< The USART module to use
@@ -234,11 +272,22 @@ typedef struct {
   INT_VECTOR timer_vector;  //!< The vector to use for timer
   INT_SOURCE timer_source;  //!< The source to use for timer
   IC_TIMERS input_capture_timer;  //!< The timer to use for IC
+  bool use_tx_dma;  //!< Transmit frames using DMA.
+  DMA_CHANNEL tx_dma_channel;  //!< The DMA channel to use for TX
+  DMA_TRIGGER_SOURCE tx_dma_trigger;  //!< The USART TX trigger for the DMA
+  INT_VECTOR tx_dma_vector;  //!< The vector to use for the DMA channel
+  INT_SOURCE tx_dma_source;  //!< The source of DMA channel interrupts
+  bool use_rx_dma;  //!< Receive frames using DMA in responder mode.
+  DMA_CHANNEL rx_dma_channel;  //!< The DMA channel to use for RX
+  DMA_TRIGGER_SOURCE rx_dma_trigger;  //!< The USART RX trigger for the DMA
+  INT_VECTOR rx_dma_vector;  //!< The vector to use for the RX DMA channel
+  INT_SOURCE rx_dma_source;  //!< The source of RX DMA channel interrupts
 } TransceiverHardwareSettings;
 
 /**
  * @brief Initialize the transceiver.
- * @param settings The settings to use for the transceiver.
+ * @param settings An array of TRANSCEIVER_PORT_COUNT settings, one for each
+ *   port.
  * @param tx_callback The callback to run when a transceiver TX event occurs.
  * @param rx_callback The callback to run when a transceiver RX event occurs.
  *
@@ -251,6 +300,20 @@ void Transceiver_Initialize(const TransceiverHardwareSettings *settings,
                             TransceiverEventCallback tx_callback,
                             TransceiverEventCallback rx_callback);
 
+/**
+ * @brief Select the port the other Transceiver functions act on.
+ * @param port The port, from 0 to TRANSCEIVER_PORT_COUNT - 1.
+ * @returns true if the port was selected, false if the port doesn't exist, in
+ *   which case the selected port is unchanged.
+ */
+bool Transceiver_SelectPort(uint8_t port);
+
+/**
+ * @brief Return the selected port.
+ * @returns The selected port.
+ */
+uint8_t Transceiver_GetPort();
+
 /**
  * @brief Change the operating mode of the transceiver.
  * @param mode the new operating mode.
@@ -267,7 +330,7 @@ void Transceiver_SetMode(TransceiverMode mode);
 TransceiverMode Transceiver_GetMode();
 
 /**
- * @brief Perform the periodic transceiver tasks.
+ * @brief Perform the periodic transceiver tasks, for all ports.
  *
  * This should be called in the main event loop.
  */
@@ -278,8 +341,8 @@ void Transceiver_Tasks();
  * @param token The token for this operation.
  * @param data The DMX data, excluding the start code.
  * @param size The size of the DMX data, excluding the start code.
- * @returns true if the frame was accepted and buffered, false if the transmit
- *   buffer is full.
+ * @returns true if the frame was accepted and queued, false if the queue is
+ *   full.
  */
 bool Transceiver_QueueDMX(uint8_t token, const uint8_t* data,
                           unsigned int size);
@@ -290,8 +353,8 @@ bool Transceiver_QueueDMX(uint8_t token, const uint8_t* data,
  * @param start_code the alternate start code.
  * @param data The ASC data, excluding the start code.
  * @param size The size of the data, excluding the start code.
- * @returns true if the frame was accepted and buffered, false if the transmit
- *   buffer is full.
+ * @returns true if the frame was accepted and queued, false if the queue is
+ *   full.
  */
 bool Transceiver_QueueASC(uint8_t token, uint8_t start_code,
                           const uint8_t* data, unsigned int size);
@@ -301,8 +364,8 @@ bool Transceiver_QueueASC(uint8_t token, uint8_t start_code,
  * @param token The token for this operation.
  * @param data The RDM DUB data, excluding the start code.
  * @param size The size of the RDM DUB data, excluding the start code.
- * @returns true if the frame was accepted and buffered, false if the transmit
- *   buffer is full.
+ * @returns true if the frame was accepted and queued, false if the queue is
+ *   full.
  */
 bool Transceiver_QueueRDMDUB(uint8_t token, const uint8_t* data,
                              unsigned int size);
@@ -313,8 +376,8 @@ bool Transceiver_QueueRDMDUB(uint8_t token, const uint8_t* data,
  * @param data The RDM data, excluding the start code.
  * @param size The size of the RDM data, excluding the start code.
  * @param is_broadcast True if this is a broadcast request.
- * @returns true if the frame was accepted and buffered, false if the transmit
- *   buffer is full.
+ * @returns true if the frame was accepted and queued, false if the queue is
+ *   full.
  */
 bool Transceiver_QueueRDMRequest(uint8_t token, const uint8_t* data,
                                  unsigned int size, bool is_broadcast);
@@ -324,18 +387,79 @@ bool Transceiver_QueueRDMRequest(uint8_t token, const uint8_t* data,
  * @param include_break true if this response requires a break
  * @param iov The data to send in the response
  * @param iov_count The number of IOVecs.
- * @returns true if the frame was accepted and buffered, false if the transmit
- *   buffer is full.
+ * @returns true if the frame was accepted and queued, false if the queue is
+ *   full.
  */
 bool Transceiver_QueueRDMResponse(bool include_break,
                                   const IOVec* iov,
                                   unsigned int iov_count);
 
 /**
- * @brief Reset the transceiver state.
+ * @brief Load the DMX stream and start transmitting it continuously.
+ * @param data The DMX data, excluding the start code.
+ * @param size The number of slots, 0 - 512.
+ * @returns true if the stream was loaded, false if size was too large.
+ *
+ * In controller mode, the stream is transmitted every DMX refresh interval
+ * without generating events. Queued operations take priority over the stream.
+ * The new data is used from the start of the next frame, so a frame is never
+ * sent with partially updated data.
+ */
+bool Transceiver_StartDMXStream(const uint8_t* data, unsigned int size);
+
+/**
+ * @brief Update a run of slots in the DMX stream.
+ * @param offset The first slot to update, 0 is the first slot after the start
+ *   code.
+ * @param data The new slot values.
+ * @param size The number of slots to update.
+ * @returns true if the slots were updated, false if the run extends past the
+ *   number of slots loaded with Transceiver_StartDMXStream().
+ *
+ * Like Transceiver_StartDMXStream(), the updates are used from the start of
+ * the next frame.
+ */
+bool Transceiver_UpdateDMXStream(uint16_t offset, const uint8_t* data,
+                                 unsigned int size);
+
+/**
+ * @brief Get the number of slots in the DMX stream.
+ * @returns The number of slots loaded with Transceiver_StartDMXStream(),
+ *   excluding the start code.
+ */
+unsigned int Transceiver_GetDMXStreamSize();
+
+/**
+ * @brief Stop transmitting the DMX stream.
+ */
+void Transceiver_StopDMXStream();
+
+/**
+ * @brief Check if the DMX stream is being transmitted.
+ */
+bool Transceiver_IsDMXStreamEnabled();
+
+/**
+ * @brief Get the most recent complete DMX frame received in responder mode.
+ * @param[out] frame The latest frame.
+ * @returns true if a frame has been received, false otherwise.
+ *
+ * Only frames with a NULL start code that were received in full are
+ * published, so the slots never change part way through a frame. The data is
+ * valid, and unchanged, until the next call to
+ * Transceiver_GetLatestDMXFrame().
  *
- * This can be used to recover from an error. The line will be placed back into
- * a MARK state.
+ * Frames are published through a triple buffer, so this never blocks the
+ * receive path and doesn't disable interrupts. It should only be called from
+ * a single context.
+ */
+bool Transceiver_GetLatestDMXFrame(TransceiverDMXFrame *frame);
+
+/**
+ * @brief Reset the transceiver state, for all ports.
+ *
+ * This can be used to recover from an error. The lines will be placed back
+ * into a MARK state.
  */
 void Transceiver_Reset();
 
@@ -486,6 +610,26 @@ bool Transceiver_SetRDMResponderJitter(uint16_t max_jitter);
  */
 uint16_t Transceiver_GetRDMResponderJitter();
 
+/**
+ * @brief Set the break to break interval for the DMX stream.
+ * @param interval The interval in 10ths of a millisecond, 0 to 10000. Setting
+ *   0 sends frames back to back.
+ * @returns true if the interval was updated, false if the value was out of
+ *   range.
+ *
+ * The default value is 22.7ms, or 44Hz. Frames are never sent faster than the
+ * minimum break to break time, and a long frame may take longer than the
+ * interval.
+ */
+bool Transceiver_SetDMXRefreshInterval(uint16_t interval);
+
+/**
+ * @brief Return the DMX stream refresh interval.
+ * @returns The interval in 10ths of a millisecond.
+ * @sa Transceiver_SetDMXRefreshInterval.
+ */
+uint16_t Transceiver_GetDMXRefreshInterval();
+
 #ifdef __cplusplus
 }
 #endif
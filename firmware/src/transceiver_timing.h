@@ -128,6 +128,14 @@
  */
 #define CONTROLLER_NON_RDM_BACKOFF 2u
 
+/**
+ * @brief The maximum DMX stream refresh interval.
+ *
+ * Measured in 10ths of a millisecond. E1.11 limits the break to break time to
+ * 1 second.
+ */
+#define MAXIMUM_DMX_REFRESH_INTERVAL 10000u
+
 // Responder params
 // ----------------------------------------------------------------------------
 
@@ -440,6 +440,9 @@ void USBConsole_Tasks() {
                        Transceiver_GetRDMResponderDelay());
           SysLog_Print(SYSLOG_INFO, "RDM responder jitter: %d / 10 us",
                        Transceiver_GetRDMResponderJitter());
+          SysLog_Print(SYSLOG_INFO, "DMX refresh interval: %d / 10 ms%s",
+                       Transceiver_GetDMXRefreshInterval(),
+                       Transceiver_IsDMXStreamEnabled() ? " (streaming)" : "");
           break;
         case 'w':
           SysLog_Message(SYSLOG_WARN, "warning");
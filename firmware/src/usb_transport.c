@@ -22,6 +22,7 @@
 #include <string.h>
 
 #include "app_pipeline.h"
+#include "app_settings.h"
 #include "bootloader_options.h"
 #include "constants.h"
 #include "dfu_properties.h"
@@ -46,6 +47,41 @@ typedef enum {
   USB_STATE_UNCONFIGURED,  //!< USB device was unconfigured
 } USBTransportState;
 
+/**
+ * @brief The maximum number of IRPs used to send a single frame.
+ */
+#define MAX_IRPS_PER_FRAME 3u
+
+/**
+ * @brief The size of the header and EOM surrounding each response payload.
+ */
+#define MESSAGE_OVERHEAD 9u
+
+/**
+ * @brief A preformatted response frame, waiting to be sent to the host.
+ *
+ * A frame is either copied entirely into data, or it's a gather frame. Copied
+ * frames may hold several back to back responses, which are sent to the host
+ * as a single transfer. Gather
+ * frames are sent as three chained writes: the first size bytes of data, then
+ * payload_size bytes directly from the caller's memory, and finally the
+ * tail_size bytes in data following the first segment.
+ */
+typedef struct {
+  /**
+   * @brief The size of the first segment in data.
+   *
+   * For a copied frame this is the entire frame, including the SOM & EOM of
+   * each response.
+   */
+  uint16_t size;
+  const uint8_t *pinned;  //!< The caller's IOVec base, or NULL if copied.
+  const uint8_t *payload;  //!< The referenced part of the payload.
+  uint16_t payload_size;  //!< The size of the referenced payload.
+  uint16_t tail_size;  //!< The size of the final segment, including the EOM.
+  uint8_t data[USB_READ_BUFFER_SIZE];  //!< The frame data.
+} TXFrame;
+
 typedef struct {
   TransportRxFunction rx_cb;
   USB_DEVICE_HANDLE usb_device;  //!< The USB Device layer handle.
@@ -56,26 +92,235 @@ typedef struct {
   bool rx_in_progress;  //!< True if there is a RX in progress.
   bool dfu_detach;  //!< True if we've received a DFU detach.
 
-  USB_DEVICE_TRANSFER_HANDLE write_transfer;
+  USB_DEVICE_TRANSFER_HANDLE write_transfer[MAX_IRPS_PER_FRAME];
   USB_DEVICE_TRANSFER_HANDLE read_transfer;
   USB_ENDPOINT_ADDRESS tx_endpoint;  //!< TX endpoint address
   USB_ENDPOINT_ADDRESS rx_endpoint;  //!< RX endpoint address
   uint8_t alt_setting;  //!< The alternate setting, always 0
-
-  int rx_data_size;
+  uint16_t packet_size;  //!< The max packet size of the TX endpoint.
+
+  int rx_data_size;  //!< The size of the last completed read.
+  uint8_t rx_buffer;  //!< The receive buffer the armed read will fill.
+  bool rx_pending;  //!< True if pending_buffer is waiting to be decoded.
+  uint8_t pending_buffer;  //!< The receive buffer waiting to be decoded.
+  int pending_data_size;  //!< The size of the data in pending_buffer.
+
+  uint8_t tx_head;  //!< The index of the frame at the head of the TX queue.
+  uint8_t tx_tail;  //!< The index of the next free frame in the TX queue.
+  uint8_t tx_submitted;  //!< The number of IRPs used for the head frame.
+
+  /**
+   * @brief The number of IRPs for the head frame that have completed.
+   *
+   * This is the only TX state the event handler modifies. The frame is
+   * retired from USBTransport_Tasks() once all of its IRPs complete, so the
+   * TX queue doesn't need to disable interrupts.
+   */
+  volatile uint8_t tx_completed;
+  uint32_t tx_drops;  //!< The number of responses dropped.
 } USBTransportData;
 
 static USBTransportData g_usb_transport_data;
 
-// Receive data buffer
-static uint8_t receivedDataBuffer[USB_READ_BUFFER_SIZE];
+// Receive data buffers. While one is being decoded, the next read is armed
+// with the other.
+static uint8_t receivedDataBuffer[2][USB_READ_BUFFER_SIZE];
 
-// Transmit data buffer
-static uint8_t transmitDataBuffer[USB_READ_BUFFER_SIZE];
+// The ring of response frames waiting to be sent to the host.
+static TXFrame g_tx_queue[USB_TRANSPORT_TX_QUEUE_SIZE];
+
+// The uint8_t head & tail indices only wrap correctly if the queue size is a
+// power of two, no larger than 128. This fails to compile otherwise.
+typedef char TXQueueSizeCheck[
+    (USB_TRANSPORT_TX_QUEUE_SIZE > 0u &&
+     USB_TRANSPORT_TX_QUEUE_SIZE <= 128u &&
+     (USB_TRANSPORT_TX_QUEUE_SIZE & (USB_TRANSPORT_TX_QUEUE_SIZE - 1u)) == 0u)
+    ? 1 : -1];
 
 // The buffer that holds the DFU Status response.
 static uint8_t g_status_response[GET_STATUS_RESPONSE_SIZE];
 
+// TX Queue functions
+// ----------------------------------------------------------------------------
+static inline uint8_t TXQueueSize() {
+  return (uint8_t) (g_usb_transport_data.tx_tail - g_usb_transport_data.tx_head);
+}
+
+static inline TXFrame *TXQueueFrame(uint8_t index) {
+  return &g_tx_queue[index % USB_TRANSPORT_TX_QUEUE_SIZE];
+}
+
+static inline void TXQueueReset() {
+  g_usb_transport_data.tx_head = 0u;
+  g_usb_transport_data.tx_tail = 0u;
+}
+
+/*
+ * @brief Submit a single IRP for the frame at the head of the TX queue.
+ */
+static inline bool WriteSegment(const uint8_t *data, uint16_t size,
+                                USB_DEVICE_TRANSFER_FLAGS flags) {
+  USB_DEVICE_RESULT result = USB_DEVICE_EndpointWrite(
+      g_usb_transport_data.usb_device,
+      &g_usb_transport_data.write_transfer[g_usb_transport_data.tx_submitted],
+      g_usb_transport_data.tx_endpoint, data, size, flags);
+  if (result != USB_DEVICE_RESULT_OK) {
+    return false;
+  }
+  g_usb_transport_data.tx_submitted++;
+  return true;
+}
+
+/*
+ * @brief Start sending the frame at the head of the TX queue.
+ *
+ * Gather frames are submitted as chained IRPs. Every segment other than the
+ * last is a multiple of the packet size, so the host sees a single transfer.
+ *
+ * If the write can't be scheduled the frame is discarded and the TX error flag
+ * is set. If only part of a gather frame was scheduled, the transfer is ended
+ * early.
+ * @returns true if the write was scheduled, false otherwise.
+ */
+static bool SendNextFrame() {
+  TXFrame *frame = TXQueueFrame(g_usb_transport_data.tx_head);
+  g_usb_transport_data.tx_submitted = 0u;
+  g_usb_transport_data.tx_completed = 0u;
+  g_usb_transport_data.tx_in_progress = true;
+
+  bool ok;
+  if (frame->pinned) {
+    ok = (WriteSegment(frame->data, frame->size,
+                       USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING) &&
+          WriteSegment(frame->payload, frame->payload_size,
+                       USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING) &&
+          WriteSegment(frame->data + frame->size, frame->tail_size,
+                       USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE));
+  } else {
+    ok = WriteSegment(frame->data, frame->size,
+                      USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE);
+  }
+
+  if (!ok) {
+    Flags_SetTXError();
+    if (g_usb_transport_data.tx_submitted == 0u) {
+      g_usb_transport_data.tx_in_progress = false;
+      g_usb_transport_data.tx_head++;
+    } else {
+      // Part of the frame is on the wire. End the transfer with a zero length
+      // packet, otherwise the next frame would be appended to it; the host
+      // discards the truncated frame. A failed segment doesn't use an IRP, so
+      // there is always one left. The frame is retired once the submitted IRPs
+      // complete.
+      WriteSegment(frame->data, 0u, USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE);
+    }
+  }
+  return ok;
+}
+
+/*
+ * @brief Retire the frame at the head of the TX queue, if all of its IRPs have
+ *   completed.
+ */
+static inline void RetireCompletedFrame() {
+  if (g_usb_transport_data.tx_in_progress &&
+      g_usb_transport_data.tx_completed >= g_usb_transport_data.tx_submitted) {
+    g_usb_transport_data.tx_in_progress = false;
+    g_usb_transport_data.tx_head++;
+  }
+}
+
+/*
+ * @brief Find a queued frame that a response can be appended to.
+ * @param message_size The size of the response, including the SOM & EOM.
+ * @returns The frame at the tail of the TX queue if it hasn't been submitted
+ *   yet, is a copied frame and has room for the response, otherwise NULL.
+ */
+static TXFrame *CoalesceFrame(uint16_t message_size) {
+  RetireCompletedFrame();
+  if (TXQueueSize() <= (g_usb_transport_data.tx_in_progress ? 1u : 0u)) {
+    return NULL;
+  }
+
+  TXFrame *frame = TXQueueFrame(g_usb_transport_data.tx_tail - 1u);
+  if (frame->pinned ||
+      frame->size + message_size > USB_READ_BUFFER_SIZE) {
+    return NULL;
+  }
+  return frame;
+}
+
+/*
+ * @brief Reserve the frame at the tail of the TX queue.
+ * @returns The frame, or NULL if the TX queue is full.
+ */
+static TXFrame *NewFrame() {
+  RetireCompletedFrame();
+  if (TXQueueSize() == USB_TRANSPORT_TX_QUEUE_SIZE) {
+    g_usb_transport_data.tx_drops++;
+    Flags_SetTXDrop();
+    return NULL;
+  }
+
+  TXFrame *frame = TXQueueFrame(g_usb_transport_data.tx_tail);
+  frame->size = 0u;
+  frame->pinned = NULL;
+  frame->payload = NULL;
+  frame->payload_size = 0u;
+  frame->tail_size = 0u;
+  return frame;
+}
+
+/*
+ * @brief Write a response header, excluding the length.
+ */
+static void WriteHeader(uint8_t *buffer, uint8_t token, Command command,
+                        uint8_t rc) {
+  buffer[0] = START_OF_MESSAGE_ID;
+  buffer[1] = token;
+  buffer[2] = ShortLSB(command);
+  buffer[3] = ShortMSB(command);
+  // 4 & 5 are the length.
+  buffer[6] = rc;
+
+  // Set appropriate flags.
+  buffer[7] = 0;
+  if (Flags_HasChanged()) {
+    buffer[7] |= TRANSPORT_FLAGS_CHANGED;
+  }
+}
+
+/*
+ * @brief Add the frame at the tail to the TX queue.
+ * @returns true if the frame was queued or sent.
+ */
+static bool QueueFrame() {
+  g_usb_transport_data.tx_tail++;
+
+  if (g_usb_transport_data.tx_in_progress) {
+    // The frame will be sent from USBTransport_Tasks() once the current write
+    // completes.
+    return true;
+  }
+  return SendNextFrame();
+}
+
+// RX functions
+// ----------------------------------------------------------------------------
+
+/*
+ * @brief Schedule the next read, using the current receive buffer.
+ */
+static inline void ScheduleRead() {
+  g_usb_transport_data.rx_in_progress = true;
+  USB_DEVICE_EndpointRead(
+      g_usb_transport_data.usb_device,
+      &g_usb_transport_data.read_transfer,
+      g_usb_transport_data.rx_endpoint,
+      receivedDataBuffer[g_usb_transport_data.rx_buffer],
+      USB_READ_BUFFER_SIZE);
+}
+
 // DFU functions
 // ----------------------------------------------------------------------------
 static inline bool IsDFUDetach(const USB_SETUP_PACKET *packet) {
@@ -191,8 +436,9 @@ void USBTransport_EventHandler(USB_DEVICE_EVENT event, void* event_data,
       break;
 
     case USB_DEVICE_EVENT_ENDPOINT_WRITE_COMPLETE:
-      // Endpoint write is complete
-      g_usb_transport_data.tx_in_progress = false;
+      // One of the IRPs for the head frame is complete, the frame is released
+      // in USBTransport_Tasks().
+      g_usb_transport_data.tx_completed++;
       break;
 
     case USB_DEVICE_EVENT_RESUMED:
@@ -214,7 +460,16 @@ void USBTransport_Initialize(TransportRxFunction rx_cb) {
   g_usb_transport_data.tx_in_progress = false;
   g_usb_transport_data.dfu_detach = false;
   g_usb_transport_data.alt_setting = 0;
+  g_usb_transport_data.packet_size = 64u;
   g_usb_transport_data.rx_data_size = 0;
+  g_usb_transport_data.rx_buffer = 0u;
+  g_usb_transport_data.rx_pending = false;
+  g_usb_transport_data.pending_buffer = 0u;
+  g_usb_transport_data.pending_data_size = 0;
+  g_usb_transport_data.tx_drops = 0u;
+  g_usb_transport_data.tx_submitted = 0u;
+  g_usb_transport_data.tx_completed = 0u;
+  TXQueueReset();
 }
 
 void USBTransport_Tasks() {
@@ -267,16 +522,11 @@ void USBTransport_Tasks() {
                                   g_usb_transport_data.tx_endpoint,
                                   USB_TRANSFER_TYPE_BULK, endpointSize);
       }
-
-      // Indicate that we are waiting for read
-      g_usb_transport_data.rx_in_progress = true;
+      g_usb_transport_data.packet_size = endpointSize;
 
       // Place a new read request.
-      USB_DEVICE_EndpointRead(g_usb_transport_data.usb_device,
-                              &g_usb_transport_data.read_transfer,
-                              g_usb_transport_data.rx_endpoint,
-                              &receivedDataBuffer[0],
-                              sizeof(receivedDataBuffer));
+      g_usb_transport_data.rx_pending = false;
+      ScheduleRead();
 
       // Device is ready to run the main task
       g_usb_transport_data.state = USB_STATE_MAIN_TASK;
@@ -288,25 +538,37 @@ void USBTransport_Tasks() {
         Reset_SoftReset();
       }
 
-      if (g_usb_transport_data.rx_in_progress == false) {
-        // We have received data.
-        if (g_usb_transport_data.tx_in_progress == false) {
-          // we only go ahead and process the data if we can respond.
+      // Send any queued responses back to back.
+      RetireCompletedFrame();
+      if (g_usb_transport_data.tx_in_progress == false && TXQueueSize()) {
+        SendNextFrame();
+      }
+
+      if (g_usb_transport_data.rx_in_progress == false &&
+          g_usb_transport_data.rx_pending == false) {
+        // We have received data. Hand the buffer off for decoding and
+        // immediately re-arm the endpoint with the other buffer, so the host
+        // can send the next request while we process this one.
+        g_usb_transport_data.pending_buffer = g_usb_transport_data.rx_buffer;
+        g_usb_transport_data.pending_data_size =
+            g_usb_transport_data.rx_data_size;
+        g_usb_transport_data.rx_pending = true;
+        g_usb_transport_data.rx_buffer ^= 1u;
+        ScheduleRead();
+      }
+
+      if (g_usb_transport_data.rx_pending &&
+          TXQueueSize() < USB_TRANSPORT_TX_QUEUE_SIZE) {
+        // we only go ahead and process the data if we can respond.
+        const uint8_t *data =
+            receivedDataBuffer[g_usb_transport_data.pending_buffer];
 #ifdef PIPELINE_TRANSPORT_RX
-          PIPELINE_TRANSPORT_RX(receivedDataBuffer,
-                                g_usb_transport_data.rx_data_size);
+        PIPELINE_TRANSPORT_RX(data, g_usb_transport_data.pending_data_size);
 #else
-          g_usb_transport_data.rx_cb(receivedDataBuffer,
-                                     g_usb_transport_data.rx_data_size);
+        g_usb_transport_data.rx_cb(data,
+                                   g_usb_transport_data.pending_data_size);
 #endif
-          // schedule the next read
-          g_usb_transport_data.rx_in_progress = true;
-          USB_DEVICE_EndpointRead(g_usb_transport_data.usb_device,
-                                  &g_usb_transport_data.read_transfer,
-                                  g_usb_transport_data.rx_endpoint,
-                                  &receivedDataBuffer[0],
-                                  sizeof (receivedDataBuffer));
-        }
+        g_usb_transport_data.rx_pending = false;
       }
       break;
     case USB_STATE_LOST_POWER:
@@ -323,7 +585,9 @@ void USBTransport_Tasks() {
                                    g_usb_transport_data.rx_endpoint);
       }
       g_usb_transport_data.rx_in_progress = false;
+      g_usb_transport_data.rx_pending = false;
       g_usb_transport_data.tx_in_progress = false;
+      TXQueueReset();
 
       g_usb_transport_data.state = (
           g_usb_transport_data.state == USB_STATE_LOST_POWER ?
@@ -336,59 +600,127 @@ void USBTransport_Tasks() {
 
 bool USBTransport_SendResponse(uint8_t token, Command command, uint8_t rc,
                                const IOVec* data, unsigned int iov_count) {
-  if (g_usb_transport_data.tx_in_progress ||
-      g_usb_transport_data.state != USB_STATE_MAIN_TASK) {
+  if (g_usb_transport_data.state != USB_STATE_MAIN_TASK) {
     return false;
   }
 
-  transmitDataBuffer[0] = START_OF_MESSAGE_ID;
-  transmitDataBuffer[1] = token;
-  transmitDataBuffer[2] = ShortLSB(command);
-  transmitDataBuffer[3] = ShortMSB(command);
-  // 4 & 5 are the length.
-  transmitDataBuffer[6] = rc;
+  unsigned int i = 0;
+  unsigned int length = 0u;
+  for (; i != iov_count; i++) {
+    length += data[i].length;
+  }
+  if (length > PAYLOAD_SIZE) {
+    length = PAYLOAD_SIZE;
+  }
 
-  // Set appropriate flags.
-  transmitDataBuffer[7] = 0;
-  if (Flags_HasChanged()) {
-    transmitDataBuffer[7] |= TRANSPORT_FLAGS_CHANGED;
+  // If there is a frame waiting to be sent, try to append this response to it.
+  TXFrame *frame = CoalesceFrame(length + MESSAGE_OVERHEAD);
+  bool coalesced = frame != NULL;
+  if (!frame) {
+    frame = NewFrame();
+    if (!frame) {
+      return false;
+    }
   }
 
-  unsigned int i = 0;
+  uint8_t *buffer = frame->data + frame->size;
+  WriteHeader(buffer, token, command, rc);
   uint16_t offset = 0;
-  for (; i != iov_count; i++) {
+  for (i = 0; i != iov_count; i++) {
     if (offset + data[i].length > PAYLOAD_SIZE) {
-      memcpy(transmitDataBuffer + offset + 8, data[i].base,
-             PAYLOAD_SIZE - offset);
+      memcpy(buffer + offset + 8, data[i].base, PAYLOAD_SIZE - offset);
       offset = PAYLOAD_SIZE;
-      transmitDataBuffer[7] |= TRANSPORT_MSG_TRUNCATED;
+      buffer[7] |= TRANSPORT_MSG_TRUNCATED;
       break;
     } else {
-      memcpy(transmitDataBuffer + offset + 8, data[i].base, data[i].length);
+      memcpy(buffer + offset + 8, data[i].base, data[i].length);
       offset += data[i].length;
     }
   }
 
-  transmitDataBuffer[4] = ShortLSB(offset);
-  transmitDataBuffer[5] = ShortMSB(offset);
-  transmitDataBuffer[8 + offset] = END_OF_MESSAGE_ID;
+  buffer[4] = ShortLSB(offset);
+  buffer[5] = ShortMSB(offset);
+  buffer[8 + offset] = END_OF_MESSAGE_ID;
+  frame->size += offset + MESSAGE_OVERHEAD;
+  return coalesced ? true : QueueFrame();
+}
 
-  g_usb_transport_data.tx_in_progress = true;
+bool USBTransport_SendPinnedResponse(uint8_t token, Command command,
+                                     uint8_t rc, const IOVec* data,
+                                     unsigned int iov_count) {
+  if (g_usb_transport_data.state != USB_STATE_MAIN_TASK || iov_count == 0u) {
+    return USBTransport_SendResponse(token, command, rc, data, iov_count);
+  }
 
-  USB_DEVICE_RESULT result = USB_DEVICE_EndpointWrite(
-      g_usb_transport_data.usb_device,
-      &g_usb_transport_data.write_transfer,
-      g_usb_transport_data.tx_endpoint, transmitDataBuffer,
-      offset + 9,
-      USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE);
-  if (result != USB_DEVICE_RESULT_OK) {
-    g_usb_transport_data.tx_in_progress = false;
+  const IOVec *payload = &data[iov_count - 1u];
+  unsigned int length = payload->length;
+  unsigned int i = 0u;
+  for (; i != iov_count - 1u; i++) {
+    length += data[i].length;
+  }
+
+  // The first segment is the header, the leading IOVecs and enough of the
+  // payload to fill the last packet.
+  const uint16_t packet_size = g_usb_transport_data.packet_size;
+  uint16_t head_size = 8u + length - payload->length;
+  uint16_t lead = (packet_size - head_size % packet_size) % packet_size;
+  if (length > PAYLOAD_SIZE || lead + packet_size > payload->length) {
+    // Either the frame is truncated, or there isn't a full packet of payload
+    // to reference. Fall back to copying.
+    return USBTransport_SendResponse(token, command, rc, data, iov_count);
+  }
+
+  TXFrame *frame = NewFrame();
+  if (!frame) {
+    return false;
+  }
+
+  uint8_t *buffer = frame->data;
+  WriteHeader(buffer, token, command, rc);
+  uint16_t offset = 8u;
+  for (i = 0u; i != iov_count - 1u; i++) {
+    memcpy(buffer + offset, data[i].base, data[i].length);
+    offset += data[i].length;
   }
-  return result == USB_DEVICE_RESULT_OK;
+  const uint8_t *base = (const uint8_t*) payload->base;
+  memcpy(buffer + offset, base, lead);
+  offset += lead;
+  frame->size = offset;
+
+  uint16_t referenced = payload->length - lead;
+  referenced -= referenced % packet_size;
+  frame->pinned = base;
+  frame->payload = base + lead;
+  frame->payload_size = referenced;
+
+  uint16_t remaining = payload->length - lead - referenced;
+  memcpy(buffer + offset, base + lead + referenced, remaining);
+  buffer[offset + remaining] = END_OF_MESSAGE_ID;
+  frame->tail_size = remaining + 1u;
+
+  buffer[4] = ShortLSB(length);
+  buffer[5] = ShortMSB(length);
+  return QueueFrame();
+}
+
+bool USBTransport_IsPinned(const uint8_t *data) {
+  RetireCompletedFrame();
+  uint8_t index = g_usb_transport_data.tx_head;
+  for (; index != g_usb_transport_data.tx_tail; index++) {
+    if (TXQueueFrame(index)->pinned == data) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool USBTransport_WritePending() {
-  return g_usb_transport_data.tx_in_progress;
+  RetireCompletedFrame();
+  return TXQueueSize() != 0u;
+}
+
+uint32_t USBTransport_DroppedResponses() {
+  return g_usb_transport_data.tx_drops;
 }
 
 USB_DEVICE_HANDLE USBTransport_GetHandle() {
@@ -401,9 +733,16 @@ bool USBTransport_IsConfigured() {
 
 void USBTransport_SoftReset() {
   if (g_usb_transport_data.tx_in_progress) {
-    USB_DEVICE_EndpointTransferCancel(
-        g_usb_transport_data.usb_device,
-        g_usb_transport_data.tx_endpoint,
-        g_usb_transport_data.write_transfer);
+    uint8_t i = 0u;
+    for (; i != g_usb_transport_data.tx_submitted; i++) {
+      USB_DEVICE_EndpointTransferCancel(
+          g_usb_transport_data.usb_device,
+          g_usb_transport_data.tx_endpoint,
+          g_usb_transport_data.write_transfer[i]);
+    }
   }
+  // Discard the frames that haven't been sent, so they don't reference memory
+  // the caller is about to reuse.
+  g_usb_transport_data.tx_tail = g_usb_transport_data.tx_head +
+      (g_usb_transport_data.tx_in_progress ? 1u : 0u);
 }
@@ -70,19 +70,57 @@ void USBTransport_Tasks();
  * @param data The iovecs with the payload data.
  * @param iov_count The number of IOVecs.
  * @returns true if the message was queued for sending. False if the device was
- * not yet configured, or is there was already a message queued.
+ * not yet configured, or the TX queue was full.
  *
- * Only one message can be sent at a time. Until the send completes, any
- * further messages will be dropped.
+ * Up to USB_TRANSPORT_TX_QUEUE_SIZE frames can be queued. The frames are
+ * sent back to back from USBTransport_Tasks(). Responses queued while a write
+ * is in progress are appended to the last waiting frame, up to
+ * USB_READ_BUFFER_SIZE bytes, so that they reach the host in a single
+ * transfer. If the queue is full the response is dropped, the TX Drop flag is
+ * set and the drop counter is incremented.
  */
 bool USBTransport_SendResponse(uint8_t token, Command command, uint8_t rc,
                                const IOVec* data, unsigned int iov_count);
 
 /**
- * @brief Check if there is a write in progress
+ * @brief Send a response to the Host, without copying the payload.
+ * @param token The frame token, this should match the request.
+ * @param command The command class of the response.
+ * @param rc The return code of the response.
+ * @param data The iovecs with the payload data.
+ * @param iov_count The number of IOVecs.
+ * @returns true if the message was queued for sending, false otherwise.
+ *
+ * The last IOVec is referenced rather than copied; the header, the leading
+ * IOVecs and the EOM are submitted as chained writes around it. The memory
+ * must not be modified while USBTransport_IsPinned() returns true for its
+ * base.
+ *
+ * If the payload is too small to benefit, or would be truncated, this falls
+ * back to USBTransport_SendResponse().
+ */
+bool USBTransport_SendPinnedResponse(uint8_t token, Command command,
+                                     uint8_t rc, const IOVec* data,
+                                     unsigned int iov_count);
+
+/**
+ * @brief Check if memory passed to USBTransport_SendPinnedResponse() is still
+ *   referenced.
+ * @param data The base of the pinned IOVec.
+ * @returns true if a queued or in-flight frame references the data.
+ */
+bool USBTransport_IsPinned(const uint8_t *data);
+
+/**
+ * @brief Check if there is a write in progress, or responses queued.
  */
 bool USBTransport_WritePending();
 
+/**
+ * @brief Return the number of responses dropped because the TX queue was full.
+ */
+uint32_t USBTransport_DroppedResponses();
+
 /**
  * @brief Return the USB Device handle.
  * @returns The device handle or USB_DEVICE_HANDLE_INVALID.
@@ -96,7 +134,8 @@ USB_DEVICE_HANDLE USBTransport_GetHandle();
 bool USBTransport_IsConfigured();
 
 /**
- * @brief Perform a soft reset. This aborts any outbound (write) transfers
+ * @brief Perform a soft reset. This aborts any outbound (write) transfers and
+ * discards queued responses.
  */
 void USBTransport_SoftReset();
 
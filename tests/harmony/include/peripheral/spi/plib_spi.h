@@ -32,13 +32,27 @@ typedef enum {
   SPI_CLOCK_POLARITY_IDLE_HIGH = 1
 } SPI_CLOCK_POLARITY;
 
+typedef enum {
+  SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK = 0,
+  SPI_OUTPUT_DATA_PHASE_ON_ACTIVE_TO_IDLE_CLOCK = 1
+} SPI_OUTPUT_DATA_PHASE;
+
 typedef enum {
   SPI_PIN_SLAVE_SELECT = 0,
   SPI_PIN_DATA_OUT = 1
 } SPI_PIN;
 
+typedef enum {
+  SPI_FIFO_INTERRUPT_WHEN_TRANSMISSION_IS_COMPLETE = 0,
+  SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_COMPLETELY_EMPTY = 1,
+  SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_1HALF_EMPTY_OR_MORE = 2,
+  SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL = 3
+} SPI_FIFO_INTERRUPT;
+
 void PLIB_SPI_Enable(SPI_MODULE_ID index);
 
+void PLIB_SPI_Disable(SPI_MODULE_ID index);
+
 bool PLIB_SPI_TransmitBufferIsFull(SPI_MODULE_ID index);
 
 void PLIB_SPI_CommunicationWidthSelect(SPI_MODULE_ID index,
@@ -46,6 +60,10 @@ void PLIB_SPI_CommunicationWidthSelect(SPI_MODULE_ID index,
 
 void PLIB_SPI_ClockPolaritySelect(SPI_MODULE_ID index,
                                   SPI_CLOCK_POLARITY polarity);
+
+void PLIB_SPI_OutputDataPhaseSelect(SPI_MODULE_ID index,
+                                    SPI_OUTPUT_DATA_PHASE data_phase);
+
 void PLIB_SPI_MasterEnable(SPI_MODULE_ID index);
 
 void PLIB_SPI_BaudRateSet(SPI_MODULE_ID index, uint32_t clockFrequency,
@@ -61,6 +79,11 @@ void PLIB_SPI_SlaveSelectDisable(SPI_MODULE_ID index);
 
 void PLIB_SPI_PinDisable(SPI_MODULE_ID index, SPI_PIN pin);
 
+void PLIB_SPI_FIFOInterruptModeSelect(SPI_MODULE_ID index,
+                                      SPI_FIFO_INTERRUPT mode);
+
+void* PLIB_SPI_BufferAddressGet(SPI_MODULE_ID index);
+
 #ifdef  __cplusplus
 }
 #endif
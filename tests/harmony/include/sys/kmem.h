@@ -0,0 +1,32 @@
+/*
+ * This is the stub for kmem.h used for the tests. It contains the bare
+ * minimum required to pass buffer addresses to the DMA controller.
+ *
+ * Host pointers don't fit in the 32 bit physical addresses the DMA controller
+ * uses, so KVA_TO_PA() hands out an opaque handle instead.
+ * KMEM_PhysicalToVirtual() maps a handle back to the original pointer, which
+ * lets the DMA mocks access the buffers the code under test passed in.
+ */
+
+#ifndef TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
+#define TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
+
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+uint32_t KMEM_VirtualToPhysical(const volatile void *address);
+
+void* KMEM_PhysicalToVirtual(uint32_t address);
+
+#define KVA_TO_PA(v) KMEM_VirtualToPhysical((const volatile void*) (v))
+
+#define PA_TO_KVA1(pa) KMEM_PhysicalToVirtual(pa)
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
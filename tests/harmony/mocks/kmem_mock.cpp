@@ -0,0 +1,29 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "sys/kmem.h"
+
+namespace {
+  // Handle n refers to g_addresses[n - 1], 0 is reserved for NULL.
+  std::vector<const volatile void*> g_addresses;
+}
+
+uint32_t KMEM_VirtualToPhysical(const volatile void *address) {
+  if (address == NULL) {
+    return 0u;
+  }
+  for (unsigned int i = 0; i < g_addresses.size(); i++) {
+    if (g_addresses[i] == address) {
+      return i + 1u;
+    }
+  }
+  g_addresses.push_back(address);
+  return g_addresses.size();
+}
+
+void* KMEM_PhysicalToVirtual(uint32_t address) {
+  if (address == 0u || address > g_addresses.size()) {
+    return NULL;
+  }
+  return const_cast<void*>(g_addresses[address - 1u]);
+}
@@ -0,0 +1,52 @@
+#ifndef TESTS_HARMONY_MOCKS_PLIB_DMA_MOCK_H_
+#define TESTS_HARMONY_MOCKS_PLIB_DMA_MOCK_H_
+
+#include <gmock/gmock.h>
+#include "peripheral/dma/plib_dma.h"
+
+class MockPeripheralDMA {
+ public:
+  MOCK_METHOD1(Enable, void(DMA_MODULE_ID index));
+  MOCK_METHOD2(ChannelXEnable, void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD2(ChannelXDisable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD3(ChannelXPrioritySelect,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_CHANNEL_PRIORITY channelPriority));
+  MOCK_METHOD3(ChannelXTriggerEnable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_CHANNEL_TRIGGER_TYPE trigger));
+  MOCK_METHOD3(ChannelXStartIRQSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_TRIGGER_SOURCE IRQnum));
+  MOCK_METHOD3(ChannelXSourceStartAddressSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint32_t sourceStartAddress));
+  MOCK_METHOD3(ChannelXDestinationStartAddressSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint32_t destinationStartAddress));
+  MOCK_METHOD3(ChannelXSourceSizeSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint16_t sourceSize));
+  MOCK_METHOD3(ChannelXDestinationSizeSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint16_t destinationSize));
+  MOCK_METHOD2(ChannelXDestinationPointerGet,
+               uint16_t(DMA_MODULE_ID index, DMA_CHANNEL channel));
+  MOCK_METHOD3(ChannelXCellSizeSet,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    uint16_t cellSize));
+  MOCK_METHOD3(ChannelXINTSourceEnable,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+  MOCK_METHOD3(ChannelXINTSourceFlagGet,
+               bool(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+  MOCK_METHOD3(ChannelXINTSourceFlagClear,
+               void(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                    DMA_INT_TYPE dmaINTSource));
+};
+
+void PLIB_DMA_SetMock(MockPeripheralDMA* mock);
+
+#endif  // TESTS_HARMONY_MOCKS_PLIB_DMA_MOCK_H_
@@ -15,6 +15,12 @@ void PLIB_SPI_Enable(SPI_MODULE_ID index) {
   }
 }
 
+void PLIB_SPI_Disable(SPI_MODULE_ID index) {
+  if (g_plib_spi_mock) {
+    g_plib_spi_mock->Disable(index);
+  }
+}
+
 bool PLIB_SPI_TransmitBufferIsFull(SPI_MODULE_ID index) {
   if (g_plib_spi_mock) {
     return g_plib_spi_mock->TransmitBufferIsFull(index);
@@ -36,6 +42,13 @@ void PLIB_SPI_ClockPolaritySelect(SPI_MODULE_ID index,
   }
 }
 
+void PLIB_SPI_OutputDataPhaseSelect(SPI_MODULE_ID index,
+                                    SPI_OUTPUT_DATA_PHASE data_phase) {
+  if (g_plib_spi_mock) {
+    g_plib_spi_mock->OutputDataPhaseSelect(index, data_phase);
+  }
+}
+
 void PLIB_SPI_MasterEnable(SPI_MODULE_ID index) {
   if (g_plib_spi_mock) {
     g_plib_spi_mock->MasterEnable(index);
@@ -79,3 +92,17 @@ void PLIB_SPI_PinDisable(SPI_MODULE_ID index, SPI_PIN pin) {
     g_plib_spi_mock->PinDisable(index, pin);
   }
 }
+
+void PLIB_SPI_FIFOInterruptModeSelect(SPI_MODULE_ID index,
+                                      SPI_FIFO_INTERRUPT mode) {
+  if (g_plib_spi_mock) {
+    g_plib_spi_mock->FIFOInterruptModeSelect(index, mode);
+  }
+}
+
+void* PLIB_SPI_BufferAddressGet(SPI_MODULE_ID index) {
+  if (g_plib_spi_mock) {
+    return g_plib_spi_mock->BufferAddressGet(index);
+  }
+  return NULL;
+}
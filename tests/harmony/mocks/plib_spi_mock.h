@@ -7,11 +7,14 @@
 class MockPeripheralSPI {
  public:
   MOCK_METHOD1(Enable, void(SPI_MODULE_ID index));
+  MOCK_METHOD1(Disable, void(SPI_MODULE_ID index));
   MOCK_METHOD1(TransmitBufferIsFull, bool(SPI_MODULE_ID index));
   MOCK_METHOD2(CommunicationWidthSelect,
                void(SPI_MODULE_ID index, SPI_COMMUNICATION_WIDTH width));
   MOCK_METHOD2(ClockPolaritySelect,
                void(SPI_MODULE_ID index, SPI_CLOCK_POLARITY polarity));
+  MOCK_METHOD2(OutputDataPhaseSelect,
+               void(SPI_MODULE_ID index, SPI_OUTPUT_DATA_PHASE data_phase));
   MOCK_METHOD1(MasterEnable, void(SPI_MODULE_ID index));
   MOCK_METHOD3(BaudRateSet, void(SPI_MODULE_ID index, uint32_t clockFrequency,
                                  uint32_t baudRate));
@@ -20,6 +23,9 @@ class MockPeripheralSPI {
   MOCK_METHOD2(BufferWrite, void(SPI_MODULE_ID index, uint8_t data));
   MOCK_METHOD1(SlaveSelectDisable, void(SPI_MODULE_ID index));
   MOCK_METHOD2(PinDisable, void(SPI_MODULE_ID index, SPI_PIN pin));
+  MOCK_METHOD2(FIFOInterruptModeSelect,
+               void(SPI_MODULE_ID index, SPI_FIFO_INTERRUPT mode));
+  MOCK_METHOD1(BufferAddressGet, void*(SPI_MODULE_ID index));
 };
 
 void PLIB_SPI_SetMock(MockPeripheralSPI* mock);
@@ -33,6 +33,8 @@ class MockPeripheralUSART {
                void(USART_MODULE_ID index,
                     USART_LINECONTROL_MODE dataFlowConfig));
   MOCK_METHOD1(ErrorsGet, USART_ERROR(USART_MODULE_ID index));
+  MOCK_METHOD1(TransmitterAddressGet, void*(USART_MODULE_ID index));
+  MOCK_METHOD1(ReceiverAddressGet, void*(USART_MODULE_ID index));
 };
 
 void PLIB_USART_SetMock(MockPeripheralUSART* mock);
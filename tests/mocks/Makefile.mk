@@ -11,6 +11,7 @@ noinst_LTLIBRARIES += tests/mocks/libappmock.la \
                       tests/mocks/libmessagehandlermock.la \
                       tests/mocks/librdmhandlermock.la \
                       tests/mocks/libresetmock.la \
+                      tests/mocks/librespondermock.la \
                       tests/mocks/libspirgbmock.la \
                       tests/mocks/libstreamdecodermock.la \
                       tests/mocks/libsyslogmock.la \
@@ -72,6 +73,11 @@ tests_mocks_libresetmock_la_SOURCES = tests/mocks/ResetMock.h \
 tests_mocks_libresetmock_la_CXXFLAGS = $(MOCK_CXXFLAGS)
 tests_mocks_libresetmock_la_LIBADD = $(MOCK_LIBS)
 
+tests_mocks_librespondermock_la_SOURCES = tests/mocks/ResponderMock.h \
+                                          tests/mocks/ResponderMock.cpp
+tests_mocks_librespondermock_la_CXXFLAGS = $(MOCK_CXXFLAGS)
+tests_mocks_librespondermock_la_LIBADD = $(MOCK_LIBS)
+
 tests_mocks_libspirgbmock_la_SOURCES = tests/mocks/SPIRGBMock.h \
                                        tests/mocks/SPIRGBMock.cpp
 tests_mocks_libspirgbmock_la_CXXFLAGS = $(MOCK_CXXFLAGS)
@@ -47,6 +47,12 @@ void RDMHandler_GetUID(uint8_t *uid) {
   }
 }
 
+void RDMHandler_GetUIDMask(uint8_t *mask) {
+  if (g_rdmhandler_mock) {
+    g_rdmhandler_mock->GetUIDMask(mask);
+  }
+}
+
 bool RDMHandler_SetActiveModel(uint16_t model_id) {
   if (g_rdmhandler_mock) {
     return g_rdmhandler_mock->SetActiveModel(model_id);
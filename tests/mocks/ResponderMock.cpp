@@ -0,0 +1,47 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderMock.cpp
+ * A mock Responder module.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "ResponderMock.h"
+
+namespace {
+MockResponder *g_responder_mock = NULL;
+}
+
+void Responder_SetMock(MockResponder* mock) {
+  g_responder_mock = mock;
+}
+
+void Responder_Initialize() {
+  if (g_responder_mock) {
+    g_responder_mock->Initialize();
+  }
+}
+
+void Responder_SetSPIOutput(bool enabled) {
+  if (g_responder_mock) {
+    g_responder_mock->SetSPIOutput(enabled);
+  }
+}
+
+void Responder_Receive(const TransceiverEvent *event) {
+  if (g_responder_mock) {
+    g_responder_mock->Receive(event);
+  }
+}
@@ -0,0 +1,36 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderMock.h
+ * A mock Responder module.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_MOCKS_RESPONDERMOCK_H_
+#define TESTS_MOCKS_RESPONDERMOCK_H_
+
+#include <gmock/gmock.h>
+#include "responder.h"
+
+class MockResponder {
+ public:
+  MOCK_METHOD0(Initialize, void());
+  MOCK_METHOD1(SetSPIOutput, void(bool enabled));
+  MOCK_METHOD1(Receive, void(const TransceiverEvent *event));
+};
+
+void Responder_SetMock(MockResponder* mock);
+
+#endif  // TESTS_MOCKS_RESPONDERMOCK_H_
@@ -34,6 +34,19 @@ void SPIRGB_Init(const SPIRGBConfiguration *config) {
   }
 }
 
+bool SPIRGB_Configure(PixelType type, uint16_t pixel_count) {
+  if (g_spirgb_mock) {
+    return g_spirgb_mock->Configure(type, pixel_count);
+  }
+  return true;
+}
+
+void SPIRGB_SetCurve(const DimmerCurve *curve) {
+  if (g_spirgb_mock) {
+    g_spirgb_mock->SetCurve(curve);
+  }
+}
+
 void SPIRGB_BeginUpdate() {
   if (g_spirgb_mock) {
     g_spirgb_mock->BeginUpdate();
@@ -46,6 +59,13 @@ void SPIRGB_SetPixel(uint16_t index, RGB_Color color, uint8_t value) {
   }
 }
 
+bool SPIRGB_SetSlot(uint16_t slot, uint8_t value) {
+  if (g_spirgb_mock) {
+    return g_spirgb_mock->SetSlot(slot, value);
+  }
+  return false;
+}
+
 void SPIRGB_CompleteUpdate() {
   if (g_spirgb_mock) {
     g_spirgb_mock->CompleteUpdate();
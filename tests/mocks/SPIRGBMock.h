@@ -27,8 +27,11 @@
 class MockSPIRGB {
  public:
   MOCK_METHOD1(Init, void(const SPIRGBConfiguration *config));
+  MOCK_METHOD2(Configure, bool(PixelType type, uint16_t pixel_count));
+  MOCK_METHOD1(SetCurve, void(const DimmerCurve *curve));
   MOCK_METHOD0(BeginUpdate, void());
   MOCK_METHOD3(SetPixel, void(uint16_t index, RGB_Color color, uint8_t value));
+  MOCK_METHOD2(SetSlot, bool(uint16_t slot, uint8_t value));
   MOCK_METHOD0(CompleteUpdate, void());
   MOCK_METHOD0(Tasks, void());
 };
@@ -19,13 +19,20 @@
  */
 
 #include "TransceiverMock.h"
+#include "constants.h"
+#include "dmx_spec.h"
 
 namespace {
 MockTransceiver *g_transceiver_mock = NULL;
+
+// The mock behaves like a transceiver with the maximum number of ports.
+const uint8_t kPortCount = 4;
+uint8_t g_selected_port = 0;
 }
 
 void Transceiver_SetMock(MockTransceiver* mock) {
   g_transceiver_mock = mock;
+  g_selected_port = 0;
 }
 
 
@@ -37,6 +44,18 @@ void Transceiver_Initialize(const TransceiverHardwareSettings* settings,
   }
 }
 
+bool Transceiver_SelectPort(uint8_t port) {
+  if (port >= kPortCount) {
+    return false;
+  }
+  g_selected_port = port;
+  return true;
+}
+
+uint8_t Transceiver_GetPort() {
+  return g_selected_port;
+}
+
 void Transceiver_SetMode(TransceiverMode mode) {
   if (g_transceiver_mock) {
     g_transceiver_mock->SetMode(mode);
@@ -88,6 +107,48 @@ bool Transceiver_QueueRDMRequest(uint8_t token, const uint8_t* data,
   return true;
 }
 
+bool Transceiver_StartDMXStream(const uint8_t* data, unsigned int size) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->StartDMXStream(data, size);
+  }
+  return true;
+}
+
+bool Transceiver_UpdateDMXStream(uint16_t offset, const uint8_t* data,
+                                 unsigned int size) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->UpdateDMXStream(offset, data, size);
+  }
+  return true;
+}
+
+unsigned int Transceiver_GetDMXStreamSize() {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->GetDMXStreamSize();
+  }
+  return DMX_FRAME_SIZE;
+}
+
+void Transceiver_StopDMXStream() {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->StopDMXStream();
+  }
+}
+
+bool Transceiver_IsDMXStreamEnabled() {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->IsDMXStreamEnabled();
+  }
+  return false;
+}
+
+bool Transceiver_GetLatestDMXFrame(TransceiverDMXFrame *frame) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->GetLatestDMXFrame(frame);
+  }
+  return false;
+}
+
 bool Transceiver_SetBreakTime(uint16_t mark_time_us) {
   if (g_transceiver_mock) {
     return g_transceiver_mock->SetBreakTime(mark_time_us);
@@ -185,3 +246,17 @@ uint16_t Transceiver_GetRDMResponderJitter() {
   }
   return 0;
 }
+
+bool Transceiver_SetDMXRefreshInterval(uint16_t interval) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->SetDMXRefreshInterval(interval);
+  }
+  return true;
+}
+
+uint16_t Transceiver_GetDMXRefreshInterval() {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->GetDMXRefreshInterval();
+  }
+  return DEFAULT_DMX_REFRESH_INTERVAL;
+}
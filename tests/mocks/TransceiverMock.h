@@ -42,6 +42,13 @@ class MockTransceiver {
                                  unsigned int size));
   MOCK_METHOD4(QueueRDMRequest, bool(uint8_t token, const uint8_t* data,
                                      unsigned int size, bool is_broadcast));
+  MOCK_METHOD2(StartDMXStream, bool(const uint8_t* data, unsigned int size));
+  MOCK_METHOD3(UpdateDMXStream, bool(uint16_t offset, const uint8_t* data,
+                                     unsigned int size));
+  MOCK_METHOD0(GetDMXStreamSize, unsigned int());
+  MOCK_METHOD0(StopDMXStream, void());
+  MOCK_METHOD0(IsDMXStreamEnabled, bool());
+  MOCK_METHOD1(GetLatestDMXFrame, bool(TransceiverDMXFrame *frame));
   MOCK_METHOD0(Transceiver_Reset, void());
   MOCK_METHOD1(SetBreakTime, bool(uint16_t break_time_us));
   MOCK_METHOD0(GetBreakTime, uint16_t());
@@ -57,6 +64,8 @@ class MockTransceiver {
   MOCK_METHOD0(GetRDMResponderDelay, uint16_t());
   MOCK_METHOD1(SetRDMResponderJitter, bool(uint16_t max_jitter));
   MOCK_METHOD0(GetRDMResponderJitter, uint16_t());
+  MOCK_METHOD1(SetDMXRefreshInterval, bool(uint16_t interval));
+  MOCK_METHOD0(GetDMXRefreshInterval, uint16_t());
 };
 
 void Transceiver_SetMock(MockTransceiver* mock);
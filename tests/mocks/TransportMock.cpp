@@ -37,3 +37,12 @@ bool Transport_Send(uint8_t token, Command command, uint8_t rc,
   }
   return true;
 }
+
+bool Transport_SendPinned(uint8_t token, Command command, uint8_t rc,
+                          const IOVec* iovec, unsigned int iovec_count) {
+  if (g_transport_mock) {
+    return g_transport_mock->SendPinned(token, command, rc, iovec,
+                                        iovec_count);
+  }
+  return true;
+}
@@ -28,6 +28,9 @@ class MockTransport {
  public:
   MOCK_METHOD5(Send, bool(uint8_t token, Command command, uint8_t rc,
                           const IOVec* iovec, unsigned int iovec_count));
+  MOCK_METHOD5(SendPinned, bool(uint8_t token, Command command, uint8_t rc,
+                                const IOVec* iovec,
+                                unsigned int iovec_count));
 };
 
 void Transport_SetMock(MockTransport* mock);
@@ -35,4 +38,9 @@ void Transport_SetMock(MockTransport* mock);
 bool Transport_Send(uint8_t token, Command command, uint8_t rc,
                     const IOVec* iovec, unsigned int iovec_count);
 
+extern "C" {
+bool Transport_SendPinned(uint8_t token, Command command, uint8_t rc,
+                          const IOVec* iovec, unsigned int iovec_count);
+}
+
 #endif  // TESTS_MOCKS_TRANSPORTMOCK_H_
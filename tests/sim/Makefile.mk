@@ -0,0 +1,23 @@
+noinst_LTLIBRARIES += tests/sim/libtransceiversim.la
+
+tests_sim_libtransceiversim_la_SOURCES = \
+    tests/sim/SimulatedLine.cpp \
+    tests/sim/SimulatedLine.h \
+    tests/sim/SimulatedResponder.cpp \
+    tests/sim/SimulatedResponder.h \
+    tests/sim/TransceiverSimulator.cpp \
+    tests/sim/TransceiverSimulator.h
+tests_sim_libtransceiversim_la_CXXFLAGS = $(TESTING_CXXFLAGS)
+
+# BENCHMARKS
+################################################
+noinst_PROGRAMS += tests/sim/transceiver_benchmark
+
+tests_sim_transceiver_benchmark_SOURCES = tests/sim/TransceiverBenchmark.cpp
+tests_sim_transceiver_benchmark_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_sim_transceiver_benchmark_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
+                                        tests/sim/libtransceiversim.la \
+                                        firmware/src/libtransceiver.la \
+                                        firmware/src/libcoarsetimer.la \
+                                        tests/harmony/mocks/libharmonymock.la \
+                                        tests/mocks/libsyslogmock.la
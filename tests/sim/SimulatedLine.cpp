@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedLine.cpp
+ * Bit level models of a DMX512 / RDM line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "SimulatedLine.h"
+
+namespace {
+
+// The step within a slot at which the first stop bit is sampled.
+const unsigned int kStopBitSample = 9u * kBitTime + kBitTime / 2u;
+
+}  // namespace
+
+UARTReceiver::UARTReceiver()
+    : m_last_level(true),
+      m_receiving(false),
+      m_elapsed(0u),
+      m_value(0u) {
+}
+
+void UARTReceiver::Reset(bool level) {
+  m_last_level = level;
+  m_receiving = false;
+}
+
+bool UARTReceiver::Sample(bool level, ReceivedByte *byte) {
+  bool complete = false;
+  if (!m_receiving) {
+    if (m_last_level && !level) {
+      // Falling edge, the start of the start bit.
+      m_receiving = true;
+      m_elapsed = 0u;
+      m_value = 0u;
+    }
+  } else {
+    m_elapsed++;
+    if (m_elapsed % kBitTime == kBitTime / 2u) {
+      unsigned int bit = m_elapsed / kBitTime;
+      if (bit == 0u) {
+        if (level) {
+          // A glitch rather than a start bit.
+          m_receiving = false;
+        }
+      } else if (bit <= 8u) {
+        m_value |= (level ? 1u : 0u) << (bit - 1u);
+      }
+    }
+
+    if (m_elapsed == kStopBitSample) {
+      byte->value = m_value;
+      byte->framing_error = !level;
+      m_receiving = false;
+      complete = true;
+    }
+  }
+  m_last_level = level;
+  return complete;
+}
+
+UARTTransmitter::UARTTransmitter()
+    : m_busy(false),
+      m_bits(0u),
+      m_elapsed(0u) {
+}
+
+void UARTTransmitter::Reset() {
+  m_busy = false;
+}
+
+void UARTTransmitter::Load(uint8_t value) {
+  // LSB first: the start bit, the data and two stop bits.
+  m_bits = (value << 1u) | (3u << 9u);
+  m_elapsed = 0u;
+  m_busy = true;
+}
+
+bool UARTTransmitter::Level() const {
+  if (!m_busy) {
+    return true;
+  }
+  return (m_bits >> (m_elapsed / kBitTime)) & 1u;
+}
+
+void UARTTransmitter::Advance() {
+  if (m_busy) {
+    m_elapsed++;
+    if (m_elapsed == kBitsPerSlot * kBitTime) {
+      m_busy = false;
+    }
+  }
+}
+
+void Waveform::AddLevel(bool level, unsigned int duration) {
+  if (duration == 0u) {
+    return;
+  }
+  if (!m_segments.empty() && m_segments.back().first == level) {
+    m_segments.back().second += duration;
+  } else {
+    m_segments.push_back(std::make_pair(level, duration));
+  }
+}
+
+void Waveform::AddSlots(const uint8_t *data, unsigned int size) {
+  for (unsigned int i = 0; i < size; i++) {
+    AddLevel(false, kBitTime);
+    for (unsigned int bit = 0; bit < 8u; bit++) {
+      AddLevel((data[i] >> bit) & 1u, kBitTime);
+    }
+    AddLevel(true, 2u * kBitTime);
+  }
+}
+
+bool Waveform::Next() {
+  bool level = m_segments.front().first;
+  if (--m_segments.front().second == 0u) {
+    m_segments.pop_front();
+  }
+  return level;
+}
@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedLine.h
+ * Bit level models of a DMX512 / RDM line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_SIMULATEDLINE_H_
+#define TESTS_SIM_SIMULATEDLINE_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <utility>
+
+/**
+ * @brief The simulation advances in steps of 1uS, so at 250kbaud each bit
+ *   lasts 4 steps.
+ */
+static const unsigned int kBitTime = 4u;
+
+/**
+ * @brief The number of bits in each slot: a start bit, 8 data bits and two
+ *   stop bits.
+ */
+static const unsigned int kBitsPerSlot = 11u;
+
+/**
+ * @brief A byte decoded by a UARTReceiver.
+ */
+struct ReceivedByte {
+  uint8_t value;
+  bool framing_error;  //!< True if the stop bit was low, i.e. a break.
+};
+
+/**
+ * @brief Decodes 8N2 slots from the line.
+ *
+ * The line is sampled once per step, and each bit is read in the middle of
+ * the bit time, like a UART with 16x oversampling.
+ */
+class UARTReceiver {
+ public:
+  UARTReceiver();
+
+  /**
+   * @brief Abandon any partial byte.
+   * @param level The current level of the line.
+   */
+  void Reset(bool level);
+
+  /**
+   * @brief Sample the line.
+   * @param level The level of the line for this step.
+   * @param[out] byte The decoded byte.
+   * @returns true if a byte was completed during this step.
+   */
+  bool Sample(bool level, ReceivedByte *byte);
+
+ private:
+  bool m_last_level;
+  bool m_receiving;
+  unsigned int m_elapsed;
+  uint8_t m_value;
+};
+
+/**
+ * @brief Encodes 8N2 slots onto the line.
+ */
+class UARTTransmitter {
+ public:
+  UARTTransmitter();
+
+  /**
+   * @brief Abort the slot in progress.
+   */
+  void Reset();
+
+  /**
+   * @brief Check if a slot is being transmitted.
+   */
+  bool Busy() const { return m_busy; }
+
+  /**
+   * @brief Start transmitting a slot.
+   * @pre !Busy()
+   */
+  void Load(uint8_t value);
+
+  /**
+   * @brief The level the transmitter is driving during this step.
+   */
+  bool Level() const;
+
+  /**
+   * @brief Move to the next step.
+   */
+  void Advance();
+
+ private:
+  bool m_busy;
+  uint16_t m_bits;
+  unsigned int m_elapsed;
+};
+
+/**
+ * @brief A sequence of line levels, used by the simulated responders.
+ */
+class Waveform {
+ public:
+  /**
+   * @brief Remove all levels.
+   */
+  void Clear() { m_segments.clear(); }
+
+  /**
+   * @brief Check if the waveform has been completely played.
+   */
+  bool Empty() const { return m_segments.empty(); }
+
+  /**
+   * @brief Append a level.
+   * @param level The line level.
+   * @param duration The number of steps to hold the level for.
+   */
+  void AddLevel(bool level, unsigned int duration);
+
+  /**
+   * @brief Append a break.
+   */
+  void AddBreak(unsigned int duration) { AddLevel(false, duration); }
+
+  /**
+   * @brief Append a mark.
+   */
+  void AddMark(unsigned int duration) { AddLevel(true, duration); }
+
+  /**
+   * @brief Append 8N2 slots.
+   */
+  void AddSlots(const uint8_t *data, unsigned int size);
+
+  /**
+   * @brief Return the level for this step, and move to the next step.
+   * @pre !Empty()
+   */
+  bool Next();
+
+ private:
+  std::deque<std::pair<bool, unsigned int> > m_segments;
+};
+
+#endif  // TESTS_SIM_SIMULATEDLINE_H_
@@ -0,0 +1,293 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedResponder.cpp
+ * A RDM responder attached to the simulated line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "SimulatedResponder.h"
+
+#include <string.h>
+
+#include "constants.h"
+#include "rdm.h"
+
+namespace {
+
+// Low periods at least this long are treated as a break.
+const unsigned int kMinBreak = 88u;
+
+// The break & mark used for responses.
+const unsigned int kResponseBreak = 176u;
+const unsigned int kResponseMark = 12u;
+
+// A frame ends if no slots arrive for this long.
+const unsigned int kInterSlotTimeout = 2100u;
+
+// Slots are decoded when the first stop bit is sampled, this is the time
+// remaining until the end of the slot.
+const unsigned int kSlotRemainder = kBitTime + kBitTime / 2u;
+
+const unsigned int kDUBParamDataSize = 2u * UID_LENGTH;
+const unsigned int kDUBPreambleSize = 7u;
+const unsigned int kDUBResponseSize = 24u;
+
+// The offsets of fields in an RDM frame.
+const unsigned int kDestinationUIDOffset = 3u;
+const unsigned int kSourceUIDOffset = 9u;
+const unsigned int kTransactionNumberOffset = 15u;
+const unsigned int kPortIdOffset = 16u;
+const unsigned int kMessageCountOffset = 17u;
+const unsigned int kSubDeviceOffset = 18u;
+const unsigned int kCommandClassOffset = 20u;
+const unsigned int kParamIdOffset = 21u;
+
+uint16_t Checksum(const uint8_t *data, unsigned int size) {
+  uint16_t checksum = 0u;
+  for (unsigned int i = 0; i < size; i++) {
+    checksum += data[i];
+  }
+  return checksum;
+}
+
+}  // namespace
+
+SimulatedResponder::SimulatedResponder(const uint8_t uid[UID_LENGTH],
+                                       unsigned int turnaround)
+    : m_turnaround(turnaround),
+      m_muted(false),
+      m_last_level(true),
+      m_level_duration(0u),
+      m_break(0u),
+      m_in_frame(false),
+      m_in_mark(false),
+      m_idle(0u),
+      m_last_break(0u),
+      m_last_mark(0u),
+      m_frame_count(0u),
+      m_response_delay(0u),
+      m_transmitting(false),
+      m_response_count(0u) {
+  memcpy(m_uid, uid, UID_LENGTH);
+}
+
+bool SimulatedResponder::Drive(bool *level) {
+  if (m_response.Empty()) {
+    if (m_transmitting) {
+      // Turn the line around.
+      m_transmitting = false;
+      m_receiver.Reset(true);
+      m_last_level = true;
+      m_level_duration = 0u;
+    }
+    return false;
+  }
+
+  if (m_response_delay) {
+    m_response_delay--;
+    return false;
+  }
+
+  if (!m_transmitting) {
+    m_transmitting = true;
+    m_response_count++;
+  }
+  *level = m_response.Next();
+  return true;
+}
+
+void SimulatedResponder::Sample(bool level) {
+  if (m_transmitting) {
+    // The receiver is disabled while we drive the line.
+    return;
+  }
+
+  if (level == m_last_level) {
+    m_level_duration++;
+    if (!level && m_level_duration == kMinBreak && m_in_frame) {
+      // The next break has started, so the frame in progress is complete.
+      FrameComplete();
+    }
+  } else {
+    if (level && m_level_duration >= kMinBreak) {
+      // The end of a break.
+      m_break = m_level_duration;
+      m_in_frame = true;
+      m_in_mark = true;
+      m_idle = 0u;
+      m_frame.clear();
+      m_receiver.Reset(level);
+    } else if (!level && m_in_mark) {
+      // The start code's start bit.
+      m_last_mark = m_level_duration;
+      m_in_mark = false;
+    }
+    m_level_duration = 1u;
+  }
+  m_last_level = level;
+
+  ReceivedByte byte;
+  if (m_receiver.Sample(level, &byte) && m_in_frame && !byte.framing_error) {
+    m_frame.push_back(byte.value);
+    m_idle = 0u;
+
+    if (m_frame.size() > MESSAGE_LENGTH_OFFSET &&
+        m_frame[0] == RDM_START_CODE && m_frame[1] == RDM_SUB_START_CODE &&
+        m_frame.size() == static_cast<unsigned int>(
+            m_frame[MESSAGE_LENGTH_OFFSET] + RDM_CHECKSUM_LENGTH)) {
+      FrameComplete();
+      if (!m_response.Empty()) {
+        // Time the response from the end of the last slot.
+        m_response_delay += kSlotRemainder;
+      }
+    }
+  } else if (m_in_frame && !m_frame.empty() && ++m_idle > kInterSlotTimeout) {
+    FrameComplete();
+  }
+}
+
+void SimulatedResponder::FrameComplete() {
+  m_in_frame = false;
+  m_last_frame = m_frame;
+  m_last_break = m_break;
+  m_frame_count++;
+  HandleRequest();
+}
+
+void SimulatedResponder::HandleRequest() {
+  const std::vector<uint8_t> &frame = m_last_frame;
+  if (frame.size() < RDM_PARAM_DATA_OFFSET + RDM_CHECKSUM_LENGTH ||
+      frame[0] != RDM_START_CODE || frame[1] != RDM_SUB_START_CODE) {
+    return;
+  }
+
+  unsigned int length = frame[MESSAGE_LENGTH_OFFSET];
+  if (frame.size() != length + RDM_CHECKSUM_LENGTH ||
+      Checksum(&frame[0], length) != ((frame[length] << 8) |
+                                      frame[length + 1])) {
+    return;
+  }
+
+  const uint8_t *request = &frame[0];
+  if (!IsAddressed(request + kDestinationUIDOffset)) {
+    return;
+  }
+
+  bool unicast = memcmp(request + kDestinationUIDOffset, m_uid,
+                        UID_LENGTH) == 0;
+  uint8_t command_class = request[kCommandClassOffset];
+  uint16_t pid = (request[kParamIdOffset] << 8) | request[kParamIdOffset + 1];
+  unsigned int param_data_size = request[RDM_PARAM_DATA_LENGTH_OFFSET];
+  const uint8_t *param_data = request + RDM_PARAM_DATA_OFFSET;
+
+  if (command_class == DISCOVERY_COMMAND) {
+    const uint8_t control_field[] = {0u, 0u};
+    switch (pid) {
+      case PID_DISC_UNIQUE_BRANCH:
+        if (!m_muted && param_data_size == kDUBParamDataSize &&
+            memcmp(param_data, m_uid, UID_LENGTH) <= 0 &&
+            memcmp(m_uid, param_data + UID_LENGTH, UID_LENGTH) <= 0) {
+          QueueDUBResponse();
+        }
+        break;
+      case PID_DISC_MUTE:
+      case PID_DISC_UN_MUTE:
+        m_muted = pid == PID_DISC_MUTE;
+        if (unicast) {
+          QueueResponse(request, DISCOVERY_COMMAND_RESPONSE, control_field,
+                        sizeof(control_field));
+        }
+        break;
+      default:
+        {}
+    }
+  } else if (unicast && (command_class == GET_COMMAND ||
+                         command_class == SET_COMMAND)) {
+    QueueResponse(request, command_class + 1u, NULL, 0u);
+  }
+}
+
+void SimulatedResponder::QueueResponse(const uint8_t *request,
+                                       uint8_t command_class,
+                                       const uint8_t *param_data,
+                                       unsigned int param_data_size) {
+  uint8_t response[RDM_PARAM_DATA_OFFSET + UINT8_MAX + RDM_CHECKSUM_LENGTH];
+  const unsigned int length = RDM_PARAM_DATA_OFFSET + param_data_size;
+
+  response[0] = RDM_START_CODE;
+  response[1] = RDM_SUB_START_CODE;
+  response[MESSAGE_LENGTH_OFFSET] = length;
+  memcpy(response + kDestinationUIDOffset, request + kSourceUIDOffset,
+         UID_LENGTH);
+  memcpy(response + kSourceUIDOffset, m_uid, UID_LENGTH);
+  response[kTransactionNumberOffset] = request[kTransactionNumberOffset];
+  response[kPortIdOffset] = ACK;
+  response[kMessageCountOffset] = 0u;
+  response[kSubDeviceOffset] = request[kSubDeviceOffset];
+  response[kSubDeviceOffset + 1] = request[kSubDeviceOffset + 1];
+  response[kCommandClassOffset] = command_class;
+  response[kParamIdOffset] = request[kParamIdOffset];
+  response[kParamIdOffset + 1] = request[kParamIdOffset + 1];
+  response[RDM_PARAM_DATA_LENGTH_OFFSET] = param_data_size;
+  if (param_data_size) {
+    memcpy(response + RDM_PARAM_DATA_OFFSET, param_data, param_data_size);
+  }
+
+  uint16_t checksum = Checksum(response, length);
+  response[length] = checksum >> 8;
+  response[length + 1] = checksum & 0xff;
+
+  m_response.Clear();
+  m_response.AddBreak(kResponseBreak);
+  m_response.AddMark(kResponseMark);
+  m_response.AddSlots(response, length + RDM_CHECKSUM_LENGTH);
+  m_response_delay = m_turnaround;
+}
+
+void SimulatedResponder::QueueDUBResponse() {
+  uint8_t response[kDUBResponseSize];
+  memset(response, 0xfe, kDUBPreambleSize);
+  response[kDUBPreambleSize] = 0xaa;
+
+  uint8_t *encoded_uid = response + kDUBPreambleSize + 1u;
+  for (unsigned int i = 0; i < UID_LENGTH; i++) {
+    encoded_uid[2 * i] = m_uid[i] | 0xaa;
+    encoded_uid[2 * i + 1] = m_uid[i] | 0x55;
+  }
+
+  uint16_t checksum = Checksum(encoded_uid, 2u * UID_LENGTH);
+  uint8_t *encoded_checksum = encoded_uid + 2u * UID_LENGTH;
+  encoded_checksum[0] = (checksum >> 8) | 0xaa;
+  encoded_checksum[1] = (checksum >> 8) | 0x55;
+  encoded_checksum[2] = (checksum & 0xff) | 0xaa;
+  encoded_checksum[3] = (checksum & 0xff) | 0x55;
+
+  // DUB responses don't have a break.
+  m_response.Clear();
+  m_response.AddSlots(response, kDUBResponseSize);
+  m_response_delay = m_turnaround;
+}
+
+bool SimulatedResponder::IsAddressed(const uint8_t *uid) const {
+  static const uint8_t kBroadcastDevices[] = {0xff, 0xff, 0xff, 0xff};
+  if (memcmp(uid, m_uid, UID_LENGTH) == 0) {
+    return true;
+  }
+  // Either the all-devices broadcast, or a manufacturer broadcast.
+  return (memcmp(uid + 2, kBroadcastDevices, sizeof(kBroadcastDevices)) == 0 &&
+          ((uid[0] == 0xff && uid[1] == 0xff) ||
+           (uid[0] == m_uid[0] && uid[1] == m_uid[1])));
+}
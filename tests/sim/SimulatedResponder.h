@@ -0,0 +1,114 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedResponder.h
+ * A RDM responder attached to the simulated line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_SIMULATEDRESPONDER_H_
+#define TESTS_SIM_SIMULATEDRESPONDER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "SimulatedLine.h"
+#include "uid.h"
+
+/**
+ * @brief A minimal RDM responder.
+ *
+ * The responder receives every frame on the line. It answers DUB requests
+ * that match its UID while unmuted, handles DISC_MUTE & DISC_UN_MUTE, and
+ * ACKs any other unicast GET / SET with an empty parameter data.
+ */
+class SimulatedResponder {
+ public:
+  /**
+   * @brief Create a new responder.
+   * @param uid The responder's UID.
+   * @param turnaround The delay in uS between the end of the request and the
+   *   start of the response.
+   */
+  SimulatedResponder(const uint8_t uid[UID_LENGTH],
+                     unsigned int turnaround = 176u);
+
+  /**
+   * @brief Return the level to drive for this step.
+   * @param[out] level The level to drive.
+   * @returns true if the responder is driving the line.
+   */
+  bool Drive(bool *level);
+
+  /**
+   * @brief Sample the line.
+   * @param level The line level for this step.
+   */
+  void Sample(bool level);
+
+  bool IsMuted() const { return m_muted; }
+
+  /**
+   * @brief The slots of the last complete frame, including the start code.
+   */
+  const std::vector<uint8_t>& LastFrame() const { return m_last_frame; }
+
+  /**
+   * @brief The length of the break before the last frame, in uS.
+   */
+  unsigned int LastBreak() const { return m_last_break; }
+
+  /**
+   * @brief The length of the mark after the break of the last frame, in uS.
+   */
+  unsigned int LastMark() const { return m_last_mark; }
+
+  unsigned int FrameCount() const { return m_frame_count; }
+  unsigned int ResponseCount() const { return m_response_count; }
+
+ private:
+  uint8_t m_uid[UID_LENGTH];
+  unsigned int m_turnaround;
+  bool m_muted;
+
+  UARTReceiver m_receiver;
+  bool m_last_level;
+  unsigned int m_level_duration;
+  unsigned int m_break;
+  bool m_in_frame;
+  bool m_in_mark;
+  unsigned int m_idle;
+  std::vector<uint8_t> m_frame;
+
+  std::vector<uint8_t> m_last_frame;
+  unsigned int m_last_break;
+  unsigned int m_last_mark;
+  unsigned int m_frame_count;
+
+  Waveform m_response;
+  unsigned int m_response_delay;
+  bool m_transmitting;
+  unsigned int m_response_count;
+
+  void FrameComplete();
+  void HandleRequest();
+  void QueueResponse(const uint8_t *request, uint8_t command_class,
+                     const uint8_t *param_data, unsigned int param_data_size);
+  void QueueDUBResponse();
+  bool IsAddressed(const uint8_t *uid) const;
+};
+
+#endif  // TESTS_SIM_SIMULATEDRESPONDER_H_
@@ -0,0 +1,260 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TransceiverBenchmark.cpp
+ * Measure the line throughput of the transceiver on a simulated line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "TransceiverSimulator.h"
+#include "constants.h"
+#include "dmx_spec.h"
+#include "rdm.h"
+
+namespace {
+
+const uint8_t kControllerUID[] = {0x7a, 0x70, 0xff, 0xff, 0xfe, 0x00};
+const uint8_t kBroadcastUID[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+// The maximum simulated time for a single operation.
+const uint64_t kOperationTimeout = 100000u;
+
+const uint16_t kDeviceInfoPID = 0x0060u;
+
+unsigned int g_event_count = 0;
+TransceiverOperationResult g_last_result = T_RESULT_TX_OK;
+
+bool CountEvent(const TransceiverEvent *event) {
+  g_event_count++;
+  g_last_result = event->result;
+  return true;
+}
+
+void ResponderUID(unsigned int index, uint8_t *uid) {
+  const uint8_t base[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x00};
+  memcpy(uid, base, UID_LENGTH);
+  uid[UID_LENGTH - 1] = index + 1u;
+}
+
+/*
+ * Build a RDM request, excluding the start code.
+ */
+std::vector<uint8_t> BuildRequest(const uint8_t *destination,
+                                  uint8_t command_class, uint16_t pid,
+                                  const uint8_t *param_data,
+                                  unsigned int param_data_size) {
+  std::vector<uint8_t> frame;
+  frame.push_back(RDM_START_CODE);
+  frame.push_back(RDM_SUB_START_CODE);
+  frame.push_back(RDM_PARAM_DATA_OFFSET + param_data_size);
+  frame.insert(frame.end(), destination, destination + UID_LENGTH);
+  frame.insert(frame.end(), kControllerUID, kControllerUID + UID_LENGTH);
+  frame.push_back(0u);  // transaction number
+  frame.push_back(1u);  // port id
+  frame.push_back(0u);  // message count
+  frame.push_back(0u);  // sub device
+  frame.push_back(0u);
+  frame.push_back(command_class);
+  frame.push_back(pid >> 8);
+  frame.push_back(pid & 0xff);
+  frame.push_back(param_data_size);
+  frame.insert(frame.end(), param_data, param_data + param_data_size);
+
+  uint16_t checksum = 0u;
+  for (unsigned int i = 0; i < frame.size(); i++) {
+    checksum += frame[i];
+  }
+  frame.push_back(checksum >> 8);
+  frame.push_back(checksum & 0xff);
+  frame.erase(frame.begin());
+  return frame;
+}
+
+struct Result {
+  double operations_per_second;
+  double cycle_time;  // in uS
+  double wall_clock_ratio;  // simulated time / wall clock time
+  TransceiverOperationResult last_result;
+  double collision_time;  // in uS per operation
+  uint64_t turnaround;  // in uS
+  double isr_calls;  // per operation
+};
+
+/*
+ * Run count operations, keeping the transceiver's queue full.
+ * @param queue Queues the next operation, returns false if the queue is full.
+ */
+Result Run(unsigned int responder_count,
+           const std::function<bool()> &queue,
+           unsigned int count,
+           bool use_tx_dma = false) {
+  TransceiverSimulator::Options options;
+  options.use_tx_dma = use_tx_dma;
+  TransceiverSimulator simulator(options);
+  std::vector<SimulatedResponder*> responders;
+  for (unsigned int i = 0; i < responder_count; i++) {
+    uint8_t uid[UID_LENGTH];
+    ResponderUID(i, uid);
+    responders.push_back(new SimulatedResponder(uid));
+    simulator.AddResponder(responders.back());
+  }
+  simulator.Initialize(CountEvent);
+
+  g_event_count = 0u;
+  unsigned int queued = 0u;
+  while (queued < count && queue()) {
+    queued++;
+  }
+
+  // Skip the first operation, so the cycle time is measured from break to
+  // break.
+  simulator.RunUntil([]() { return g_event_count == 1u; }, kOperationTimeout);
+  uint64_t start = simulator.Now();
+  unsigned int start_isr_calls = simulator.ISRCalls();
+  auto wall_start = std::chrono::steady_clock::now();
+
+  for (unsigned int i = 1; i < count; i++) {
+    if (queued < count && queue()) {
+      queued++;
+    }
+    simulator.RunUntil([i]() { return g_event_count > i; },
+                       kOperationTimeout);
+  }
+
+  std::chrono::duration<double> wall_elapsed =
+      std::chrono::steady_clock::now() - wall_start;
+  double elapsed = simulator.Now() - start;
+
+  Result result;
+  result.cycle_time = elapsed / (count - 1u);
+  result.operations_per_second = 1000000.0 / result.cycle_time;
+  result.wall_clock_ratio = elapsed / 1000000.0 / wall_elapsed.count();
+  result.last_result = g_last_result;
+  result.collision_time =
+      static_cast<double>(simulator.CollisionTime()) / count;
+  result.turnaround = simulator.LastResponseStart() > simulator.LastTurnaround()
+      ? simulator.LastResponseStart() - simulator.LastTurnaround() : 0u;
+  result.isr_calls = static_cast<double>(
+      simulator.ISRCalls() - start_isr_calls) / (count - 1u);
+
+  for (unsigned int i = 0; i < responders.size(); i++) {
+    delete responders[i];
+  }
+  return result;
+}
+
+const char *ResultToString(TransceiverOperationResult result) {
+  switch (result) {
+    case T_RESULT_TX_OK:
+      return "TX_OK";
+    case T_RESULT_TX_ERROR:
+      return "TX_ERROR";
+    case T_RESULT_RX_DATA:
+      return "RX_DATA";
+    case T_RESULT_RX_TIMEOUT:
+      return "RX_TIMEOUT";
+    case T_RESULT_RX_INVALID:
+      return "RX_INVALID";
+    default:
+      return "OTHER";
+  }
+}
+
+void Print(const char *name, const Result &result) {
+  printf("%-26s %10.1f %10.0f %12s %10.1f %10llu %8.1f %8.1fx\n", name,
+         result.operations_per_second, result.cycle_time,
+         ResultToString(result.last_result), result.collision_time,
+         static_cast<unsigned long long>(result.turnaround),
+         result.isr_calls, result.wall_clock_ratio);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  unsigned int count = argc > 1 ? atoi(argv[1]) : 50;
+  if (count < 2u) {
+    count = 2u;
+  }
+
+  uint8_t dmx[DMX_FRAME_SIZE];
+  for (unsigned int i = 0; i < DMX_FRAME_SIZE; i++) {
+    dmx[i] = i & 0xff;
+  }
+
+  uint8_t responder_uid[UID_LENGTH];
+  ResponderUID(0u, responder_uid);
+  const std::vector<uint8_t> get = BuildRequest(
+      responder_uid, GET_COMMAND, kDeviceInfoPID, NULL, 0u);
+  const std::vector<uint8_t> broadcast = BuildRequest(
+      kBroadcastUID, SET_COMMAND, kDeviceInfoPID, NULL, 0u);
+  uint8_t dub_param_data[2 * UID_LENGTH];
+  memset(dub_param_data, 0, UID_LENGTH);
+  memset(dub_param_data + UID_LENGTH, 0xff, UID_LENGTH);
+  const std::vector<uint8_t> dub = BuildRequest(
+      kBroadcastUID, DISCOVERY_COMMAND, PID_DISC_UNIQUE_BRANCH,
+      dub_param_data, sizeof(dub_param_data));
+
+  printf("%-26s %10s %10s %12s %10s %10s %8s %9s\n", "Operation", "Ops/s",
+         "Cycle (uS)", "Result", "Collision", "Turnaround", "ISRs",
+         "Sim rate");
+
+  Print("DMX, 512 slots", Run(
+      1u, [&]() { return Transceiver_QueueDMX(0, dmx, DMX_FRAME_SIZE); },
+      count));
+  Print("DMX, 512 slots, DMA", Run(
+      1u, [&]() { return Transceiver_QueueDMX(0, dmx, DMX_FRAME_SIZE); },
+      count, true));
+  Print("DMX, 24 slots", Run(
+      1u, [&]() { return Transceiver_QueueDMX(0, dmx, 24u); }, count));
+  Print("RDM GET", Run(
+      1u, [&]() {
+        return Transceiver_QueueRDMRequest(0, get.data(), get.size(), false);
+      }, count));
+  Print("RDM GET, DMA", Run(
+      1u, [&]() {
+        return Transceiver_QueueRDMRequest(0, get.data(), get.size(), false);
+      }, count, true));
+  Print("RDM GET, no response", Run(
+      0u, [&]() {
+        return Transceiver_QueueRDMRequest(0, get.data(), get.size(), false);
+      }, count));
+  Print("RDM broadcast SET", Run(
+      1u, [&]() {
+        return Transceiver_QueueRDMRequest(0, broadcast.data(),
+                                           broadcast.size(), true);
+      }, count));
+  Print("DUB, 0 responders", Run(
+      0u, [&]() {
+        return Transceiver_QueueRDMDUB(0, dub.data(), dub.size());
+      }, count));
+  Print("DUB, 1 responder", Run(
+      1u, [&]() {
+        return Transceiver_QueueRDMDUB(0, dub.data(), dub.size());
+      }, count));
+  Print("DUB, 2 responders", Run(
+      2u, [&]() {
+        return Transceiver_QueueRDMDUB(0, dub.data(), dub.size());
+      }, count));
+  return 0;
+}
@@ -0,0 +1,808 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TransceiverSimulator.cpp
+ * Runs the transceiver code against a simulated RS-485 line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "TransceiverSimulator.h"
+
+#include <algorithm>
+
+#include "coarse_timer.h"
+#include "setting_macros.h"
+#include "sys/kmem.h"
+
+// The transceiver ISRs.
+extern "C" {
+void InputCaptureEvent(void);
+void Transceiver_TimerEvent();
+void Transceiver_UARTEvent();
+void Transceiver_DMAEvent();
+void Transceiver_RXDMAEvent();
+}
+
+using ::testing::Invoke;
+using ::testing::_;
+
+namespace {
+
+// The peripheral bus clock, in ticks per uS.
+const unsigned int kTicksPerMicroSecond = SYS_CLK_FREQ / 1000000u;
+
+// The prescale divisors, indexed by TMR_PRESCALE.
+const unsigned int kPrescaleDivisors[] = {1u, 2u, 4u, 8u, 16u, 32u, 64u, 256u};
+
+// A real CPU would spin forever if an ISR failed to clear its interrupt
+// condition. Bound the number of ISR calls per step so the simulation
+// always makes progress.
+const unsigned int kMaxISRCallsPerStep = 64u;
+
+// The timeout for the initial switch to controller mode.
+const uint64_t kModeSwitchTimeout = 10000u;
+
+// The break & mark sent by the simulated controller.
+const unsigned int kControllerBreak = 176u;
+const unsigned int kControllerMark = 12u;
+
+}  // namespace
+
+TransceiverSimulator::TransceiverSimulator(const Options &options)
+    : m_options(options),
+      m_now(0u),
+      m_line(true),
+      m_driving(false),
+      m_awaiting_response(false),
+      m_collision_time(0u),
+      m_last_turnaround(0u),
+      m_last_response_start(0u),
+      m_break_pin(false),
+      m_tx_enable_pin(false),
+      m_rx_enable_pin(false),
+      m_timer_running(false),
+      m_timer_counter(0u),
+      m_timer_period(0xffffu),
+      m_timer_prescale(1u),
+      m_timer_fraction(0u),
+      m_usart_enabled(false),
+      m_usart_tx_enabled(false),
+      m_usart_rx_enabled(false),
+      m_usart_tx_mode(USART_TRANSMIT_FIFO_EMPTY),
+      m_rx_overrun(false),
+      m_rx_overruns(0u),
+      m_usart_tx_register(0u),
+      m_usart_rx_register(0u),
+      m_ic_enabled(false),
+      m_ic_armed(false),
+      m_ic_first_edge(IC_EDGE_RISING),
+      m_rx_line(true),
+      m_rx_edge(false),
+      m_isr_calls(0u) {
+  TransceiverHardwareSettings settings = {
+    .usart = AS_USART_ID(1),
+    .usart_vector = AS_USART_INTERRUPT_VECTOR(1),
+    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(1),
+    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(1),
+    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(1),
+    .port = PORT_CHANNEL_F,
+    .break_bit = PORTS_BIT_POS_8,
+    .tx_enable_bit = PORTS_BIT_POS_1,
+    .rx_enable_bit = PORTS_BIT_POS_0,
+    .input_capture_module = AS_IC_ID(2),
+    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(2),
+    .input_capture_source = AS_IC_INTERRUPT_SOURCE(2),
+    .timer_module_id = AS_TIMER_ID(3),
+    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(3),
+    .timer_source = AS_TIMER_INTERRUPT_SOURCE(3),
+    .input_capture_timer = AS_IC_TMR_ID(3),
+    .use_tx_dma = options.use_tx_dma,
+    .tx_dma_channel = AS_DMA_CHANNEL(0),
+    .tx_dma_trigger = AS_USART_DMA_TX_TRIGGER(1),
+    .tx_dma_vector = AS_DMA_INTERRUPT_VECTOR(0),
+    .tx_dma_source = AS_DMA_INTERRUPT_SOURCE(0),
+    .use_rx_dma = options.use_rx_dma,
+    .rx_dma_channel = AS_DMA_CHANNEL(1),
+    .rx_dma_trigger = AS_USART_DMA_RX_TRIGGER(1),
+    .rx_dma_vector = AS_DMA_INTERRUPT_VECTOR(1),
+    .rx_dma_source = AS_DMA_INTERRUPT_SOURCE(1),
+  };
+  m_settings = settings;
+
+  ON_CALL(m_ports_mock, PinSet(_, _, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::PinSet));
+  ON_CALL(m_ports_mock, PinClear(_, _, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::PinClear));
+
+  ON_CALL(m_timer_mock, Counter16BitSet(_, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerCounterSet));
+  ON_CALL(m_timer_mock, Counter16BitGet(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerCounterGet));
+  ON_CALL(m_timer_mock, Period16BitSet(_, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerPeriodSet));
+  ON_CALL(m_timer_mock, Counter16BitClear(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerCounterClear));
+  ON_CALL(m_timer_mock, Start(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerStart));
+  ON_CALL(m_timer_mock, Stop(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerStop));
+  ON_CALL(m_timer_mock, PrescaleSelect(_, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::TimerPrescaleSelect));
+
+  ON_CALL(m_usart_mock, Enable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::USARTEnable));
+  ON_CALL(m_usart_mock, Disable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::USARTDisable));
+  ON_CALL(m_usart_mock, TransmitterEnable(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTTransmitterEnable));
+  ON_CALL(m_usart_mock, TransmitterDisable(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTTransmitterDisable));
+  ON_CALL(m_usart_mock, ReceiverEnable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::USARTReceiverEnable));
+  ON_CALL(m_usart_mock, ReceiverDisable(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTReceiverDisable));
+  ON_CALL(m_usart_mock, TransmitterByteSend(_, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTTransmitterByteSend));
+  ON_CALL(m_usart_mock, ReceiverByteReceive(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTReceiverByteReceive));
+  ON_CALL(m_usart_mock, ReceiverDataIsAvailable(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTReceiverDataIsAvailable));
+  ON_CALL(m_usart_mock, TransmitterBufferIsFull(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTTransmitterBufferIsFull));
+  ON_CALL(m_usart_mock, TransmitterInterruptModeSelect(_, _))
+      .WillByDefault(Invoke(
+          this, &TransceiverSimulator::USARTTransmitterInterruptModeSelect));
+  ON_CALL(m_usart_mock, ErrorsGet(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::USARTErrorsGet));
+  ON_CALL(m_usart_mock, TransmitterAddressGet(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTTransmitterAddressGet));
+  ON_CALL(m_usart_mock, ReceiverAddressGet(_))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::USARTReceiverAddressGet));
+
+  ON_CALL(m_dma_mock, ChannelXEnable(_, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::DMAChannelEnable));
+  ON_CALL(m_dma_mock, ChannelXDisable(_, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::DMAChannelDisable));
+  ON_CALL(m_dma_mock, ChannelXSourceStartAddressSet(_, _, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::DMASourceStartAddressSet));
+  ON_CALL(m_dma_mock, ChannelXSourceSizeSet(_, _, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::DMASourceSizeSet));
+  ON_CALL(m_dma_mock, ChannelXDestinationStartAddressSet(_, _, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::DMADestinationStartAddressSet));
+  ON_CALL(m_dma_mock, ChannelXDestinationSizeSet(_, _, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::DMADestinationSizeSet));
+  ON_CALL(m_dma_mock, ChannelXDestinationPointerGet(_, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::DMADestinationPointerGet));
+  ON_CALL(m_dma_mock, ChannelXINTSourceFlagGet(_, _, _))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::DMAINTSourceFlagGet));
+  ON_CALL(m_dma_mock, ChannelXINTSourceFlagClear(_, _, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::DMAINTSourceFlagClear));
+
+  ON_CALL(m_ic_mock, Enable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::ICEnable));
+  ON_CALL(m_ic_mock, Disable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::ICDisable));
+  ON_CALL(m_ic_mock, FirstCaptureEdgeSelect(_, _))
+      .WillByDefault(
+          Invoke(this, &TransceiverSimulator::ICFirstCaptureEdgeSelect));
+  ON_CALL(m_ic_mock, Buffer16BitGet(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::ICBuffer16BitGet));
+  ON_CALL(m_ic_mock, BufferIsEmpty(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::ICBufferIsEmpty));
+
+  ON_CALL(m_int_mock, SourceStatusGet(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::SourceStatusGet));
+  ON_CALL(m_int_mock, SourceStatusClear(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::SourceStatusClear));
+  ON_CALL(m_int_mock, SourceEnable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::SourceEnable));
+  ON_CALL(m_int_mock, SourceDisable(_))
+      .WillByDefault(Invoke(this, &TransceiverSimulator::SourceDisable));
+
+  PLIB_DMA_SetMock(&m_dma_mock);
+  PLIB_IC_SetMock(&m_ic_mock);
+  PLIB_PORTS_SetMock(&m_ports_mock);
+  PLIB_TMR_SetMock(&m_timer_mock);
+  PLIB_USART_SetMock(&m_usart_mock);
+  SYS_INT_SetMock(&m_int_mock);
+  CoarseTimer_SetCounter(0u);
+}
+
+TransceiverSimulator::~TransceiverSimulator() {
+  PLIB_DMA_SetMock(NULL);
+  PLIB_IC_SetMock(NULL);
+  PLIB_PORTS_SetMock(NULL);
+  PLIB_TMR_SetMock(NULL);
+  PLIB_USART_SetMock(NULL);
+  SYS_INT_SetMock(NULL);
+}
+
+void TransceiverSimulator::Initialize(TransceiverEventCallback tx_callback) {
+  Transceiver_Initialize(&m_settings, tx_callback, NULL);
+  Transceiver_SetMode(T_MODE_CONTROLLER);
+  RunUntil([]() { return Transceiver_GetMode() == T_MODE_CONTROLLER; },
+           kModeSwitchTimeout);
+}
+
+void TransceiverSimulator::InitializeResponder(
+    TransceiverEventCallback rx_callback) {
+  Transceiver_Initialize(&m_settings, NULL, rx_callback);
+  Run(kModeSwitchTimeout);
+}
+
+void TransceiverSimulator::AddResponder(SimulatedResponder *responder) {
+  m_responders.push_back(responder);
+}
+
+void TransceiverSimulator::SendFrame(const uint8_t *data, unsigned int size) {
+  m_controller.AddBreak(kControllerBreak);
+  m_controller.AddMark(kControllerMark);
+  m_controller.AddSlots(data, size);
+}
+
+void TransceiverSimulator::Run(uint64_t duration) {
+  for (uint64_t i = 0; i < duration; i++) {
+    Step();
+  }
+}
+
+bool TransceiverSimulator::RunUntil(const std::function<bool()> &done,
+                                    uint64_t timeout) {
+  for (uint64_t i = 0; i < timeout; i++) {
+    Step();
+    if (done()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TransceiverSimulator::Step() {
+  ResolveLine();
+  UpdateUSART();
+  UpdateDMA();
+  UpdateInputCapture();
+
+  std::vector<SimulatedResponder*>::iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    (*iter)->Sample(m_line);
+  }
+
+  UpdateTimer();
+  DispatchInterrupts();
+
+  if (m_now % m_options.main_loop_interval == 0u) {
+    Transceiver_Tasks();
+    DispatchInterrupts();
+  }
+
+  m_now++;
+  // The coarse timer ticks every 100uS.
+  CoarseTimer_SetCounter(m_now / 100u);
+}
+
+void TransceiverSimulator::ResolveLine() {
+  bool was_driving = m_driving;
+  bool last_line = m_line;
+  unsigned int drivers = 0u;
+  bool high = false;
+  bool low = false;
+
+  m_driving = m_tx_enable_pin;
+  if (m_driving) {
+    bool level = m_break_pin && m_transmitter.Level();
+    high |= level;
+    low |= !level;
+    drivers++;
+  }
+
+  if (!m_controller.Empty()) {
+    bool level = m_controller.Next();
+    high |= level;
+    low |= !level;
+    drivers++;
+  }
+
+  std::vector<SimulatedResponder*>::iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    bool level;
+    if ((*iter)->Drive(&level)) {
+      high |= level;
+      low |= !level;
+      drivers++;
+    }
+  }
+
+  // The line idles high, and a low driver wins.
+  m_line = !low;
+  if (drivers > 1u && high && low) {
+    m_collision_time++;
+  }
+
+  if (was_driving && !m_driving) {
+    m_last_turnaround = m_now;
+    m_awaiting_response = true;
+  } else if (m_driving) {
+    m_awaiting_response = false;
+  } else if (m_awaiting_response && last_line && !m_line) {
+    m_last_response_start = m_now;
+    m_awaiting_response = false;
+  }
+
+  // RE is active low.
+  bool rx_line = m_rx_enable_pin ? true : m_line;
+  m_rx_edge = rx_line != m_rx_line;
+  m_rx_line = rx_line;
+}
+
+void TransceiverSimulator::UpdateTimer() {
+  if (!m_timer_running) {
+    return;
+  }
+
+  m_timer_fraction += kTicksPerMicroSecond;
+  uint32_t ticks = m_timer_fraction / m_timer_prescale;
+  m_timer_fraction %= m_timer_prescale;
+
+  // The counter resets on the tick after it matches the period.
+  if (m_timer_counter <= m_timer_period &&
+      m_timer_counter + ticks > m_timer_period) {
+    m_timer_counter = m_timer_counter + ticks - (m_timer_period + 1u);
+    m_interrupts[m_settings.timer_source].flag = true;
+  } else {
+    m_timer_counter = (m_timer_counter + ticks) & 0xffffu;
+  }
+}
+
+void TransceiverSimulator::UpdateUSART() {
+  if (m_usart_enabled && m_usart_rx_enabled) {
+    ReceivedByte byte;
+    if (m_receiver.Sample(m_rx_line, &byte)) {
+      if (m_rx_fifo.size() < m_options.rx_fifo_depth) {
+        m_rx_fifo.push_back(byte);
+        if (byte.framing_error) {
+          m_interrupts[m_settings.usart_error_source].flag = true;
+        }
+      } else {
+        m_rx_overrun = true;
+        m_rx_overruns++;
+        m_interrupts[m_settings.usart_error_source].flag = true;
+      }
+    }
+  }
+
+  m_transmitter.Advance();
+  ServiceTransmitter();
+}
+
+void TransceiverSimulator::UpdateDMA() {
+  // A channel reading from the USART RX register moves a byte each time the RX
+  // interrupt is raised. One writing to the TX register moves a byte each time
+  // the TX interrupt is raised.
+  std::map<DMA_CHANNEL, DMAChannel>::iterator iter = m_dma_channels.begin();
+  for (; iter != m_dma_channels.end(); ++iter) {
+    DMAChannel &channel = iter->second;
+    const bool from_rx = IsRegister(channel.source, &m_usart_rx_register);
+    const bool to_tx = IsRegister(channel.destination, &m_usart_tx_register);
+    const uint16_t block_size = std::max(channel.source_size,
+                                         channel.destination_size);
+
+    while (channel.enabled && channel.source_size &&
+           channel.destination_size &&
+           ((from_rx && !m_rx_fifo.empty()) ||
+            (to_tx && TXInterruptCondition()))) {
+      uint8_t value;
+      if (from_rx) {
+        value = USARTReceiverByteReceive(m_settings.usart);
+      } else {
+        value = reinterpret_cast<const uint8_t*>(KMEM_PhysicalToVirtual(
+            channel.source))[channel.index % channel.source_size];
+      }
+
+      if (to_tx) {
+        USARTTransmitterByteSend(m_settings.usart, value);
+      } else {
+        reinterpret_cast<uint8_t*>(KMEM_PhysicalToVirtual(
+            channel.destination))[channel.index % channel.destination_size] =
+            value;
+      }
+
+      channel.index++;
+      if (channel.index >= block_size) {
+        channel.enabled = false;
+        channel.index = 0u;
+        channel.block_complete = true;
+        if (iter->first == m_settings.tx_dma_channel) {
+          m_interrupts[m_settings.tx_dma_source].flag = true;
+        } else if (iter->first == m_settings.rx_dma_channel) {
+          m_interrupts[m_settings.rx_dma_source].flag = true;
+        }
+      }
+    }
+  }
+}
+
+bool TransceiverSimulator::IsRegister(uint32_t address,
+                                      const uint8_t *usart_register) {
+  return KMEM_PhysicalToVirtual(address) == usart_register;
+}
+
+void TransceiverSimulator::UpdateInputCapture() {
+  if (!m_ic_enabled || !m_rx_edge) {
+    return;
+  }
+
+  if (!m_ic_armed) {
+    IC_EDGE_TYPES edge_type = m_rx_line ? IC_EDGE_RISING : IC_EDGE_FALLING;
+    if (edge_type != m_ic_first_edge) {
+      return;
+    }
+    m_ic_armed = true;
+  }
+
+  if (m_ic_fifo.size() < m_options.ic_fifo_depth) {
+    m_ic_fifo.push_back(m_timer_counter);
+  }
+}
+
+bool TransceiverSimulator::TXInterruptCondition() {
+  if (!(m_usart_enabled && m_usart_tx_enabled)) {
+    return false;
+  }
+  switch (m_usart_tx_mode) {
+    case USART_TRANSMIT_FIFO_NOT_FULL:
+      return m_tx_fifo.size() < m_options.tx_fifo_depth;
+    case USART_TRANSMIT_FIFO_IDLE:
+      return m_tx_fifo.empty() && !m_transmitter.Busy();
+    case USART_TRANSMIT_FIFO_EMPTY:
+      return m_tx_fifo.empty();
+  }
+  return false;
+}
+
+void TransceiverSimulator::UpdateInterruptFlags() {
+  // The TX, RX & input capture interrupts are level triggered.
+  if (TXInterruptCondition()) {
+    m_interrupts[m_settings.usart_tx_source].flag = true;
+  }
+  if (!m_rx_fifo.empty()) {
+    m_interrupts[m_settings.usart_rx_source].flag = true;
+  }
+  if (!m_ic_fifo.empty()) {
+    m_interrupts[m_settings.input_capture_source].flag = true;
+  }
+}
+
+bool TransceiverSimulator::InterruptPending(INT_SOURCE source) {
+  const Interrupt &interrupt = m_interrupts[source];
+  return interrupt.enabled && interrupt.flag;
+}
+
+void TransceiverSimulator::DispatchInterrupts() {
+  for (unsigned int i = 0; i < kMaxISRCallsPerStep; i++) {
+    UpdateDMA();
+    UpdateInterruptFlags();
+    if (InterruptPending(m_settings.input_capture_source)) {
+      InputCaptureEvent();
+    } else if (InterruptPending(m_settings.timer_source)) {
+      Transceiver_TimerEvent();
+    } else if (InterruptPending(m_settings.usart_tx_source) ||
+               InterruptPending(m_settings.usart_rx_source) ||
+               InterruptPending(m_settings.usart_error_source)) {
+      Transceiver_UARTEvent();
+    } else if (m_settings.use_tx_dma &&
+               InterruptPending(m_settings.tx_dma_source)) {
+      Transceiver_DMAEvent();
+    } else if (m_settings.use_rx_dma &&
+               InterruptPending(m_settings.rx_dma_source)) {
+      Transceiver_RXDMAEvent();
+    } else {
+      return;
+    }
+    m_isr_calls++;
+  }
+}
+
+void TransceiverSimulator::ServiceTransmitter() {
+  if (m_usart_enabled && m_usart_tx_enabled && !m_transmitter.Busy() &&
+      !m_tx_fifo.empty()) {
+    m_transmitter.Load(m_tx_fifo.front());
+    m_tx_fifo.pop_front();
+  }
+}
+
+// Pins
+// ----------------------------------------------------------------------------
+void TransceiverSimulator::PinSet(PORTS_MODULE_ID,
+                                  PORTS_CHANNEL channel,
+                                  PORTS_BIT_POS pos) {
+  SetPin(channel, pos, true);
+}
+
+void TransceiverSimulator::PinClear(PORTS_MODULE_ID,
+                                    PORTS_CHANNEL channel,
+                                    PORTS_BIT_POS pos) {
+  SetPin(channel, pos, false);
+}
+
+void TransceiverSimulator::SetPin(PORTS_CHANNEL channel, PORTS_BIT_POS pos,
+                                  bool value) {
+  if (channel != m_settings.port) {
+    return;
+  }
+  if (pos == m_settings.break_bit) {
+    m_break_pin = value;
+  } else if (pos == m_settings.tx_enable_bit) {
+    m_tx_enable_pin = value;
+  } else if (pos == m_settings.rx_enable_bit) {
+    m_rx_enable_pin = value;
+  }
+}
+
+// Timer
+// ----------------------------------------------------------------------------
+void TransceiverSimulator::TimerCounterSet(TMR_MODULE_ID,
+                                           uint16_t value) {
+  m_timer_counter = value;
+}
+
+uint16_t TransceiverSimulator::TimerCounterGet(TMR_MODULE_ID) {
+  return m_timer_counter;
+}
+
+void TransceiverSimulator::TimerPeriodSet(TMR_MODULE_ID,
+                                          uint16_t period) {
+  m_timer_period = period;
+}
+
+void TransceiverSimulator::TimerCounterClear(TMR_MODULE_ID) {
+  m_timer_counter = 0u;
+  m_timer_fraction = 0u;
+}
+
+void TransceiverSimulator::TimerStart(TMR_MODULE_ID) {
+  m_timer_running = true;
+}
+
+void TransceiverSimulator::TimerStop(TMR_MODULE_ID) {
+  m_timer_running = false;
+}
+
+void TransceiverSimulator::TimerPrescaleSelect(TMR_MODULE_ID,
+                                               TMR_PRESCALE prescale) {
+  m_timer_prescale = kPrescaleDivisors[prescale];
+  m_timer_fraction = 0u;
+}
+
+// USART
+// ----------------------------------------------------------------------------
+void TransceiverSimulator::USARTEnable(USART_MODULE_ID) {
+  m_usart_enabled = true;
+  ServiceTransmitter();
+}
+
+void TransceiverSimulator::USARTDisable(USART_MODULE_ID) {
+  m_usart_enabled = false;
+  m_tx_fifo.clear();
+  m_transmitter.Reset();
+  m_rx_fifo.clear();
+  m_receiver.Reset(m_rx_line);
+  m_rx_overrun = false;
+}
+
+void TransceiverSimulator::USARTTransmitterEnable(USART_MODULE_ID) {
+  m_usart_tx_enabled = true;
+  ServiceTransmitter();
+}
+
+void TransceiverSimulator::USARTTransmitterDisable(USART_MODULE_ID) {
+  m_usart_tx_enabled = false;
+  m_tx_fifo.clear();
+  m_transmitter.Reset();
+}
+
+void TransceiverSimulator::USARTReceiverEnable(USART_MODULE_ID) {
+  if (!m_usart_rx_enabled) {
+    m_receiver.Reset(m_rx_line);
+  }
+  m_usart_rx_enabled = true;
+}
+
+void TransceiverSimulator::USARTReceiverDisable(USART_MODULE_ID) {
+  m_usart_rx_enabled = false;
+  m_rx_overrun = false;
+}
+
+void TransceiverSimulator::USARTTransmitterByteSend(USART_MODULE_ID,
+                                                    int8_t data) {
+  if (m_tx_fifo.size() < m_options.tx_fifo_depth) {
+    m_tx_fifo.push_back(data);
+  }
+  ServiceTransmitter();
+}
+
+int8_t TransceiverSimulator::USARTReceiverByteReceive(USART_MODULE_ID) {
+  if (m_rx_fifo.empty()) {
+    return 0;
+  }
+  uint8_t value = m_rx_fifo.front().value;
+  m_rx_fifo.pop_front();
+  return value;
+}
+
+bool TransceiverSimulator::USARTReceiverDataIsAvailable(
+    USART_MODULE_ID) {
+  return !m_rx_fifo.empty();
+}
+
+bool TransceiverSimulator::USARTTransmitterBufferIsFull(
+    USART_MODULE_ID) {
+  return m_tx_fifo.size() >= m_options.tx_fifo_depth;
+}
+
+void TransceiverSimulator::USARTTransmitterInterruptModeSelect(
+    USART_MODULE_ID,
+    USART_TRANSMIT_INTR_MODE mode) {
+  m_usart_tx_mode = mode;
+}
+
+USART_ERROR TransceiverSimulator::USARTErrorsGet(USART_MODULE_ID) {
+  unsigned int errors = USART_ERROR_NONE;
+  if (!m_rx_fifo.empty() && m_rx_fifo.front().framing_error) {
+    errors |= USART_ERROR_FRAMING;
+  }
+  if (m_rx_overrun) {
+    errors |= USART_ERROR_RECEIVER_OVERRUN;
+  }
+  return static_cast<USART_ERROR>(errors);
+}
+
+void* TransceiverSimulator::USARTTransmitterAddressGet(USART_MODULE_ID) {
+  return &m_usart_tx_register;
+}
+
+void* TransceiverSimulator::USARTReceiverAddressGet(USART_MODULE_ID) {
+  return &m_usart_rx_register;
+}
+
+// DMA
+// ----------------------------------------------------------------------------
+uint16_t TransceiverSimulator::DMARegisterSize(uint16_t size) {
+  // The size registers are 8 bits wide, 0 means 256.
+  size &= 0xff;
+  return size ? size : 256u;
+}
+
+void TransceiverSimulator::DMAChannelEnable(DMA_MODULE_ID,
+                                            DMA_CHANNEL channel) {
+  m_dma_channels[channel].enabled = true;
+}
+
+void TransceiverSimulator::DMAChannelDisable(DMA_MODULE_ID,
+                                             DMA_CHANNEL channel) {
+  m_dma_channels[channel].enabled = false;
+}
+
+void TransceiverSimulator::DMASourceStartAddressSet(DMA_MODULE_ID,
+                                                    DMA_CHANNEL channel,
+                                                    uint32_t address) {
+  m_dma_channels[channel].source = address;
+  m_dma_channels[channel].index = 0u;
+}
+
+void TransceiverSimulator::DMASourceSizeSet(DMA_MODULE_ID, DMA_CHANNEL channel,
+                                            uint16_t size) {
+  m_dma_channels[channel].source_size = DMARegisterSize(size);
+}
+
+void TransceiverSimulator::DMADestinationStartAddressSet(DMA_MODULE_ID,
+                                                         DMA_CHANNEL channel,
+                                                         uint32_t address) {
+  m_dma_channels[channel].destination = address;
+  m_dma_channels[channel].index = 0u;
+}
+
+void TransceiverSimulator::DMADestinationSizeSet(DMA_MODULE_ID,
+                                                 DMA_CHANNEL channel,
+                                                 uint16_t size) {
+  m_dma_channels[channel].destination_size = DMARegisterSize(size);
+}
+
+uint16_t TransceiverSimulator::DMADestinationPointerGet(DMA_MODULE_ID,
+                                                        DMA_CHANNEL channel) {
+  const DMAChannel &state = m_dma_channels[channel];
+  return state.destination_size ? state.index % state.destination_size : 0u;
+}
+
+bool TransceiverSimulator::DMAINTSourceFlagGet(DMA_MODULE_ID,
+                                               DMA_CHANNEL channel,
+                                               DMA_INT_TYPE source) {
+  return source == DMA_INT_BLOCK_TRANSFER_COMPLETE &&
+      m_dma_channels[channel].block_complete;
+}
+
+void TransceiverSimulator::DMAINTSourceFlagClear(DMA_MODULE_ID,
+                                                 DMA_CHANNEL channel,
+                                                 DMA_INT_TYPE source) {
+  if (source == DMA_INT_BLOCK_TRANSFER_COMPLETE) {
+    m_dma_channels[channel].block_complete = false;
+  }
+}
+
+// Input Capture
+// ----------------------------------------------------------------------------
+void TransceiverSimulator::ICEnable(IC_MODULE_ID) {
+  if (!m_ic_enabled) {
+    m_ic_armed = false;
+  }
+  m_ic_enabled = true;
+}
+
+void TransceiverSimulator::ICDisable(IC_MODULE_ID) {
+  m_ic_enabled = false;
+  m_ic_fifo.clear();
+}
+
+void TransceiverSimulator::ICFirstCaptureEdgeSelect(IC_MODULE_ID,
+                                                    IC_EDGE_TYPES edge) {
+  m_ic_first_edge = edge;
+}
+
+uint16_t TransceiverSimulator::ICBuffer16BitGet(IC_MODULE_ID) {
+  if (m_ic_fifo.empty()) {
+    return 0u;
+  }
+  uint16_t value = m_ic_fifo.front();
+  m_ic_fifo.pop_front();
+  return value;
+}
+
+bool TransceiverSimulator::ICBufferIsEmpty(IC_MODULE_ID) {
+  return m_ic_fifo.empty();
+}
+
+// Interrupts
+// ----------------------------------------------------------------------------
+bool TransceiverSimulator::SourceStatusGet(INT_SOURCE source) {
+  return m_interrupts[source].flag;
+}
+
+void TransceiverSimulator::SourceStatusClear(INT_SOURCE source) {
+  m_interrupts[source].flag = false;
+}
+
+void TransceiverSimulator::SourceEnable(INT_SOURCE source) {
+  m_interrupts[source].enabled = true;
+}
+
+bool TransceiverSimulator::SourceDisable(INT_SOURCE source) {
+  bool enabled = m_interrupts[source].enabled;
+  m_interrupts[source].enabled = false;
+  return enabled;
+}
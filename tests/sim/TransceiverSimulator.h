@@ -0,0 +1,336 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TransceiverSimulator.h
+ * Runs the transceiver code against a simulated RS-485 line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_TRANSCEIVERSIMULATOR_H_
+#define TESTS_SIM_TRANSCEIVERSIMULATOR_H_
+
+#include <gmock/gmock.h>
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "SimulatedLine.h"
+#include "SimulatedResponder.h"
+#include "plib_dma_mock.h"
+#include "plib_ic_mock.h"
+#include "plib_ports_mock.h"
+#include "plib_tmr_mock.h"
+#include "plib_usart_mock.h"
+#include "sys_int_mock.h"
+#include "transceiver.h"
+
+/**
+ * @brief Runs the transceiver code against a simulated RS-485 line.
+ *
+ * The simulator models the peripherals the transceiver uses: the timer, the
+ * USART with its TX & RX FIFOs, the TX & RX DMA channels, the input capture
+ * module and the break & line driver pins. They're wired to the harmony mocks,
+ * so the unmodified transceiver.c runs on top of them.
+ *
+ * Time advances in steps of 1uS. During each step the line level is resolved
+ * from the transceiver and the attached responders, the peripherals are
+ * updated and any pending interrupts are dispatched to the transceiver ISRs.
+ * Transceiver_Tasks() is called every main_loop_interval steps.
+ *
+ * ISRs run to completion within a single step, so the model doesn't account
+ * for interrupt latency or ISR execution time.
+ *
+ * Only one simulator may exist at a time.
+ */
+class TransceiverSimulator {
+ public:
+  struct Options {
+    Options()
+        : main_loop_interval(5u),
+          tx_fifo_depth(8u),
+          rx_fifo_depth(8u),
+          ic_fifo_depth(4u),
+          use_tx_dma(false),
+          use_rx_dma(false) {
+    }
+
+    unsigned int main_loop_interval;  //!< uS between calls to _Tasks()
+    unsigned int tx_fifo_depth;  //!< The depth of the USART TX FIFO.
+    unsigned int rx_fifo_depth;  //!< The depth of the USART RX FIFO.
+    unsigned int ic_fifo_depth;  //!< The depth of the input capture FIFO.
+    bool use_tx_dma;  //!< Configure the transceiver to transmit using DMA.
+    bool use_rx_dma;  //!< Configure the transceiver to receive using DMA.
+  };
+
+  explicit TransceiverSimulator(const Options &options = Options());
+  ~TransceiverSimulator();
+
+  /**
+   * @brief Initialize the transceiver and switch it to controller mode.
+   * @param tx_callback The callback to run when an operation completes.
+   */
+  void Initialize(TransceiverEventCallback tx_callback);
+
+  /**
+   * @brief Initialize the transceiver and leave it in responder mode.
+   * @param rx_callback The callback to run when frames are received.
+   */
+  void InitializeResponder(TransceiverEventCallback rx_callback);
+
+  /**
+   * @brief Attach a responder to the line.
+   *
+   * The responder must outlive the simulator.
+   */
+  void AddResponder(SimulatedResponder *responder);
+
+  /**
+   * @brief Queue a frame to be sent to the transceiver by a simulated
+   *   controller.
+   * @param data The frame, including the start code.
+   * @param size The number of slots, including the start code.
+   *
+   * Frames are sent back to back, each with a 176uS break and 12uS mark.
+   */
+  void SendFrame(const uint8_t *data, unsigned int size);
+
+  /**
+   * @brief Check if the simulated controller has finished sending frames.
+   */
+  bool ControllerIdle() const { return m_controller.Empty(); }
+
+  /**
+   * @brief Advance the simulation.
+   * @param duration The number of uS to run for.
+   */
+  void Run(uint64_t duration);
+
+  /**
+   * @brief Advance the simulation until a condition is met.
+   * @param done Checked after every step.
+   * @param timeout The maximum number of uS to run for.
+   * @returns true if the condition was met, false if the timeout expired.
+   */
+  bool RunUntil(const std::function<bool()> &done, uint64_t timeout);
+
+  /**
+   * @brief The current simulation time in uS.
+   */
+  uint64_t Now() const { return m_now; }
+
+  /**
+   * @brief The total time, in uS, that more than one device drove the line
+   *   to different levels.
+   */
+  uint64_t CollisionTime() const { return m_collision_time; }
+
+  /**
+   * @brief The time the transceiver last stopped driving the line.
+   */
+  uint64_t LastTurnaround() const { return m_last_turnaround; }
+
+  /**
+   * @brief The time of the first falling edge after LastTurnaround().
+   */
+  uint64_t LastResponseStart() const { return m_last_response_start; }
+
+  /**
+   * @brief The number of bytes lost to RX FIFO overruns.
+   */
+  unsigned int RXOverruns() const { return m_rx_overruns; }
+
+  /**
+   * @brief The total number of ISR calls.
+   */
+  unsigned int ISRCalls() const { return m_isr_calls; }
+
+ private:
+  struct Interrupt {
+    Interrupt() : enabled(false), flag(false) {}
+
+    bool enabled;
+    bool flag;
+  };
+
+  struct DMAChannel {
+    DMAChannel()
+        : enabled(false),
+          source(0u),
+          source_size(0u),
+          destination(0u),
+          destination_size(0u),
+          index(0u),
+          block_complete(false) {
+    }
+
+    bool enabled;
+    uint32_t source;
+    uint16_t source_size;
+    uint32_t destination;
+    uint16_t destination_size;
+    uint16_t index;  //!< The number of cells transferred.
+    bool block_complete;
+  };
+
+  const Options m_options;
+  TransceiverHardwareSettings m_settings;
+  uint64_t m_now;
+  std::vector<SimulatedResponder*> m_responders;
+  Waveform m_controller;
+
+  // The line
+  bool m_line;
+  bool m_driving;
+  bool m_awaiting_response;
+  uint64_t m_collision_time;
+  uint64_t m_last_turnaround;
+  uint64_t m_last_response_start;
+
+  // The control pins
+  bool m_break_pin;
+  bool m_tx_enable_pin;
+  bool m_rx_enable_pin;
+
+  // The timer
+  bool m_timer_running;
+  uint32_t m_timer_counter;
+  uint16_t m_timer_period;
+  unsigned int m_timer_prescale;
+  unsigned int m_timer_fraction;
+
+  // The USART
+  bool m_usart_enabled;
+  bool m_usart_tx_enabled;
+  bool m_usart_rx_enabled;
+  USART_TRANSMIT_INTR_MODE m_usart_tx_mode;
+  std::deque<uint8_t> m_tx_fifo;
+  UARTTransmitter m_transmitter;
+  std::deque<ReceivedByte> m_rx_fifo;
+  UARTReceiver m_receiver;
+  bool m_rx_overrun;
+  unsigned int m_rx_overruns;
+
+  // The USART TX & RX registers, used as DMA destinations & sources.
+  uint8_t m_usart_tx_register;
+  uint8_t m_usart_rx_register;
+
+  // DMA
+  std::map<DMA_CHANNEL, DMAChannel> m_dma_channels;
+
+  // Input capture
+  bool m_ic_enabled;
+  bool m_ic_armed;
+  IC_EDGE_TYPES m_ic_first_edge;
+  std::deque<uint16_t> m_ic_fifo;
+
+  // The receive side of the line driver, high while RE is disabled.
+  bool m_rx_line;
+  bool m_rx_edge;
+
+  std::map<INT_SOURCE, Interrupt> m_interrupts;
+  unsigned int m_isr_calls;
+
+  testing::NiceMock<MockPeripheralDMA> m_dma_mock;
+
+  testing::NiceMock<MockPeripheralInputCapture> m_ic_mock;
+  testing::NiceMock<MockPeripheralPorts> m_ports_mock;
+  testing::NiceMock<MockPeripheralTimer> m_timer_mock;
+  testing::NiceMock<MockPeripheralUSART> m_usart_mock;
+  testing::NiceMock<MockSysInt> m_int_mock;
+
+  void Step();
+  void ResolveLine();
+  void UpdateTimer();
+  void UpdateUSART();
+  void UpdateDMA();
+  bool IsRegister(uint32_t address, const uint8_t *usart_register);
+  bool TXInterruptCondition();
+  void UpdateInputCapture();
+  void UpdateInterruptFlags();
+  bool InterruptPending(INT_SOURCE source);
+  void DispatchInterrupts();
+  void ServiceTransmitter();
+
+  // Pins
+  void PinSet(PORTS_MODULE_ID index, PORTS_CHANNEL channel, PORTS_BIT_POS pos);
+  void PinClear(PORTS_MODULE_ID index, PORTS_CHANNEL channel,
+                PORTS_BIT_POS pos);
+  void SetPin(PORTS_CHANNEL channel, PORTS_BIT_POS pos, bool value);
+
+  // Timer
+  void TimerCounterSet(TMR_MODULE_ID index, uint16_t value);
+  uint16_t TimerCounterGet(TMR_MODULE_ID index);
+  void TimerPeriodSet(TMR_MODULE_ID index, uint16_t period);
+  void TimerCounterClear(TMR_MODULE_ID index);
+  void TimerStart(TMR_MODULE_ID index);
+  void TimerStop(TMR_MODULE_ID index);
+  void TimerPrescaleSelect(TMR_MODULE_ID index, TMR_PRESCALE prescale);
+
+  // USART
+  void USARTEnable(USART_MODULE_ID index);
+  void USARTDisable(USART_MODULE_ID index);
+  void USARTTransmitterEnable(USART_MODULE_ID index);
+  void USARTTransmitterDisable(USART_MODULE_ID index);
+  void USARTReceiverEnable(USART_MODULE_ID index);
+  void USARTReceiverDisable(USART_MODULE_ID index);
+  void USARTTransmitterByteSend(USART_MODULE_ID index, int8_t data);
+  int8_t USARTReceiverByteReceive(USART_MODULE_ID index);
+  bool USARTReceiverDataIsAvailable(USART_MODULE_ID index);
+  bool USARTTransmitterBufferIsFull(USART_MODULE_ID index);
+  void USARTTransmitterInterruptModeSelect(USART_MODULE_ID index,
+                                           USART_TRANSMIT_INTR_MODE mode);
+  USART_ERROR USARTErrorsGet(USART_MODULE_ID index);
+  void* USARTTransmitterAddressGet(USART_MODULE_ID index);
+  void* USARTReceiverAddressGet(USART_MODULE_ID index);
+
+  // DMA
+  static uint16_t DMARegisterSize(uint16_t size);
+  void DMAChannelEnable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void DMAChannelDisable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void DMASourceStartAddressSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                uint32_t address);
+  void DMASourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                        uint16_t size);
+  void DMADestinationStartAddressSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                     uint32_t address);
+  void DMADestinationSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                             uint16_t size);
+  uint16_t DMADestinationPointerGet(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  bool DMAINTSourceFlagGet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                           DMA_INT_TYPE source);
+  void DMAINTSourceFlagClear(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                             DMA_INT_TYPE source);
+
+  // Input Capture
+  void ICEnable(IC_MODULE_ID index);
+  void ICDisable(IC_MODULE_ID index);
+  void ICFirstCaptureEdgeSelect(IC_MODULE_ID index, IC_EDGE_TYPES edge);
+  uint16_t ICBuffer16BitGet(IC_MODULE_ID index);
+  bool ICBufferIsEmpty(IC_MODULE_ID index);
+
+  // Interrupts
+  bool SourceStatusGet(INT_SOURCE source);
+  void SourceStatusClear(INT_SOURCE source);
+  void SourceEnable(INT_SOURCE source);
+  bool SourceDisable(INT_SOURCE source);
+
+  TransceiverSimulator(const TransceiverSimulator&);
+  TransceiverSimulator& operator=(const TransceiverSimulator&);
+};
+
+#endif  // TESTS_SIM_TRANSCEIVERSIMULATOR_H_
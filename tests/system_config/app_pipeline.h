@@ -7,4 +7,18 @@
 #ifndef TESTS_SYSTEM_CONFIG_APP_PIPELINE_H_
 #define TESTS_SYSTEM_CONFIG_APP_PIPELINE_H_
 
+/*
+ * Tests of the pinned TX path define TESTS_PIPELINE_TX_PINNED, which sends
+ * pinned messages to the transport mock.
+ */
+#ifdef TESTS_PIPELINE_TX_PINNED
+#include "transport.h"
+
+bool Transport_SendPinned(uint8_t token, Command command, uint8_t rc,
+                          const IOVec* iovec, unsigned int iovec_count);
+
+#define PIPELINE_TRANSPORT_TX_PINNED(token, command, rc, iov, iov_count) \
+  Transport_SendPinned(token, command, rc, iov, iov_count);
+#endif
+
 #endif  // TESTS_SYSTEM_CONFIG_APP_PIPELINE_H_
@@ -38,6 +38,22 @@
  */
 #define COARSE_TIMER_ID 2
 
+/**
+ * @}
+ *
+ * @name USB Transport
+ * Settings for the @ref usb_transport.
+ * @{
+ */
+
+/**
+ * @brief The number of response frames that can be queued for the host.
+ *
+ * Each frame uses USB_READ_BUFFER_SIZE bytes of RAM. This must be a power of
+ * two.
+ */
+#define USB_TRANSPORT_TX_QUEUE_SIZE 2u
+
 /**
  * @}
  *
@@ -82,6 +98,63 @@
  */
 #define TRANSCEIVER_RX_ENABLE_PORT_BIT PORTS_BIT_POS_1
 
+/**
+ * @brief The number of operations that can be queued with the transceiver.
+ *
+ * This allows the host to pipeline requests, the completion events are
+ * returned in order with the token of each request. Each queued operation
+ * uses a 513 byte buffer.
+ */
+#define TRANSCEIVER_QUEUE_DEPTH 2u
+
+/**
+ * @brief Use DMA to transmit frames.
+ *
+ * If true, each frame is handed to a DMA channel which is triggered by the
+ * USART TX interrupt. The CPU only takes a single interrupt once the last slot
+ * has been loaded into the TX FIFO.
+ */
+#define TRANSCEIVER_TX_DMA false
+
+/**
+ * @brief The DMA channel to use when TRANSCEIVER_TX_DMA is true.
+ */
+#define TRANSCEIVER_TX_DMA_CHANNEL 0
+
+/**
+ * @brief Use DMA to receive frames in responder mode.
+ *
+ * If true, DMX & ASC frames are moved from the USART into alternating buffers
+ * by a DMA channel. The break of the following frame completes the frame, so
+ * there are a handful of interrupts per frame rather than one per slot. RDM
+ * requests are still received a slot at a time, since the response is timed
+ * from the last slot.
+ */
+#define TRANSCEIVER_RX_DMA false
+
+/**
+ * @brief The DMA channel to use when TRANSCEIVER_RX_DMA is true.
+ */
+#define TRANSCEIVER_RX_DMA_CHANNEL 1
+
+/**
+ * @brief The number of DMX512 / RDM ports, from 1 to 4.
+ *
+ * Each additional port needs its own USART, timer, input capture module, DMA
+ * channels and I/O pins. These are set with TRANSCEIVER_1_UART,
+ * TRANSCEIVER_1_TIMER, TRANSCEIVER_1_IC, TRANSCEIVER_1_PORT,
+ * TRANSCEIVER_1_PORT_BIT, TRANSCEIVER_1_TX_ENABLE_PORT_BIT,
+ * TRANSCEIVER_1_RX_ENABLE_PORT_BIT, TRANSCEIVER_1_TX_DMA,
+ * TRANSCEIVER_1_TX_DMA_CHANNEL, TRANSCEIVER_1_RX_DMA and
+ * TRANSCEIVER_1_RX_DMA_CHANNEL, and likewise for ports 2 and 3.
+ *
+ * The timer is also the input capture time base. On the PIC32MX input capture
+ * can only use timers 2 and 3, which limits those parts to two ports.
+ *
+ * Each port uses about (TRANSCEIVER_QUEUE_DEPTH + 7) * 520 bytes of RAM.
+ */
+#define TRANSCEIVER_PORT_COUNT 1u
+
 /**
  * @}
  *
@@ -135,6 +208,26 @@
  */
 #define SPI_USE_ENHANCED_BUFFERING true
 
+/**
+ * @brief Use DMA to send pixel frames.
+ *
+ * If true, each frame is handed to a DMA channel which is triggered by the SPI
+ * TX interrupt. Otherwise the bytes are written from SPIRGB_Tasks().
+ */
+#define SPI_USE_DMA true
+
+/**
+ * @brief The DMA channel to use when SPI_USE_DMA is true.
+ *
+ * This must not be one of the TRANSCEIVER_*_DMA_CHANNEL channels.
+ */
+#define SPI_DMA_CHANNEL 7
+
+/**
+ * @brief The DMA trigger for the SPI_MODULE_ID TX interrupt.
+ */
+#define SPI_DMA_TRIGGER DMA_TRIGGER_SPI_1_TRANSMIT
+
 /**
  * @}
  */
@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXMergeTest.cpp
+ * Tests for the DMX merge code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <algorithm>
+
+#include "dmx_merge.h"
+
+class DMXMergeTest : public testing::Test {
+ public:
+  void SetUp() {
+    m_buffers.output = m_output;
+    m_buffers.last_dmx = m_last_dmx;
+    m_buffers.last_preset = m_last_preset;
+    m_buffers.length = LENGTH;
+    DMXMerge_Reset(&m_buffers);
+  }
+
+  // Use an odd length so the tail is tested.
+  enum { LENGTH = 7 };
+
+  DMXMergeBuffers m_buffers;
+  uint8_t m_output[LENGTH];
+  uint8_t m_last_dmx[LENGTH];
+  uint8_t m_last_preset[LENGTH];
+};
+
+TEST_F(DMXMergeTest, testDMXAndPresetOnly) {
+  const uint8_t dmx[] = {1, 2, 3, 4, 5, 6, 7};
+  const uint8_t preset[] = {10, 20, 30, 40, 50, 60, 70};
+
+  DMXMerge_Merge(DMX_MERGE_DMX_ONLY, dmx, preset, &m_buffers);
+  EXPECT_EQ(0, memcmp(dmx, m_output, LENGTH));
+
+  DMXMerge_Merge(DMX_MERGE_PRESET_ONLY, dmx, preset, &m_buffers);
+  EXPECT_EQ(0, memcmp(preset, m_output, LENGTH));
+}
+
+TEST_F(DMXMergeTest, testHTP) {
+  const uint8_t dmx[] = {0, 255, 127, 128, 200, 1, 99};
+  const uint8_t preset[] = {0, 254, 128, 127, 201, 0, 100};
+  const uint8_t expected[] = {0, 255, 128, 128, 201, 1, 100};
+
+  DMXMerge_Merge(DMX_MERGE_HTP, dmx, preset, &m_buffers);
+  EXPECT_EQ(0, memcmp(expected, m_output, LENGTH));
+}
+
+TEST_F(DMXMergeTest, testHTPAllValues) {
+  // Check every pair of values, in every byte lane.
+  enum { SIZE = 256 };
+  uint8_t dmx[SIZE];
+  uint8_t preset[SIZE];
+  uint8_t output[SIZE];
+  uint8_t last_dmx[SIZE];
+  uint8_t last_preset[SIZE];
+  DMXMergeBuffers buffers = {
+    .output = output,
+    .last_dmx = last_dmx,
+    .last_preset = last_preset,
+    .length = SIZE
+  };
+
+  for (unsigned int i = 0; i < SIZE; i++) {
+    preset[i] = i;
+  }
+  for (unsigned int value = 0; value < SIZE; value++) {
+    memset(dmx, value, SIZE);
+    DMXMerge_Merge(DMX_MERGE_HTP, dmx, preset, &buffers);
+    for (unsigned int i = 0; i < SIZE; i++) {
+      ASSERT_EQ(std::max(value, i), output[i]) << value << ", " << i;
+    }
+  }
+}
+
+TEST_F(DMXMergeTest, testLTP) {
+  uint8_t dmx[] = {10, 10, 10, 10, 10, 10, 10};
+  uint8_t preset[] = {0, 0, 0, 0, 0, 0, 0};
+
+  // The DMX levels changed.
+  DMXMerge_Merge(DMX_MERGE_LTP, dmx, preset, &m_buffers);
+  EXPECT_EQ(0, memcmp(dmx, m_output, LENGTH));
+
+  // The preset changes some levels, these take over.
+  preset[1] = 5;
+  preset[4] = 200;
+  preset[6] = 1;
+  DMXMerge_Merge(DMX_MERGE_LTP, dmx, preset, &m_buffers);
+  const uint8_t expected1[] = {10, 5, 10, 10, 200, 10, 1};
+  EXPECT_EQ(0, memcmp(expected1, m_output, LENGTH));
+
+  // Nothing changed, the output is held.
+  DMXMerge_Merge(DMX_MERGE_LTP, dmx, preset, &m_buffers);
+  EXPECT_EQ(0, memcmp(expected1, m_output, LENGTH));
+
+  // DMX changes some levels. When both change, DMX wins.
+  dmx[4] = 20;
+  dmx[5] = 30;
+  dmx[6] = 40;
+  preset[6] = 2;
+  DMXMerge_Merge(DMX_MERGE_LTP, dmx, preset, &m_buffers);
+  const uint8_t expected2[] = {10, 5, 10, 10, 20, 30, 40};
+  EXPECT_EQ(0, memcmp(expected2, m_output, LENGTH));
+}
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DimmerCurveTest.cpp
+ * Tests for the dimmer curves.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include "dimmer_curve.h"
+
+class DimmerCurveTest : public testing::Test {};
+
+TEST_F(DimmerCurveTest, testTables) {
+  EXPECT_EQ(NULL, DimmerCurve_GetTable(static_cast<DimmerCurveType>(0)));
+  EXPECT_EQ(NULL, DimmerCurve_GetTable(static_cast<DimmerCurveType>(5)));
+
+  const uint8_t *linear = DimmerCurve_GetTable(DIMMER_CURVE_LINEAR);
+  const uint8_t *modified_linear = DimmerCurve_GetTable(
+      DIMMER_CURVE_MODIFIED_LINEAR);
+  const uint8_t *square = DimmerCurve_GetTable(DIMMER_CURVE_SQUARE);
+  const uint8_t *modified_square = DimmerCurve_GetTable(
+      DIMMER_CURVE_MODIFIED_SQUARE);
+
+  for (unsigned int i = 0; i < DIMMER_CURVE_TABLE_SIZE; i++) {
+    EXPECT_EQ(i, linear[i]);
+    if (i) {
+      EXPECT_LE(linear[i - 1], linear[i]);
+      EXPECT_LE(modified_linear[i - 1], modified_linear[i]);
+      EXPECT_LE(square[i - 1], square[i]);
+      EXPECT_LE(modified_square[i - 1], modified_square[i]);
+    }
+  }
+
+  EXPECT_EQ(0, modified_linear[0]);
+  EXPECT_EQ(26, modified_linear[1]);
+  EXPECT_EQ(255, modified_linear[255]);
+
+  EXPECT_EQ(0, square[0]);
+  EXPECT_EQ(64, square[128]);
+  EXPECT_EQ(255, square[255]);
+
+  EXPECT_EQ(0, modified_square[0]);
+  EXPECT_EQ(26, modified_square[1]);
+  EXPECT_EQ(255, modified_square[255]);
+}
+
+TEST_F(DimmerCurveTest, testApply) {
+  EXPECT_EQ(0, DimmerCurve_Apply(NULL, 0));
+  EXPECT_EQ(100, DimmerCurve_Apply(NULL, 100));
+  EXPECT_EQ(255, DimmerCurve_Apply(NULL, 255));
+
+  DimmerCurve curve;
+  DimmerCurve_Init(&curve, DIMMER_CURVE_LINEAR, 0, 0xfffe, false);
+  EXPECT_EQ(0, DimmerCurve_Apply(&curve, 0));
+  EXPECT_EQ(100, DimmerCurve_Apply(&curve, 100));
+  EXPECT_EQ(255, DimmerCurve_Apply(&curve, 255));
+
+  // Invalid curves are linear.
+  DimmerCurve_Init(&curve, static_cast<DimmerCurveType>(9), 0, 0xffff, false);
+  EXPECT_EQ(100, DimmerCurve_Apply(&curve, 100));
+
+  DimmerCurve_Init(&curve, DIMMER_CURVE_SQUARE, 0, 0xffff, false);
+  EXPECT_EQ(64, DimmerCurve_Apply(&curve, 128));
+}
+
+TEST_F(DimmerCurveTest, testLimits) {
+  // 16-bit levels are rounded to 8 bits.
+  DimmerCurve curve;
+  DimmerCurve_Init(&curve, DIMMER_CURVE_LINEAR, 0x1480, 0xc87f, false);
+  EXPECT_EQ(0x15, curve.min_level);
+  EXPECT_EQ(0xc8, curve.max_level);
+
+  EXPECT_EQ(0, DimmerCurve_Apply(&curve, 0));
+  EXPECT_EQ(0, DimmerCurve_Apply(&curve, 0x14));
+  EXPECT_EQ(0x15, DimmerCurve_Apply(&curve, 0x15));
+  EXPECT_EQ(0x80, DimmerCurve_Apply(&curve, 0x80));
+  EXPECT_EQ(0xc8, DimmerCurve_Apply(&curve, 0xc8));
+  EXPECT_EQ(0xc8, DimmerCurve_Apply(&curve, 0xff));
+
+  // Levels below the minimum stay on.
+  DimmerCurve_Init(&curve, DIMMER_CURVE_LINEAR, 0x1480, 0xc87f, true);
+  EXPECT_EQ(0x15, DimmerCurve_Apply(&curve, 0));
+  EXPECT_EQ(0x15, DimmerCurve_Apply(&curve, 0x14));
+  EXPECT_EQ(0x80, DimmerCurve_Apply(&curve, 0x80));
+}
@@ -18,6 +18,7 @@
  * Copyright (C) 2015 Simon Newton
  */
 
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <ola/rdm/UID.h>
@@ -29,13 +30,17 @@
 #include <memory>
 
 #include "dimmer_model.h"
+#include "dmx_spec.h"
 #include "rdm.h"
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
 #include "Array.h"
 #include "Matchers.h"
 #include "ModelTest.h"
+#include "ResponderMock.h"
+#include "SPIRGBMock.h"
 #include "TestHelpers.h"
+#include "TransceiverMock.h"
 
 using ola::network::HostToNetwork;
 using ola::rdm::UID;
@@ -45,32 +50,102 @@ using ola::rdm::RDMRequest;
 using ola::rdm::RDMResponse;
 using ola::rdm::RDMSetRequest;
 using std::unique_ptr;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::_;
 
 class DimmerModelTest : public ModelTest {
  public:
   DimmerModelTest() : ModelTest(&DIMMER_MODEL_ENTRY) {}
 
   void SetUp() {
+    Responder_SetMock(&m_responder_mock);
+    SPIRGB_SetMock(&m_spi_mock);
+    Transceiver_SetMock(&m_transceiver_mock);
+
     RDMResponderSettings settings;
     memcpy(settings.uid, TEST_UID, UID_LENGTH);
     RDMResponder_Initialize(&settings);
     DimmerModel_Initialize();
+    EXPECT_CALL(m_responder_mock, SetSPIOutput(false));
     DIMMER_MODEL_ENTRY.activate_fn();
   }
+
+  void TearDown() {
+    Responder_SetMock(nullptr);
+    SPIRGB_SetMock(nullptr);
+    Transceiver_SetMock(nullptr);
+  }
+
+ protected:
+  NiceMock<MockResponder> m_responder_mock;
+  NiceMock<MockSPIRGB> m_spi_mock;
+  NiceMock<MockTransceiver> m_transceiver_mock;
 };
 
 TEST_F(DimmerModelTest, testLifecycle) {
   EXPECT_EQ(DIMMER_MODEL_ID, DIMMER_MODEL_ENTRY.model_id);
   DIMMER_MODEL_ENTRY.tasks_fn();
+
+  // The responder drives the SPI output again once we're inactive.
+  EXPECT_CALL(m_responder_mock, SetSPIOutput(true));
   DIMMER_MODEL_ENTRY.deactivate_fn();
 }
 
+TEST_F(DimmerModelTest, mergedOutput) {
+  uint8_t output[DMX_FRAME_SIZE];
+  memset(output, 0xff, arraysize(output));
+  ON_CALL(m_spi_mock, SetSlot(_, _))
+      .WillByDefault(Invoke([&output](uint16_t slot, uint8_t value) {
+        output[slot] = value;
+        return false;
+      }));
+
+  const uint8_t dmx[] = {10, 250};
+  const TransceiverDMXFrame frame = {dmx, arraysize(dmx), 1u};
+  ON_CALL(m_transceiver_mock, GetLatestDMXFrame(_))
+      .WillByDefault(DoAll(SetArgPointee<0>(frame), Return(true)));
+  EXPECT_CALL(m_spi_mock, CompleteUpdate()).Times(2);
+
+  // With no scene playing, sub-device n outputs slot n of the DMX frame.
+  DIMMER_MODEL_ENTRY.tasks_fn();
+  EXPECT_EQ(10, output[0]);
+  EXPECT_EQ(250, output[1]);
+  EXPECT_EQ(0, output[2]);
+  EXPECT_EQ(0, output[127]);
+  EXPECT_EQ(0xff, output[128]);
+
+  // Play all sub-devices at 100, merged HTP with DMX.
+  const uint8_t merge_mode = MERGE_MODE_HTP;
+  unique_ptr<RDMRequest> request = BuildSetRequest(
+      PID_PRESET_MERGEMODE, &merge_mode, sizeof(merge_mode));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  const uint8_t playback[] = {0xff, 0xff, 100};
+  request = BuildSetRequest(PID_PRESET_PLAYBACK, playback,
+                            arraysize(playback));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  DIMMER_MODEL_ENTRY.tasks_fn();
+  EXPECT_EQ(100, output[0]);
+  EXPECT_EQ(250, output[1]);
+  EXPECT_EQ(100, output[2]);
+  EXPECT_EQ(100, output[127]);
+}
+
 TEST_F(DimmerModelTest, dmxBlockAddress) {
   unique_ptr<RDMRequest> request = BuildGetRequest(PID_DMX_BLOCK_ADDRESS);
 
   // First request should be contiguous, starting at 1.
   const uint8_t expected_response[] = {
-    0x00, 0x04, 0x00, 0x01
+    0x00, 0x80, 0x00, 0x01
   };
 
   unique_ptr<RDMResponse> response(GetResponseFromData(
@@ -94,7 +169,7 @@ TEST_F(DimmerModelTest, dmxBlockAddress) {
   request = BuildGetRequest(PID_DMX_BLOCK_ADDRESS);
 
   const uint8_t expected_response2[] = {
-    0x00, 0x04, 0xff, 0xff
+    0x00, 0x80, 0xff, 0xff
   };
 
   response.reset(GetResponseFromData(
@@ -118,7 +193,7 @@ TEST_F(DimmerModelTest, dmxBlockAddress) {
   request = BuildGetRequest(PID_DMX_BLOCK_ADDRESS);
 
   const uint8_t expected_response3[] = {
-    0x00, 0x04, 0x00, 0x5a
+    0x00, 0x80, 0x00, 0x5a
   };
 
   response.reset(GetResponseFromData(
@@ -139,3 +214,99 @@ TEST_F(DimmerModelTest, dmxBlockAddress) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(DimmerModelTest, subDeviceAddressing) {
+  // Sub-device 2 is skipped, so the sub-devices are 1 and 3 - 129.
+  const uint16_t valid_sub_devices[] = {1, 3, 64, 129};
+  const uint16_t invalid_sub_devices[] = {2, 130, 0xfffe};
+  const uint8_t identify_off = 0u;
+  const uint8_t identify_on = 1u;
+
+  for (unsigned int i = 0; i < arraysize(valid_sub_devices); i++) {
+    unique_ptr<RDMRequest> request(new ola::rdm::RDMGetRequest(
+        m_controller_uid, m_our_uid, 0, 0, valid_sub_devices[i],
+        PID_IDENTIFY_DEVICE, nullptr, 0));
+    unique_ptr<RDMResponse> response(GetResponseFromData(
+        request.get(), &identify_off, sizeof(identify_off)));
+
+    int size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+
+  for (unsigned int i = 0; i < arraysize(invalid_sub_devices); i++) {
+    unique_ptr<RDMRequest> request(new ola::rdm::RDMGetRequest(
+        m_controller_uid, m_our_uid, 0, 0, invalid_sub_devices[i],
+        PID_IDENTIFY_DEVICE, nullptr, 0));
+    unique_ptr<RDMResponse> response(NackWithReason(
+        request.get(), ola::rdm::NR_SUB_DEVICE_OUT_OF_RANGE));
+
+    int size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+
+  // A SET to all sub-devices reaches every one of them.
+  unique_ptr<RDMRequest> request(new RDMSetRequest(
+      m_controller_uid, m_our_uid, 0, 0, SUBDEVICE_ALL, PID_IDENTIFY_DEVICE,
+      &identify_on, sizeof(identify_on)));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  for (unsigned int i = 0; i < arraysize(valid_sub_devices); i++) {
+    request.reset(new ola::rdm::RDMGetRequest(
+        m_controller_uid, m_our_uid, 0, 0, valid_sub_devices[i],
+        PID_IDENTIFY_DEVICE, nullptr, 0));
+    response.reset(GetResponseFromData(
+        request.get(), &identify_on, sizeof(identify_on)));
+
+    size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+  }
+}
+
+TEST_F(DimmerModelTest, outputCurves) {
+  uint8_t output[DMX_FRAME_SIZE];
+  memset(output, 0, arraysize(output));
+  ON_CALL(m_spi_mock, SetSlot(_, _))
+      .WillByDefault(Invoke([&output](uint16_t slot, uint8_t value) {
+        output[slot] = value;
+        return false;
+      }));
+
+  const uint8_t dmx[] = {200, 200, 200, 200};
+  const TransceiverDMXFrame frame = {dmx, arraysize(dmx), 1u};
+  ON_CALL(m_transceiver_mock, GetLatestDMXFrame(_))
+      .WillByDefault(DoAll(SetArgPointee<0>(frame), Return(true)));
+
+  // Sub-device 1 uses the square curve, sub-device 3 the modified linear one.
+  const uint8_t square = 3u;
+  unique_ptr<RDMRequest> request(new RDMSetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 1, PID_CURVE, &square,
+      sizeof(square)));
+  unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+  int size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  const uint8_t modified_linear = 2u;
+  request.reset(new RDMSetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 3, PID_CURVE, &modified_linear,
+      sizeof(modified_linear)));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  // Sub-device 4 is limited to 25%.
+  const uint16_t max_level = HostToNetwork(static_cast<uint16_t>(0x4000));
+  request.reset(new RDMSetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 4, PID_MAXIMUM_LEVEL,
+      reinterpret_cast<const uint8_t*>(&max_level), sizeof(max_level)));
+  response.reset(GetResponseFromData(request.get()));
+  size = InvokeRDMHandler(request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
+
+  DIMMER_MODEL_ENTRY.tasks_fn();
+  EXPECT_EQ(157, output[0]);
+  EXPECT_EQ(205, output[1]);
+  EXPECT_EQ(64, output[2]);
+  // Sub-device 5 is still linear.
+  EXPECT_EQ(200, output[3]);
+}
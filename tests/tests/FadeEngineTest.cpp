@@ -0,0 +1,162 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FadeEngineTest.cpp
+ * Tests for the fade engine.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include "coarse_timer.h"
+#include "fade_engine.h"
+#include "sys_int_mock.h"
+
+class FadeEngineTest : public testing::Test {
+ public:
+  void SetUp() {
+    SYS_INT_SetMock(&m_sys_int_mock);
+    CoarseTimer_Settings timer_settings = {
+      .timer_id = TMR_ID_2,
+      .interrupt_source = INT_SOURCE_TIMER_2
+    };
+    CoarseTimer_Initialize(&timer_settings);
+
+    FadeEngineSettings settings = {
+      .levels = m_levels,
+      .steps = m_steps,
+      .targets = m_targets,
+      .channel_count = CHANNEL_COUNT
+    };
+    FadeEngine_Initialize(&settings);
+  }
+
+  void TearDown() {
+    SYS_INT_SetMock(NULL);
+  }
+
+  // Advance the clock by one tick and run the fade engine.
+  void Tick() {
+    CoarseTimer_SetCounter(CoarseTimer_GetTime() + FADE_ENGINE_TICK_INTERVAL);
+    FadeEngine_Tasks();
+  }
+
+  enum { CHANNEL_COUNT = 300 };
+
+  testing::NiceMock<MockSysInt> m_sys_int_mock;
+  int32_t m_levels[CHANNEL_COUNT];
+  int32_t m_steps[CHANNEL_COUNT];
+  uint8_t m_targets[CHANNEL_COUNT];
+};
+
+TEST_F(FadeEngineTest, testSetLevel) {
+  EXPECT_FALSE(FadeEngine_IsFading());
+  EXPECT_EQ(0, FadeEngine_GetLevel(0));
+
+  FadeEngine_SetLevel(0, 100);
+  FadeEngine_SetLevel(CHANNEL_COUNT - 1, 255);
+  EXPECT_EQ(100, FadeEngine_GetLevel(0));
+  EXPECT_EQ(0, FadeEngine_GetLevel(1));
+  EXPECT_EQ(255, FadeEngine_GetLevel(CHANNEL_COUNT - 1));
+  EXPECT_FALSE(FadeEngine_IsFading());
+
+  // A fade time of 0 is a snap.
+  FadeEngine_FadeTo(1, 50, 0);
+  EXPECT_EQ(50, FadeEngine_GetLevel(1));
+  EXPECT_FALSE(FadeEngine_IsFading());
+}
+
+TEST_F(FadeEngineTest, testFade) {
+  // Up over 1s, down over 0.2s.
+  FadeEngine_SetLevel(1, 200);
+  FadeEngine_FadeTo(0, 250, 10);
+  FadeEngine_FadeTo(1, 100, 2);
+  EXPECT_TRUE(FadeEngine_IsFading());
+
+  // Nothing happens until a tick has elapsed.
+  FadeEngine_Tasks();
+  EXPECT_EQ(0, FadeEngine_GetLevel(0));
+  EXPECT_EQ(200, FadeEngine_GetLevel(1));
+
+  Tick();
+  EXPECT_EQ(5, FadeEngine_GetLevel(0));
+  EXPECT_EQ(190, FadeEngine_GetLevel(1));
+
+  for (unsigned int i = 1; i < 10; i++) {
+    Tick();
+  }
+  EXPECT_EQ(50, FadeEngine_GetLevel(0));
+  EXPECT_EQ(100, FadeEngine_GetLevel(1));
+  EXPECT_TRUE(FadeEngine_IsFading());
+
+  for (unsigned int i = 10; i < 50; i++) {
+    Tick();
+  }
+  EXPECT_EQ(250, FadeEngine_GetLevel(0));
+  EXPECT_EQ(100, FadeEngine_GetLevel(1));
+  EXPECT_FALSE(FadeEngine_IsFading());
+
+  // Further ticks don't move the levels.
+  Tick();
+  EXPECT_EQ(250, FadeEngine_GetLevel(0));
+}
+
+TEST_F(FadeEngineTest, testCrossfade) {
+  FadeEngine_FadeTo(0, 255, 10);
+  for (unsigned int i = 0; i < 25; i++) {
+    Tick();
+  }
+  EXPECT_EQ(127, FadeEngine_GetLevel(0));
+
+  // Reverse mid fade, the new fade starts from the current level.
+  FadeEngine_FadeTo(0, 0, 1);
+  for (unsigned int i = 0; i < 4; i++) {
+    Tick();
+  }
+  EXPECT_EQ(25, FadeEngine_GetLevel(0));
+  Tick();
+  EXPECT_EQ(0, FadeEngine_GetLevel(0));
+  EXPECT_FALSE(FadeEngine_IsFading());
+}
+
+TEST_F(FadeEngineTest, testLongFade) {
+  // A single step over the longest fade still completes.
+  FadeEngine_FadeTo(0, 1, 0xfffe);
+  unsigned int ticks = 0;
+  while (FadeEngine_IsFading()) {
+    Tick();
+    ticks++;
+  }
+  EXPECT_EQ(1, FadeEngine_GetLevel(0));
+  EXPECT_EQ(65536u, ticks);
+}
+
+TEST_F(FadeEngineTest, testCatchUp) {
+  FadeEngine_FadeTo(0, 100, 1);
+  FadeEngine_FadeTo(CHANNEL_COUNT - 1, 200, 1);
+
+  // If the main loop stalls, each call runs a single tick.
+  CoarseTimer_SetCounter(CoarseTimer_GetTime() +
+                         3 * FADE_ENGINE_TICK_INTERVAL);
+  FadeEngine_Tasks();
+  EXPECT_EQ(20, FadeEngine_GetLevel(0));
+  EXPECT_EQ(40, FadeEngine_GetLevel(CHANNEL_COUNT - 1));
+  FadeEngine_Tasks();
+  FadeEngine_Tasks();
+  EXPECT_EQ(60, FadeEngine_GetLevel(0));
+  EXPECT_EQ(120, FadeEngine_GetLevel(CHANNEL_COUNT - 1));
+  FadeEngine_Tasks();
+  EXPECT_EQ(60, FadeEngine_GetLevel(0));
+}
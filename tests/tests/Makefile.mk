@@ -30,18 +30,25 @@ TESTING_LIBS = $(GMOCK_LIBS) $(GTEST_LIBS)
 TESTS += tests/tests/bootloader_test \
          tests/tests/bootloader_transfer_test \
          tests/tests/coarse_timer_test \
+         tests/tests/dimmer_curve_test \
          tests/tests/dimmer_model_test \
+         tests/tests/dmx_merge_test \
+         tests/tests/fade_engine_test \
          tests/tests/flags_test \
          tests/tests/led_model_test \
          tests/tests/message_handler_test \
+         tests/tests/message_handler_pinned_test \
+         tests/tests/moving_light_test \
          tests/tests/network_model_test \
          tests/tests/proxy_model_test \
          tests/tests/rdm_handler_test \
          tests/tests/rdm_responder_test \
          tests/tests/rdm_util_test \
+         tests/tests/responder_definition_test \
          tests/tests/responder_test \
          tests/tests/spirgb_test \
          tests/tests/stream_decoder_test \
+         tests/tests/transceiver_simulator_test \
          tests/tests/transceiver_test \
          tests/tests/usb_transport_test \
          tests/tests/utils_test
@@ -78,10 +85,18 @@ tests_tests_coarse_timer_test_LDADD = $(TESTING_LIBS) \
                                       firmware/src/libcoarsetimer.la \
                                       tests/harmony/mocks/libharmonymock.la
 
+tests_tests_dimmer_curve_test_SOURCES = tests/tests/DimmerCurveTest.cpp
+tests_tests_dimmer_curve_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_dimmer_curve_test_LDADD = $(TESTING_LIBS) \
+                                      firmware/src/libdimmercurve.la
+
 tests_tests_dimmer_model_test_SOURCES = tests/tests/DimmerModelTest.cpp
 tests_tests_dimmer_model_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_dimmer_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                       firmware/src/libdimmermodel.la \
+                                      firmware/src/libdimmercurve.la \
+                                      firmware/src/libdmxmerge.la \
+                                      firmware/src/libfadeengine.la \
                                       firmware/src/librdmresponder.la \
                                       firmware/src/libreceivercounters.la \
                                       firmware/src/libcoarsetimer.la \
@@ -89,7 +104,22 @@ tests_tests_dimmer_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                       firmware/src/librdmutil.la \
                                       tests/tests/libmodeltest.la \
                                       tests/harmony/mocks/libharmonymock.la \
-                                      tests/mocks/libmatchers.la
+                                      tests/mocks/libmatchers.la \
+                                      tests/mocks/librespondermock.la \
+                                      tests/mocks/libspirgbmock.la \
+                                      tests/mocks/libtransceivermock.la
+
+tests_tests_dmx_merge_test_SOURCES = tests/tests/DMXMergeTest.cpp
+tests_tests_dmx_merge_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_dmx_merge_test_LDADD = $(TESTING_LIBS) \
+                                   firmware/src/libdmxmerge.la
+
+tests_tests_fade_engine_test_SOURCES = tests/tests/FadeEngineTest.cpp
+tests_tests_fade_engine_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_fade_engine_test_LDADD = $(TESTING_LIBS) \
+                                     firmware/src/libfadeengine.la \
+                                     firmware/src/libcoarsetimer.la \
+                                     tests/harmony/mocks/libharmonymock.la
 
 tests_tests_flags_test_SOURCES = tests/tests/FlagsTest.cpp
 tests_tests_flags_test_CXXFLAGS = $(TESTING_CXXFLAGS)
@@ -110,7 +140,8 @@ tests_tests_led_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                    firmware/src/librdmutil.la \
                                    tests/tests/libmodeltest.la \
                                    tests/harmony/mocks/libharmonymock.la \
-                                   tests/mocks/libmatchers.la
+                                   tests/mocks/libmatchers.la \
+                                   tests/mocks/libspirgbmock.la
 
 tests_tests_message_handler_test_SOURCES = tests/tests/MessageHandlerTest.cpp
 tests_tests_message_handler_test_CXXFLAGS = $(TESTING_CXXFLAGS)
@@ -124,6 +155,37 @@ tests_tests_message_handler_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                          tests/mocks/libtransceivermock.la \
                                          tests/mocks/libtransportmock.la
 
+# The pinned TX path is only compiled in when the pipeline defines it.
+tests_tests_message_handler_pinned_test_SOURCES = \
+    tests/tests/MessageHandlerPinnedTest.cpp \
+    firmware/src/message_handler.c
+tests_tests_message_handler_pinned_test_CFLAGS = $(TESTING_CFLAGS) \
+                                                 -DTESTS_PIPELINE_TX_PINNED
+tests_tests_message_handler_pinned_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_message_handler_pinned_test_LDADD = \
+    $(GMOCK_LIBS) $(GTEST_LIBS) \
+    tests/mocks/libappmock.la \
+    tests/mocks/libflagsmock.la \
+    tests/mocks/libmatchers.la \
+    tests/mocks/librdmhandlermock.la \
+    tests/mocks/libsyslogmock.la \
+    tests/mocks/libtransceivermock.la \
+    tests/mocks/libtransportmock.la
+
+tests_tests_moving_light_test_SOURCES = tests/tests/MovingLightTest.cpp
+tests_tests_moving_light_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
+tests_tests_moving_light_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
+                                      firmware/src/libmovinglight.la \
+                                      firmware/src/librdmresponder.la \
+                                      firmware/src/libreceivercounters.la \
+                                      firmware/src/libcoarsetimer.la \
+                                      firmware/src/librdmbuffer.la \
+                                      firmware/src/librandom.la \
+                                      firmware/src/librdmutil.la \
+                                      tests/tests/libmodeltest.la \
+                                      tests/harmony/mocks/libharmonymock.la \
+                                      tests/mocks/libmatchers.la
+
 tests_tests_network_model_test_SOURCES = tests/tests/NetworkModelTest.cpp
 tests_tests_network_model_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_network_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
@@ -182,6 +244,32 @@ tests_tests_rdm_util_test_LDADD = $(TESTING_LIBS) \
                                   firmware/src/librdmutil.la \
                                   tests/mocks/libmatchers.la
 
+tests_tests_responder_definition_test_SOURCES = \
+    tests/tests/ResponderDefinitionTest.cpp
+tests_tests_responder_definition_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_responder_definition_test_LDADD = \
+    $(TESTING_LIBS) \
+    firmware/src/libdimmermodel.la \
+    firmware/src/libledmodel.la \
+    firmware/src/libmovinglight.la \
+    firmware/src/libnetworkmodel.la \
+    firmware/src/libproxymodel.la \
+    firmware/src/libsensormodel.la \
+    firmware/src/libdimmercurve.la \
+    firmware/src/libdmxmerge.la \
+    firmware/src/libfadeengine.la \
+    firmware/src/librdmresponder.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/libcoarsetimer.la \
+    firmware/src/librdmbuffer.la \
+    firmware/src/librandom.la \
+    firmware/src/librdmutil.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libmatchers.la \
+    tests/mocks/librespondermock.la \
+    tests/mocks/libspirgbmock.la \
+    tests/mocks/libtransceivermock.la
+
 tests_tests_responder_test_SOURCES = tests/tests/ResponderTest.cpp
 tests_tests_responder_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_responder_test_LDADD = $(TESTING_LIBS) \
@@ -197,6 +285,7 @@ tests_tests_responder_test_LDADD = $(TESTING_LIBS) \
 tests_tests_spirgb_test_SOURCES = tests/tests/SPIRGBTest.cpp
 tests_tests_spirgb_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_spirgb_test_LDADD = $(TESTING_LIBS) \
+                                firmware/src/libcoarsetimer.la \
                                 firmware/src/libspirgb.la \
                                 tests/harmony/mocks/libharmonymock.la \
                                 tests/mocks/libmatchers.la
@@ -218,6 +307,18 @@ tests_tests_usb_transport_test_LDADD = $(TESTING_LIBS) \
                                        tests/mocks/libstreamdecodermock.la \
                                        firmware/src/libflags.la
 
+tests_tests_transceiver_simulator_test_SOURCES = \
+    tests/tests/TransceiverSimulatorTest.cpp
+tests_tests_transceiver_simulator_test_CXXFLAGS = $(TESTING_CXXFLAGS) \
+                                                  -I tests/sim
+tests_tests_transceiver_simulator_test_LDADD = \
+    $(GMOCK_LIBS) $(GTEST_LIBS) \
+    tests/sim/libtransceiversim.la \
+    firmware/src/libtransceiver.la \
+    firmware/src/libcoarsetimer.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libsyslogmock.la
+
 tests_tests_transceiver_test_SOURCES = tests/tests/TransceiverTest.cpp
 tests_tests_transceiver_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_transceiver_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
@@ -230,3 +331,13 @@ tests_tests_utils_test_SOURCES = tests/tests/UtilsTest.cpp
 tests_tests_utils_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_utils_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                tests/mocks/libmatchers.la
+
+# BENCHMARKS
+################################################
+noinst_PROGRAMS += tests/tests/stream_decoder_benchmark
+
+tests_tests_stream_decoder_benchmark_SOURCES = \
+    tests/tests/StreamDecoderBenchmark.cpp
+tests_tests_stream_decoder_benchmark_CXXFLAGS = $(TESTING_CFLAGS) \
+                                                $(WARNING_CXXFLAGS)
+tests_tests_stream_decoder_benchmark_LDADD = firmware/src/libstreamdecoder.la
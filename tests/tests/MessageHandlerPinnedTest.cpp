@@ -0,0 +1,90 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MessageHandlerPinnedTest.cpp
+ * Tests for the MessageHandler code, with the pinned TX pipeline.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "Array.h"
+#include "Matchers.h"
+#include "TransceiverMock.h"
+#include "TransportMock.h"
+#include "constants.h"
+#include "message_handler.h"
+
+using ::testing::Args;
+using ::testing::Return;
+using ::testing::_;
+
+class MessageHandlerPinnedTest : public testing::Test {
+ public:
+  void SetUp() {
+    Transport_SetMock(&m_transport_mock);
+    Transceiver_SetMock(&m_transceiver_mock);
+    MessageHandler_Initialize(Transport_Send);
+  }
+
+  void TearDown() {
+    Transceiver_SetMock(nullptr);
+    Transport_SetMock(nullptr);
+  }
+
+  void SendEvent(uint8_t port, uint8_t token, TransceiverOperation op,
+                 TransceiverOperationResult result, const uint8_t *data,
+                 unsigned int length) {
+    TransceiverTiming timing;
+    memset(reinterpret_cast<uint8_t*>(&timing), 0, sizeof(timing));
+    TransceiverEvent event {
+      .token = token,
+      .op = op,
+      .result = result,
+      .data = data,
+      .length = length,
+      .timing = &timing,
+      .port = port
+    };
+    MessageHandler_TransceiverEvent(&event);
+  }
+
+ protected:
+  MockTransport m_transport_mock;
+  MockTransceiver m_transceiver_mock;
+
+  static const uint8_t kToken = 0;
+};
+
+TEST_F(MessageHandlerPinnedTest, eventOnPort) {
+  const uint8_t rdm_reply[] = {1, 3, 4, 4, 5};
+
+  EXPECT_CALL(m_transport_mock, Send(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(m_transport_mock, SendPinned(kToken, (Command) 0x3030, RC_OK,
+                                           _, _))
+      .With(Args<3, 4>(EmptyPayload()))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              SendPinned(kToken + 1, (Command) 0x1042,
+                         RC_RDM_BCAST_RESPONSE, _, _))
+      .With(Args<3, 4>(PayloadIs(rdm_reply, arraysize(rdm_reply))))
+      .WillOnce(Return(true));
+
+  // The command carries the event's port, not the selected one.
+  SendEvent(3u, kToken, T_OP_TX_ONLY, T_RESULT_TX_OK, NULL, 0);
+  SendEvent(1u, kToken + 1, T_OP_RDM_BROADCAST, T_RESULT_RX_DATA, rdm_reply,
+            arraysize(rdm_reply));
+}
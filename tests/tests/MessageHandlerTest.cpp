@@ -28,9 +28,11 @@
 #include "TransceiverMock.h"
 #include "TransportMock.h"
 #include "constants.h"
+#include "dmx_spec.h"
 #include "message_handler.h"
 
 using ::testing::Args;
+using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::_;
 using ::testing::SetArrayArgument;
@@ -167,6 +169,12 @@ TEST_P(ConfigurationTest, CheckSetGet) {
       EXPECT_CALL(m_transceiver_mock, GetRDMResponderJitter())
           .WillOnce(Return(args.value));
       break;
+    case COMMAND_GET_DMX_REFRESH_INTERVAL:
+      EXPECT_CALL(m_transceiver_mock, SetDMXRefreshInterval(args.value))
+          .WillOnce(Return(true));
+      EXPECT_CALL(m_transceiver_mock, GetDMXRefreshInterval())
+          .WillOnce(Return(args.value));
+      break;
     default:
       {}
   }
@@ -196,7 +204,9 @@ INSTANTIATE_TEST_CASE_P(
       ConfigurationTestArgs(COMMAND_GET_RDM_RESPONDER_DELAY,
                             COMMAND_SET_RDM_RESPONDER_DELAY, 2000),
       ConfigurationTestArgs(COMMAND_GET_RDM_RESPONDER_JITTER,
-                            COMMAND_SET_RDM_RESPONDER_JITTER, 10)));
+                            COMMAND_SET_RDM_RESPONDER_JITTER, 10),
+      ConfigurationTestArgs(COMMAND_GET_DMX_REFRESH_INTERVAL,
+                            COMMAND_SET_DMX_REFRESH_INTERVAL, 250)));
 
 // Non-parametized tests.
 // ----------------------------------------------------------------------------
@@ -228,7 +238,8 @@ class MessageHandlerTest : public testing::Test {
       .result = result,
       .data = data,
       .length = length,
-      .timing = &timing
+      .timing = &timing,
+      .port = Transceiver_GetPort()
     };
     MessageHandler_TransceiverEvent(&event);
   }
@@ -306,6 +317,86 @@ TEST_F(MessageHandlerTest, testDMX) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testDMXStream) {
+  const uint8_t dmx_data[] = {1, 3, 4, 4};
+
+  testing::InSequence seq;
+  EXPECT_CALL(m_transceiver_mock, StartDMXStream(_, arraysize(dmx_data)))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_START_DMX_STREAM, RC_OK, NULL, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transceiver_mock, StopDMXStream());
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_STOP_DMX_STREAM, RC_OK, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message start_message = {
+    kToken, COMMAND_START_DMX_STREAM, arraysize(dmx_data), &dmx_data[0]
+  };
+  MessageHandler_HandleMessage(&start_message);
+
+  Message stop_message = { kToken, COMMAND_STOP_DMX_STREAM, 0, NULL };
+  MessageHandler_HandleMessage(&stop_message);
+}
+
+TEST_F(MessageHandlerTest, testUpdateDMXStream) {
+  // Two runs: slot 10 & 11, then slot 300.
+  const uint8_t runs[] = {10, 0, 2, 0, 100, 101, 0x2c, 1, 1, 0, 255};
+
+  EXPECT_CALL(m_transceiver_mock, GetDMXStreamSize())
+      .WillRepeatedly(Return(DMX_FRAME_SIZE));
+
+  testing::InSequence seq;
+  EXPECT_CALL(m_transceiver_mock, UpdateDMXStream(10, &runs[4], 2))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transceiver_mock, UpdateDMXStream(300, &runs[10], 1))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_UPDATE_DMX_STREAM, RC_OK, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message message = {
+    kToken, COMMAND_UPDATE_DMX_STREAM, arraysize(runs), &runs[0]
+  };
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testMalformedUpdateDMXStream) {
+  // The second run is missing a slot, so nothing is applied.
+  const uint8_t runs[] = {10, 0, 2, 0, 100, 101, 0x2c, 1, 2, 0, 255};
+  EXPECT_CALL(m_transceiver_mock, UpdateDMXStream(_, _, _)).Times(0);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_UPDATE_DMX_STREAM, RC_BAD_PARAM, NULL, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  Message message = {
+    kToken, COMMAND_UPDATE_DMX_STREAM, arraysize(runs), &runs[0]
+  };
+  MessageHandler_HandleMessage(&message);
+
+  // A truncated run header.
+  message.length = 2;
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testOutOfRangeUpdateDMXStream) {
+  // The second run extends past the end of the stream, so nothing is applied.
+  const uint8_t runs[] = {10, 0, 2, 0, 100, 101, 0x2c, 1, 2, 0, 255, 255};
+  EXPECT_CALL(m_transceiver_mock, GetDMXStreamSize())
+      .WillRepeatedly(Return(301));
+  EXPECT_CALL(m_transceiver_mock, UpdateDMXStream(_, _, _)).Times(0);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_UPDATE_DMX_STREAM, RC_BAD_PARAM, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message message = {
+    kToken, COMMAND_UPDATE_DMX_STREAM, arraysize(runs), &runs[0]
+  };
+  MessageHandler_HandleMessage(&message);
+}
+
 TEST_F(MessageHandlerTest, testFlags) {
   MockFlags flags_mock;
   Flags_SetMock(&flags_mock);
@@ -338,6 +429,56 @@ TEST_F(MessageHandlerTest, testUnknownMessage) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testPorts) {
+  const uint8_t dmx_data[] = {1, 3, 4, 4};
+
+  // The port is selected while the request is handled, and the response
+  // carries the port.
+  EXPECT_CALL(m_transceiver_mock, QueueDMX(_, _, arraysize(dmx_data)))
+      .WillOnce(Invoke([](uint8_t, const uint8_t*, unsigned int) {
+        EXPECT_EQ(2, Transceiver_GetPort());
+        return false;
+      }));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, (Command) 0x2030, RC_BUFFER_FULL, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, 0x2030, arraysize(dmx_data), &dmx_data[0] };
+  MessageHandler_HandleMessage(&message);
+  EXPECT_EQ(0, Transceiver_GetPort());
+
+  // A port that doesn't exist.
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, (Command) 0x5030, RC_BAD_PARAM, NULL, 0))
+      .WillOnce(Return(true));
+  message.command = 0x5030;
+  MessageHandler_HandleMessage(&message);
+  EXPECT_EQ(0, Transceiver_GetPort());
+}
+
+TEST_F(MessageHandlerTest, testResponderModeIsPortZeroOnly) {
+  EXPECT_CALL(m_transceiver_mock, SetMode(_)).Times(0);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, (Command) 0x1001, RC_BAD_PARAM, _, 0))
+      .WillOnce(Return(true));
+
+  uint8_t request_payload = 1;
+  Message message = { kToken, 0x1001, sizeof(request_payload),
+                      &request_payload };
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, transceiverEventOnPort) {
+  EXPECT_CALL(m_transport_mock, Send(kToken, (Command) 0x3030, RC_OK, _, _))
+      .With(Args<3, 4>(EmptyPayload()))
+      .WillOnce(Return(true));
+
+  // Events are delivered with their port selected.
+  Transceiver_SelectPort(3);
+  SendEvent(kToken, T_OP_TX_ONLY, T_RESULT_TX_OK, NULL, 0);
+  Transceiver_SelectPort(0);
+}
+
 TEST_F(MessageHandlerTest, transceiverDMXEvent) {
   EXPECT_CALL(m_transport_mock, Send(kToken, TX_DMX, RC_OK, _, _))
       .With(Args<3, 4>(EmptyPayload()))
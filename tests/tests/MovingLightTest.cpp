@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MovingLightTest.cpp
+ * Tests for the Moving Light Model RDM responder.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include <ola/rdm/UID.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMEnums.h>
+#include <ola/rdm/RDMCommandSerializer.h>
+#include <string.h>
+#include <memory>
+
+#include "coarse_timer.h"
+#include "moving_light.h"
+#include "rdm.h"
+#include "rdm_buffer.h"
+#include "rdm_responder.h"
+#include "Array.h"
+#include "Matchers.h"
+#include "ModelTest.h"
+#include "TestHelpers.h"
+
+using ola::rdm::GetResponseFromData;
+using ola::rdm::NackWithReason;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using std::unique_ptr;
+
+class MovingLightTest : public ModelTest {
+ public:
+  MovingLightTest() : ModelTest(&MOVING_LIGHT_MODEL_ENTRY) {}
+
+  void SetUp() {
+    RDMResponderSettings settings;
+    memcpy(settings.uid, TEST_UID, UID_LENGTH);
+    RDMResponder_Initialize(&settings);
+    MovingLightModel_Initialize();
+    MOVING_LIGHT_MODEL_ENTRY.activate_fn();
+  }
+
+  void ExpectGet(uint16_t pid, const uint8_t *data, unsigned int size) {
+    unique_ptr<RDMRequest> request = BuildGetRequest(pid);
+    unique_ptr<RDMResponse> response(GetResponseFromData(
+        request.get(), data, size));
+    int response_size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, response_size),
+                ResponseIs(response.get()));
+  }
+
+  void ExpectSetAck(uint16_t pid, const uint8_t *data, unsigned int size) {
+    unique_ptr<RDMRequest> request = BuildSetRequest(pid, data, size);
+    unique_ptr<RDMResponse> response(GetResponseFromData(request.get()));
+    int response_size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, response_size),
+                ResponseIs(response.get()));
+  }
+
+  void ExpectSetNack(uint16_t pid, const uint8_t *data, unsigned int size,
+                     ola::rdm::rdm_nack_reason reason) {
+    unique_ptr<RDMRequest> request = BuildSetRequest(pid, data, size);
+    unique_ptr<RDMResponse> response(NackWithReason(request.get(), reason));
+    int response_size = InvokeRDMHandler(request.get());
+    EXPECT_THAT(ArrayTuple(g_rdm_buffer, response_size),
+                ResponseIs(response.get()));
+  }
+
+  void ExpectFactoryDefaults(bool using_defaults) {
+    const uint8_t data = using_defaults;
+    ExpectGet(PID_FACTORY_DEFAULTS, &data, sizeof(data));
+  }
+};
+
+TEST_F(MovingLightTest, testLifecycle) {
+  EXPECT_EQ(MOVING_LIGHT_MODEL_ID, MOVING_LIGHT_MODEL_ENTRY.model_id);
+  MOVING_LIGHT_MODEL_ENTRY.tasks_fn();
+  MOVING_LIGHT_MODEL_ENTRY.deactivate_fn();
+}
+
+TEST_F(MovingLightTest, uint32Field) {
+  const uint8_t hours[] = {0x01, 0x02, 0x03, 0x04};
+  ExpectSetAck(PID_DEVICE_HOURS, hours, arraysize(hours));
+  ExpectGet(PID_DEVICE_HOURS, hours, arraysize(hours));
+
+  // The neighbouring fields are untouched.
+  const uint8_t hours2[] = {0xff, 0xfe, 0xfd, 0xfc};
+  ExpectSetAck(PID_LAMP_HOURS, hours2, arraysize(hours2));
+  ExpectGet(PID_DEVICE_HOURS, hours, arraysize(hours));
+  ExpectGet(PID_LAMP_HOURS, hours2, arraysize(hours2));
+
+  ExpectSetNack(PID_DEVICE_HOURS, hours, 2u, ola::rdm::NR_FORMAT_ERROR);
+  ExpectSetNack(PID_DEVICE_HOURS, nullptr, 0u, ola::rdm::NR_FORMAT_ERROR);
+  ExpectGet(PID_DEVICE_HOURS, hours, arraysize(hours));
+}
+
+TEST_F(MovingLightTest, rangeChecks) {
+  const uint8_t on_mode = LAMP_ON_MODE_ON_AFTER_CAL;
+  ExpectSetAck(PID_LAMP_ON_MODE, &on_mode, sizeof(on_mode));
+  ExpectGet(PID_LAMP_ON_MODE, &on_mode, sizeof(on_mode));
+
+  const uint8_t bad_on_mode = LAMP_ON_MODE_ON_AFTER_CAL + 1;
+  ExpectSetNack(PID_LAMP_ON_MODE, &bad_on_mode, sizeof(bad_on_mode),
+                ola::rdm::NR_DATA_OUT_OF_RANGE);
+  ExpectGet(PID_LAMP_ON_MODE, &on_mode, sizeof(on_mode));
+
+  const uint8_t bad_invert = DISPLAY_INVERT_AUTO + 1;
+  ExpectSetNack(PID_DISPLAY_INVERT, &bad_invert, sizeof(bad_invert),
+                ola::rdm::NR_DATA_OUT_OF_RANGE);
+
+  // Bools only accept 0 & 1.
+  const uint8_t on = 1u;
+  const uint8_t bad_bool = 2u;
+  ExpectSetAck(PID_PAN_INVERT, &on, sizeof(on));
+  ExpectSetNack(PID_PAN_INVERT, &bad_bool, sizeof(bad_bool),
+                ola::rdm::NR_DATA_OUT_OF_RANGE);
+  ExpectGet(PID_PAN_INVERT, &on, sizeof(on));
+
+  // No upper limit on the display level.
+  const uint8_t level = 0xff;
+  ExpectSetAck(PID_DISPLAY_LEVEL, &level, sizeof(level));
+  ExpectGet(PID_DISPLAY_LEVEL, &level, sizeof(level));
+}
+
+TEST_F(MovingLightTest, factoryDefaults) {
+  ExpectFactoryDefaults(true);
+
+  // Untracked fields don't change the factory defaults.
+  const uint8_t hours[] = {0x00, 0x00, 0x01, 0x00};
+  ExpectSetAck(PID_DEVICE_HOURS, hours, arraysize(hours));
+  ExpectFactoryDefaults(true);
+
+  // Neither does setting a tracked field to its current value.
+  const uint8_t level = 255u;
+  ExpectSetAck(PID_DISPLAY_LEVEL, &level, sizeof(level));
+  ExpectFactoryDefaults(true);
+
+  const uint8_t new_level = 10u;
+  ExpectSetAck(PID_DISPLAY_LEVEL, &new_level, sizeof(new_level));
+  ExpectFactoryDefaults(false);
+
+  ExpectSetAck(PID_FACTORY_DEFAULTS, nullptr, 0u);
+  ExpectFactoryDefaults(true);
+  ExpectGet(PID_DISPLAY_LEVEL, &level, sizeof(level));
+
+  const uint8_t on = 1u;
+  ExpectSetAck(PID_PAN_TILT_SWAP, &on, sizeof(on));
+  ExpectFactoryDefaults(false);
+}
+
+TEST_F(MovingLightTest, lampStrike) {
+  const uint8_t no_strikes[] = {0x00, 0x00, 0x00, 0x00};
+  ExpectSetAck(PID_LAMP_STRIKES, no_strikes, arraysize(no_strikes));
+
+  CoarseTimer_SetCounter(0u);
+  const uint8_t strike = LAMP_STRIKE;
+  ExpectSetAck(PID_LAMP_STATE, &strike, sizeof(strike));
+  ExpectGet(PID_LAMP_STATE, &strike, sizeof(strike));
+
+  // The lamp is on after 5s.
+  CoarseTimer_SetCounter(50001u);
+  MOVING_LIGHT_MODEL_ENTRY.tasks_fn();
+  const uint8_t on = LAMP_ON;
+  ExpectGet(PID_LAMP_STATE, &on, sizeof(on));
+
+  const uint8_t one_strike[] = {0x00, 0x00, 0x00, 0x01};
+  ExpectGet(PID_LAMP_STRIKES, one_strike, arraysize(one_strike));
+}
+
+TEST_F(MovingLightTest, powerState) {
+  const uint8_t normal = POWER_STATE_NORMAL;
+  ExpectGet(PID_POWER_STATE, &normal, sizeof(normal));
+
+  const uint8_t standby = POWER_STATE_STANDBY;
+  ExpectSetAck(PID_POWER_STATE, &standby, sizeof(standby));
+  ExpectGet(PID_POWER_STATE, &standby, sizeof(standby));
+
+  const uint8_t undefined = POWER_STATE_STANDBY + 1;
+  ExpectSetNack(PID_POWER_STATE, &undefined, sizeof(undefined),
+                ola::rdm::NR_DATA_OUT_OF_RANGE);
+  ExpectGet(PID_POWER_STATE, &standby, sizeof(standby));
+}
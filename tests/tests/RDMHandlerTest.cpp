@@ -33,6 +33,7 @@
 #include "Matchers.h"
 #include "TestHelpers.h"
 
+using ::testing::DoAll;
 using ::testing::Return;
 using ::testing::StrictMock;
 using ::testing::WithArgs;
@@ -309,6 +310,47 @@ TEST_F(RDMHandlerTest, testDispatching) {
   EXPECT_TRUE(RDMHandler_SetActiveModel(NULL_MODEL_ID));
 }
 
+TEST_F(RDMHandlerTest, testGetUIDMask) {
+  RDMHandlerSettings settings = {
+    .default_model = NULL_MODEL_ID,
+    .send_callback = nullptr
+  };
+  RDMHandler_Initialize(&settings);
+
+  const uint8_t full_mask[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+  const uint8_t proxy_mask[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+  uint8_t mask[UID_LENGTH];
+
+  // No active model.
+  SetUID(mask);
+  RDMHandler_GetUIDMask(mask);
+  EXPECT_THAT(mask, MatchesUID(full_mask));
+
+  EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
+  EXPECT_TRUE(RDMHandler_AddModel(&SECOND_MODEL));
+
+  // A model without IOCTL_GET_UID_MASK support.
+  EXPECT_CALL(m_first_model, Activate()).Times(1);
+  EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_ONE));
+  EXPECT_CALL(m_first_model, Ioctl(IOCTL_GET_UID_MASK, _, UID_LENGTH))
+    .WillOnce(Return(0));
+
+  SetUID(mask);
+  RDMHandler_GetUIDMask(mask);
+  EXPECT_THAT(mask, MatchesUID(full_mask));
+
+  // A model that responds to a range of UIDs.
+  EXPECT_CALL(m_first_model, Deactivate()).Times(1);
+  EXPECT_CALL(m_second_model, Activate()).Times(1);
+  EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_TWO));
+  EXPECT_CALL(m_second_model, Ioctl(IOCTL_GET_UID_MASK, _, UID_LENGTH))
+    .WillOnce(DoAll(WithArgs<1>(CopyUIDNoReturn(proxy_mask)), Return(1)));
+
+  SetUID(mask);
+  RDMHandler_GetUIDMask(mask);
+  EXPECT_THAT(mask, MatchesUID(proxy_mask));
+}
+
 TEST_F(RDMHandlerTest, testSendResponse) {
   RDMHandlerSettings settings = {
     .default_model = MODEL_ONE,
@@ -27,10 +27,13 @@
 #include <ola/network/NetworkUtils.h>
 #include <string.h>
 #include <memory>
+#include <vector>
 
 #include "rdm.h"
 #include "rdm_buffer.h"
 #include "rdm_responder.h"
+#include "rdm_util.h"
+#include "utils.h"
 #include "Array.h"
 #include "Matchers.h"
 #include "MessageHandlerMock.h"
@@ -95,6 +98,24 @@ int ClearSensors(const RDMHeader *header,
   return 0;
 }
 
+std::vector<unsigned int> g_selected_responders;
+
+void SelectResponder(unsigned int index) {
+  g_selected_responders.push_back(index);
+}
+
+MATCHER(IsBroadcast, "") {
+  return !RDMUtil_IsUnicast(arg->dest_uid);
+}
+
+int GetAnyPID(const RDMHeader *header, const uint8_t *param_data) {
+  if (g_pid_handler) {
+    return g_pid_handler->Call(static_cast<RDMPid>(ntohs(header->param_id)),
+                               true, header, param_data);
+  }
+  return 0;
+}
+
 }  // namespace
 
 class RDMResponderTest : public testing::Test {
@@ -165,30 +186,33 @@ TEST_F(RDMResponderTest, DiscoveryUniqueBranch) {
     0xfa, 0x7f, 0xfa, 0x75, 0xba, 0x57, 0xbe, 0x75,
     0xfe, 0x57, 0xfa, 0x7d, 0xaf, 0x57, 0xfa, 0xfd
   };
-  ArrayTuple tuple(g_rdm_buffer, DUB_RESPONSE_LENGTH);
 
   uint8_t param_data[UID_LENGTH * 2];
   CreateDUBParamData(UID(0, 0), UID::AllDevices(), param_data);
   EXPECT_EQ(-DUB_RESPONSE_LENGTH,
             RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
-  EXPECT_THAT(tuple, DataIs(expected_data, arraysize(expected_data)));
+  EXPECT_THAT(ArrayTuple(g_rdm_response, DUB_RESPONSE_LENGTH),
+              DataIs(expected_data, arraysize(expected_data)));
 
   CreateDUBParamData(m_our_uid, m_our_uid, param_data);
   EXPECT_EQ(-DUB_RESPONSE_LENGTH,
             RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
-  EXPECT_THAT(tuple, DataIs(expected_data, arraysize(expected_data)));
+  EXPECT_THAT(ArrayTuple(g_rdm_response, DUB_RESPONSE_LENGTH),
+              DataIs(expected_data, arraysize(expected_data)));
 
   CreateDUBParamData(UID(m_our_uid.ManufacturerId(), 0),
                      UID::AllDevices(), param_data);
   EXPECT_EQ(-DUB_RESPONSE_LENGTH,
             RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
-  EXPECT_THAT(tuple, DataIs(expected_data, arraysize(expected_data)));
+  EXPECT_THAT(ArrayTuple(g_rdm_response, DUB_RESPONSE_LENGTH),
+              DataIs(expected_data, arraysize(expected_data)));
 
   CreateDUBParamData(UID(m_our_uid.ManufacturerId(), 0),
                      UID::VendorcastAddress(m_our_uid), param_data);
   EXPECT_EQ(-DUB_RESPONSE_LENGTH,
             RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
-  EXPECT_THAT(tuple, DataIs(expected_data, arraysize(expected_data)));
+  EXPECT_THAT(ArrayTuple(g_rdm_response, DUB_RESPONSE_LENGTH),
+              DataIs(expected_data, arraysize(expected_data)));
 
   // Check we don't respond if muted
   g_responder->is_muted = true;
@@ -197,6 +221,32 @@ TEST_F(RDMResponderTest, DiscoveryUniqueBranch) {
             RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
 }
 
+TEST_F(RDMResponderTest, setUID) {
+  InitResponder();
+
+  const uint8_t new_uid[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x01};
+  const uint8_t expected_data[] = {
+    0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xaa,
+    0xfa, 0x7f, 0xfa, 0x75, 0xaa, 0x55, 0xaa, 0x55,
+    0xaa, 0x55, 0xab, 0x55, 0xae, 0x57, 0xef, 0xf5
+  };
+
+  RDMResponder_SetUID(new_uid);
+  uint8_t uid[UID_LENGTH];
+  RDMResponder_GetUID(uid);
+  EXPECT_THAT(uid, MatchesUID(new_uid));
+
+  uint8_t param_data[UID_LENGTH * 2];
+  CreateDUBParamData(UID(0, 0), UID::AllDevices(), param_data);
+  EXPECT_EQ(-DUB_RESPONSE_LENGTH,
+            RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
+  EXPECT_THAT(ArrayTuple(g_rdm_response, DUB_RESPONSE_LENGTH),
+              DataIs(expected_data, arraysize(expected_data)));
+
+  // The response isn't built in g_rdm_buffer.
+  EXPECT_NE(g_rdm_buffer, g_rdm_response);
+}
+
 TEST_F(RDMResponderTest, discoveryCommands) {
   unique_ptr<RDMDiscoveryRequest> unmute(NewUnMuteRequest(
       m_controller_uid, m_our_uid, 0));
@@ -275,8 +325,8 @@ TEST_F(RDMResponderTest, testBuildNack) {
 
 TEST_F(RDMResponderTest, testDispatch) {
   const PIDDescriptor pid_descriptors[] = {
-    {PID_IDENTIFY_DEVICE, GetIdentifyDevice, 0, (PIDCommandHandler) nullptr},
     {PID_RECORD_SENSORS, (PIDCommandHandler) nullptr, 0, ClearSensors},
+    {PID_IDENTIFY_DEVICE, GetIdentifyDevice, 0, (PIDCommandHandler) nullptr},
   };
   ResponderDefinition responder_def;
   InitDefinition(&responder_def);
@@ -362,6 +412,115 @@ TEST_F(RDMResponderTest, testDispatch) {
   EXPECT_THAT(tuple3, DataIs(unknown_pid, arraysize(unknown_pid)));
 }
 
+TEST_F(RDMResponderTest, testDispatchSetToAll) {
+  const PIDDescriptor pid_descriptors[] = {
+    {PID_RECORD_SENSORS, (PIDCommandHandler) nullptr, 0, ClearSensors},
+    {PID_IDENTIFY_DEVICE, GetIdentifyDevice, 0, (PIDCommandHandler) nullptr},
+  };
+  ResponderDefinition responder_def;
+  InitDefinition(&responder_def);
+  responder_def.descriptors = pid_descriptors;
+  responder_def.descriptor_count = arraysize(pid_descriptors);
+  g_selected_responders.clear();
+
+  const uint8_t set_record_sensors[] = {
+    0xcc, 0x01, 0x1a, 0x7a, 0x70, 0x12, 0x34, 0x56, 0x78, 0x7a, 0x70, 0x00,
+    0x00, 0x00, 0x00, 0x11, 0x00, 0xff, 0xff, 0x05, 0x30, 0x02, 0x02, 0x02,
+  };
+
+  // Only the last responder is passed the original header, so only it builds
+  // a response.
+  {
+    testing::InSequence seq;
+    EXPECT_CALL(m_pid_handler,
+                Call(PID_RECORD_SENSORS, false, IsBroadcast(), nullptr))
+      .Times(2)
+      .WillRepeatedly(Return(0));
+    EXPECT_CALL(m_pid_handler,
+                Call(PID_RECORD_SENSORS, false, AsHeader(set_record_sensors),
+                     nullptr))
+      .WillOnce(Return(26));
+  }
+  EXPECT_EQ(26, RDMResponder_DispatchSetToAll(AsHeader(set_record_sensors),
+                                              nullptr, &responder_def,
+                                              SelectResponder, 3));
+  const std::vector<unsigned int> expected_responders = {0, 1, 2};
+  EXPECT_EQ(expected_responders, g_selected_responders);
+
+  // A PID without a SET handler is NACKed once, without selecting any
+  // responders.
+  g_selected_responders.clear();
+  const uint8_t set_identify_device[] = {
+    0xcc, 0x01, 0x18, 0x7a, 0x70, 0x12, 0x34, 0x56, 0x78, 0x7a, 0x70, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x30, 0x10, 0x00, 0x00
+  };
+  EXPECT_EQ(28, RDMResponder_DispatchSetToAll(AsHeader(set_identify_device),
+                                              nullptr, &responder_def,
+                                              SelectResponder, 3));
+  EXPECT_EQ(static_cast<uint16_t>(NR_UNSUPPORTED_COMMAND_CLASS),
+            JoinShort(g_rdm_buffer[RDM_PARAM_DATA_OFFSET],
+                      g_rdm_buffer[RDM_PARAM_DATA_OFFSET + 1]));
+
+  const uint8_t set_device_info[] = {
+    0xcc, 0x01, 0x18, 0x7a, 0x70, 0x12, 0x34, 0x56, 0x78, 0x7a, 0x70, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x30, 0x00, 0x60, 0x00
+  };
+  EXPECT_EQ(28, RDMResponder_DispatchSetToAll(AsHeader(set_device_info),
+                                              nullptr, &responder_def,
+                                              SelectResponder, 3));
+  EXPECT_EQ(static_cast<uint16_t>(NR_UNKNOWN_PID),
+            JoinShort(g_rdm_buffer[RDM_PARAM_DATA_OFFSET],
+                      g_rdm_buffer[RDM_PARAM_DATA_OFFSET + 1]));
+  EXPECT_TRUE(g_selected_responders.empty());
+}
+
+TEST_F(RDMResponderTest, testDispatchSearch) {
+  const PIDDescriptor pid_descriptors[] = {
+    {PID_SUPPORTED_PARAMETERS, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+    {PID_DEVICE_INFO, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+    {PID_DEVICE_LABEL, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+    {PID_DMX_START_ADDRESS, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+    {PID_RECORD_SENSORS, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+    {PID_IDENTIFY_DEVICE, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+    {PID_POWER_STATE, GetAnyPID, 0, (PIDCommandHandler) nullptr},
+  };
+  ResponderDefinition responder_def;
+  InitDefinition(&responder_def);
+  responder_def.descriptors = pid_descriptors;
+  responder_def.descriptor_count = arraysize(pid_descriptors);
+
+  uint8_t get_header[] = {
+    0xcc, 0x01, 0x18, 0x7a, 0x70, 0x12, 0x34, 0x56, 0x78, 0x7a, 0x70, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00
+  };
+
+  // Every PID in the table should be found, including the first and last.
+  for (unsigned int i = 0; i < arraysize(pid_descriptors); i++) {
+    get_header[21] = ShortMSB(pid_descriptors[i].pid);
+    get_header[22] = ShortLSB(pid_descriptors[i].pid);
+    EXPECT_CALL(m_pid_handler,
+                Call(static_cast<RDMPid>(pid_descriptors[i].pid), true,
+                     AsHeader(get_header), nullptr))
+      .WillOnce(Return(26 + i));
+    EXPECT_EQ(static_cast<int>(26 + i),
+              RDMResponder_DispatchPID(AsHeader(get_header), nullptr));
+  }
+
+  // PIDs before, between and after the entries in the table are NACKed.
+  const uint16_t unknown_pids[] = {
+    PID_DISC_UNIQUE_BRANCH, PID_PARAMETER_DESCRIPTION, PID_SENSOR_VALUE,
+    PID_PERFORM_SELFTEST
+  };
+  for (unsigned int i = 0; i < arraysize(unknown_pids); i++) {
+    get_header[21] = ShortMSB(unknown_pids[i]);
+    get_header[22] = ShortLSB(unknown_pids[i]);
+    EXPECT_EQ(28, RDMResponder_DispatchPID(AsHeader(get_header), nullptr));
+    EXPECT_EQ(static_cast<uint16_t>(NR_UNKNOWN_PID),
+              JoinShort(g_rdm_buffer[RDM_PARAM_DATA_OFFSET],
+                        g_rdm_buffer[RDM_PARAM_DATA_OFFSET + 1]));
+  }
+}
+
 TEST_F(RDMResponderTest, supportedParameters) {
   unique_ptr<RDMRequest> request(new RDMGetRequest(
       m_controller_uid, m_our_uid, 0, 0, 0, PID_SUPPORTED_PARAMETERS,
@@ -378,8 +537,8 @@ TEST_F(RDMResponderTest, supportedParameters) {
     {PID_DEVICE_INFO, nullptr, 0, nullptr},
     {PID_SOFTWARE_VERSION_LABEL, nullptr, 0, nullptr},
     {PID_DMX_START_ADDRESS, nullptr, 0, nullptr},
-    {PID_IDENTIFY_DEVICE, nullptr, 0, nullptr},
-    {PID_RECORD_SENSORS, nullptr, 0, nullptr}
+    {PID_RECORD_SENSORS, nullptr, 0, nullptr},
+    {PID_IDENTIFY_DEVICE, nullptr, 0, nullptr}
   };
 
   ResponderDefinition responder_def;
@@ -395,6 +554,97 @@ TEST_F(RDMResponderTest, supportedParameters) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(RDMResponderTest, slotInfoOverflow) {
+  // 60 slots won't fit in a single SLOT_INFO response.
+  SlotDefinition slots[60];
+  std::vector<uint8_t> slot_info;
+  std::vector<uint8_t> default_values;
+  for (unsigned int i = 0; i < arraysize(slots); i++) {
+    slots[i].description = "Slot";
+    slots[i].slot_label_id = 0x100 + i;
+    slots[i].slot_type = i % 2;
+    slots[i].default_value = i;
+
+    slot_info.push_back(ShortMSB(i));
+    slot_info.push_back(ShortLSB(i));
+    slot_info.push_back(slots[i].slot_type);
+    slot_info.push_back(ShortMSB(slots[i].slot_label_id));
+    slot_info.push_back(ShortLSB(slots[i].slot_label_id));
+
+    default_values.push_back(ShortMSB(i));
+    default_values.push_back(ShortLSB(i));
+    default_values.push_back(slots[i].default_value);
+  }
+
+  const PersonalityDefinition personality = {
+    arraysize(slots), "Test", slots, arraysize(slots)
+  };
+
+  InitResponder();
+  ResponderDefinition responder_def;
+  InitDefinition(&responder_def);
+  responder_def.personalities = &personality;
+  responder_def.personality_count = 1;
+  g_responder->current_personality = 1;
+
+  // The first frame holds 46 whole slots.
+  const unsigned int first_frame_size = 46 * 5;
+
+  unique_ptr<RDMRequest> request(new RDMGetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 0, PID_SLOT_INFO, nullptr, 0));
+  unique_ptr<RDMResponse> first_response(GetResponseFromData(
+        request.get(), slot_info.data(), first_frame_size,
+        ola::rdm::RDM_ACK_OVERFLOW));
+  unique_ptr<RDMResponse> last_response(GetResponseFromData(
+        request.get(), slot_info.data() + first_frame_size,
+        slot_info.size() - first_frame_size));
+
+  int size = InvokeHandler(RDMResponder_GetSlotInfo, request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(first_response.get()));
+
+  size = InvokeHandler(RDMResponder_GetSlotInfo, request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(last_response.get()));
+
+  // Once the list is complete, the next GET starts again.
+  size = InvokeHandler(RDMResponder_GetSlotInfo, request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(first_response.get()));
+
+  // A GET from another controller restarts the list.
+  unique_ptr<RDMRequest> other_request(new RDMGetRequest(
+      UID(0x7a70, 0x00000001), m_our_uid, 0, 0, 0, PID_SLOT_INFO, nullptr,
+      0));
+  unique_ptr<RDMResponse> other_response(GetResponseFromData(
+        other_request.get(), slot_info.data(), first_frame_size,
+        ola::rdm::RDM_ACK_OVERFLOW));
+
+  size = InvokeHandler(RDMResponder_GetSlotInfo, other_request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(other_response.get()));
+
+  size = InvokeHandler(RDMResponder_GetSlotInfo, request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(first_response.get()));
+
+  // So does a GET for a different PID. The default slot values fit in a
+  // single frame.
+  unique_ptr<RDMRequest> default_request(new RDMGetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 0, PID_DEFAULT_SLOT_VALUE, nullptr,
+      0));
+  unique_ptr<RDMResponse> default_response(GetResponseFromData(
+        default_request.get(), default_values.data(), default_values.size()));
+  size = InvokeHandler(RDMResponder_GetDefaultSlotValue,
+                       default_request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(default_response.get()));
+
+  size = InvokeHandler(RDMResponder_GetSlotInfo, request.get());
+  EXPECT_THAT(ArrayTuple(g_rdm_buffer, size),
+              ResponseIs(first_response.get()));
+}
+
 TEST_F(RDMResponderTest, productDetailIds) {
   unique_ptr<RDMRequest> request(new RDMGetRequest(
       m_controller_uid, m_our_uid, 0, 0, 0, PID_PRODUCT_DETAIL_ID_LIST,
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderDefinitionTest.cpp
+ * Checks the ResponderDefinitions of every model.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include "dimmer_model.h"
+#include "led_model.h"
+#include "moving_light.h"
+#include "network_model.h"
+#include "proxy_model.h"
+#include "rdm.h"
+#include "rdm_responder.h"
+#include "sensor_model.h"
+#include "Array.h"
+
+using ::testing::Not;
+
+namespace {
+
+/*
+ * @brief Check a ResponderDefinition's descriptors are sorted by PID.
+ *
+ * RDMResponder_DispatchPID() uses a binary search, so an unsorted table will
+ * cause PIDs to be NACKed with NR_UNKNOWN_PID.
+ */
+MATCHER(HasSortedDescriptors, "") {
+  for (unsigned int i = 1; i < arg->descriptor_count; i++) {
+    if (arg->descriptors[i - 1].pid >= arg->descriptors[i].pid) {
+      *result_listener << "PID 0x" << std::hex << arg->descriptors[i].pid
+                       << " at index " << std::dec << i << " is out of order";
+      return false;
+    }
+  }
+  return true;
+}
+
+typedef struct {
+  const char *name;
+  const ResponderDefinition *const *definitions;
+} ModelDefinitions;
+
+const ModelDefinitions MODELS[] = {
+  {"Dimmer", DIMMER_MODEL_DEFINITIONS},
+  {"LED", LED_MODEL_DEFINITIONS},
+  {"Moving Light", MOVING_LIGHT_MODEL_DEFINITIONS},
+  {"Network", NETWORK_MODEL_DEFINITIONS},
+  {"Proxy", PROXY_MODEL_DEFINITIONS},
+  {"Sensor", SENSOR_MODEL_DEFINITIONS},
+};
+
+}  // namespace
+
+TEST(ResponderDefinitionTest, sortedDescriptors) {
+  for (unsigned int i = 0; i < arraysize(MODELS); i++) {
+    SCOPED_TRACE(MODELS[i].name);
+    unsigned int definition_count = 0;
+    const ResponderDefinition *const *definition = MODELS[i].definitions;
+    for (; *definition; definition++) {
+      EXPECT_LT(0u, (*definition)->descriptor_count);
+      EXPECT_THAT(*definition, HasSortedDescriptors());
+      definition_count++;
+    }
+    EXPECT_LT(0u, definition_count);
+  }
+}
+
+TEST(ResponderDefinitionTest, unsortedDescriptors) {
+  const PIDDescriptor descriptors[] = {
+    {PID_DEVICE_INFO, RDMResponder_GetDeviceInfo, 0u,
+      (PIDCommandHandler) NULL},
+    {PID_SUPPORTED_PARAMETERS, RDMResponder_GetSupportedParameters, 0u,
+      (PIDCommandHandler) NULL},
+  };
+  ResponderDefinition definition;
+  memset(&definition, 0, sizeof(definition));
+  definition.descriptors = descriptors;
+  definition.descriptor_count = arraysize(descriptors);
+  EXPECT_THAT(&definition, Not(HasSortedDescriptors()));
+}
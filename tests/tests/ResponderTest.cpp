@@ -19,6 +19,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string.h>
 
 #include <algorithm>
 #include <memory>
@@ -30,6 +31,7 @@
 #include "RDMHandlerMock.h"
 #include "SPIRGBMock.h"
 
+using ::testing::AnyNumber;
 using ::testing::IgnoreResult;
 using ::testing::Return;
 using ::testing::StrictMock;
@@ -41,6 +43,12 @@ class ResponderTest : public testing::Test {
   void SetUp() {
     RDMHandler_SetMock(&handler_mock);
     SPIRGB_SetMock(&spi_mock);
+    EXPECT_CALL(handler_mock, GetUID(_))
+      .Times(AnyNumber())
+      .WillRepeatedly(WithArgs<0>(IgnoreResult(CopyUID(TEST_UID))));
+    EXPECT_CALL(handler_mock, GetUIDMask(_))
+      .Times(AnyNumber())
+      .WillRepeatedly(WithArgs<0>(IgnoreResult(CopyUID(UNICAST_MASK))));
     Responder_Initialize();
     ReceiverCounters_ResetCounters();
   }
@@ -72,6 +80,7 @@ class ResponderTest : public testing::Test {
   MockSPIRGB spi_mock;
 
   static const uint8_t TEST_UID[];
+  static const uint8_t UNICAST_MASK[];
   static const uint8_t ASC_FRAME[];
   static const uint8_t DMX_FRAME[];
   static const uint8_t RDM_FRAME[];
@@ -79,7 +88,10 @@ class ResponderTest : public testing::Test {
   static const uint8_t LONG_DMX_FRAME[];
 };
 
-const uint8_t ResponderTest::TEST_UID[] = {0x7a, 0x70, 0, 0, 0, 1};
+const uint8_t ResponderTest::TEST_UID[] = {0x7a, 0x70, 0, 0, 0, 0};
+const uint8_t ResponderTest::UNICAST_MASK[] = {
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
 
 const uint8_t ResponderTest::ASC_FRAME[] = {
   99,
@@ -176,9 +188,6 @@ TEST_F(ResponderTest, rxSequence) {
 }
 
 TEST_F(ResponderTest, rdmChecksumMismatch) {
-  EXPECT_CALL(handler_mock, GetUID(_))
-    .WillOnce(WithArgs<0>(IgnoreResult(CopyUID(TEST_UID))));
-
   const uint8_t bad_frame[] = {
     0xcc, 0x01, 0x18, 0x7a, 0x70, 0xff, 0xff, 0xff, 0xff, 0x7a, 0x70, 0x12,
     0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x00,
@@ -189,6 +198,75 @@ TEST_F(ResponderTest, rdmChecksumMismatch) {
   EXPECT_EQ(1, ReceiverCounters_RDMChecksumInvalidCounter());
 }
 
+TEST_F(ResponderTest, rdmBodyMismatch) {
+  // RDM_FRAME sent to all devices, without updating the checksum.
+  uint8_t bad_frame[arraysize(RDM_FRAME)];
+  memcpy(bad_frame, RDM_FRAME, arraysize(RDM_FRAME));
+  memset(bad_frame + 5, 0xff, 4);
+  SendFrame(bad_frame, arraysize(bad_frame), 5);
+
+  EXPECT_EQ(1, ReceiverCounters_RDMChecksumInvalidCounter());
+}
+
+TEST_F(ResponderTest, rdmNotAddressed) {
+  // RDM_FRAME sent to 7a70:00000002, with a matching checksum.
+  uint8_t other_frame[arraysize(RDM_FRAME)];
+  memcpy(other_frame, RDM_FRAME, arraysize(RDM_FRAME));
+  other_frame[8] = 0x02;
+  other_frame[25] = 0xe1;
+  SendFrame(other_frame, arraysize(other_frame));
+
+  // A bad checksum isn't counted either, since the frame isn't checksummed.
+  other_frame[25] = 0x00;
+  SendFrame(other_frame, arraysize(other_frame), 5);
+
+  // Nor is a broadcast for another manufacturer.
+  memset(other_frame + 3, 0xff, UID_LENGTH);
+  other_frame[3] = 0x7b;
+  SendFrame(other_frame, arraysize(other_frame));
+
+  EXPECT_EQ(3, ReceiverCounters_RDMFrames());
+  EXPECT_EQ(0, ReceiverCounters_RDMChecksumInvalidCounter());
+  EXPECT_EQ(0, ReceiverCounters_RDMLengthMismatch());
+}
+
+TEST_F(ResponderTest, rdmAddressed) {
+  const uint8_t all_devices[] = {
+    0xcc, 0x01, 0x18, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7a, 0x70, 0x12,
+    0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x00,
+    0x08, 0xef
+  };
+  const uint8_t manufacturer[] = {
+    0xcc, 0x01, 0x18, 0x7a, 0x70, 0xff, 0xff, 0xff, 0xff, 0x7a, 0x70, 0x12,
+    0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x00,
+    0x07, 0xdb
+  };
+  const uint8_t child[] = {
+    0xcc, 0x01, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x05, 0x7a, 0x70, 0x12,
+    0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x00,
+    0x03, 0xe4
+  };
+  const uint8_t proxy_mask[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+
+  EXPECT_CALL(handler_mock, HandleRequest(
+        reinterpret_cast<const RDMHeader*>(all_devices), NULL))
+    .Times(1);
+  EXPECT_CALL(handler_mock, HandleRequest(
+        reinterpret_cast<const RDMHeader*>(manufacturer), NULL))
+    .Times(1);
+  SendFrame(all_devices, arraysize(all_devices));
+  SendFrame(manufacturer, arraysize(manufacturer));
+
+  // The child UID only matches once the model widens the mask.
+  SendFrame(child, arraysize(child));
+  EXPECT_CALL(handler_mock, GetUIDMask(_))
+    .WillRepeatedly(WithArgs<0>(IgnoreResult(CopyUID(proxy_mask))));
+  EXPECT_CALL(handler_mock, HandleRequest(
+        reinterpret_cast<const RDMHeader*>(child), NULL))
+    .Times(1);
+  SendFrame(child, arraysize(child));
+}
+
 TEST_F(ResponderTest, badSubStartCode) {
   const uint8_t frame[] = {
     0xcc, 0x02, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x70, 0x12,
@@ -287,18 +365,46 @@ TEST_F(ResponderTest, SPIOutput) {
   spi_config.module_id = SPI_ID_1;
   spi_config.baud_rate = 2000000;
   spi_config.use_enhanced_buffering = false;
+  spi_config.use_dma = false;
   SPIRGB_Init(&spi_config);
 
   EXPECT_CALL(spi_mock, BeginUpdate())
     .Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, RED, 1)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, GREEN, 2)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, BLUE, 3)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, RED, 4)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, GREEN, 5)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, BLUE, 6)).Times(1);
+  EXPECT_CALL(spi_mock, SetSlot(0, 1)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(1, 2)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(2, 3)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(3, 4)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(4, 5)).WillOnce(Return(false));
+  // The last slot used by the pixels completes the update.
+  EXPECT_CALL(spi_mock, SetSlot(5, 6)).WillOnce(Return(true));
+  EXPECT_CALL(spi_mock, SetSlot(6, 7)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(7, 8)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(8, 9)).WillOnce(Return(false));
+  EXPECT_CALL(spi_mock, SetSlot(9, 10)).WillOnce(Return(false));
   EXPECT_CALL(spi_mock, CompleteUpdate())
     .Times(1);
 
   SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
 }
+
+TEST_F(ResponderTest, SPIOutputDisabled) {
+  Responder_SetSPIOutput(false);
+
+  EXPECT_CALL(spi_mock, BeginUpdate()).Times(0);
+  EXPECT_CALL(spi_mock, SetSlot(_, _)).Times(0);
+  EXPECT_CALL(spi_mock, CompleteUpdate()).Times(0);
+
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+
+  TransceiverEvent event;
+  event.token = 0;
+  event.op = T_OP_RX;
+  event.result = T_RESULT_RX_FRAME_TIMEOUT;
+  event.data = NULL;
+  event.length = 0;
+  event.timing = NULL;
+  Responder_Receive(&event);
+
+  // The frame is still counted.
+  EXPECT_EQ(1, ReceiverCounters_DMXFrames());
+}
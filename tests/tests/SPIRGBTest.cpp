@@ -23,12 +23,21 @@
 
 #include "spi_rgb.h"
 #include "Array.h"
+#include "coarse_timer.h"
 #include "Matchers.h"
+#include "plib_dma_mock.h"
 #include "plib_spi_mock.h"
+#include "sys/kmem.h"
+#include "sys_int_mock.h"
 
+using ::testing::AnyNumber;
 using ::testing::ElementsAreArray;
+using ::testing::InSequence;
 using ::testing::Invoke;
+using ::testing::Ne;
+using ::testing::NiceMock;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::StrictMock;
 using ::testing::WithArgs;
 using ::testing::_;
@@ -37,16 +46,89 @@ class SPIRGBTest : public testing::Test {
  public:
   void SetUp() {
     PLIB_SPI_SetMock(&spi_mock);
+    CoarseTimer_SetCounter(0u);
   }
 
   void TearDown() {
     PLIB_SPI_SetMock(NULL);
+    PLIB_DMA_SetMock(NULL);
+    SYS_INT_SetMock(NULL);
   }
 
   void AppendByte(uint8_t byte) {
     m_spi_data.push_back(byte);
   }
 
+  void InitSPI() {
+    SPIRGBConfiguration config;
+    config.module_id = SPI_ID_1;
+    config.baud_rate = 2000000;
+    config.use_enhanced_buffering = false;
+    config.use_dma = false;
+
+    EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_1, _, 2000000));
+    EXPECT_CALL(spi_mock, CommunicationWidthSelect(
+        SPI_ID_1, SPI_COMMUNICATION_WIDTH_8BITS));
+    EXPECT_CALL(spi_mock, SlaveSelectDisable(SPI_ID_1));
+    EXPECT_CALL(spi_mock, PinDisable(SPI_ID_1, SPI_PIN_SLAVE_SELECT));
+    EXPECT_CALL(spi_mock, MasterEnable(SPI_ID_1));
+    // Each call to SPIRGB_Configure() sets the clock mode.
+    EXPECT_CALL(spi_mock, Disable(SPI_ID_1)).Times(AnyNumber());
+    EXPECT_CALL(spi_mock, ClockPolaritySelect(SPI_ID_1, _))
+      .Times(AnyNumber());
+    EXPECT_CALL(spi_mock, OutputDataPhaseSelect(SPI_ID_1, _))
+      .Times(AnyNumber());
+    EXPECT_CALL(spi_mock, Enable(SPI_ID_1)).Times(AnyNumber());
+    EXPECT_CALL(spi_mock, IsBusy(SPI_ID_1))
+      .WillRepeatedly(Return(false));
+    EXPECT_CALL(spi_mock, BufferWrite(SPI_ID_1, _))
+      .WillRepeatedly(WithArgs<1>(Invoke(this, &SPIRGBTest::AppendByte)));
+
+    SPIRGB_Init(&config);
+  }
+
+  void InitDMASPI(uint8_t *spi_buffer) {
+    SPIRGBConfiguration config;
+    config.module_id = SPI_ID_2;
+    config.baud_rate = 4000000;
+    config.use_enhanced_buffering = true;
+    config.use_dma = true;
+    config.dma_channel = DMA_CHANNEL_7;
+    config.dma_trigger = DMA_TRIGGER_SPI_2_TRANSMIT;
+  config.dma_vector = INT_VECTOR_DMA7;
+  config.dma_source = INT_SOURCE_DMA_7;
+    config.dma_vector = INT_VECTOR_DMA7;
+    config.dma_source = INT_SOURCE_DMA_7;
+
+    EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_2, _, 4000000));
+    EXPECT_CALL(spi_mock, CommunicationWidthSelect(
+        SPI_ID_2, SPI_COMMUNICATION_WIDTH_8BITS));
+    EXPECT_CALL(spi_mock, FIFOEnable(SPI_ID_2));
+    EXPECT_CALL(spi_mock, FIFOInterruptModeSelect(
+        SPI_ID_2, SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL));
+    EXPECT_CALL(spi_mock, SlaveSelectDisable(SPI_ID_2));
+    EXPECT_CALL(spi_mock, PinDisable(SPI_ID_2, SPI_PIN_SLAVE_SELECT));
+    EXPECT_CALL(spi_mock, MasterEnable(SPI_ID_2));
+    EXPECT_CALL(spi_mock, Disable(SPI_ID_2)).Times(AnyNumber());
+    EXPECT_CALL(spi_mock, ClockPolaritySelect(SPI_ID_2, _))
+      .Times(AnyNumber());
+    EXPECT_CALL(spi_mock, OutputDataPhaseSelect(SPI_ID_2, _))
+      .Times(AnyNumber());
+    EXPECT_CALL(spi_mock, Enable(SPI_ID_2)).Times(AnyNumber());
+    EXPECT_CALL(spi_mock, BufferAddressGet(SPI_ID_2))
+      .WillOnce(Return(spi_buffer));
+
+    SPIRGB_Init(&config);
+  }
+
+  // CoarseTimer_GetTime() masks the timer interrupt.
+  void AllowTimerInterrupt(MockSysInt *sys_int_mock) {
+    EXPECT_CALL(*sys_int_mock, SourceDisable(Ne(INT_SOURCE_DMA_7)))
+      .Times(AnyNumber());
+    EXPECT_CALL(*sys_int_mock, SourceEnable(Ne(INT_SOURCE_DMA_7)))
+      .Times(AnyNumber());
+  }
+
  protected:
   StrictMock<MockPeripheralSPI> spi_mock;
   std::vector<uint8_t> m_spi_data;
@@ -57,15 +139,21 @@ TEST_F(SPIRGBTest, testSimpleMode) {
   config.module_id = SPI_ID_1;
   config.baud_rate = 2000000;
   config.use_enhanced_buffering = false;
+  config.use_dma = false;
 
   EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_1, _, 2000000))
     .Times(1);
   EXPECT_CALL(spi_mock,
               CommunicationWidthSelect(SPI_ID_1, SPI_COMMUNICATION_WIDTH_8BITS))
     .Times(1);
+  EXPECT_CALL(spi_mock, Disable(SPI_ID_1))
+    .Times(1);
   EXPECT_CALL(spi_mock,
               ClockPolaritySelect(SPI_ID_1, SPI_CLOCK_POLARITY_IDLE_HIGH))
     .Times(1);
+  EXPECT_CALL(spi_mock, OutputDataPhaseSelect(
+      SPI_ID_1, SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK))
+    .Times(1);
   EXPECT_CALL(spi_mock, SlaveSelectDisable(SPI_ID_1))
     .Times(1);
   EXPECT_CALL(spi_mock, PinDisable(SPI_ID_1, SPI_PIN_SLAVE_SELECT))
@@ -116,15 +204,21 @@ TEST_F(SPIRGBTest, testEnhancedMode) {
   config.module_id = SPI_ID_1;
   config.baud_rate = 4000000;
   config.use_enhanced_buffering = true;
+  config.use_dma = false;
 
   EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_1, _, 4000000))
     .Times(1);
   EXPECT_CALL(spi_mock,
               CommunicationWidthSelect(SPI_ID_1, SPI_COMMUNICATION_WIDTH_8BITS))
     .Times(1);
+  EXPECT_CALL(spi_mock, Disable(SPI_ID_1))
+    .Times(1);
   EXPECT_CALL(spi_mock,
               ClockPolaritySelect(SPI_ID_1, SPI_CLOCK_POLARITY_IDLE_HIGH))
     .Times(1);
+  EXPECT_CALL(spi_mock, OutputDataPhaseSelect(
+      SPI_ID_1, SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK))
+    .Times(1);
   EXPECT_CALL(spi_mock, FIFOEnable(SPI_ID_1))
     .Times(1);
   EXPECT_CALL(spi_mock, SlaveSelectDisable(SPI_ID_1))
@@ -171,3 +265,413 @@ TEST_F(SPIRGBTest, testEnhancedMode) {
   };
   EXPECT_THAT(m_spi_data, ElementsAreArray(expected2));
 }
+
+TEST_F(SPIRGBTest, testDMA) {
+  StrictMock<MockPeripheralDMA> dma_mock;
+  PLIB_DMA_SetMock(&dma_mock);
+  uint8_t spi_buffer;
+
+  SPIRGBConfiguration config;
+  config.module_id = SPI_ID_2;
+  config.baud_rate = 4000000;
+  config.use_enhanced_buffering = true;
+  config.use_dma = true;
+  config.dma_channel = DMA_CHANNEL_7;
+  config.dma_trigger = DMA_TRIGGER_SPI_2_TRANSMIT;
+  config.dma_vector = INT_VECTOR_DMA7;
+  config.dma_source = INT_SOURCE_DMA_7;
+
+  EXPECT_CALL(spi_mock, BaudRateSet(SPI_ID_2, _, 4000000));
+  EXPECT_CALL(spi_mock,
+              CommunicationWidthSelect(SPI_ID_2, SPI_COMMUNICATION_WIDTH_8BITS));
+  EXPECT_CALL(spi_mock, Disable(SPI_ID_2));
+  EXPECT_CALL(spi_mock,
+              ClockPolaritySelect(SPI_ID_2, SPI_CLOCK_POLARITY_IDLE_HIGH));
+  EXPECT_CALL(spi_mock, OutputDataPhaseSelect(
+      SPI_ID_2, SPI_OUTPUT_DATA_PHASE_ON_IDLE_TO_ACTIVE_CLOCK));
+  EXPECT_CALL(spi_mock, FIFOEnable(SPI_ID_2));
+  EXPECT_CALL(spi_mock, FIFOInterruptModeSelect(
+      SPI_ID_2, SPI_FIFO_INTERRUPT_WHEN_TRANSMIT_BUFFER_IS_NOT_FULL));
+  EXPECT_CALL(spi_mock, SlaveSelectDisable(SPI_ID_2));
+  EXPECT_CALL(spi_mock, PinDisable(SPI_ID_2, SPI_PIN_SLAVE_SELECT));
+  EXPECT_CALL(spi_mock, Enable(SPI_ID_2));
+  EXPECT_CALL(spi_mock, MasterEnable(SPI_ID_2));
+  EXPECT_CALL(spi_mock, BufferAddressGet(SPI_ID_2))
+    .WillOnce(Return(&spi_buffer));
+
+  EXPECT_CALL(dma_mock, Enable(DMA_ID_0));
+  EXPECT_CALL(dma_mock, ChannelXDisable(DMA_ID_0, DMA_CHANNEL_7));
+  EXPECT_CALL(dma_mock, ChannelXPrioritySelect(DMA_ID_0, DMA_CHANNEL_7, _));
+  EXPECT_CALL(dma_mock, ChannelXStartIRQSet(DMA_ID_0, DMA_CHANNEL_7,
+                                            DMA_TRIGGER_SPI_2_TRANSMIT));
+  EXPECT_CALL(dma_mock, ChannelXTriggerEnable(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_CHANNEL_TRIGGER_TRANSFER_START));
+  EXPECT_CALL(dma_mock, ChannelXDestinationStartAddressSet(
+      DMA_ID_0, DMA_CHANNEL_7, KVA_TO_PA(&spi_buffer)));
+  EXPECT_CALL(dma_mock, ChannelXDestinationSizeSet(DMA_ID_0, DMA_CHANNEL_7,
+                                                   1u));
+  EXPECT_CALL(dma_mock, ChannelXCellSizeSet(DMA_ID_0, DMA_CHANNEL_7, 1u));
+  EXPECT_CALL(dma_mock, ChannelXINTSourceEnable(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+
+  SPIRGB_Init(&config);
+
+  // The first frame is handed to the DMA channel on completion.
+  uint32_t address = 0u;
+  EXPECT_CALL(dma_mock, ChannelXSourceStartAddressSet(DMA_ID_0, DMA_CHANNEL_7,
+                                                      _))
+    .WillOnce(SaveArg<2>(&address));
+  EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_7, 7u));
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagClear(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  EXPECT_CALL(dma_mock, ChannelXEnable(DMA_ID_0, DMA_CHANNEL_7));
+
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 255);
+  SPIRGB_CompleteUpdate();
+
+  const uint8_t *frame = reinterpret_cast<uint8_t*>(PA_TO_KVA1(address));
+  const uint8_t expected[] = {0x80, 0xff, 0x80, 0x80, 0x80, 0x80, 0};
+  EXPECT_THAT(ArrayTuple(frame, 7), DataIs(expected, arraysize(expected)));
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+
+  // While the first frame is being sent, the next one is decoded into the
+  // back buffer.
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagGet(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE))
+    .WillRepeatedly(Return(false));
+
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(5, 128);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  EXPECT_THAT(ArrayTuple(frame, 7), DataIs(expected, arraysize(expected)));
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+
+  // Once the DMA completes, the second frame is sent.
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagGet(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE))
+    .WillOnce(Return(true));
+  EXPECT_CALL(dma_mock, ChannelXSourceStartAddressSet(DMA_ID_0, DMA_CHANNEL_7,
+                                                      _))
+    .WillOnce(SaveArg<2>(&address));
+  EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_7, 7u));
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagClear(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  EXPECT_CALL(dma_mock, ChannelXEnable(DMA_ID_0, DMA_CHANNEL_7));
+
+  SPIRGB_Tasks();
+
+  const uint8_t *frame2 = reinterpret_cast<uint8_t*>(PA_TO_KVA1(address));
+  EXPECT_NE(frame, frame2);
+  const uint8_t expected2[] = {0x80, 0xff, 0x80, 0x80, 0x80, 0xc0, 0};
+  EXPECT_THAT(ArrayTuple(frame2, 7), DataIs(expected2, arraysize(expected2)));
+}
+
+TEST_F(SPIRGBTest, testDMABlocks) {
+  NiceMock<MockPeripheralDMA> dma_mock;
+  PLIB_DMA_SetMock(&dma_mock);
+  StrictMock<MockSysInt> sys_int_mock;
+  SYS_INT_SetMock(&sys_int_mock);
+  AllowTimerInterrupt(&sys_int_mock);
+  uint8_t spi_buffer;
+
+  EXPECT_CALL(dma_mock, ChannelXINTSourceEnable(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  EXPECT_CALL(sys_int_mock, VectorPrioritySet(INT_VECTOR_DMA7, _));
+  EXPECT_CALL(sys_int_mock, VectorSubprioritySet(INT_VECTOR_DMA7, _));
+  InitDMASPI(&spi_buffer);
+
+  // 170 LPD8806 pixels & 6 latch bytes, which is sent as 3 blocks.
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_LPD8806, SPIRGB_MAX_PIXEL_COUNT));
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+  ::testing::Mock::VerifyAndClearExpectations(&sys_int_mock);
+  AllowTimerInterrupt(&sys_int_mock);
+
+  uint32_t address = 0u;
+  {
+    InSequence seq;
+    EXPECT_CALL(dma_mock, ChannelXSourceStartAddressSet(DMA_ID_0,
+                                                        DMA_CHANNEL_7, _))
+      .WillOnce(SaveArg<2>(&address));
+    EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_7,
+                                                256u));
+    EXPECT_CALL(dma_mock, ChannelXEnable(DMA_ID_0, DMA_CHANNEL_7));
+    EXPECT_CALL(sys_int_mock, SourceStatusClear(INT_SOURCE_DMA_7));
+    EXPECT_CALL(sys_int_mock, SourceEnable(INT_SOURCE_DMA_7));
+  }
+  SPIRGB_Tasks();
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+  ::testing::Mock::VerifyAndClearExpectations(&sys_int_mock);
+  AllowTimerInterrupt(&sys_int_mock);
+  const uint8_t *frame = reinterpret_cast<uint8_t*>(PA_TO_KVA1(address));
+
+  // The main loop doesn't start the next block.
+  EXPECT_CALL(dma_mock, ChannelXEnable(_, _)).Times(0);
+  SPIRGB_Tasks();
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+
+  // Each block complete interrupt starts the next block.
+  const uint16_t block_sizes[] = {256u, 4u};
+  for (unsigned int i = 0; i < arraysize(block_sizes); i++) {
+    InSequence seq;
+    EXPECT_CALL(dma_mock, ChannelXSourceStartAddressSet(DMA_ID_0,
+                                                        DMA_CHANNEL_7, _))
+      .WillOnce(SaveArg<2>(&address));
+    EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_7,
+                                                block_sizes[i]));
+    EXPECT_CALL(dma_mock, ChannelXINTSourceFlagClear(
+        DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+    EXPECT_CALL(dma_mock, ChannelXEnable(DMA_ID_0, DMA_CHANNEL_7));
+    EXPECT_CALL(sys_int_mock, SourceStatusClear(INT_SOURCE_DMA_7));
+    SPIRGB_DMAEvent();
+    ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+    ::testing::Mock::VerifyAndClearExpectations(&sys_int_mock);
+    AllowTimerInterrupt(&sys_int_mock);
+    EXPECT_EQ(frame + 256u * (i + 1),
+              reinterpret_cast<uint8_t*>(PA_TO_KVA1(address)));
+  }
+
+  // The frame isn't complete until the last block is.
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagGet(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE))
+    .WillOnce(Return(false));
+  SPIRGB_Tasks();
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+
+  // The last interrupt disables the source, and leaves the flag set.
+  {
+    InSequence seq;
+    EXPECT_CALL(sys_int_mock, SourceDisable(INT_SOURCE_DMA_7))
+      .WillOnce(Return(true));
+    EXPECT_CALL(sys_int_mock, SourceStatusClear(INT_SOURCE_DMA_7));
+  }
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagClear(_, _, _)).Times(0);
+  EXPECT_CALL(dma_mock, ChannelXEnable(_, _)).Times(0);
+  SPIRGB_DMAEvent();
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+  ::testing::Mock::VerifyAndClearExpectations(&sys_int_mock);
+  AllowTimerInterrupt(&sys_int_mock);
+
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagGet(
+      DMA_ID_0, DMA_CHANNEL_7, DMA_INT_BLOCK_TRANSFER_COMPLETE))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(dma_mock, ChannelXEnable(_, _)).Times(0);
+  SPIRGB_Tasks();
+  SPIRGB_Tasks();
+  ::testing::Mock::VerifyAndClearExpectations(&dma_mock);
+
+  // Reconfiguring mid-frame stops the DMA channel & the interrupt.
+  EXPECT_CALL(sys_int_mock, SourceStatusClear(INT_SOURCE_DMA_7));
+  EXPECT_CALL(sys_int_mock, SourceEnable(INT_SOURCE_DMA_7));
+  SPIRGB_BeginUpdate();
+  SPIRGB_CompleteUpdate();
+  ::testing::Mock::VerifyAndClearExpectations(&sys_int_mock);
+  AllowTimerInterrupt(&sys_int_mock);
+
+  {
+    InSequence seq;
+    EXPECT_CALL(sys_int_mock, SourceDisable(INT_SOURCE_DMA_7))
+      .WillOnce(Return(true));
+    EXPECT_CALL(sys_int_mock, SourceStatusClear(INT_SOURCE_DMA_7));
+    EXPECT_CALL(dma_mock, ChannelXDisable(DMA_ID_0, DMA_CHANNEL_7));
+  }
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_WS2801, 10u));
+}
+
+TEST_F(SPIRGBTest, testConfigure) {
+  InitSPI();
+
+  EXPECT_FALSE(SPIRGB_Configure(static_cast<PixelType>(3), 2));
+  EXPECT_FALSE(SPIRGB_Configure(PIXEL_TYPE_WS2801,
+                                SPIRGB_MAX_PIXEL_COUNT + 1));
+
+  // Configure resets the pixels.
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_LPD8806, 1));
+  SPIRGB_Tasks();
+
+  const uint8_t expected[] = {0x80, 0x80, 0x80, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+}
+
+TEST_F(SPIRGBTest, testWS2801) {
+  InitSPI();
+
+  // The WS2801 is latched by idling the clock low, and samples on the rising
+  // edge.
+  EXPECT_CALL(spi_mock, Disable(SPI_ID_1));
+  EXPECT_CALL(spi_mock,
+              ClockPolaritySelect(SPI_ID_1, SPI_CLOCK_POLARITY_IDLE_LOW));
+  EXPECT_CALL(spi_mock, OutputDataPhaseSelect(
+      SPI_ID_1, SPI_OUTPUT_DATA_PHASE_ON_ACTIVE_TO_IDLE_CLOCK));
+  EXPECT_CALL(spi_mock, Enable(SPI_ID_1));
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_WS2801, 2));
+  ::testing::Mock::VerifyAndClearExpectations(&spi_mock);
+  EXPECT_CALL(spi_mock, IsBusy(SPI_ID_1))
+    .WillRepeatedly(Return(false));
+  EXPECT_CALL(spi_mock, BufferWrite(SPI_ID_1, _))
+    .WillRepeatedly(WithArgs<1>(Invoke(this, &SPIRGBTest::AppendByte)));
+
+  SPIRGB_BeginUpdate();
+  EXPECT_FALSE(SPIRGB_SetSlot(0, 255));
+  EXPECT_FALSE(SPIRGB_SetSlot(1, 128));
+  EXPECT_FALSE(SPIRGB_SetSlot(2, 1));
+  EXPECT_FALSE(SPIRGB_SetSlot(4, 10));
+  EXPECT_TRUE(SPIRGB_SetSlot(5, 20));
+  // Slots beyond the pixels are ignored.
+  EXPECT_FALSE(SPIRGB_SetSlot(6, 30));
+  EXPECT_FALSE(SPIRGB_SetSlot(511, 40));
+  SPIRGB_CompleteUpdate();
+  // Changing the clock mode starts a new latch period.
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+  CoarseTimer_SetCounter(6u);
+  SPIRGB_Tasks();
+
+  // RGB order, no latch bytes.
+  const uint8_t expected[] = {255, 128, 1, 0, 10, 20};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+}
+
+TEST_F(SPIRGBTest, testWS2801Latch) {
+  InitSPI();
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_WS2801, 1));
+  CoarseTimer_SetCounter(6u);
+  SPIRGB_Tasks();
+
+  const uint8_t expected[] = {0, 0, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+  m_spi_data.clear();
+
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 10);
+  SPIRGB_CompleteUpdate();
+
+  // The next frame waits until the clock has idled for 500uS.
+  SPIRGB_Tasks();
+  CoarseTimer_SetCounter(11u);
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+
+  CoarseTimer_SetCounter(12u);
+  SPIRGB_Tasks();
+  const uint8_t expected2[] = {10, 0, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected2));
+  m_spi_data.clear();
+
+  // The latch period starts once the last byte has been shifted out.
+  EXPECT_CALL(spi_mock, IsBusy(SPI_ID_1))
+    .WillRepeatedly(Return(true));
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 20);
+  SPIRGB_CompleteUpdate();
+  CoarseTimer_SetCounter(20u);
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+
+  EXPECT_CALL(spi_mock, IsBusy(SPI_ID_1))
+    .WillRepeatedly(Return(false));
+  SPIRGB_Tasks();
+  CoarseTimer_SetCounter(25u);
+  SPIRGB_Tasks();
+  EXPECT_TRUE(m_spi_data.empty());
+  CoarseTimer_SetCounter(26u);
+  SPIRGB_Tasks();
+  const uint8_t expected3[] = {20, 0, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected3));
+}
+
+TEST_F(SPIRGBTest, testAPA102) {
+  InitSPI();
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_APA102, 2));
+
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 1);
+  SPIRGB_SetSlot(1, 2);
+  SPIRGB_SetSlot(2, 3);
+  SPIRGB_SetPixel(1, RED, 4);
+  SPIRGB_SetPixel(1, GREEN, 5);
+  SPIRGB_SetPixel(1, BLUE, 6);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  // Start frame, 2 BGR pixels at full brightness and the end frame.
+  const uint8_t expected[] = {
+    0, 0, 0, 0,
+    0xff, 3, 2, 1,
+    0xff, 6, 5, 4,
+    0
+  };
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+}
+
+TEST_F(SPIRGBTest, testFullUniverse) {
+  InitSPI();
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_LPD8806, SPIRGB_MAX_PIXEL_COUNT));
+
+  SPIRGB_BeginUpdate();
+  for (uint16_t slot = 0; slot < 510; slot++) {
+    EXPECT_EQ(slot == 509, SPIRGB_SetSlot(slot, slot & 0xff));
+  }
+  SPIRGB_SetSlot(510, 0xff);
+  SPIRGB_SetSlot(511, 0xff);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  // 170 GRB pixels, followed by 6 latch bytes.
+  std::vector<uint8_t> expected;
+  for (uint16_t pixel = 0; pixel < SPIRGB_MAX_PIXEL_COUNT; pixel++) {
+    const uint16_t slot = pixel * 3;
+    expected.push_back(0x80 | ((slot + 1) & 0xff) >> 1);
+    expected.push_back(0x80 | (slot & 0xff) >> 1);
+    expected.push_back(0x80 | ((slot + 2) & 0xff) >> 1);
+  }
+  expected.insert(expected.end(), 6, 0);
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+}
+
+TEST_F(SPIRGBTest, testCurve) {
+  InitSPI();
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_WS2801, 1));
+
+  DimmerCurve curve;
+  DimmerCurve_Init(&curve, DIMMER_CURVE_SQUARE, 0, 0xc800, false);
+  SPIRGB_SetCurve(&curve);
+
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 0);
+  SPIRGB_SetSlot(1, 128);
+  SPIRGB_SetSlot(2, 255);
+  SPIRGB_CompleteUpdate();
+  CoarseTimer_SetCounter(6u);
+  SPIRGB_Tasks();
+
+  const uint8_t expected[] = {0, 64, 200};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected));
+  m_spi_data.clear();
+
+  // The curve is kept when the pixels are reconfigured.
+  EXPECT_TRUE(SPIRGB_Configure(PIXEL_TYPE_LPD8806, 1));
+  SPIRGB_Tasks();
+  m_spi_data.clear();
+
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 128);
+  SPIRGB_SetSlot(1, 255);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  const uint8_t expected2[] = {0x80 | 100, 0x80 | 32, 0x80, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected2));
+  m_spi_data.clear();
+
+  SPIRGB_SetCurve(NULL);
+  SPIRGB_BeginUpdate();
+  SPIRGB_SetSlot(0, 128);
+  SPIRGB_CompleteUpdate();
+  SPIRGB_Tasks();
+
+  const uint8_t expected3[] = {0x80 | 100, 0x80 | 64, 0x80, 0};
+  EXPECT_THAT(m_spi_data, ElementsAreArray(expected3));
+}
@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StreamDecoderBenchmark.cpp
+ * Measure how many messages per second the StreamDecoder can decode.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "constants.h"
+#include "dmx_spec.h"
+#include "stream_decoder.h"
+
+namespace {
+
+typedef std::vector<uint8_t> Transfer;
+
+// The size of an RDM GET request, excluding the start code.
+const unsigned int RDM_REQUEST_SIZE = 25;
+
+unsigned int g_message_count = 0;
+
+void CountMessage(const Message*) {
+  g_message_count++;
+}
+
+void AppendMessage(Transfer *transfer, uint8_t token, Command command,
+                   unsigned int payload_size) {
+  transfer->push_back(START_OF_MESSAGE_ID);
+  transfer->push_back(token);
+  transfer->push_back(command & 0xff);
+  transfer->push_back(command >> 8);
+  transfer->push_back(payload_size & 0xff);
+  transfer->push_back(payload_size >> 8);
+  for (unsigned int i = 0; i < payload_size; i++) {
+    transfer->push_back(i & 0xff);
+  }
+  transfer->push_back(END_OF_MESSAGE_ID);
+}
+
+/*
+ * Build the transfers for a mix of messages. Every dmx_ratio'th message is a
+ * TX_DMX, the others are RDM requests. Messages are packed into transfers of
+ * up to USB_READ_BUFFER_SIZE bytes, as a host batching requests would.
+ */
+std::vector<Transfer> BuildTransfers(unsigned int message_count,
+                                     unsigned int dmx_ratio) {
+  std::vector<Transfer> transfers;
+  Transfer transfer;
+  for (unsigned int i = 0; i < message_count; i++) {
+    Transfer message;
+    if (dmx_ratio && i % dmx_ratio == 0) {
+      AppendMessage(&message, i, TX_DMX, DMX_FRAME_SIZE);
+    } else {
+      AppendMessage(&message, i, COMMAND_RDM_REQUEST, RDM_REQUEST_SIZE);
+    }
+
+    if (transfer.size() + message.size() > USB_READ_BUFFER_SIZE) {
+      transfers.push_back(transfer);
+      transfer.clear();
+    }
+    transfer.insert(transfer.end(), message.begin(), message.end());
+  }
+  if (!transfer.empty()) {
+    transfers.push_back(transfer);
+  }
+  return transfers;
+}
+
+/*
+ * Decode the transfers, passing chunk_size bytes to StreamDecoder_Process()
+ * at a time. A chunk_size of 0 passes each transfer in a single call.
+ * @returns The number of messages decoded per second.
+ */
+double Run(const std::vector<Transfer> &transfers, unsigned int chunk_size,
+           unsigned int iterations) {
+  StreamDecoder_Initialize(CountMessage);
+  g_message_count = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < iterations; i++) {
+    for (const Transfer &transfer : transfers) {
+      unsigned int step = chunk_size ? chunk_size : transfer.size();
+      for (unsigned int offset = 0; offset < transfer.size(); offset += step) {
+        unsigned int size = transfer.size() - offset;
+        StreamDecoder_Process(transfer.data() + offset,
+                              size < step ? size : step);
+      }
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return g_message_count / elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  unsigned int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+
+  struct {
+    const char *name;
+    unsigned int dmx_ratio;
+  } mixes[] = {
+    {"TX_DMX only", 1},
+    {"1 TX_DMX : 3 RDM", 4},
+    {"RDM only", 0},
+  };
+
+  printf("%-20s %15s %15s\n", "Mix", "Whole transfer", "Byte at a time");
+  for (unsigned int i = 0; i < sizeof(mixes) / sizeof(mixes[0]); i++) {
+    std::vector<Transfer> transfers = BuildTransfers(100, mixes[i].dmx_ratio);
+    double whole = Run(transfers, 0, iterations);
+    double bytewise = Run(transfers, 1, iterations / 10 + 1);
+    printf("%-20s %13.0f/s %13.0f/s\n", mixes[i].name, whole, bytewise);
+  }
+  return 0;
+}
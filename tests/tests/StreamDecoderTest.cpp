@@ -19,10 +19,11 @@
  */
 
 #include <gtest/gtest.h>
-
+#include <string.h>
 
 #include "stream_decoder.h"
 #include "Array.h"
+#include "constants.h"
 #include "MessageHandlerMock.h"
 
 using ::testing::Args;
@@ -180,3 +181,75 @@ TEST_F(StreamDecoderTest, missingEOM) {
   uint8_t not_eom = 0;
   StreamDecoder_Process(&not_eom, 1);  // not an EOM marker
 }
+
+/*
+ * Check that multiple complete messages in a single buffer are decoded.
+ */
+TEST_F(StreamDecoderTest, multipleMessages) {
+  StreamDecoder_Initialize(MessageHandler_HandleMessage);
+
+  const uint8_t data[] = {
+    'n', 0x5a, 0x44, 0x01, 0x02, 0x00, 0x00, 0xa5,
+    0x5a, 0x45, 0x02, 0x02, 0x05, 0x00, 1, 2, 3, 4, 5, 0xa5,
+    // Bad EOM
+    0x5a, 0x46, 0x02, 0x02, 0x01, 0x00, 1, 0x00,
+  };
+  const uint8_t partial[] = {0x5a, 0x47, 0x02, 0x02, 0x05, 0x00, 1, 2, 3};
+  const uint8_t tail[] = {4, 5, 0xa5};
+
+  testing::InSequence seq;
+  EXPECT_CALL(message_handler_mock,
+              HandleMessage(MessageIs(0x44, 0x0201, nullptr, 0u)));
+  EXPECT_CALL(message_handler_mock,
+              HandleMessage(MessageIs(0x45, 0x0202, message1 + PAYLOAD_OFFSET,
+                                      MSG1_PAYLOAD_SIZE)));
+  EXPECT_CALL(message_handler_mock,
+              HandleMessage(MessageIs(0x47, 0x0202, message1 + PAYLOAD_OFFSET,
+                                      MSG1_PAYLOAD_SIZE)));
+
+  StreamDecoder_Process(data, arraysize(data));
+  EXPECT_FALSE(StreamDecoder_GetFragmentedFrameFlag());
+
+  // A message split across buffers still uses the state machine.
+  StreamDecoder_Process(partial, arraysize(partial));
+  StreamDecoder_Process(tail, arraysize(tail));
+  EXPECT_TRUE(StreamDecoder_GetFragmentedFrameFlag());
+}
+
+/*
+ * Check that a full OUT transfer of back to back requests is decoded.
+ */
+TEST_F(StreamDecoderTest, batchedRequests) {
+  StreamDecoder_Initialize(MessageHandler_HandleMessage);
+
+  // An RDM GET request is 25 bytes, plus the message header & EOM.
+  const unsigned int kPayloadSize = 25;
+  const unsigned int kMessageSize = kPayloadSize + 7;
+  const unsigned int kMessageCount = USB_READ_BUFFER_SIZE / kMessageSize;
+
+  uint8_t payload[kPayloadSize];
+  for (unsigned int i = 0; i < kPayloadSize; i++) {
+    payload[i] = i;
+  }
+
+  uint8_t data[USB_READ_BUFFER_SIZE];
+  uint8_t *ptr = data;
+  testing::InSequence seq;
+  for (unsigned int i = 0; i < kMessageCount; i++) {
+    *ptr++ = 0x5a;
+    *ptr++ = i;
+    *ptr++ = 0x41;
+    *ptr++ = 0x00;
+    *ptr++ = kPayloadSize;
+    *ptr++ = 0x00;
+    memcpy(ptr, payload, kPayloadSize);
+    ptr += kPayloadSize;
+    *ptr++ = 0xa5;
+
+    EXPECT_CALL(message_handler_mock,
+                HandleMessage(MessageIs(i, 0x0041, payload, kPayloadSize)));
+  }
+
+  StreamDecoder_Process(data, ptr - data);
+  EXPECT_FALSE(StreamDecoder_GetFragmentedFrameFlag());
+}
@@ -0,0 +1,519 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TransceiverSimulatorTest.cpp
+ * Tests for the Transceiver code, running on a simulated line.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Array.h"
+#include "TransceiverSimulator.h"
+#include "constants.h"
+#include "dmx_spec.h"
+#include "rdm.h"
+
+namespace {
+
+const uint8_t kControllerUID[] = {0x7a, 0x70, 0xff, 0xff, 0xfe, 0x00};
+const uint8_t kResponderUID[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x01};
+const uint8_t kOtherResponderUID[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x02};
+const uint8_t kBroadcastUID[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+// The simulated time to wait for an operation to complete.
+const uint64_t kTimeout = 100000u;
+
+const uint16_t kDeviceInfoPID = 0x0060u;
+
+// The event data is only valid during the callback, so take a copy.
+struct Event {
+  uint8_t token;
+  TransceiverOperation op;
+  TransceiverOperationResult result;
+  std::vector<uint8_t> data;
+};
+
+std::vector<Event> g_events;
+
+bool RecordEvent(const TransceiverEvent *event) {
+  Event copy = {event->token, event->op, event->result,
+                std::vector<uint8_t>(event->data,
+                                     event->data + event->length)};
+  g_events.push_back(copy);
+  return true;
+}
+
+/*
+ * Build a RDM request, excluding the start code.
+ */
+std::vector<uint8_t> BuildRequest(const uint8_t *destination,
+                                  uint8_t command_class, uint16_t pid,
+                                  const uint8_t *param_data,
+                                  unsigned int param_data_size) {
+  std::vector<uint8_t> frame;
+  frame.push_back(RDM_START_CODE);
+  frame.push_back(RDM_SUB_START_CODE);
+  frame.push_back(RDM_PARAM_DATA_OFFSET + param_data_size);
+  frame.insert(frame.end(), destination, destination + UID_LENGTH);
+  frame.insert(frame.end(), kControllerUID, kControllerUID + UID_LENGTH);
+  frame.push_back(0u);  // transaction number
+  frame.push_back(1u);  // port id
+  frame.push_back(0u);  // message count
+  frame.push_back(0u);  // sub device
+  frame.push_back(0u);
+  frame.push_back(command_class);
+  frame.push_back(pid >> 8);
+  frame.push_back(pid & 0xff);
+  frame.push_back(param_data_size);
+  frame.insert(frame.end(), param_data, param_data + param_data_size);
+
+  uint16_t checksum = 0u;
+  for (unsigned int i = 0; i < frame.size(); i++) {
+    checksum += frame[i];
+  }
+  frame.push_back(checksum >> 8);
+  frame.push_back(checksum & 0xff);
+  frame.erase(frame.begin());
+  return frame;
+}
+
+std::vector<uint8_t> BuildDUB(const uint8_t *lower, const uint8_t *upper) {
+  uint8_t param_data[2 * UID_LENGTH];
+  memcpy(param_data, lower, UID_LENGTH);
+  memcpy(param_data + UID_LENGTH, upper, UID_LENGTH);
+  return BuildRequest(kBroadcastUID, DISCOVERY_COMMAND, PID_DISC_UNIQUE_BRANCH,
+                      param_data, sizeof(param_data));
+}
+
+bool HasEvent() {
+  return !g_events.empty();
+}
+
+// The frames received in responder mode.
+std::vector<std::vector<uint8_t> > g_frames;
+
+bool RecordFrame(const TransceiverEvent *event) {
+  if (event->result == T_RESULT_RX_START_FRAME) {
+    g_frames.push_back(std::vector<uint8_t>());
+  }
+  if ((event->result == T_RESULT_RX_START_FRAME ||
+       event->result == T_RESULT_RX_CONTINUE_FRAME) && !g_frames.empty()) {
+    g_frames.back().assign(event->data, event->data + event->length);
+  }
+  return true;
+}
+
+/*
+ * Send DMX frames to a transceiver in responder mode.
+ * @returns The number of ISR calls per frame.
+ */
+double ReceiveDMXFrames(TransceiverSimulator *simulator,
+                        unsigned int frame_count) {
+  simulator->InitializeResponder(RecordFrame);
+  unsigned int isr_calls = simulator->ISRCalls();
+
+  for (unsigned int i = 0; i < frame_count; i++) {
+    uint8_t frame[DMX_FRAME_SIZE + 1];
+    frame[0] = NULL_START_CODE;
+    for (unsigned int j = 1; j < sizeof(frame); j++) {
+      frame[j] = (i + j) & 0xff;
+    }
+    simulator->SendFrame(frame, sizeof(frame));
+  }
+  simulator->RunUntil([simulator]() { return simulator->ControllerIdle(); },
+                      kTimeout);
+  simulator->Run(1000u);
+  return static_cast<double>(simulator->ISRCalls() - isr_calls) / frame_count;
+}
+
+}  // namespace
+
+class TransceiverSimulatorTest : public testing::Test {
+ public:
+  void SetUp() {
+    g_events.clear();
+    g_frames.clear();
+  }
+};
+
+TEST_F(TransceiverSimulatorTest, dmxFrame) {
+  TransceiverSimulator simulator;
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+
+  const uint8_t dmx[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_TRUE(Transceiver_QueueDMX(1, dmx, sizeof(dmx)));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(1, g_events[0].token);
+  EXPECT_EQ(T_OP_TX_ONLY, g_events[0].op);
+  EXPECT_EQ(T_RESULT_TX_OK, g_events[0].result);
+
+  // Let the responder time out the frame.
+  simulator.Run(3000u);
+  ASSERT_EQ(1u, responder.FrameCount());
+  const std::vector<uint8_t> &frame = responder.LastFrame();
+  ASSERT_EQ(sizeof(dmx) + 1u, frame.size());
+  EXPECT_EQ(NULL_START_CODE, frame[0]);
+  EXPECT_TRUE(std::equal(dmx, dmx + sizeof(dmx), frame.begin() + 1));
+
+  EXPECT_NEAR(176u, responder.LastBreak(), 2u);
+  EXPECT_NEAR(12u, responder.LastMark(), 2u);
+  EXPECT_EQ(0u, simulator.CollisionTime());
+}
+
+TEST_F(TransceiverSimulatorTest, getWithResponse) {
+  TransceiverSimulator simulator;
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+
+  std::vector<uint8_t> request = BuildRequest(kResponderUID, GET_COMMAND,
+                                              kDeviceInfoPID, NULL, 0u);
+  EXPECT_TRUE(Transceiver_QueueRDMRequest(2, request.data(), request.size(),
+                                          false));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(2, g_events[0].token);
+  EXPECT_EQ(T_OP_RDM_WITH_RESPONSE, g_events[0].op);
+  EXPECT_EQ(T_RESULT_RX_DATA, g_events[0].result);
+  ASSERT_EQ(RDM_PARAM_DATA_OFFSET + RDM_CHECKSUM_LENGTH,
+            g_events[0].data.size());
+  EXPECT_EQ(RDM_START_CODE, g_events[0].data[0]);
+  EXPECT_EQ(GET_COMMAND_RESPONSE, g_events[0].data[20]);
+  EXPECT_EQ(1u, responder.ResponseCount());
+
+  // The responder waited for its turnaround time.
+  EXPECT_NEAR(176u,
+              simulator.LastResponseStart() - simulator.LastTurnaround(), 2u);
+  EXPECT_EQ(0u, simulator.CollisionTime());
+}
+
+TEST_F(TransceiverSimulatorTest, getWithTimeout) {
+  TransceiverSimulator simulator;
+  simulator.Initialize(RecordEvent);
+
+  std::vector<uint8_t> request = BuildRequest(kResponderUID, GET_COMMAND,
+                                              kDeviceInfoPID, NULL, 0u);
+  EXPECT_TRUE(Transceiver_QueueRDMRequest(3, request.data(), request.size(),
+                                          false));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(3, g_events[0].token);
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT, g_events[0].result);
+}
+
+TEST_F(TransceiverSimulatorTest, broadcast) {
+  TransceiverSimulator simulator;
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+
+  std::vector<uint8_t> request = BuildRequest(kBroadcastUID, SET_COMMAND,
+                                              kDeviceInfoPID, NULL, 0u);
+  EXPECT_TRUE(Transceiver_QueueRDMRequest(4, request.data(), request.size(),
+                                          true));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(T_OP_RDM_BROADCAST, g_events[0].op);
+  EXPECT_EQ(T_RESULT_RX_TIMEOUT, g_events[0].result);
+  EXPECT_EQ(1u, responder.FrameCount());
+  EXPECT_EQ(0u, responder.ResponseCount());
+}
+
+TEST_F(TransceiverSimulatorTest, dubSingleResponder) {
+  TransceiverSimulator simulator;
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+
+  const uint8_t lower[] = {0, 0, 0, 0, 0, 0};
+  std::vector<uint8_t> dub = BuildDUB(lower, kBroadcastUID);
+  EXPECT_TRUE(Transceiver_QueueRDMDUB(5, dub.data(), dub.size()));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(T_OP_RDM_DUB, g_events[0].op);
+  EXPECT_EQ(T_RESULT_RX_DATA, g_events[0].result);
+  ASSERT_EQ(24u, g_events[0].data.size());
+  EXPECT_EQ(0xfe, g_events[0].data[0]);
+  EXPECT_EQ(0xaa, g_events[0].data[7]);
+  EXPECT_EQ(0u, simulator.CollisionTime());
+}
+
+TEST_F(TransceiverSimulatorTest, dubCollision) {
+  TransceiverSimulator simulator;
+  SimulatedResponder responder1(kResponderUID);
+  SimulatedResponder responder2(kOtherResponderUID);
+  simulator.AddResponder(&responder1);
+  simulator.AddResponder(&responder2);
+  simulator.Initialize(RecordEvent);
+
+  const uint8_t lower[] = {0, 0, 0, 0, 0, 0};
+  std::vector<uint8_t> dub = BuildDUB(lower, kBroadcastUID);
+  EXPECT_TRUE(Transceiver_QueueRDMDUB(6, dub.data(), dub.size()));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(T_RESULT_RX_DATA, g_events[0].result);
+  EXPECT_EQ(1u, responder1.ResponseCount());
+  EXPECT_EQ(1u, responder2.ResponseCount());
+  EXPECT_LT(0u, simulator.CollisionTime());
+
+  // Mute the first responder, only the second should reply.
+  g_events.clear();
+  std::vector<uint8_t> mute = BuildRequest(kResponderUID, DISCOVERY_COMMAND,
+                                           PID_DISC_MUTE, NULL, 0u);
+  EXPECT_TRUE(Transceiver_QueueRDMRequest(7, mute.data(), mute.size(),
+                                          false));
+  EXPECT_TRUE(Transceiver_QueueRDMDUB(8, dub.data(), dub.size()));
+  EXPECT_TRUE(simulator.RunUntil([]() { return g_events.size() == 2u; },
+                                 kTimeout));
+  EXPECT_TRUE(responder1.IsMuted());
+  EXPECT_EQ(T_RESULT_RX_DATA, g_events[0].result);
+  EXPECT_EQ(T_RESULT_RX_DATA, g_events[1].result);
+  // The first responder sent the DUB & mute responses.
+  EXPECT_EQ(2u, responder1.ResponseCount());
+  EXPECT_EQ(2u, responder2.ResponseCount());
+}
+
+TEST_F(TransceiverSimulatorTest, dmxFrameWithDMA) {
+  uint8_t dmx[DMX_FRAME_SIZE];
+  for (unsigned int i = 0; i < DMX_FRAME_SIZE; i++) {
+    dmx[i] = i & 0xff;
+  }
+
+  unsigned int isr_calls = 0u;
+  {
+    TransceiverSimulator simulator;
+    SimulatedResponder responder(kResponderUID);
+    simulator.AddResponder(&responder);
+    simulator.Initialize(RecordEvent);
+    isr_calls = simulator.ISRCalls();
+
+    EXPECT_TRUE(Transceiver_QueueDMX(1, dmx, sizeof(dmx)));
+    EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+    isr_calls = simulator.ISRCalls() - isr_calls;
+  }
+
+  g_events.clear();
+  TransceiverSimulator::Options options;
+  options.use_tx_dma = true;
+  TransceiverSimulator simulator(options);
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+  unsigned int dma_isr_calls = simulator.ISRCalls();
+
+  EXPECT_TRUE(Transceiver_QueueDMX(1, dmx, sizeof(dmx)));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+  dma_isr_calls = simulator.ISRCalls() - dma_isr_calls;
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(T_RESULT_TX_OK, g_events[0].result);
+
+  simulator.Run(3000u);
+  ASSERT_EQ(1u, responder.FrameCount());
+  const std::vector<uint8_t> &frame = responder.LastFrame();
+  ASSERT_EQ(sizeof(dmx) + 1u, frame.size());
+  EXPECT_EQ(NULL_START_CODE, frame[0]);
+  EXPECT_TRUE(std::equal(dmx, dmx + sizeof(dmx), frame.begin() + 1));
+  EXPECT_NEAR(12u, responder.LastMark(), 2u);
+
+  // Break, mark, a DMA complete for each 256 byte block & drain.
+  EXPECT_EQ(6u, dma_isr_calls);
+  // Without DMA, there is an interrupt each time the TX FIFO empties.
+  EXPECT_LT(DMX_FRAME_SIZE / TransceiverSimulator::Options().tx_fifo_depth,
+            isr_calls);
+}
+
+TEST_F(TransceiverSimulatorTest, dmxFrameWithDMABlocks) {
+  // The frame sizes around the 256 byte DMA block limit, including the start
+  // code.
+  const unsigned int kSizes[] = {255u, 256u, 257u, 300u};
+
+  TransceiverSimulator::Options options;
+  options.use_tx_dma = true;
+  TransceiverSimulator simulator(options);
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+
+  for (unsigned int i = 0; i < arraysize(kSizes); i++) {
+    const unsigned int size = kSizes[i] - 1u;
+    std::vector<uint8_t> dmx(size);
+    for (unsigned int j = 0; j < size; j++) {
+      dmx[j] = (i + j) & 0xff;
+    }
+
+    g_events.clear();
+    EXPECT_TRUE(Transceiver_QueueDMX(1, dmx.data(), size));
+    EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+    ASSERT_EQ(1u, g_events.size());
+    EXPECT_EQ(T_RESULT_TX_OK, g_events[0].result);
+
+    simulator.Run(3000u);
+    ASSERT_EQ(i + 1u, responder.FrameCount());
+    const std::vector<uint8_t> &frame = responder.LastFrame();
+    ASSERT_EQ(kSizes[i], frame.size());
+    EXPECT_EQ(NULL_START_CODE, frame[0]);
+    EXPECT_TRUE(std::equal(dmx.begin(), dmx.end(), frame.begin() + 1));
+  }
+}
+
+TEST_F(TransceiverSimulatorTest, getWithResponseWithDMA) {
+  TransceiverSimulator::Options options;
+  options.use_tx_dma = true;
+  TransceiverSimulator simulator(options);
+  SimulatedResponder responder(kResponderUID);
+  simulator.AddResponder(&responder);
+  simulator.Initialize(RecordEvent);
+
+  std::vector<uint8_t> request = BuildRequest(kResponderUID, GET_COMMAND,
+                                              kDeviceInfoPID, NULL, 0u);
+  EXPECT_TRUE(Transceiver_QueueRDMRequest(2, request.data(), request.size(),
+                                          false));
+  EXPECT_TRUE(simulator.RunUntil(HasEvent, kTimeout));
+
+  ASSERT_EQ(1u, g_events.size());
+  EXPECT_EQ(T_RESULT_RX_DATA, g_events[0].result);
+  EXPECT_EQ(1u, responder.ResponseCount());
+  EXPECT_EQ(GET_COMMAND_RESPONSE, g_events[0].data[20]);
+  EXPECT_EQ(0u, simulator.CollisionTime());
+}
+
+TEST_F(TransceiverSimulatorTest, responderDMXFrames) {
+  const unsigned int kFrameCount = 4u;
+  double isr_calls = 0.0;
+  {
+    TransceiverSimulator simulator;
+    isr_calls = ReceiveDMXFrames(&simulator, kFrameCount);
+  }
+
+  g_frames.clear();
+  TransceiverSimulator::Options options;
+  options.use_rx_dma = true;
+  TransceiverSimulator simulator(options);
+  double dma_isr_calls = ReceiveDMXFrames(&simulator, kFrameCount);
+
+  // The last frame isn't complete until the next break or the inter-slot
+  // timeout.
+  ASSERT_EQ(kFrameCount - 1u, g_frames.size());
+  for (unsigned int i = 0; i < g_frames.size(); i++) {
+    const std::vector<uint8_t> &frame = g_frames[i];
+    ASSERT_EQ(DMX_FRAME_SIZE + 1u, frame.size());
+    EXPECT_EQ(NULL_START_CODE, frame[0]);
+    for (unsigned int j = 1; j < frame.size(); j++) {
+      EXPECT_EQ((i + j) & 0xff, frame[j]);
+    }
+  }
+  EXPECT_EQ(0u, simulator.RXOverruns());
+
+  // The end of the break, the mark, one per 256 byte DMA block & the framing
+  // error from the next break.
+  EXPECT_GE(7.0, dma_isr_calls);
+  // Without DMA, input capture interrupts on each edge & the USART on each
+  // slot.
+  EXPECT_LT(DMX_FRAME_SIZE, isr_calls);
+}
+
+TEST_F(TransceiverSimulatorTest, responderRDMWithDMA) {
+  TransceiverSimulator::Options options;
+  options.use_rx_dma = true;
+  TransceiverSimulator simulator(options);
+  simulator.InitializeResponder(RecordFrame);
+
+  std::vector<uint8_t> request = BuildRequest(kResponderUID, GET_COMMAND,
+                                              kDeviceInfoPID, NULL, 0u);
+  request.insert(request.begin(), RDM_START_CODE);
+  simulator.SendFrame(request.data(), request.size());
+  simulator.RunUntil([&simulator]() { return simulator.ControllerIdle(); },
+                     kTimeout);
+  simulator.Run(5000u);
+
+  // RDM requests are received a slot at a time.
+  ASSERT_EQ(1u, g_frames.size());
+  EXPECT_EQ(request, g_frames[0]);
+}
+
+class LatestDMXFrameTest
+    : public TransceiverSimulatorTest,
+      public testing::WithParamInterface<bool> {
+};
+
+TEST_P(LatestDMXFrameTest, publishCompleteFrames) {
+  TransceiverSimulator::Options options;
+  options.use_rx_dma = GetParam();
+  TransceiverSimulator simulator(options);
+  simulator.InitializeResponder(NULL);
+
+  TransceiverDMXFrame frame;
+  EXPECT_FALSE(Transceiver_GetLatestDMXFrame(&frame));
+
+  std::vector<uint8_t> first(25u, 0x11);
+  first[0] = NULL_START_CODE;
+  std::vector<uint8_t> second(DMX_FRAME_SIZE + 1u, 0x22);
+  second[0] = NULL_START_CODE;
+  // The break of the alternate start code frame completes the DMX frame
+  // before it.
+  const uint8_t asc[] = {0x17, 1, 2, 3};
+
+  simulator.SendFrame(first.data(), first.size());
+  simulator.SendFrame(second.data(), second.size());
+  simulator.SendFrame(asc, sizeof(asc));
+  simulator.RunUntil([&simulator]() { return simulator.ControllerIdle(); },
+                     kTimeout);
+  simulator.Run(1000u);
+
+  ASSERT_TRUE(Transceiver_GetLatestDMXFrame(&frame));
+  ASSERT_EQ(DMX_FRAME_SIZE, frame.size);
+  EXPECT_TRUE(std::equal(second.begin() + 1, second.end(), frame.data));
+  const uint32_t sequence = frame.sequence;
+  const uint8_t *data = frame.data;
+
+  // Publishing another frame doesn't touch the one the reader holds.
+  std::vector<uint8_t> third(13u, 0x33);
+  third[0] = NULL_START_CODE;
+  simulator.SendFrame(third.data(), third.size());
+  simulator.SendFrame(asc, sizeof(asc));
+  simulator.RunUntil([&simulator]() { return simulator.ControllerIdle(); },
+                     kTimeout);
+  simulator.Run(1000u);
+  EXPECT_TRUE(std::equal(second.begin() + 1, second.end(), data));
+
+  ASSERT_TRUE(Transceiver_GetLatestDMXFrame(&frame));
+  EXPECT_LT(sequence, frame.sequence);
+  ASSERT_EQ(third.size() - 1u, frame.size);
+  EXPECT_TRUE(std::equal(third.begin() + 1, third.end(), frame.data));
+
+  // Nothing new, so the same frame is returned.
+  TransceiverDMXFrame again;
+  ASSERT_TRUE(Transceiver_GetLatestDMXFrame(&again));
+  EXPECT_EQ(frame.sequence, again.sequence);
+  EXPECT_EQ(frame.data, again.data);
+}
+
+INSTANTIATE_TEST_CASE_P(RXDMA, LatestDMXFrameTest, testing::Bool());
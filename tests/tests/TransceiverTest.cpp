@@ -22,6 +22,9 @@
 #include <gtest/gtest.h>
 
 #include "Array.h"
+#include "app_settings.h"
+#include "plib_dma_mock.h"
+#include "sys/kmem.h"
 #include "transceiver.h"
 #include "setting_macros.h"
 
@@ -56,6 +59,16 @@ class TransceiverTest : public testing::Test {
       .timer_vector = AS_TIMER_INTERRUPT_VECTOR(3),
       .timer_source = AS_TIMER_INTERRUPT_SOURCE(3),
       .input_capture_timer = AS_IC_TMR_ID(3),
+      .use_tx_dma = false,
+      .tx_dma_channel = AS_DMA_CHANNEL(0),
+      .tx_dma_trigger = AS_USART_DMA_TX_TRIGGER(1),
+      .tx_dma_vector = AS_DMA_INTERRUPT_VECTOR(0),
+      .tx_dma_source = AS_DMA_INTERRUPT_SOURCE(0),
+      .use_rx_dma = false,
+      .rx_dma_channel = AS_DMA_CHANNEL(1),
+      .rx_dma_trigger = AS_USART_DMA_RX_TRIGGER(1),
+      .rx_dma_vector = AS_DMA_INTERRUPT_VECTOR(1),
+      .rx_dma_source = AS_DMA_INTERRUPT_SOURCE(1),
     };
     return settings;
   }
@@ -66,6 +79,77 @@ TEST_F(TransceiverTest, testUnsetTransceiver) {
   Transceiver_Initialize(&settings, NULL, NULL);
 }
 
+TEST_F(TransceiverTest, testTXDMAInitialization) {
+  StrictMock<MockPeripheralDMA> dma_mock;
+  PLIB_DMA_SetMock(&dma_mock);
+
+  TransceiverHardwareSettings settings = DefaultSettings();
+  settings.use_tx_dma = true;
+  settings.tx_dma_channel = AS_DMA_CHANNEL(2);
+  settings.tx_dma_trigger = AS_USART_DMA_TX_TRIGGER(1);
+  settings.tx_dma_vector = AS_DMA_INTERRUPT_VECTOR(2);
+  settings.tx_dma_source = AS_DMA_INTERRUPT_SOURCE(2);
+
+  // Without a USART mock the TX register address is NULL.
+  EXPECT_CALL(dma_mock, Enable(DMA_ID_0));
+  EXPECT_CALL(dma_mock, ChannelXDisable(DMA_ID_0, DMA_CHANNEL_2));
+  EXPECT_CALL(dma_mock, ChannelXPrioritySelect(DMA_ID_0, DMA_CHANNEL_2, _));
+  EXPECT_CALL(dma_mock, ChannelXStartIRQSet(DMA_ID_0, DMA_CHANNEL_2,
+                                            DMA_TRIGGER_USART_1_TRANSMIT));
+  EXPECT_CALL(dma_mock, ChannelXTriggerEnable(
+      DMA_ID_0, DMA_CHANNEL_2, DMA_CHANNEL_TRIGGER_TRANSFER_START));
+  EXPECT_CALL(dma_mock, ChannelXDestinationStartAddressSet(
+      DMA_ID_0, DMA_CHANNEL_2, KVA_TO_PA(NULL)));
+  EXPECT_CALL(dma_mock, ChannelXDestinationSizeSet(DMA_ID_0, DMA_CHANNEL_2,
+                                                   1u));
+  EXPECT_CALL(dma_mock, ChannelXCellSizeSet(DMA_ID_0, DMA_CHANNEL_2, 1u));
+  EXPECT_CALL(dma_mock, ChannelXINTSourceEnable(
+      DMA_ID_0, DMA_CHANNEL_2, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  Transceiver_Initialize(&settings, NULL, NULL);
+
+  // Switching modes aborts any transfer in progress.
+  EXPECT_CALL(dma_mock, ChannelXDisable(DMA_ID_0, DMA_CHANNEL_2));
+  Transceiver_Tasks();
+
+  PLIB_DMA_SetMock(NULL);
+}
+
+TEST_F(TransceiverTest, testRXDMAInitialization) {
+  StrictMock<MockPeripheralDMA> dma_mock;
+  PLIB_DMA_SetMock(&dma_mock);
+
+  TransceiverHardwareSettings settings = DefaultSettings();
+  settings.use_rx_dma = true;
+  settings.rx_dma_channel = AS_DMA_CHANNEL(3);
+  settings.rx_dma_trigger = AS_USART_DMA_RX_TRIGGER(1);
+
+  // Without a USART mock the RX register address is NULL.
+  EXPECT_CALL(dma_mock, Enable(DMA_ID_0));
+  EXPECT_CALL(dma_mock, ChannelXDisable(DMA_ID_0, DMA_CHANNEL_3));
+  EXPECT_CALL(dma_mock, ChannelXPrioritySelect(DMA_ID_0, DMA_CHANNEL_3, _));
+  EXPECT_CALL(dma_mock, ChannelXStartIRQSet(DMA_ID_0, DMA_CHANNEL_3,
+                                            DMA_TRIGGER_USART_1_RECEIVE));
+  EXPECT_CALL(dma_mock, ChannelXTriggerEnable(
+      DMA_ID_0, DMA_CHANNEL_3, DMA_CHANNEL_TRIGGER_TRANSFER_START));
+  EXPECT_CALL(dma_mock, ChannelXSourceStartAddressSet(
+      DMA_ID_0, DMA_CHANNEL_3, KVA_TO_PA(NULL)));
+  EXPECT_CALL(dma_mock, ChannelXSourceSizeSet(DMA_ID_0, DMA_CHANNEL_3, 1u));
+  EXPECT_CALL(dma_mock, ChannelXCellSizeSet(DMA_ID_0, DMA_CHANNEL_3, 1u));
+  EXPECT_CALL(dma_mock, ChannelXINTSourceEnable(
+      DMA_ID_0, DMA_CHANNEL_3, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  Transceiver_Initialize(&settings, NULL, NULL);
+
+  // Entering responder mode stops the channel.
+  EXPECT_CALL(dma_mock, ChannelXDisable(DMA_ID_0, DMA_CHANNEL_3));
+  EXPECT_CALL(dma_mock, ChannelXINTSourceFlagGet(
+      DMA_ID_0, DMA_CHANNEL_3, DMA_INT_BLOCK_TRANSFER_COMPLETE));
+  EXPECT_CALL(dma_mock, ChannelXDestinationPointerGet(DMA_ID_0,
+                                                      DMA_CHANNEL_3));
+  Transceiver_Tasks();
+
+  PLIB_DMA_SetMock(NULL);
+}
+
 TEST_F(TransceiverTest, testSetBreakTime) {
   TransceiverHardwareSettings settings = DefaultSettings();
   Transceiver_Initialize(&settings, NULL, NULL);
@@ -177,3 +261,68 @@ TEST_F(TransceiverTest, testSetResponderJitter) {
   EXPECT_EQ(11000, Transceiver_GetRDMResponderDelay());
   EXPECT_EQ(9000, Transceiver_GetRDMResponderJitter());
 }
+
+TEST_F(TransceiverTest, testQueueDepth) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(&settings, NULL, NULL);
+
+  // Frames can't be queued in responder mode.
+  const uint8_t dmx[] = {1, 2, 3, 4};
+  EXPECT_FALSE(Transceiver_QueueDMX(1, dmx, arraysize(dmx)));
+
+  const uint8_t response[] = {0xcc, 1, 2, 3};
+  IOVec iov = {response, arraysize(response)};
+  for (unsigned int i = 0; i < TRANSCEIVER_QUEUE_DEPTH; i++) {
+    EXPECT_TRUE(Transceiver_QueueRDMResponse(true, &iov, 1));
+  }
+  EXPECT_FALSE(Transceiver_QueueRDMResponse(true, &iov, 1));
+
+  // Resetting discards the queued frames.
+  Transceiver_Reset();
+  EXPECT_TRUE(Transceiver_QueueRDMResponse(true, &iov, 1));
+}
+
+TEST_F(TransceiverTest, testSetDMXRefreshInterval) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(&settings, NULL, NULL);
+
+  EXPECT_EQ(227, Transceiver_GetDMXRefreshInterval());
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(0));
+  EXPECT_EQ(0, Transceiver_GetDMXRefreshInterval());
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(10000));
+  EXPECT_EQ(10000, Transceiver_GetDMXRefreshInterval());
+  EXPECT_FALSE(Transceiver_SetDMXRefreshInterval(10001));
+  EXPECT_EQ(10000, Transceiver_GetDMXRefreshInterval());
+}
+
+TEST_F(TransceiverTest, testDMXStream) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(&settings, NULL, NULL);
+  EXPECT_FALSE(Transceiver_IsDMXStreamEnabled());
+  EXPECT_EQ(0u, Transceiver_GetDMXStreamSize());
+
+  uint8_t dmx[513];
+  memset(dmx, 0, arraysize(dmx));
+  EXPECT_FALSE(Transceiver_StartDMXStream(dmx, arraysize(dmx)));
+  EXPECT_FALSE(Transceiver_IsDMXStreamEnabled());
+
+  EXPECT_TRUE(Transceiver_StartDMXStream(dmx, 512));
+  EXPECT_TRUE(Transceiver_IsDMXStreamEnabled());
+  Transceiver_StopDMXStream();
+  EXPECT_FALSE(Transceiver_IsDMXStreamEnabled());
+
+  // Updates must be within the loaded slots.
+  const uint8_t update[] = {255, 255};
+  EXPECT_TRUE(Transceiver_UpdateDMXStream(0, update, arraysize(update)));
+  EXPECT_TRUE(Transceiver_UpdateDMXStream(510, update, arraysize(update)));
+  EXPECT_FALSE(Transceiver_UpdateDMXStream(511, update, arraysize(update)));
+  EXPECT_TRUE(Transceiver_StartDMXStream(dmx, 24));
+  EXPECT_EQ(24u, Transceiver_GetDMXStreamSize());
+  EXPECT_TRUE(Transceiver_UpdateDMXStream(22, update, arraysize(update)));
+  EXPECT_FALSE(Transceiver_UpdateDMXStream(23, update, arraysize(update)));
+
+  // The stream is stopped by a reset.
+  EXPECT_TRUE(Transceiver_StartDMXStream(dmx, 24));
+  Transceiver_Reset();
+  EXPECT_FALSE(Transceiver_IsDMXStreamEnabled());
+}
@@ -29,11 +29,13 @@
 #include "Matchers.h"
 #include "ResetMock.h"
 #include "StreamDecoderMock.h"
+#include "app_settings.h"
 #include "flags.h"
 #include "usb_device_mock.h"
 #include "usb_transport.h"
 
 using ::testing::Args;
+using ::testing::DoAll;
 using ::testing::InSequence;
 using ::testing::Mock;
 using ::testing::NotNull;
@@ -52,6 +54,7 @@ class USBTransportTest : public testing::Test {
     StreamDecoder_SetMock(&m_stream_decoder_mock);
     BootloaderOptions_SetMock(&m_bootloader_options_mock);
     Reset_SetMock(&m_reset_mock);
+    Flags_Initialize(nullptr);
   }
 
   void TearDown() {
@@ -334,6 +337,103 @@ TEST_F(USBTransportTest, read) {
   USBTransport_Tasks();
 }
 
+/*
+ * Check the next read is armed with the other buffer before the data is
+ * decoded.
+ */
+TEST_F(USBTransportTest, doubleBufferedRead) {
+  const uint8_t packet1[] = {1, 2, 3, 4, 5};
+  const uint8_t packet2[] = {6, 7, 8, 9};
+
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+  void *first_buffer = m_read_buffer;
+
+  InSequence seq;
+  EXPECT_CALL(m_usb_mock, EndpointRead(m_usb_handle, _, 1, _, _))
+    .WillOnce(DoAll(SaveArg<3>(&m_read_buffer),
+                    Return(USB_DEVICE_RESULT_OK)));
+  EXPECT_CALL(m_stream_decoder_mock, Process(_, _))
+      .With(Args<0, 1>(DataIs(packet1, arraysize(packet1))));
+
+  memcpy(reinterpret_cast<uint8_t*>(m_read_buffer), packet1,
+         arraysize(packet1));
+  USB_DEVICE_EVENT_DATA_ENDPOINT_READ_COMPLETE read_complete = {
+    .transferHandle = 0,
+    .length = arraysize(packet1)
+  };
+  m_event_handler(USB_DEVICE_EVENT_ENDPOINT_READ_COMPLETE,
+                  reinterpret_cast<void*>(&read_complete),
+                  sizeof(read_complete));
+  USBTransport_Tasks();
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+  Mock::VerifyAndClearExpectations(&m_stream_decoder_mock);
+
+  // The second read uses a different buffer
+  void *second_buffer = m_read_buffer;
+  EXPECT_NE(first_buffer, second_buffer);
+
+  EXPECT_CALL(m_usb_mock, EndpointRead(m_usb_handle, _, 1, _, _))
+    .WillOnce(DoAll(SaveArg<3>(&m_read_buffer),
+                    Return(USB_DEVICE_RESULT_OK)));
+  EXPECT_CALL(m_stream_decoder_mock, Process(_, _))
+      .With(Args<0, 1>(DataIs(packet2, arraysize(packet2))));
+
+  memcpy(reinterpret_cast<uint8_t*>(m_read_buffer), packet2,
+         arraysize(packet2));
+  read_complete.length = arraysize(packet2);
+  m_event_handler(USB_DEVICE_EVENT_ENDPOINT_READ_COMPLETE,
+                  reinterpret_cast<void*>(&read_complete),
+                  sizeof(read_complete));
+  USBTransport_Tasks();
+  EXPECT_EQ(first_buffer, m_read_buffer);
+}
+
+/*
+ * Check the next read is armed even if we can't decode the data yet.
+ */
+TEST_F(USBTransportTest, readWhileTXQueueFull) {
+  const uint8_t packet[] = {1, 2, 3, 4, 5};
+
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  // Fill the TX queue. The responses are too large to share a frame.
+  uint8_t payload[300];
+  memset(payload, 0, arraysize(payload));
+  IOVec iovec = { payload, arraysize(payload) };
+
+  EXPECT_CALL(m_usb_mock, EndpointWrite(m_usb_handle, _, 0x81, _, _, _))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  for (unsigned int i = 0; i < USB_TRANSPORT_TX_QUEUE_SIZE; i++) {
+    EXPECT_TRUE(
+        USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, &iovec, 1));
+  }
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  EXPECT_CALL(m_usb_mock, EndpointRead(m_usb_handle, _, 1, _, _))
+    .WillOnce(Return(USB_DEVICE_RESULT_OK));
+
+  memcpy(reinterpret_cast<uint8_t*>(m_read_buffer), packet, arraysize(packet));
+  USB_DEVICE_EVENT_DATA_ENDPOINT_READ_COMPLETE read_complete = {
+    .transferHandle = 0,
+    .length = arraysize(packet)
+  };
+  m_event_handler(USB_DEVICE_EVENT_ENDPOINT_READ_COMPLETE,
+                  reinterpret_cast<void*>(&read_complete),
+                  sizeof(read_complete));
+  USBTransport_Tasks();
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  // Once a write completes, the pending data is decoded.
+  EXPECT_CALL(m_usb_mock, EndpointWrite(m_usb_handle, _, 0x81, _, _, _))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  EXPECT_CALL(m_stream_decoder_mock, Process(_, _))
+      .With(Args<0, 1>(DataIs(packet, arraysize(packet))));
+  CompleteWrite();
+  USBTransport_Tasks();
+}
+
 /*
  * Check sending messages to the Host works.
  */
@@ -365,27 +465,99 @@ TEST_F(USBTransportTest, sendResponse) {
   EXPECT_FALSE(USBTransport_WritePending());
 }
 
-TEST_F(USBTransportTest, doubleSendResponse) {
+TEST_F(USBTransportTest, queuedSendResponse) {
   USBTransport_Initialize(StreamDecoder_Process);
   ConfigureDevice();
 
-  const uint8_t expected_message[] = {
+  const uint8_t expected_message1[] = {
     0x5a, kToken, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa5
   };
+  // The responses queued while the first is pending are sent as a single
+  // transfer.
+  const uint8_t expected_message2[] = {
+    0x5a, kToken + 1, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa5,
+    0x5a, kToken + 2, 0xf0, 0x00, 0x02, 0x00, 0x00, 0x00, 1, 2, 0xa5,
+    0x5a, kToken + 3, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa5
+  };
 
   EXPECT_CALL(
       m_usb_mock,
       EndpointWrite(m_usb_handle, _, 0x81, _, _,
                     USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
-      .With(Args<3, 4>(DataIs(expected_message, arraysize(expected_message))))
+      .With(Args<3, 4>(DataIs(expected_message1,
+                              arraysize(expected_message1))))
       .WillOnce(Return(USB_DEVICE_RESULT_OK));
 
   EXPECT_TRUE(USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
-  // Try to send a second message while the first is pending.
-  EXPECT_FALSE(
+
+  const uint8_t payload[] = {1, 2};
+  IOVec iovec = { payload, arraysize(payload) };
+  EXPECT_TRUE(
       USBTransport_SendResponse(kToken + 1, COMMAND_ECHO, RC_OK, NULL, 0));
+  EXPECT_TRUE(
+      USBTransport_SendResponse(kToken + 2, COMMAND_ECHO, RC_OK, &iovec, 1));
+  EXPECT_TRUE(
+      USBTransport_SendResponse(kToken + 3, COMMAND_ECHO, RC_OK, NULL, 0));
+  EXPECT_TRUE(USBTransport_WritePending());
+  EXPECT_EQ(0u, USBTransport_DroppedResponses());
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  // Nothing is sent until the first write completes.
+  USBTransport_Tasks();
+
+  CompleteWrite();
   EXPECT_TRUE(USBTransport_WritePending());
 
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .With(Args<3, 4>(DataIs(expected_message2,
+                              arraysize(expected_message2))))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  USBTransport_Tasks();
+  EXPECT_TRUE(USBTransport_WritePending());
+
+  CompleteWrite();
+  EXPECT_FALSE(USBTransport_WritePending());
+}
+
+TEST_F(USBTransportTest, queueFull) {
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  // Two of these don't fit in a single frame.
+  uint8_t payload[300];
+  memset(payload, 0, arraysize(payload));
+  IOVec iovec = { payload, arraysize(payload) };
+
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, 309,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+
+  EXPECT_TRUE(
+      USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, &iovec, 1));
+  EXPECT_TRUE(
+      USBTransport_SendResponse(kToken + 1, COMMAND_ECHO, RC_OK, &iovec, 1));
+  EXPECT_EQ(0u, USBTransport_DroppedResponses());
+
+  // The queue is now full, so the third message is dropped.
+  EXPECT_FALSE(
+      USBTransport_SendResponse(kToken + 2, COMMAND_ECHO, RC_OK, &iovec, 1));
+  EXPECT_EQ(1u, USBTransport_DroppedResponses());
+  EXPECT_TRUE(Flags_HasChanged());
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  CompleteWrite();
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, 309,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  USBTransport_Tasks();
+
   CompleteWrite();
   EXPECT_FALSE(USBTransport_WritePending());
 }
@@ -423,6 +595,147 @@ TEST_F(USBTransportTest, sendResponseWithData) {
   EXPECT_FALSE(USBTransport_WritePending());
 }
 
+TEST_F(USBTransportTest, sendPinnedResponse) {
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  const uint8_t timing[] = {1, 2, 3, 4};
+  uint8_t payload[200];
+  for (unsigned int i = 0; i < arraysize(payload); i++) {
+    payload[i] = i;
+  }
+
+  IOVec iovec[2] = {
+      { reinterpret_cast<const void*>(&timing), arraysize(timing) },
+      { reinterpret_cast<const void*>(&payload), arraysize(payload) }
+  };
+
+  // The header, the timing data and the start of the payload fill the first
+  // packet.
+  uint8_t expected_head[64] = {
+    0x5a, kToken, 0x41, 0x00, 0xcc, 0x00, 0x00, 0x00, 1, 2, 3, 4
+  };
+  memcpy(expected_head + 12, payload, 52);
+  uint8_t expected_tail[21];
+  memcpy(expected_tail, payload + 180, 20);
+  expected_tail[20] = 0xa5;
+
+  {
+    InSequence seq;
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                      USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING))
+        .With(Args<3, 4>(DataIs(expected_head, arraysize(expected_head))))
+        .WillOnce(Return(USB_DEVICE_RESULT_OK));
+    // The middle of the payload isn't copied.
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, payload + 52, 128,
+                      USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING))
+        .WillOnce(Return(USB_DEVICE_RESULT_OK));
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                      USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+        .With(Args<3, 4>(DataIs(expected_tail, arraysize(expected_tail))))
+        .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  }
+
+  EXPECT_TRUE(USBTransport_SendPinnedResponse(
+      kToken, COMMAND_RDM_REQUEST, RC_OK, iovec, arraysize(iovec)));
+  EXPECT_TRUE(USBTransport_IsPinned(payload));
+
+  // The payload stays pinned until all the writes complete.
+  CompleteWrite();
+  CompleteWrite();
+  EXPECT_TRUE(USBTransport_IsPinned(payload));
+  EXPECT_TRUE(USBTransport_WritePending());
+
+  CompleteWrite();
+  EXPECT_FALSE(USBTransport_IsPinned(payload));
+  EXPECT_FALSE(USBTransport_WritePending());
+}
+
+TEST_F(USBTransportTest, pinnedResponseWriteError) {
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  uint8_t payload[200];
+  memset(payload, 0, arraysize(payload));
+  IOVec iovec = { reinterpret_cast<const void*>(&payload), arraysize(payload) };
+
+  // The payload can't be written, so the transfer is ended with a zero length
+  // packet.
+  {
+    InSequence seq;
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, _, 64,
+                      USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING))
+        .WillOnce(Return(USB_DEVICE_RESULT_OK));
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, payload + 56, 128,
+                      USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING))
+        .WillOnce(Return(USB_DEVICE_RESULT_ERROR_TRANSFER_QUEUE_FULL));
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, _, 0,
+                      USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+        .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  }
+
+  EXPECT_FALSE(USBTransport_SendPinnedResponse(
+      kToken, COMMAND_RDM_REQUEST, RC_OK, &iovec, 1));
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  // The frame is retired once the header & the zero length packet complete.
+  EXPECT_TRUE(USBTransport_WritePending());
+  CompleteWrite();
+  EXPECT_TRUE(USBTransport_WritePending());
+  CompleteWrite();
+  EXPECT_FALSE(USBTransport_IsPinned(payload));
+  EXPECT_FALSE(USBTransport_WritePending());
+
+  // The next frame is a new transfer.
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  EXPECT_TRUE(USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
+}
+
+TEST_F(USBTransportTest, smallPinnedResponse) {
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  // Payloads less than a packet are copied.
+  const uint8_t payload[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  IOVec iovec = { reinterpret_cast<const void*>(&payload), arraysize(payload) };
+
+  const uint8_t expected_message[] = {
+    0x5a, kToken, 0x41, 0x00, 0x08, 0x00, 0x00, 0x00,
+    1, 2, 3, 4, 5, 6, 7, 8,
+    0xa5
+  };
+
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .With(Args<3, 4>(DataIs(expected_message, arraysize(expected_message))))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+
+  EXPECT_TRUE(USBTransport_SendPinnedResponse(
+      kToken, COMMAND_RDM_REQUEST, RC_OK, &iovec, 1));
+  EXPECT_FALSE(USBTransport_IsPinned(payload));
+
+  CompleteWrite();
+  EXPECT_FALSE(USBTransport_WritePending());
+}
+
 TEST_F(USBTransportTest, sendError) {
   USBTransport_Initialize(StreamDecoder_Process);
   ConfigureDevice();
@@ -7,10 +7,38 @@ tools_libdfu_la_SOURCES = tools/dfu.c \
 # Programs
 ##################################################
 noinst_PROGRAMS += tools/hex2dfu \
+                   tools/pidgen \
                    tools/uid2dfu
 
 tools_hex2dfu_SOURCES = tools/hex2dfu.c
 tools_hex2dfu_LDADD = tools/libdfu.la
 
+tools_pidgen_SOURCES = tools/pidgen.c
+tools_pidgen_LDADD = tools/libdfu.la
+
 tools_uid2dfu_SOURCES = tools/uid2dfu.c
 tools_uid2dfu_LDADD = tools/libdfu.la
+
+# Tests
+##################################################
+# The pidgen output is checked in, so check that pidgen works and that the
+# checked in headers match their .pids files.
+check-local: check-pidgen check-pid-tables
+
+check-pidgen: tools/pidgen
+	$(SHELL) $(srcdir)/tools/pidgen_test.sh tools/pidgen $(srcdir)
+
+check-pid-tables: tools/pidgen
+	@tmpdir=`mktemp -d` && \
+	  tools/pidgen -p $(srcdir)/firmware/src/rdm.h \
+	    -o $$tmpdir/moving_light_pids.h \
+	    $(srcdir)/firmware/src/moving_light.pids && \
+	  diff -u $(srcdir)/firmware/src/moving_light_pids.h \
+	    $$tmpdir/moving_light_pids.h; \
+	  status=$$?; rm -rf $$tmpdir; \
+	  if [ $$status -ne 0 ]; then \
+	    echo "moving_light_pids.h is out of date, re-run tools/pidgen"; \
+	  fi; \
+	  exit $$status
+
+.PHONY: check-pidgen check-pid-tables
@@ -0,0 +1,799 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * pidgen.c
+ * Generate the state struct & PID descriptor table for a RDM model.
+ * Copyright (C) 2015 Simon Newton.
+ */
+
+#include <ctype.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+#include "utils.h"
+
+enum { MAX_LINE_SIZE = 256 };
+enum { MAX_NAME_SIZE = 64 };
+enum { MAX_TOKENS = 8 };
+enum { MAX_PID_NAMES = 512 };
+enum { MAX_FIELDS = 64 };
+enum { MAX_PIDS = 128 };
+enum { MAX_PID_FILES = 8 };
+enum { MAX_INCLUDES = 8 };
+enum { MAX_STATE_SIZE = 256 };  // The field offsets are a uint8_t.
+
+static const char GENERATED_PREFIX = '@';
+static const char NO_HANDLER[] = "-";
+
+typedef struct {
+  const char *pid_files[MAX_PID_FILES];
+  unsigned int pid_file_count;
+  const char *output_file;
+  bool help;
+} Options;
+
+/*
+ * @brief A PID name & value, from a header file.
+ */
+typedef struct {
+  char name[MAX_NAME_SIZE];
+  uint16_t value;
+} PIDName;
+
+/*
+ * @brief A member of the model's state struct.
+ */
+typedef struct {
+  char type[MAX_NAME_SIZE];
+  char name[MAX_NAME_SIZE];
+  char min[MAX_NAME_SIZE];  // Empty if there is no lower bound.
+  char max[MAX_NAME_SIZE];  // Empty if there is no upper bound.
+  unsigned int size;
+  bool tracked;
+} Field;
+
+/*
+ * @brief An entry in the PID descriptor table.
+ */
+typedef struct {
+  char name[MAX_NAME_SIZE];
+  uint16_t value;
+  char get_handler[MAX_NAME_SIZE];
+  char get_param_size[MAX_NAME_SIZE];
+  char set_handler[MAX_NAME_SIZE];
+} PIDEntry;
+
+typedef struct {
+  char source[MAX_NAME_SIZE];
+  char prefix[MAX_NAME_SIZE];
+  char state_type[MAX_NAME_SIZE];
+  char state_variable[MAX_NAME_SIZE];
+  char defaults_field[MAX_NAME_SIZE];
+  char includes[MAX_INCLUDES][MAX_NAME_SIZE];
+  unsigned int include_count;
+  Field fields[MAX_FIELDS];
+  unsigned int field_count;
+  PIDEntry pids[MAX_PIDS];
+  unsigned int pid_count;
+} Table;
+
+static PIDName g_pid_names[MAX_PID_NAMES];
+static unsigned int g_pid_name_count = 0u;
+
+void DisplayHelpAndExit(const char *arg0, int exit_code) {
+  printf("Usage: %s [options] <table>\n", arg0);
+  printf("  -h, --help   Show the help message\n");
+  printf("  -o, --output Output file, defaults to stdout\n");
+  printf("  -p, --pids <file>  A header containing PID_ enum values, may be\n"
+         "                     repeated\n");
+  exit(exit_code);
+}
+
+bool InitOptions(Options *options, int argc, char *argv[]) {
+  options->pid_file_count = 0u;
+  options->output_file = NULL;
+  options->help = false;
+
+  static struct option long_options[] = {
+      {"help", no_argument, 0, 'h'},
+      {"output", required_argument, 0, 'o'},
+      {"pids", required_argument, 0, 'p'},
+      {0, 0, 0, 0}
+    };
+
+  int c;
+  int option_index = 0;
+
+  while (1) {
+    c = getopt_long(argc, argv, "ho:p:", long_options, &option_index);
+
+    if (c == -1)
+      break;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'h':
+        options->help = true;
+        break;
+      case 'o':
+        options->output_file = optarg;
+        break;
+      case 'p':
+        if (options->pid_file_count == MAX_PID_FILES) {
+          printf("Too many PID files\n");
+          exit(EX_USAGE);
+        }
+        options->pid_files[options->pid_file_count++] = optarg;
+        break;
+      default:
+        {}
+    }
+  }
+
+  if (options->help) {
+    DisplayHelpAndExit(argv[0], 0);
+  }
+
+  if (optind + 1 != argc) {
+    printf("Missing table file\n");
+    exit(EX_USAGE);
+  }
+  return true;
+}
+
+/*
+ * @brief Exit with an error about a line of the table.
+ */
+void TableError(const char *file, unsigned int line, const char *message,
+                const char *token) {
+  fprintf(stderr, "%s:%u: %s %s\n", file, line, message, token);
+  exit(EX_DATAERR);
+}
+
+/*
+ * @brief Copy a token, exiting if it's too long.
+ */
+void CopyName(char *dst, const char *src, const char *file,
+              unsigned int line) {
+  if (strlen(src) >= MAX_NAME_SIZE) {
+    TableError(file, line, "Name too long:", src);
+  }
+  strcpy(dst, src);
+}
+
+/*
+ * @brief Load the PID_ values from an enum in a header file.
+ */
+void LoadPIDNames(const char *file) {
+  FILE *fp = fopen(file, "r");
+  if (!fp) {
+    fprintf(stderr, "Failed to open %s\n", file);
+    exit(EX_NOINPUT);
+  }
+
+  char line[MAX_LINE_SIZE];
+  char name[MAX_NAME_SIZE];
+  char value[MAX_NAME_SIZE];
+  while (fgets(line, MAX_LINE_SIZE, fp)) {
+    if (sscanf(line, " %63[A-Za-z0-9_] = %63[0-9a-fA-Fx]", name, value) != 2 ||
+        strncmp(name, "PID_", 4) != 0) {
+      continue;
+    }
+    if (g_pid_name_count == MAX_PID_NAMES) {
+      fprintf(stderr, "Too many PIDs in %s\n", file);
+      exit(EX_SOFTWARE);
+    }
+    PIDName *pid = &g_pid_names[g_pid_name_count];
+    if (StringToUInt16(value, &pid->value)) {
+      strcpy(pid->name, name);
+      g_pid_name_count++;
+    }
+  }
+  fclose(fp);
+}
+
+/*
+ * @brief Resolve a PID name or number to its value.
+ */
+bool LookupPID(const char *name, uint16_t *value) {
+  if (isdigit((unsigned char) name[0])) {
+    return StringToUInt16(name, value);
+  }
+
+  unsigned int i = 0u;
+  for (; i < g_pid_name_count; i++) {
+    if (strcmp(name, g_pid_names[i].name) == 0) {
+      *value = g_pid_names[i].value;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * @brief The size and alignment of a type on the PIC32.
+ *
+ * Types we don't know about are assumed to be word sized.
+ */
+unsigned int TypeSize(const char *type) {
+  if (strcmp(type, "bool") == 0 || strcmp(type, "uint8_t") == 0 ||
+      strcmp(type, "int8_t") == 0 || strcmp(type, "char") == 0) {
+    return 1u;
+  } else if (strcmp(type, "uint16_t") == 0 || strcmp(type, "int16_t") == 0) {
+    return 2u;
+  }
+  return 4u;
+}
+
+/*
+ * @brief The largest value the generic handlers accept for a type.
+ * @returns The value, or NULL if the generic handlers don't support the type.
+ */
+const char *TypeMax(const char *type) {
+  if (strcmp(type, "bool") == 0) {
+    return "1u";
+  } else if (strcmp(type, "uint8_t") == 0) {
+    return "UINT8_MAX";
+  } else if (strcmp(type, "uint16_t") == 0) {
+    return "UINT16_MAX";
+  } else if (strcmp(type, "uint32_t") == 0) {
+    return "UINT32_MAX";
+  }
+  return NULL;
+}
+
+const Field *FindField(const Table *table, const char *name) {
+  unsigned int i = 0u;
+  for (; i < table->field_count; i++) {
+    if (strcmp(name, table->fields[i].name) == 0) {
+      return &table->fields[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * @brief Split a line into whitespace separated tokens, ignoring comments.
+ */
+unsigned int Tokenize(char *line, char *tokens[MAX_TOKENS]) {
+  char *comment = strchr(line, '#');
+  if (comment) {
+    *comment = 0;
+  }
+
+  unsigned int count = 0u;
+  char *token = strtok(line, " \t\r\n");
+  while (token && count < MAX_TOKENS) {
+    tokens[count++] = token;
+    token = strtok(NULL, " \t\r\n");
+  }
+  return token ? MAX_TOKENS + 1u : count;
+}
+
+void ParseField(Table *table, char *tokens[], unsigned int count,
+                const char *file, unsigned int line) {
+  if (count < 3u) {
+    TableError(file, line, "Expected: field <type> <name> [options]", "");
+  }
+  if (table->field_count == MAX_FIELDS) {
+    TableError(file, line, "Too many fields", "");
+  }
+  if (FindField(table, tokens[2])) {
+    TableError(file, line, "Duplicate field", tokens[2]);
+  }
+
+  Field *field = &table->fields[table->field_count++];
+  CopyName(field->type, tokens[1], file, line);
+  CopyName(field->name, tokens[2], file, line);
+  field->min[0] = 0;
+  field->max[0] = 0;
+  field->size = TypeSize(field->type);
+  field->tracked = false;
+
+  unsigned int i = 3u;
+  for (; i < count; i++) {
+    if (strncmp(tokens[i], "min=", 4) == 0) {
+      CopyName(field->min, tokens[i] + 4, file, line);
+    } else if (strncmp(tokens[i], "max=", 4) == 0) {
+      CopyName(field->max, tokens[i] + 4, file, line);
+    } else if (strcmp(tokens[i], "tracked") == 0) {
+      field->tracked = true;
+    } else {
+      TableError(file, line, "Unknown field option", tokens[i]);
+    }
+  }
+}
+
+void ParsePID(Table *table, char *tokens[], unsigned int count,
+              const char *file, unsigned int line) {
+  if (count != 5u) {
+    TableError(file, line,
+               "Expected: pid <pid> <get> <get param size> <set>", "");
+  }
+  if (table->pid_count == MAX_PIDS) {
+    TableError(file, line, "Too many PIDs", "");
+  }
+
+  PIDEntry *pid = &table->pids[table->pid_count++];
+  CopyName(pid->name, tokens[1], file, line);
+  if (!LookupPID(pid->name, &pid->value)) {
+    TableError(file, line, "Unknown PID", pid->name);
+  }
+  CopyName(pid->get_handler, tokens[2], file, line);
+  CopyName(pid->get_param_size, tokens[3], file, line);
+  CopyName(pid->set_handler, tokens[4], file, line);
+
+  const char *handlers[] = {pid->get_handler, pid->set_handler};
+  unsigned int i = 0u;
+  for (; i < 2u; i++) {
+    if (handlers[i][0] != GENERATED_PREFIX) {
+      continue;
+    }
+    const Field *field = FindField(table, handlers[i] + 1);
+    if (!field) {
+      TableError(file, line, "Unknown field", handlers[i]);
+    }
+    if (!TypeMax(field->type)) {
+      TableError(file, line, "No generic handler for type", field->type);
+    }
+  }
+
+  // The generic handlers find the field from the PID, so there can only be
+  // one field per PID.
+  if (pid->get_handler[0] == GENERATED_PREFIX &&
+      pid->set_handler[0] == GENERATED_PREFIX &&
+      strcmp(pid->get_handler, pid->set_handler) != 0) {
+    TableError(file, line, "GET and SET use different fields for",
+               pid->name);
+  }
+}
+
+void LoadTable(const char *file, Table *table) {
+  memset(table, 0, sizeof(Table));
+  const char *basename = strrchr(file, '/');
+  CopyName(table->source, basename ? basename + 1 : file, file, 0u);
+
+  FILE *fp = fopen(file, "r");
+  if (!fp) {
+    fprintf(stderr, "Failed to open %s\n", file);
+    exit(EX_NOINPUT);
+  }
+
+  char line[MAX_LINE_SIZE];
+  char *tokens[MAX_TOKENS];
+  unsigned int line_number = 0u;
+  while (fgets(line, MAX_LINE_SIZE, fp)) {
+    line_number++;
+    unsigned int count = Tokenize(line, tokens);
+    if (count == 0u) {
+      continue;
+    } else if (count > MAX_TOKENS) {
+      TableError(file, line_number, "Too many tokens", "");
+    }
+
+    if (strcmp(tokens[0], "prefix") == 0 && count == 2u) {
+      CopyName(table->prefix, tokens[1], file, line_number);
+    } else if (strcmp(tokens[0], "state") == 0 && count == 3u) {
+      CopyName(table->state_type, tokens[1], file, line_number);
+      CopyName(table->state_variable, tokens[2], file, line_number);
+    } else if (strcmp(tokens[0], "include") == 0 && count == 2u) {
+      if (table->include_count == MAX_INCLUDES) {
+        TableError(file, line_number, "Too many includes", "");
+      }
+      CopyName(table->includes[table->include_count++], tokens[1], file,
+               line_number);
+    } else if (strcmp(tokens[0], "defaults") == 0 && count == 2u) {
+      CopyName(table->defaults_field, tokens[1], file, line_number);
+    } else if (strcmp(tokens[0], "field") == 0) {
+      ParseField(table, tokens, count, file, line_number);
+    } else if (strcmp(tokens[0], "pid") == 0) {
+      ParsePID(table, tokens, count, file, line_number);
+    } else {
+      TableError(file, line_number, "Unknown directive", tokens[0]);
+    }
+  }
+  fclose(fp);
+
+  if (!table->prefix[0] || !table->state_type[0]) {
+    TableError(file, line_number, "Missing prefix or state directive", "");
+  }
+  unsigned int state_size = 0u;
+  unsigned int i = 0u;
+  for (; i < table->field_count; i++) {
+    state_size += table->fields[i].size;
+  }
+  if (state_size > MAX_STATE_SIZE) {
+    TableError(file, line_number, "The state is too large", "");
+  }
+
+  if (table->defaults_field[0]) {
+    const Field *field = FindField(table, table->defaults_field);
+    if (!field || strcmp(field->type, "bool") != 0) {
+      TableError(file, line_number, "The defaults field must be a bool",
+                 table->defaults_field);
+    }
+  }
+}
+
+int ComparePIDs(const void *a, const void *b) {
+  return ((const PIDEntry*) a)->value - ((const PIDEntry*) b)->value;
+}
+
+/*
+ * @brief Build the name of a generic handler, e.g. <prefix>_GetField.
+ */
+void HandlerName(const Table *table, const char *action, char *output) {
+  sprintf(output, "%s_%sField", table->prefix, action);
+}
+
+/*
+ * @brief Build a handler reference for the descriptor table.
+ */
+void HandlerReference(const Table *table, const char *handler,
+                      const char *action, char *output) {
+  if (strcmp(handler, NO_HANDLER) == 0) {
+    strcpy(output, "(PIDCommandHandler) NULL");
+  } else if (handler[0] == GENERATED_PREFIX) {
+    HandlerName(table, action, output);
+  } else {
+    strcpy(output, handler);
+  }
+}
+
+/*
+ * @brief Return the field a PID's generated handlers use.
+ * @returns The field, or NULL if neither handler is generated.
+ */
+const Field *GeneratedField(const Table *table, const PIDEntry *pid) {
+  if (pid->get_handler[0] == GENERATED_PREFIX) {
+    return FindField(table, pid->get_handler + 1);
+  } else if (pid->set_handler[0] == GENERATED_PREFIX) {
+    return FindField(table, pid->set_handler + 1);
+  }
+  return NULL;
+}
+
+/*
+ * @brief Write the field table, and the generic GET / SET handlers that
+ *   serve it.
+ *
+ * Each generated PID is one table entry, rather than a pair of handlers, which
+ * keeps the code size down as more fields are added.
+ */
+void WriteGenericHandlers(FILE *out, const Table *table) {
+  const char *state = table->state_variable;
+  const bool tracking = table->defaults_field[0];
+  char get_handler[2 * MAX_NAME_SIZE];
+  char set_handler[2 * MAX_NAME_SIZE];
+  HandlerName(table, "Get", get_handler);
+  HandlerName(table, "Set", set_handler);
+
+  bool has_get = false;
+  bool has_set = false;
+  unsigned int i = 0u;
+  for (; i < table->pid_count; i++) {
+    has_get |= table->pids[i].get_handler[0] == GENERATED_PREFIX;
+    has_set |= table->pids[i].set_handler[0] == GENERATED_PREFIX;
+  }
+  if (!has_get && !has_set) {
+    return;
+  }
+
+  fprintf(out,
+          "enum {\n"
+          "  FIELD_SIZE_MASK = 0x07,  //!< The size of the field in bytes.\n");
+  if (tracking) {
+    fprintf(out,
+            "  FIELD_TRACKED = 0x80,  //!< Clears %s when changed.\n",
+            table->defaults_field);
+  }
+  fprintf(out,
+          "};\n\n"
+          "/*\n"
+          " * @brief A field served by the generic GET / SET handlers.\n"
+          " */\n"
+          "typedef struct {\n"
+          "  uint16_t pid;\n"
+          "  uint8_t offset;  //!< The offset of the field in the state.\n"
+          "  uint8_t flags;  //!< The field size, and FIELD_TRACKED.\n"
+          "  uint32_t min;\n"
+          "  uint32_t max;\n"
+          "} GeneratedField;\n\n");
+
+  // Sorted by PID, since the PIDs are.
+  fprintf(out, "static const GeneratedField GENERATED_FIELDS[] = {\n");
+  bool first = true;
+  for (i = 0u; i < table->pid_count; i++) {
+    const PIDEntry *pid = &table->pids[i];
+    const Field *field = GeneratedField(table, pid);
+    if (!field) {
+      continue;
+    }
+    fprintf(out,
+            "%s  {%s,\n"
+            "    offsetof(%s, %s),\n"
+            "    sizeof(%s)%s, %s, %s}",
+            first ? "" : ",\n", pid->name, table->state_type, field->name,
+            field->type, tracking && field->tracked ? " | FIELD_TRACKED" : "",
+            field->min[0] ? field->min : "0u",
+            field->max[0] ? field->max : TypeMax(field->type));
+    first = false;
+  }
+  fprintf(out, "\n};\n\n");
+
+  fprintf(out,
+          "/*\n"
+          " * @brief Find the field for a PID.\n"
+          " *\n"
+          " * Only PIDs in GENERATED_FIELDS are dispatched to the generic\n"
+          " * handlers, so this always finds a field.\n"
+          " */\n"
+          "static const GeneratedField *%s_FindField(uint16_t pid) {\n"
+          "  const unsigned int last = (sizeof(GENERATED_FIELDS) /\n"
+          "                             sizeof(GeneratedField)) - 1u;\n"
+          "  unsigned int i = 0u;\n"
+          "  for (; i < last; i++) {\n"
+          "    if (GENERATED_FIELDS[i].pid == pid) {\n"
+          "      break;\n"
+          "    }\n"
+          "  }\n"
+          "  return &GENERATED_FIELDS[i];\n"
+          "}\n\n",
+          table->prefix);
+
+  if (has_get || tracking) {
+    fprintf(out,
+            "static uint32_t %s_ReadField(const GeneratedField *field) {\n"
+            "  const uint8_t *ptr = (const uint8_t*) &%s + field->offset;\n"
+            "  switch (field->flags & FIELD_SIZE_MASK) {\n"
+            "    case sizeof(uint32_t):\n"
+            "      return *(const uint32_t*) ptr;\n"
+            "    case sizeof(uint16_t):\n"
+            "      return *(const uint16_t*) ptr;\n"
+            "    default:\n"
+            "      return *ptr;\n"
+            "  }\n"
+            "}\n\n",
+            table->prefix, state);
+  }
+
+  if (has_get) {
+    fprintf(out,
+            "static int %s(const RDMHeader *header,\n"
+            "    UNUSED const uint8_t *param_data) {\n"
+            "  const GeneratedField *field = %s_FindField(\n"
+            "      ntohs(header->param_id));\n"
+            "  const uint32_t value = %s_ReadField(field);\n"
+            "  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);\n"
+            "  switch (field->flags & FIELD_SIZE_MASK) {\n"
+            "    case sizeof(uint32_t):\n"
+            "      ptr = PushUInt32(ptr, value);\n"
+            "      break;\n"
+            "    case sizeof(uint16_t):\n"
+            "      ptr = PushUInt16(ptr, value);\n"
+            "      break;\n"
+            "    default:\n"
+            "      *ptr++ = value;\n"
+            "  }\n"
+            "  return RDMResponder_AddHeaderAndChecksum(header, ACK,\n"
+            "                                           ptr - g_rdm_buffer);\n"
+            "}\n\n",
+            get_handler, table->prefix, table->prefix);
+  }
+
+  if (!has_set) {
+    return;
+  }
+  fprintf(out,
+          "static int %s(const RDMHeader *header,\n"
+          "    const uint8_t *param_data) {\n"
+          "  const GeneratedField *field = %s_FindField(\n"
+          "      ntohs(header->param_id));\n"
+          "  const unsigned int size = field->flags & FIELD_SIZE_MASK;\n"
+          "  if (header->param_data_length != size) {\n"
+          "    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);\n"
+          "  }\n\n"
+          "  uint32_t value = param_data[0];\n"
+          "  if (size == sizeof(uint32_t)) {\n"
+          "    value = ExtractUInt32(param_data);\n"
+          "  } else if (size == sizeof(uint16_t)) {\n"
+          "    value = ExtractUInt16(param_data);\n"
+          "  }\n"
+          "  if (value < field->min || value > field->max) {\n"
+          "    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);\n"
+          "  }\n\n",
+          set_handler, table->prefix);
+  if (tracking) {
+    fprintf(out,
+            "  if ((field->flags & FIELD_TRACKED) &&\n"
+            "      %s_ReadField(field) != value) {\n"
+            "    %s.%s = false;\n"
+            "  }\n\n",
+            table->prefix, state, table->defaults_field);
+  }
+  fprintf(out,
+          "  uint8_t *ptr = (uint8_t*) &%s + field->offset;\n"
+          "  switch (size) {\n"
+          "    case sizeof(uint32_t):\n"
+          "      *(uint32_t*) ptr = value;\n"
+          "      break;\n"
+          "    case sizeof(uint16_t):\n"
+          "      *(uint16_t*) ptr = value;\n"
+          "      break;\n"
+          "    default:\n"
+          "      *ptr = value;\n"
+          "  }\n"
+          "  return RDMResponder_BuildSetAck(header);\n"
+          "}\n\n",
+          state);
+}
+
+/*
+ * @brief Check if a handler is used by a PID before index, so prototypes and
+ *   generated handlers are only written once.
+ */
+bool SeenHandler(const Table *table, unsigned int index, const char *handler,
+                 bool check_get, bool check_set) {
+  unsigned int i = 0u;
+  for (; i < index; i++) {
+    if ((check_get && strcmp(table->pids[i].get_handler, handler) == 0) ||
+        (check_set && strcmp(table->pids[i].set_handler, handler) == 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WriteOutput(FILE *out, const char *output_file, const Table *table) {
+  const char *name = table->source;
+  if (output_file) {
+    name = strrchr(output_file, '/') ? strrchr(output_file, '/') + 1 :
+        output_file;
+  }
+  char guard[MAX_LINE_SIZE];
+  snprintf(guard, MAX_LINE_SIZE, "FIRMWARE_SRC_%.64s_", name);
+  char *ptr = guard;
+  for (; *ptr; ptr++) {
+    *ptr = isalnum((unsigned char) *ptr) ? toupper((unsigned char) *ptr) : '_';
+  }
+
+  fprintf(out,
+          "/*\n"
+          " * Generated by tools/pidgen from %s, do not edit.\n"
+          " *\n"
+          " * This is included once, by the model's .c file.\n"
+          " */\n\n"
+          "#ifndef %s\n"
+          "#define %s\n\n"
+          "#include <stdbool.h>\n"
+          "#include <stddef.h>\n"
+          "#include <stdint.h>\n\n"
+          "#include \"macros.h\"\n"
+          "#include \"rdm.h\"\n"
+          "#include \"rdm_buffer.h\"\n"
+          "#include \"rdm_responder.h\"\n"
+          "#include \"utils.h\"\n",
+          table->source, guard, guard);
+  unsigned int i = 0u;
+  for (; i < table->include_count; i++) {
+    fprintf(out, "#include \"%s\"\n", table->includes[i]);
+  }
+  fprintf(out, "\n");
+
+  // The state, largest members first so the struct has no padding.
+  fprintf(out,
+          "/*\n"
+          " * @brief The model state.\n"
+          " */\n"
+          "typedef struct {\n");
+  unsigned int size = 4u;
+  for (; size > 0u; size /= 2u) {
+    unsigned int i = 0u;
+    for (; i < table->field_count; i++) {
+      if (table->fields[i].size == size) {
+        fprintf(out, "  %s %s;\n", table->fields[i].type,
+                table->fields[i].name);
+      }
+    }
+  }
+  fprintf(out, "} %s;\n\n", table->state_type);
+  fprintf(out, "static %s %s;\n\n", table->state_type, table->state_variable);
+
+  // Prototypes for the model's own handlers.
+  fprintf(out, "// Model PID handlers\n");
+  const size_t prefix_size = strlen(table->prefix);
+  for (i = 0u; i < table->pid_count; i++) {
+    const PIDEntry *pid = &table->pids[i];
+    const char *handlers[] = {pid->get_handler, pid->set_handler};
+    unsigned int j = 0u;
+    for (; j < 2u; j++) {
+      if (strncmp(handlers[j], table->prefix, prefix_size) != 0 ||
+          handlers[j][prefix_size] != '_' ||
+          SeenHandler(table, i, handlers[j], true, true) ||
+          (j == 1u && strcmp(pid->get_handler, pid->set_handler) == 0)) {
+        continue;
+      }
+      fprintf(out,
+              "int %s(const RDMHeader *header,\n"
+              "    const uint8_t *param_data);\n",
+              handlers[j]);
+    }
+  }
+
+  fprintf(out, "\n");
+  WriteGenericHandlers(out, table);
+
+  // The descriptor table, sorted by PID for RDMResponder_DispatchPID().
+  fprintf(out, "static const PIDDescriptor PID_DESCRIPTORS[] = {\n");
+  for (i = 0u; i < table->pid_count; i++) {
+    const PIDEntry *pid = &table->pids[i];
+    char get_handler[2 * MAX_NAME_SIZE];
+    char set_handler[2 * MAX_NAME_SIZE];
+    HandlerReference(table, pid->get_handler, "Get", get_handler);
+    HandlerReference(table, pid->set_handler, "Set", set_handler);
+
+    // Keep within 80 columns.
+    const bool wrap = strlen(pid->name) + strlen(get_handler) +
+        strlen(pid->get_param_size) + 8u > 80u;
+    fprintf(out, "  {%s,%s%s, %s,\n    %s}%s\n", pid->name,
+            wrap ? "\n    " : " ", get_handler, pid->get_param_size,
+            set_handler, i + 1u == table->pid_count ? "" : ",");
+  }
+  fprintf(out, "};\n\n");
+  fprintf(out, "#endif  // %s\n", guard);
+}
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!InitOptions(&options, argc, argv)) {
+    return EX_USAGE;
+  }
+
+  unsigned int i = 0u;
+  for (; i < options.pid_file_count; i++) {
+    LoadPIDNames(options.pid_files[i]);
+  }
+
+  static Table table;
+  LoadTable(argv[optind], &table);
+
+  qsort(table.pids, table.pid_count, sizeof(PIDEntry), ComparePIDs);
+  for (i = 1u; i < table.pid_count; i++) {
+    if (table.pids[i].value == table.pids[i - 1u].value) {
+      fprintf(stderr, "Duplicate PID 0x%04x\n", table.pids[i].value);
+      return EX_DATAERR;
+    }
+  }
+
+  FILE *out = stdout;
+  if (options.output_file) {
+    out = fopen(options.output_file, "w");
+    if (!out) {
+      fprintf(stderr, "Failed to open %s\n", options.output_file);
+      return EX_CANTCREAT;
+    }
+  }
+  WriteOutput(out, options.output_file, &table);
+  if (out != stdout) {
+    fclose(out);
+  }
+  return EX_OK;
+}
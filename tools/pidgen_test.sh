@@ -0,0 +1,106 @@
+#!/bin/sh
+# Tests for pidgen.
+#
+# Usage: pidgen_test.sh <pidgen> <srcdir>
+
+PIDGEN=$1
+SRCDIR=$2
+TESTDATA=$SRCDIR/tools/testdata
+TMPDIR=$(mktemp -d)
+trap 'rm -rf $TMPDIR' EXIT
+
+FAILED=0
+
+fail() {
+  echo "FAIL: $1"
+  FAILED=1
+}
+
+# Check pidgen rejects a table, with EX_DATAERR.
+expect_error() {
+  description=$1
+  cat > $TMPDIR/bad.pids
+  $PIDGEN -p $TESTDATA/pidgen_test_rdm.h -o $TMPDIR/bad_pids.h \
+    $TMPDIR/bad.pids > /dev/null 2>&1
+  if [ $? -ne 65 ]; then
+    fail "$description wasn't rejected"
+  fi
+}
+
+# The generated header matches the expected output.
+$PIDGEN -p $TESTDATA/pidgen_test_rdm.h -o $TMPDIR/pidgen_test_pids.h \
+  $TESTDATA/pidgen_test.pids || fail "pidgen_test.pids was rejected"
+diff -u $TESTDATA/pidgen_test_pids.h $TMPDIR/pidgen_test_pids.h ||
+  fail "pidgen_test_pids.h differs"
+
+# Without any @<field> handlers, the generic handlers are left out.
+cat > $TMPDIR/no_fields.pids <<EOF
+prefix TestModel
+state TestModel g_test
+field uint8_t lamp_state
+pid PID_DEVICE_INFO RDMResponder_GetDeviceInfo 0u -
+EOF
+$PIDGEN -p $TESTDATA/pidgen_test_rdm.h -o $TMPDIR/no_fields_pids.h \
+  $TMPDIR/no_fields.pids ||
+  fail "A table without generated handlers was rejected"
+if grep -q GeneratedField $TMPDIR/no_fields_pids.h; then
+  fail "The generic handlers were written without any @<field> handlers"
+fi
+
+HEADER="prefix TestModel
+state TestModel g_test
+defaults using_factory_defaults
+field bool using_factory_defaults
+field uint8_t lamp_state
+field uint16_t display_level"
+
+expect_error "An unknown PID" <<EOF
+$HEADER
+pid PID_UNKNOWN @lamp_state 0u -
+EOF
+
+expect_error "A duplicate PID" <<EOF
+$HEADER
+pid PID_LAMP_STATE @lamp_state 0u -
+pid 0x0403 @display_level 0u -
+EOF
+
+expect_error "An unknown field" <<EOF
+$HEADER
+pid PID_LAMP_STATE @lamp_mode 0u -
+EOF
+
+expect_error "A PID with two fields" <<EOF
+$HEADER
+pid PID_LAMP_STATE @lamp_state 0u @display_level
+EOF
+
+expect_error "A field without a generic handler" <<EOF
+$HEADER
+field CoarseTimer_Value timer
+pid PID_LAMP_STATE @timer 0u -
+EOF
+
+expect_error "A duplicate field" <<EOF
+$HEADER
+field uint8_t lamp_state
+EOF
+
+expect_error "An unknown field option" <<EOF
+$HEADER
+field uint8_t power_state maximum=4
+EOF
+
+expect_error "A defaults field that isn't a bool" <<EOF
+prefix TestModel
+state TestModel g_test
+defaults lamp_state
+field uint8_t lamp_state
+EOF
+
+expect_error "A table without a prefix" <<EOF
+state TestModel g_test
+field uint8_t lamp_state
+EOF
+
+exit $FAILED
@@ -0,0 +1,183 @@
+/*
+ * Generated by tools/pidgen from pidgen_test.pids, do not edit.
+ *
+ * This is included once, by the model's .c file.
+ */
+
+#ifndef FIRMWARE_SRC_PIDGEN_TEST_PIDS_H_
+#define FIRMWARE_SRC_PIDGEN_TEST_PIDS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "macros.h"
+#include "rdm.h"
+#include "rdm_buffer.h"
+#include "rdm_responder.h"
+#include "utils.h"
+#include "coarse_timer.h"
+
+/*
+ * @brief The model state.
+ */
+typedef struct {
+  uint32_t device_hours;
+  CoarseTimer_Value timer;
+  uint16_t display_level;
+  bool using_factory_defaults;
+  uint8_t lamp_state;
+  bool pan_invert;
+} TestModel;
+
+static TestModel g_test;
+
+// Model PID handlers
+int TestModel_GetFactoryDefaults(const RDMHeader *header,
+    const uint8_t *param_data);
+int TestModel_SetFactoryDefaults(const RDMHeader *header,
+    const uint8_t *param_data);
+int TestModel_SetLampState(const RDMHeader *header,
+    const uint8_t *param_data);
+int TestModel_ResetDevice(const RDMHeader *header,
+    const uint8_t *param_data);
+
+enum {
+  FIELD_SIZE_MASK = 0x07,  //!< The size of the field in bytes.
+  FIELD_TRACKED = 0x80,  //!< Clears using_factory_defaults when changed.
+};
+
+/*
+ * @brief A field served by the generic GET / SET handlers.
+ */
+typedef struct {
+  uint16_t pid;
+  uint8_t offset;  //!< The offset of the field in the state.
+  uint8_t flags;  //!< The field size, and FIELD_TRACKED.
+  uint32_t min;
+  uint32_t max;
+} GeneratedField;
+
+static const GeneratedField GENERATED_FIELDS[] = {
+  {PID_DEVICE_HOURS,
+    offsetof(TestModel, device_hours),
+    sizeof(uint32_t), 0u, UINT32_MAX},
+  {PID_LAMP_STATE,
+    offsetof(TestModel, lamp_state),
+    sizeof(uint8_t), 0u, 4},
+  {PID_DISPLAY_LEVEL,
+    offsetof(TestModel, display_level),
+    sizeof(uint16_t) | FIELD_TRACKED, 10, 1000},
+  {PID_PAN_INVERT,
+    offsetof(TestModel, pan_invert),
+    sizeof(bool) | FIELD_TRACKED, 0u, 1u}
+};
+
+/*
+ * @brief Find the field for a PID.
+ *
+ * Only PIDs in GENERATED_FIELDS are dispatched to the generic
+ * handlers, so this always finds a field.
+ */
+static const GeneratedField *TestModel_FindField(uint16_t pid) {
+  const unsigned int last = (sizeof(GENERATED_FIELDS) /
+                             sizeof(GeneratedField)) - 1u;
+  unsigned int i = 0u;
+  for (; i < last; i++) {
+    if (GENERATED_FIELDS[i].pid == pid) {
+      break;
+    }
+  }
+  return &GENERATED_FIELDS[i];
+}
+
+static uint32_t TestModel_ReadField(const GeneratedField *field) {
+  const uint8_t *ptr = (const uint8_t*) &g_test + field->offset;
+  switch (field->flags & FIELD_SIZE_MASK) {
+    case sizeof(uint32_t):
+      return *(const uint32_t*) ptr;
+    case sizeof(uint16_t):
+      return *(const uint16_t*) ptr;
+    default:
+      return *ptr;
+  }
+}
+
+static int TestModel_GetField(const RDMHeader *header,
+    UNUSED const uint8_t *param_data) {
+  const GeneratedField *field = TestModel_FindField(
+      ntohs(header->param_id));
+  const uint32_t value = TestModel_ReadField(field);
+  uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
+  switch (field->flags & FIELD_SIZE_MASK) {
+    case sizeof(uint32_t):
+      ptr = PushUInt32(ptr, value);
+      break;
+    case sizeof(uint16_t):
+      ptr = PushUInt16(ptr, value);
+      break;
+    default:
+      *ptr++ = value;
+  }
+  return RDMResponder_AddHeaderAndChecksum(header, ACK,
+                                           ptr - g_rdm_buffer);
+}
+
+static int TestModel_SetField(const RDMHeader *header,
+    const uint8_t *param_data) {
+  const GeneratedField *field = TestModel_FindField(
+      ntohs(header->param_id));
+  const unsigned int size = field->flags & FIELD_SIZE_MASK;
+  if (header->param_data_length != size) {
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  uint32_t value = param_data[0];
+  if (size == sizeof(uint32_t)) {
+    value = ExtractUInt32(param_data);
+  } else if (size == sizeof(uint16_t)) {
+    value = ExtractUInt16(param_data);
+  }
+  if (value < field->min || value > field->max) {
+    return RDMResponder_BuildNack(header, NR_DATA_OUT_OF_RANGE);
+  }
+
+  if ((field->flags & FIELD_TRACKED) &&
+      TestModel_ReadField(field) != value) {
+    g_test.using_factory_defaults = false;
+  }
+
+  uint8_t *ptr = (uint8_t*) &g_test + field->offset;
+  switch (size) {
+    case sizeof(uint32_t):
+      *(uint32_t*) ptr = value;
+      break;
+    case sizeof(uint16_t):
+      *(uint16_t*) ptr = value;
+      break;
+    default:
+      *ptr = value;
+  }
+  return RDMResponder_BuildSetAck(header);
+}
+
+static const PIDDescriptor PID_DESCRIPTORS[] = {
+  {0x0050, RDMResponder_GetSupportedParameters, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_DEVICE_INFO, RDMResponder_GetDeviceInfo, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_FACTORY_DEFAULTS, TestModel_GetFactoryDefaults, 0u,
+    TestModel_SetFactoryDefaults},
+  {PID_DEVICE_HOURS, TestModel_GetField, 0u,
+    (PIDCommandHandler) NULL},
+  {PID_LAMP_STATE, TestModel_GetField, 0u,
+    TestModel_SetLampState},
+  {PID_DISPLAY_LEVEL, TestModel_GetField, 0u,
+    TestModel_SetField},
+  {PID_PAN_INVERT, TestModel_GetField, 0u,
+    TestModel_SetField},
+  {PID_RESET_DEVICE, (PIDCommandHandler) NULL, 0u,
+    TestModel_ResetDevice}
+};
+
+#endif  // FIRMWARE_SRC_PIDGEN_TEST_PIDS_H_
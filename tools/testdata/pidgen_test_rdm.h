@@ -0,0 +1,13 @@
+/*
+ * PIDs for the pidgen tests, in the same form as firmware/src/rdm.h.
+ */
+typedef enum {
+  PID_SUPPORTED_PARAMETERS = 0x0050,
+  PID_DEVICE_INFO = 0x0060,
+  PID_FACTORY_DEFAULTS = 0x0090,
+  PID_DEVICE_HOURS = 0x0400,
+  PID_LAMP_STATE = 0x0403,
+  PID_DISPLAY_LEVEL = 0x0501,
+  PID_PAN_INVERT = 0x0600,
+  PID_RESET_DEVICE = 0x1001,
+} RDMPid;